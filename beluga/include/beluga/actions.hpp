@@ -19,6 +19,8 @@
 #include <beluga/actions/normalize.hpp>
 #include <beluga/actions/propagate.hpp>
 #include <beluga/actions/reweight.hpp>
+#include <beluga/actions/reweight_bounded.hpp>
+#include <beluga/actions/reweight_coarse_to_fine.hpp>
 
 /**
  * \file
@@ -15,6 +15,9 @@
 #ifndef BELUGA_ACTIONS_ASSIGN_HPP
 #define BELUGA_ACTIONS_ASSIGN_HPP
 
+#include <type_traits>
+#include <utility>
+
 #include <range/v3/action/action.hpp>
 #include <range/v3/functional/bind_back.hpp>
 #include <range/v3/range/conversion.hpp>
@@ -45,6 +48,19 @@ inline constexpr bool is_range_closure_v = is_range_closure<T>::value;
 
 namespace detail {
 
+/// Type trait that checks if a container can reserve capacity and be assigned a range of type `View`.
+template <class Range, class View, class = void>
+struct is_reservable_assignable : std::false_type {};
+
+/// `is_reservable_assignable` specialization for containers that can.
+template <class Range, class View>
+struct is_reservable_assignable<
+    Range,
+    View,
+    std::void_t<
+        decltype(std::declval<Range&>().reserve(std::declval<const Range&>().capacity())),
+        decltype(std::declval<Range&>().assign_range(std::declval<View>()))>> : std::true_type {};
+
 /// Implementation detail for an assign range adaptor object.
 struct assign_fn {
   /// Overload that implements the assign algorithm.
@@ -58,7 +74,15 @@ struct assign_fn {
     if constexpr (!std::is_same_v<Range, std::decay_t<decltype(view)>>) {
       // If the result of invoking the closure is not the range itself,
       // then we need to convert the view and assign it to the input range.
-      range = std::move(view) | ranges::to<Range>;
+      if constexpr (is_reservable_assignable<Range, decltype(view)>::value) {
+        // Carry capacity over, so that containers reserved upfront are not regrown on every assignment.
+        auto result = Range{};
+        result.reserve(range.capacity());
+        result.assign_range(std::move(view));
+        range = std::move(result);
+      } else {
+        range = std::move(view) | ranges::to<Range>;
+      }
     }
     return range;
   }
@@ -95,6 +119,8 @@ struct assign_fn {
  * `ranges::views::move` to adapt the range in order for their elements to always produce an rvalue
  * reference during the indirection call which implies move. In this case, make sure that the input
  * views don't require accessing the elements in the adapted range more than once.
+ *
+ * Containers that support it (e.g. beluga::TupleVector) keep their capacity across assignments.
  */
 inline constexpr detail::assign_fn assign;
 
@@ -0,0 +1,163 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ACTIONS_REWEIGHT_BOUNDED_HPP
+#define BELUGA_ACTIONS_REWEIGHT_BOUNDED_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <execution>
+#include <type_traits>
+
+#include <beluga/sensor/bounded_weighting_function.hpp>
+#include <beluga/type_traits/particle_traits.hpp>
+#include <beluga/views/particles.hpp>
+
+#include <range/v3/action/action.hpp>
+#include <range/v3/iterator/operations.hpp>
+#include <range/v3/range/access.hpp>
+#include <range/v3/range/primitives.hpp>
+#include <range/v3/view/common.hpp>
+
+/**
+ * \file
+ * \brief Implementation of the bounded reweight range adaptor object.
+ */
+
+namespace beluga::actions {
+
+namespace detail {
+
+/// Implementation detail for a bounded reweight range adaptor object.
+struct reweight_bounded_base_fn {
+  /// Overload that implements the bounded reweight algorithm.
+  /**
+   * \tparam ExecutionPolicy An [execution policy](https://en.cppreference.com/w/cpp/algorithm/execution_policy_tag_t).
+   * \tparam Range An [input range](https://en.cppreference.com/w/cpp/ranges/input_range) of particles.
+   * \tparam Model A bounded state weighting function, such as beluga::BoundedWeightingFunction.
+   * \param policy The execution policy to use.
+   * \param range An existing range of particles to apply this action to.
+   * \param model A bounded state weighting function instance to compute the weights given the particle states.
+   * \param ratio Ratio to the best importance weight so far below which particles may stop being weighted early.
+   * \param stats Optional point evaluation counts to add to.
+   *
+   * Particles are weighted in turn, keeping track of the best importance weight computed in full. Each particle
+   * may stop being weighted as soon as its importance weight cannot exceed `ratio` times that best weight,
+   * in which case it gets a conservative importance weight. As in the reweight action, the current weight
+   * of each particle is multiplied by the resulting importance weight.
+   */
+  template <
+      class ExecutionPolicy,
+      class Range,
+      class Model,
+      std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0,
+      std::enable_if_t<ranges::range<Range>, int> = 0>
+  constexpr auto operator()(
+      ExecutionPolicy&& policy,
+      Range& range,
+      Model model,
+      double ratio,
+      EarlyTerminationStats* stats = nullptr) const -> Range& {
+    static_assert(beluga::is_particle_range_v<Range>);
+    auto states = range | beluga::views::states | ranges::views::common;
+    auto weights = range | beluga::views::weights | ranges::views::common;
+
+    std::atomic<double> best_weight{0.0};
+    std::atomic<std::size_t> evaluated{0};
+    const std::size_t size = model.size();
+    std::transform(
+        policy,               //
+        std::begin(states),   //
+        std::end(states),     //
+        std::begin(weights),  //
+        std::begin(weights),  //
+        [&model, &best_weight, &evaluated, ratio, size](const auto& s, auto w) {
+          const auto [importance_weight, count] = model(s, ratio * best_weight.load(std::memory_order_relaxed));
+          if (count == size) {
+            // Only weights computed in full may raise the bar, conservative weights are upper bounds.
+            double best = best_weight.load(std::memory_order_relaxed);
+            while (importance_weight > best &&
+                   !best_weight.compare_exchange_weak(best, importance_weight, std::memory_order_relaxed)) {
+            }
+          }
+          evaluated.fetch_add(count, std::memory_order_relaxed);
+          return w * importance_weight;
+        });
+
+    if (stats != nullptr) {
+      stats->evaluated += evaluated.load();
+      stats->total += size * static_cast<std::size_t>(ranges::distance(states));
+    }
+    return range;
+  }
+
+  /// Overload that re-orders arguments from a view closure.
+  template <
+      class Range,
+      class Model,
+      class ExecutionPolicy,
+      std::enable_if_t<ranges::range<Range>, int> = 0,
+      std::enable_if_t<std::is_execution_policy_v<ExecutionPolicy>, int> = 0>
+  constexpr auto operator()(
+      Range&& range,
+      Model model,
+      double ratio,
+      EarlyTerminationStats* stats,
+      ExecutionPolicy policy) const -> Range& {
+    return (*this)(std::move(policy), std::forward<Range>(range), std::move(model), ratio, stats);
+  }
+
+  /// Overload that returns a view closure to compose with other views.
+  template <class ExecutionPolicy, class Model, std::enable_if_t<std::is_execution_policy_v<ExecutionPolicy>, int> = 0>
+  constexpr auto operator()(ExecutionPolicy policy, Model model, double ratio, EarlyTerminationStats* stats = nullptr)
+      const {
+    return ranges::make_action_closure(
+        ranges::bind_back(reweight_bounded_base_fn{}, std::move(model), ratio, stats, std::move(policy)));
+  }
+};
+
+/// Implementation detail for a bounded reweight range adaptor object with a default execution policy.
+struct reweight_bounded_fn : public reweight_bounded_base_fn {
+  using reweight_bounded_base_fn::operator();
+
+  /// Overload that defines a default execution policy.
+  template <class Range, class Model, std::enable_if_t<ranges::range<Range>, int> = 0>
+  constexpr auto operator()(Range&& range, Model model, double ratio, EarlyTerminationStats* stats = nullptr) const
+      -> Range& {
+    return (*this)(std::execution::seq, std::forward<Range>(range), std::move(model), ratio, stats);
+  }
+
+  /// Overload that returns a view closure to compose with other views.
+  template <class Model>
+  constexpr auto operator()(Model model, double ratio, EarlyTerminationStats* stats = nullptr) const {
+    return ranges::make_action_closure(ranges::bind_back(reweight_bounded_fn{}, std::move(model), ratio, stats));
+  }
+};
+
+}  // namespace detail
+
+/// [Range adaptor object](https://en.cppreference.com/w/cpp/named_req/RangeAdaptorObject) that
+/// can update the weights in a particle range using a bounded sensor model.
+/**
+ * This action updates particle weights by importance weight multiplication, like beluga::actions::reweight
+ * does, but it stops weighting particles as soon as they are known to be far less likely than the best one
+ * so far (see beluga::BoundedWeightingFunction). This cuts update costs whenever most particles are unlikely,
+ * ie. during global localization, at the expense of overestimating the weights of those unlikely particles.
+ */
+inline constexpr detail::reweight_bounded_fn reweight_bounded;
+
+}  // namespace beluga::actions
+
+#endif
@@ -0,0 +1,206 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ACTIONS_REWEIGHT_COARSE_TO_FINE_HPP
+#define BELUGA_ACTIONS_REWEIGHT_COARSE_TO_FINE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <beluga/type_traits/particle_traits.hpp>
+#include <beluga/views/particles.hpp>
+
+#include <range/v3/action/action.hpp>
+#include <range/v3/range/access.hpp>
+#include <range/v3/range/primitives.hpp>
+#include <range/v3/view/common.hpp>
+
+/**
+ * \file
+ * \brief Implementation of the coarse-to-fine reweight range adaptor object.
+ */
+
+namespace beluga::actions {
+
+namespace detail {
+
+/// Implementation detail for a coarse-to-fine reweight range adaptor object.
+struct reweight_coarse_to_fine_base_fn {
+  /// Overload that implements the coarse-to-fine reweight algorithm.
+  /**
+   * \tparam ExecutionPolicy An [execution policy](https://en.cppreference.com/w/cpp/algorithm/execution_policy_tag_t).
+   * \tparam Range A [random access range](https://en.cppreference.com/w/cpp/ranges/random_access_range) of particles.
+   * \tparam CoarseModel A callable that can approximate the importance weight given a particle state.
+   * \tparam FineModel A callable that can compute the importance weight given a particle state.
+   * \param policy The execution policy to use.
+   * \param range An existing range of particles to apply this action to.
+   * \param coarse_model A callable instance to approximate the weights given the particle states.
+   * \param fine_model A callable instance to compute the weights given the particle states.
+   * \param fraction Fraction of particles, those with the highest approximate weights, to compute weights for.
+   *
+   * Approximate importance weights are computed for all particles. Then, only the top `fraction` of them
+   * get their importance weights computed, the rest keep their approximations scaled by the mean ratio
+   * between computed and approximate importance weights of the former. As in the reweight action,
+   * the current weight of each particle is multiplied by the resulting importance weight.
+   */
+  template <
+      class ExecutionPolicy,
+      class Range,
+      class CoarseModel,
+      class FineModel,
+      std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0,
+      std::enable_if_t<ranges::range<Range>, int> = 0>
+  constexpr auto operator()(
+      ExecutionPolicy&& policy,
+      Range& range,
+      CoarseModel coarse_model,
+      FineModel fine_model,
+      double fraction) const -> Range& {
+    static_assert(beluga::is_particle_range_v<Range>);
+    auto states = range | beluga::views::states | ranges::views::common;
+    auto weights = range | beluga::views::weights | ranges::views::common;
+    static_assert(ranges::random_access_range<decltype(states)>);
+
+    const auto size = static_cast<std::size_t>(ranges::distance(states));
+    auto importance_weights = std::vector<double>(size);
+    std::transform(
+        policy,                      //
+        std::begin(states),          //
+        std::end(states),            //
+        importance_weights.begin(),  //
+        [&coarse_model](const auto& s) { return static_cast<double>(coarse_model(s)); });
+
+    const auto count = std::min(
+        size, static_cast<std::size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(size))));
+    auto indices = std::vector<std::size_t>(size);
+    std::iota(indices.begin(), indices.end(), std::size_t{0});
+    if (count < size) {
+      std::nth_element(
+          indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(count), indices.end(),
+          [&importance_weights](std::size_t first, std::size_t second) {
+            return importance_weights[first] > importance_weights[second];
+          });
+    }
+
+    const auto first = std::begin(states);
+    auto ratios = std::vector<double>(count);
+    std::transform(
+        policy, indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(count), ratios.begin(),
+        [&importance_weights, &fine_model, first](std::size_t index) {
+          const double approximate_weight = importance_weights[index];
+          importance_weights[index] = static_cast<double>(fine_model(first[static_cast<std::ptrdiff_t>(index)]));
+          return approximate_weight > 0.0 ? importance_weights[index] / approximate_weight
+                                          : std::numeric_limits<double>::quiet_NaN();
+        });
+
+    // Approximations may be biased (eg. upper bounds), so rescale those that were not refined by how
+    // much refined ones deviated from their approximations on average, or they may outweigh the latter.
+    double ratio_sum = 0.0;
+    std::size_t ratio_count = 0;
+    for (const double ratio : ratios) {
+      if (!std::isnan(ratio)) {
+        ratio_sum += ratio;
+        ++ratio_count;
+      }
+    }
+    if (ratio_count > 0) {
+      const double mean_ratio = ratio_sum / static_cast<double>(ratio_count);
+      std::for_each(
+          policy, indices.begin() + static_cast<std::ptrdiff_t>(count), indices.end(),
+          [&importance_weights, mean_ratio](std::size_t index) { importance_weights[index] *= mean_ratio; });
+    }
+
+    std::transform(
+        policy,                      //
+        std::begin(weights),         //
+        std::end(weights),           //
+        importance_weights.begin(),  //
+        std::begin(weights),         //
+        [](auto w, double importance_weight) { return w * importance_weight; });
+    return range;
+  }
+
+  /// Overload that re-orders arguments from a view closure.
+  template <
+      class Range,
+      class CoarseModel,
+      class FineModel,
+      class ExecutionPolicy,
+      std::enable_if_t<ranges::range<Range>, int> = 0,
+      std::enable_if_t<std::is_execution_policy_v<ExecutionPolicy>, int> = 0>
+  constexpr auto operator()(
+      Range&& range,
+      CoarseModel coarse_model,
+      FineModel fine_model,
+      double fraction,
+      ExecutionPolicy policy) const -> Range& {
+    return (*this)(
+        std::move(policy), std::forward<Range>(range), std::move(coarse_model), std::move(fine_model), fraction);
+  }
+
+  /// Overload that returns a view closure to compose with other views.
+  template <
+      class ExecutionPolicy,
+      class CoarseModel,
+      class FineModel,
+      std::enable_if_t<std::is_execution_policy_v<ExecutionPolicy>, int> = 0>
+  constexpr auto operator()(ExecutionPolicy policy, CoarseModel coarse_model, FineModel fine_model, double fraction)
+      const {
+    return ranges::make_action_closure(ranges::bind_back(
+        reweight_coarse_to_fine_base_fn{}, std::move(coarse_model), std::move(fine_model), fraction,
+        std::move(policy)));
+  }
+};
+
+/// Implementation detail for a coarse-to-fine reweight range adaptor object with a default execution policy.
+struct reweight_coarse_to_fine_fn : public reweight_coarse_to_fine_base_fn {
+  using reweight_coarse_to_fine_base_fn::operator();
+
+  /// Overload that defines a default execution policy.
+  template <class Range, class CoarseModel, class FineModel, std::enable_if_t<ranges::range<Range>, int> = 0>
+  constexpr auto operator()(Range&& range, CoarseModel coarse_model, FineModel fine_model, double fraction) const
+      -> Range& {
+    return (*this)(
+        std::execution::seq, std::forward<Range>(range), std::move(coarse_model), std::move(fine_model), fraction);
+  }
+
+  /// Overload that returns a view closure to compose with other views.
+  template <class CoarseModel, class FineModel>
+  constexpr auto operator()(CoarseModel coarse_model, FineModel fine_model, double fraction) const {
+    return ranges::make_action_closure(
+        ranges::bind_back(reweight_coarse_to_fine_fn{}, std::move(coarse_model), std::move(fine_model), fraction));
+  }
+};
+
+}  // namespace detail
+
+/// [Range adaptor object](https://en.cppreference.com/w/cpp/named_req/RangeAdaptorObject) that
+/// can update the weights in a particle range using a coarse and a fine sensor model.
+/**
+ * This action updates particle weights by importance weight multiplication, like beluga::actions::reweight
+ * does, but only computes importance weights with the (expensive) fine model for the most promising
+ * particles according to the (cheap) coarse model. The rest of the particles are weighted by the coarse
+ * model alone, rescaled to match the fine model on average. This cuts update costs whenever most particles
+ * are unlikely, ie. during global localization.
+ */
+inline constexpr detail::reweight_coarse_to_fine_fn reweight_coarse_to_fine;
+
+}  // namespace beluga::actions
+
+#endif
@@ -20,11 +20,15 @@
  * \brief Includes all beluga algorithms.
  */
 
+#include <beluga/algorithm/branch_and_bound_scan_matcher.hpp>
+#include <beluga/algorithm/compressed_resampling.hpp>
 #include <beluga/algorithm/cluster_based_estimation.hpp>
 #include <beluga/algorithm/distance_map.hpp>
 #include <beluga/algorithm/effective_sample_size.hpp>
 #include <beluga/algorithm/estimation.hpp>
 #include <beluga/algorithm/exponential_filter.hpp>
+#include <beluga/algorithm/gauss_newton_scan_matcher.hpp>
+#include <beluga/algorithm/generate_particles.hpp>
 #include <beluga/algorithm/raycasting.hpp>
 #include <beluga/algorithm/spatial_hash.hpp>
 #include <beluga/algorithm/thrun_recovery_probability_estimator.hpp>
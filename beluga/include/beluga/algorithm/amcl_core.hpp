@@ -16,16 +16,23 @@
 #define BELUGA_ALGORITHM_AMCL_CORE_HPP
 
 #include <execution>
+#include <functional>
+#include <iterator>
 #include <optional>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <beluga/beluga.hpp>
+#include <beluga/utility/scratch_arena.hpp>
 
+#include <range/v3/range/access.hpp>
 #include <range/v3/range/concepts.hpp>
+#include <range/v3/range/traits.hpp>
 #include <range/v3/view/any_view.hpp>
 #include <range/v3/view/take_exactly.hpp>
+#include "beluga/policies/every_n.hpp"
+#include "beluga/policies/on_effective_size_drop.hpp"
 #include "beluga/policies/on_motion.hpp"
 
 namespace beluga {
@@ -54,6 +61,101 @@ struct AmclParams {
   double kld_z = 3.0;
 };
 
+namespace detail {
+
+/// Resampling condition that, when enabled, only holds if the effective sample size drops.
+struct selective_resampling_condition {
+  /// Whether selective resampling is enabled.
+  bool enabled{false};
+
+  /// Returns true if resampling may proceed for the given range of particles.
+  template <class Range>
+  bool operator()(const Range& range) const {
+    return !enabled || beluga::policies::on_effective_size_drop(range);
+  }
+};
+
+/// Type trait that checks if a measurement is a range of measurements a sensor model takes.
+template <class SensorModel, class Measurement, class = void>
+struct is_measurement_range : std::false_type {};
+
+/// `is_measurement_range` specialization for ranges of measurements a sensor model takes.
+template <class SensorModel, class Measurement>
+struct is_measurement_range<
+    SensorModel,
+    Measurement,
+    std::enable_if_t<
+        ranges::range<Measurement> && std::is_invocable_v<SensorModel&, ranges::range_value_t<Measurement>>>>
+    : std::true_type {};
+
+/// Convenience template variable for `is_measurement_range`.
+template <class SensorModel, class Measurement>
+inline constexpr bool is_measurement_range_v = is_measurement_range<SensorModel, Measurement>::value;
+
+/// Checkpoint of the state an update policy keeps, for policies that do not expose it.
+/**
+ * Such policies cannot be rolled back, so restoring the checkpoint does nothing.
+ */
+template <class Policy, class = void>
+struct update_policy_checkpoint {
+  /// Whether restoring the checkpoint rolls back the policy.
+  static constexpr bool kRestorable = false;
+
+  /// Constructs a checkpoint of the given policy.
+  constexpr explicit update_policy_checkpoint(const Policy&) {}
+
+  /// Restores the given policy to this checkpoint.
+  constexpr void restore(Policy&) const {}
+};
+
+/// `update_policy_checkpoint` specialization for policies that track the latest pose they triggered on.
+template <class Policy>
+struct update_policy_checkpoint<Policy, std::void_t<decltype(std::declval<const Policy&>().latest_pose())>> {
+  /// Whether restoring the checkpoint rolls back the policy.
+  static constexpr bool kRestorable = true;
+
+  /// Constructs a checkpoint of the given policy.
+  constexpr explicit update_policy_checkpoint(const Policy& policy) : latest_pose{policy.latest_pose()} {}
+
+  /// Restores the given policy to this checkpoint.
+  constexpr void restore(Policy& policy) const { policy.set_latest_pose(latest_pose); }
+
+  /// Latest pose the policy triggered on at the time of the checkpoint.
+  std::decay_t<decltype(std::declval<const Policy&>().latest_pose())> latest_pose;
+};
+
+}  // namespace detail
+
+/// Makes the default AMCL update policy, which triggers updates on motion.
+/**
+ * \tparam State Filter state type.
+ * \param min_distance Minimum translation between updates.
+ * \param min_angle Minimum rotation between updates.
+ */
+template <class State>
+auto make_amcl_update_policy(double min_distance, double min_angle) {
+  using scalar_type = typename State::Scalar;
+  return beluga::policies::on_motion<State>(static_cast<scalar_type>(min_distance), static_cast<scalar_type>(min_angle));
+}
+
+/// Makes the default AMCL resample policy, which triggers resampling every N updates and,
+/// if selective resampling is enabled, only when the effective sample size drops.
+/**
+ * \param resample_interval Number of updates between resampling steps.
+ * \param selective_resampling Whether to resample only on effective sample size drops.
+ */
+inline auto make_amcl_resample_policy(std::size_t resample_interval, bool selective_resampling) {
+  return beluga::policies::every_n(resample_interval) &&
+         beluga::make_policy(detail::selective_resampling_condition{selective_resampling});
+}
+
+/// Default AMCL update policy type. See beluga::make_amcl_update_policy().
+template <class State>
+using amcl_update_policy_t = decltype(make_amcl_update_policy<State>(0.0, 0.0));
+
+/// Default AMCL resample policy type. See beluga::make_amcl_resample_policy().
+using amcl_resample_policy_t = decltype(make_amcl_resample_policy(1UL, false));
+
 /// Implementation of the Adaptive Monte Carlo Localization (AMCL) algorithm.
 /**
  * \tparam MotionModel Class representing a motion model. Must satisfy \ref MotionModelPage.
@@ -70,6 +172,12 @@ struct AmclParams {
  * \tparam ParticleType Full particle type, containing state, weight and possibly
  * other information .
  * \tparam ExecutionPolicy Execution policy for particles processing.
+ * \tparam UpdatePolicy Policy that decides whether to update the filter, given a control action.
+ * \tparam ResamplePolicy Policy that decides whether to resample particles, given the current particle set.
+ *
+ * Policies are template parameters so that calls to them can be resolved (and inlined) at compile time.
+ * The defaults are configured by beluga::AmclParams. Type-erased policies such as beluga::any_policy
+ * may still be used, at the expense of an indirect call per evaluation.
  */
 template <
     class MotionModel,
@@ -77,7 +185,9 @@ template <
     class RandomStateGenerator,
     typename WeightT = beluga::Weight,
     class ParticleType = std::tuple<typename SensorModel::state_type, WeightT>,
-    class ExecutionPolicy = std::execution::sequenced_policy>
+    class ExecutionPolicy = std::execution::sequenced_policy,
+    class UpdatePolicy = amcl_update_policy_t<typename SensorModel::state_type>,
+    class ResamplePolicy = amcl_resample_policy_t>
 class Amcl {
   static_assert(
       std::is_same_v<ExecutionPolicy, std::execution::parallel_policy> or
@@ -109,18 +219,47 @@ class Amcl {
       spatial_hasher_type spatial_hasher,
       const AmclParams& params = AmclParams{},
       ExecutionPolicy execution_policy = std::execution::seq)
+      : Amcl(
+            std::move(motion_model),
+            std::move(sensor_model),
+            std::move(random_state_generator),
+            std::move(spatial_hasher),
+            make_amcl_update_policy<state_type>(params.update_min_d, params.update_min_a),
+            make_amcl_resample_policy(params.resample_interval, params.selective_resampling),
+            params,
+            std::move(execution_policy)) {}
+
+  /// Construct a AMCL instance with custom policies.
+  /**
+   * \param motion_model Motion model instance.
+   * \param sensor_model Sensor model Instance.
+   * \param random_state_generator A callable able to produce random states, optionally based on the current particles
+   * state.
+   * \param spatial_hasher A spatial hasher instance capable of computing a hash out of a particle state.
+   * \param update_policy Policy to decide when to update the filter. Update-related parameters are ignored.
+   * \param resample_policy Policy to decide when to resample particles. Resample-related parameters are ignored.
+   * \param params Parameters for AMCL implementation.
+   * \param execution_policy Policy to use when processing particles.
+   */
+  Amcl(
+      MotionModel motion_model,
+      SensorModel sensor_model,
+      RandomStateGenerator random_state_generator,
+      spatial_hasher_type spatial_hasher,
+      UpdatePolicy update_policy,
+      ResamplePolicy resample_policy,
+      const AmclParams& params = AmclParams{},
+      ExecutionPolicy execution_policy = std::execution::seq)
       : params_{params},
         motion_model_{std::move(motion_model)},
         sensor_model_{std::move(sensor_model)},
         execution_policy_{std::move(execution_policy)},
         spatial_hasher_{std::move(spatial_hasher)},
         random_probability_estimator_{params_.alpha_slow, params_.alpha_fast},
-        update_policy_{beluga::policies::on_motion<state_type>(params_.update_min_d, params_.update_min_a)},
-        resample_policy_{beluga::policies::every_n(params_.resample_interval)},
+        update_policy_{std::move(update_policy)},
+        resample_policy_{std::move(resample_policy)},
         random_state_generator_(std::move(random_state_generator)) {
-    if (params_.selective_resampling) {
-      resample_policy_ = resample_policy_ && beluga::policies::on_effective_size_drop;
-    }
+    resampled_particles_.reserve(params_.max_particles);
   }
 
   /// Returns a reference to the current set of particles.
@@ -129,21 +268,28 @@ class Amcl {
   /// Initialize particles using a custom distribution.
   template <class Distribution>
   void initialize(Distribution distribution) {
-    particles_ = beluga::views::sample(std::move(distribution)) |                    //
-                 ranges::views::transform(beluga::make_from_state<particle_type>) |  //
-                 ranges::views::take_exactly(params_.max_particles) |                //
-                 ranges::to<beluga::TupleVector>;
+    // Particle buffers are swapped on resampling, so both must have room for as many particles as there can be.
+    particles_.reserve(params_.max_particles);
+    particles_.assign_range(
+        beluga::views::sample(std::move(distribution)) |                    //
+        ranges::views::transform(beluga::make_from_state<particle_type>) |  //
+        ranges::views::take_exactly(params_.max_particles));
     force_update_ = true;
   }
 
   /// Initialize particles with a given pose and covariance.
   /**
+   * Particles are generated in bulk, using the configured execution policy. See beluga::generate_particles().
+   *
    * \tparam CovarianceT type representing a covariance, compliant with state_type.
    * \throw std::runtime_error If the provided covariance is invalid.
    */
   template <class CovarianceT>
   void initialize(state_type pose, CovarianceT covariance) {
-    initialize(beluga::MultivariateNormalDistribution{pose, covariance});
+    particles_ = beluga::generate_particles<particle_type>(
+        execution_policy_, beluga::MultivariateNormalDistribution{pose, covariance}, params_.max_particles);
+    particles_.reserve(params_.max_particles);
+    force_update_ = true;
   }
 
   /// Update the map used for localization.
@@ -157,23 +303,97 @@ class Amcl {
    * the particles, and the particle weights are adjusted accordingly. Also, according to the configured resampling
    * policy, the particles are resampled to maintain diversity and prevent degeneracy.
    *
+   * Particle buffers are reused across updates, and KLD sampling scratch memory comes from an
+   * arena owned by the filter that is reset on every update, so steady state updates barely allocate.
+   *
    * \param control_action Control action.
    * \param measurement Measurement data.
    * \return An optional pair containing the estimated pose and covariance after the update,
    *         or std::nullopt if no update was performed.
    */
   auto update(state_type control_action, measurement_type measurement) -> std::optional<estimation_type> {
+    return update(std::move(control_action), [&measurement]() -> measurement_type { return std::move(measurement); });
+  }
+
+  /// Update particles based on motion and information from multiple sensors.
+  /**
+   * Same as the single measurement overload, except that measurements are merged into a single measurement
+   * (ie. their points are concatenated), as if they had been taken by a single sensor. Range finder sensor
+   * models thus combine points from all sensors as they combine beams from one (e.g. adding up point likelihoods
+   * in the likelihood field model), just like beluga_ros::Amcl does with multiple laser scans. Particles are
+   * propagated, reweighted and resampled once, no matter how many sensors there are. Measurements must be
+   * expressed in the same frame the sensor model expects, so any sensor mounting transforms must have been
+   * applied beforehand.
+   *
+   * \param control_action Control action.
+   * \param measurements Measurement data, one per sensor.
+   * \return An optional pair containing the estimated pose and covariance after the update,
+   *         or std::nullopt if no update was performed.
+   */
+  auto update(state_type control_action, std::vector<measurement_type> measurements)
+      -> std::optional<estimation_type> {
+    return update(std::move(control_action), [&measurements]() -> std::vector<measurement_type> {
+      return std::move(measurements);
+    });
+  }
+
+  /// Update particles based on motion and sensor information, making the measurement only if necessary.
+  /**
+   * Same as the overload above, except that the measurement is made by a callable that is only invoked
+   * once the update policy decides that an update is due. Measurements that take work to make (e.g.
+   * conversions from sensor messages) can thus be skipped for those updates the policy rejects.
+   * Made measurements need not be of `measurement_type`, as long as the sensor model takes them
+   * (e.g. point cloud views over message buffers, for sensor models that support them), or they are
+   * ranges of measurements the sensor model takes, to be merged as in the multiple sensor overload.
+   * If making the measurement throws, the exception propagates and the filter is left as it was. Update policies
+   * that expose the latest pose they triggered on (see beluga::policies::on_motion) are rolled back, and the next
+   * update is forced for any other policy that had decided on an update, so that the update can be retried.
+   *
+   * \tparam MeasurementFactory Callable type, with no arguments and returning a measurement.
+   * \param control_action Control action.
+   * \param make_measurement Callable to make the measurement data with.
+   * \return An optional pair containing the estimated pose and covariance after the update,
+   *         or std::nullopt if no update was performed.
+   */
+  template <
+      class MeasurementFactory,
+      class Measurement = std::invoke_result_t<MeasurementFactory&>,
+      std::enable_if_t<
+          std::is_invocable_v<SensorModel&, Measurement> || detail::is_measurement_range_v<SensorModel, Measurement>,
+          int> = 0>
+  auto update(state_type control_action, MeasurementFactory&& make_measurement) -> std::optional<estimation_type> {
     if (particles_.empty()) {
       return std::nullopt;
     }
 
-    if (!update_policy_(control_action) && !force_update_) {
+    // Only commit update policy state once the measurement is made, so that an update can be retried.
+    const auto checkpoint = detail::update_policy_checkpoint<UpdatePolicy>{update_policy_};
+    const bool update_due = update_policy_(control_action);
+    if (!update_due && !force_update_) {
       return std::nullopt;
     }
 
+    auto measurement = [&]() -> std::decay_t<Measurement> {
+      try {
+        return std::invoke(make_measurement);
+      } catch (...) {
+        if constexpr (detail::update_policy_checkpoint<UpdatePolicy>::kRestorable) {
+          checkpoint.restore(update_policy_);
+        } else {
+          // Policies that cannot be rolled back would otherwise miss the update they decided on.
+          force_update_ = force_update_ || update_due;
+        }
+        throw;
+      }
+    }();
+
+    // Scratch memory from the previous update is no longer in use.
+    scratch_arena_.reset();
+
+    auto state_weighting_function = make_state_weighting_function(std::move(measurement));
     particles_ |= beluga::actions::propagate(
                       execution_policy_, motion_model_(control_action_window_ << std::move(control_action))) |  //
-                  beluga::actions::reweight(execution_policy_, sensor_model_(std::move(measurement))) |         //
+                  beluga::actions::reweight(execution_policy_, std::move(state_weighting_function)) |           //
                   beluga::actions::normalize(execution_policy_);
 
     const double random_state_probability = random_probability_estimator_(particles_);
@@ -185,15 +405,18 @@ class Amcl {
         random_probability_estimator_.reset();
       }
 
-      particles_ |= beluga::views::sample |
-                    beluga::views::random_intersperse(std::move(random_state), random_state_probability) |
-                    beluga::views::take_while_kld(
-                        spatial_hasher_,        //
-                        params_.min_particles,  //
-                        params_.max_particles,  //
-                        params_.kld_epsilon,    //
-                        params_.kld_z) |
-                    beluga::actions::assign;
+      // Resample into a second buffer, owned by the filter, and swap, so that particle buffers are reused.
+      resampled_particles_.assign_range(
+          particles_ | beluga::views::sample |
+          beluga::views::geometric_random_intersperse(std::move(random_state), random_state_probability) |
+          beluga::views::take_while_kld(
+              spatial_hasher_,        //
+              params_.min_particles,  //
+              params_.max_particles,  //
+              params_.kld_epsilon,    //
+              params_.kld_z,          //
+              &scratch_arena_));
+      std::swap(particles_, resampled_particles_);
     }
 
     force_update_ = false;
@@ -204,6 +427,23 @@ class Amcl {
   void force_update() { force_update_ = true; }
 
  private:
+  /// Gets the state weighting function for a measurement, or for a range of measurements to merge.
+  template <class Measurement>
+  [[nodiscard]] auto make_state_weighting_function(Measurement&& measurement) {
+    if constexpr (std::is_invocable_v<SensorModel&, Measurement>) {
+      return sensor_model_(std::forward<Measurement>(measurement));
+    } else {
+      // Measurements are merged into one, as if a single sensor had taken them all.
+      auto merged_measurement = measurement_type{};
+      for (auto& single_measurement : measurement) {
+        merged_measurement.insert(
+            merged_measurement.end(), std::make_move_iterator(ranges::begin(single_measurement)),
+            std::make_move_iterator(ranges::end(single_measurement)));
+      }
+      return sensor_model_(std::move(merged_measurement));
+    }
+  }
+
   /// Gets a callable that will produce a random state.
   [[nodiscard]] decltype(auto) get_random_state_generator() const {
     if constexpr (std::is_invocable_v<random_state_generator_type>) {
@@ -213,6 +453,8 @@ class Amcl {
     }
   }
   beluga::TupleVector<particle_type> particles_;
+  beluga::TupleVector<particle_type> resampled_particles_;
+  beluga::ScratchArena scratch_arena_;
 
   AmclParams params_;
 
@@ -222,8 +464,8 @@ class Amcl {
 
   spatial_hasher_type spatial_hasher_;
   beluga::ThrunRecoveryProbabilityEstimator random_probability_estimator_;
-  beluga::any_policy<state_type> update_policy_;
-  beluga::any_policy<decltype(particles_)> resample_policy_;
+  UpdatePolicy update_policy_;
+  ResamplePolicy resample_policy_;
 
   random_state_generator_type random_state_generator_;
 
@@ -0,0 +1,371 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ALGORITHM_BRANCH_AND_BOUND_SCAN_MATCHER_HPP
+#define BELUGA_ALGORITHM_BRANCH_AND_BOUND_SCAN_MATCHER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <beluga/sensor/data/value_grid.hpp>
+
+#include <Eigen/Core>
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+/**
+ * \file
+ * \brief Implementation of a branch-and-bound correlative scan matcher over likelihood fields.
+ */
+
+namespace beluga {
+
+/// Parameters used to construct a BranchAndBoundScanMatcher instance.
+struct BranchAndBoundScanMatcherParam {
+  /// Number of levels in the precomputed max-pooled likelihood field pyramid.
+  /**
+   * Level `h` holds, for every cell, the maximum likelihood over the `2^h x 2^h` window of cells
+   * that starts at it. Deeper pyramids prune more aggressively, at the expense of taking up
+   * `pyramid_depth` times the memory of the original likelihood field.
+   */
+  std::size_t pyramid_depth = 6;
+  /// Angular search step, in radians.
+  /**
+   * If not positive, the step is chosen so that the farthest point in the scan moves by
+   * at most one grid cell between consecutive rotations.
+   */
+  double angular_step = 0.0;
+  /// Maximum number of hypotheses to return.
+  std::size_t max_hypotheses = 10;
+  /// Minimum distance, in meters, between two returned hypotheses.
+  double min_linear_separation = 0.5;
+  /// Minimum angular distance, in radians, between two returned hypotheses.
+  double min_angular_separation = 0.5;
+};
+
+/// Branch-and-bound correlative scan matcher.
+/**
+ * Exhaustively searches a discretized pose space for the poses that best align a 2D scan
+ * to a likelihood field, without evaluating every candidate pose. The search space is
+ * discretized by the likelihood field resolution in translation and by an angular step in
+ * rotation. Candidate translations are grouped in square blocks of cells, which are scored
+ * against a precomputed pyramid of max-pooled likelihood fields. The score of a block is an
+ * upper bound on the score of every pose in it, so blocks that cannot beat the best
+ * hypotheses found so far are pruned. See Hess et al. \cite hess2016realtimeloopclosure
+ * for further reference.
+ *
+ * Pose scores are aggregated just like beluga::LikelihoodFieldModel does,
+ * ie. as the sum of the cubed likelihood of each scan point.
+ */
+class BranchAndBoundScanMatcher {
+ public:
+  /// Parameter type that the constructor uses to configure the scan matcher.
+  using param_type = BranchAndBoundScanMatcherParam;
+  /// Measurement type for the scan matcher: a point cloud in the reference frame of the robot.
+  using measurement_type = std::vector<std::pair<double, double>>;
+  /// Scan match hypothesis type: a pose and its score.
+  using hypothesis_type = std::pair<Sophus::SE2d, double>;
+
+  /// Constructs a scan matcher instance.
+  /**
+   * \param params Parameters to configure this instance.
+   *  See beluga::BranchAndBoundScanMatcherParam for details.
+   * \param likelihood_field Likelihood field to match scans against.
+   * \param origin Likelihood field origin in the world frame.
+   * \param background_likelihood Likelihood to assume for points that fall outside the likelihood field.
+   */
+  explicit BranchAndBoundScanMatcher(
+      const param_type& params,
+      const ValueGrid2<float>& likelihood_field,
+      const Sophus::SE2d& origin = Sophus::SE2d{},
+      float background_likelihood = 0.0F)
+      : params_{params},
+        origin_{origin},
+        resolution_{likelihood_field.resolution()},
+        width_{static_cast<int>(likelihood_field.width())},
+        height_{static_cast<int>(likelihood_field.height())},
+        background_likelihood_{background_likelihood},
+        pyramid_{make_pyramid(likelihood_field, std::max(params.pyramid_depth, std::size_t{1}), background_likelihood)} {}
+
+  /// Returns the number of levels in the precomputed pyramid.
+  [[nodiscard]] std::size_t depth() const { return pyramid_.size(); }
+
+  /// Returns the upper bound likelihood of a `2^level x 2^level` window of cells.
+  /**
+   * \param level Pyramid level.
+   * \param xi Likelihood field cell x-axis coordinate where the window starts.
+   * \param yi Likelihood field cell y-axis coordinate where the window starts.
+   */
+  [[nodiscard]] float max_likelihood_at(std::size_t level, int xi, int yi) const { return pyramid_[level].at(xi, yi); }
+
+  /// Computes the score of a given pose.
+  /**
+   * \param points 2D scan points in the reference frame of the robot.
+   * \param pose Robot pose in the world frame.
+   */
+  [[nodiscard]] double score(const measurement_type& points, const Sophus::SE2d& pose) const {
+    const auto transform = origin_.inverse() * pose;
+    const auto& level = pyramid_.front();
+    double result = 0.0;
+    for (const auto& [px, py] : points) {
+      const Eigen::Vector2d point = transform * Eigen::Vector2d{px, py};
+      const auto xi = static_cast<int>(std::floor(point.x() / resolution_));
+      const auto yi = static_cast<int>(std::floor(point.y() / resolution_));
+      const auto value = static_cast<double>(level.at(xi, yi));
+      result += value * value * value;
+    }
+    return result;
+  }
+
+  /// Searches the whole likelihood field for the poses that best match a scan.
+  /**
+   * \param points 2D scan points in the reference frame of the robot.
+   * \return Best scoring hypotheses, sorted in descending score order.
+   */
+  [[nodiscard]] std::vector<hypothesis_type> match(const measurement_type& points) const {
+    const double step = angular_step_for(points);
+    const auto count = std::max(1, static_cast<int>(std::ceil(2.0 * Sophus::Constants<double>::pi() / step)));
+    auto angles = std::vector<double>(static_cast<std::size_t>(count));
+    for (int i = 0; i < count; ++i) {
+      angles[static_cast<std::size_t>(i)] = 2.0 * Sophus::Constants<double>::pi() * i / count;
+    }
+    return search(points, angles, Eigen::Vector2i{0, 0}, Eigen::Vector2i{width_ - 1, height_ - 1});
+  }
+
+  /// Searches a window around a pose for the poses that best match a scan.
+  /**
+   * \param points 2D scan points in the reference frame of the robot.
+   * \param center Center of the search window, as a pose in the world frame.
+   * \param linear_window Half side length of the square translational search window, in meters.
+   * \param angular_window Half width of the rotational search window, in radians.
+   * \return Best scoring hypotheses, sorted in descending score order.
+   */
+  [[nodiscard]] std::vector<hypothesis_type> match(
+      const measurement_type& points,
+      const Sophus::SE2d& center,
+      double linear_window,
+      double angular_window) const {
+    const double step = angular_step_for(points);
+    const auto local_center = origin_.inverse() * center;
+    const auto count = static_cast<int>(std::ceil(angular_window / step));
+    auto angles = std::vector<double>{};
+    angles.reserve(static_cast<std::size_t>(2 * count + 1));
+    for (int i = -count; i <= count; ++i) {
+      angles.push_back(local_center.so2().log() + step * i);
+    }
+    const Eigen::Vector2d lower = (local_center.translation().array() - linear_window) / resolution_ - 0.5;
+    const Eigen::Vector2d upper = (local_center.translation().array() + linear_window) / resolution_ - 0.5;
+    return search(
+        points, angles, lower.array().ceil().cast<int>().matrix(), upper.array().floor().cast<int>().matrix());
+  }
+
+ private:
+  /// Max-pooled likelihood field pyramid level.
+  struct Level {
+    std::vector<float> data;
+    int offset;
+    int width;
+    int height;
+    float background;
+
+    [[nodiscard]] float at(int xi, int yi) const {
+      xi += offset;
+      yi += offset;
+      if (xi < 0 || yi < 0 || xi >= width || yi >= height) {
+        return background;
+      }
+      return data[static_cast<std::size_t>(yi) * static_cast<std::size_t>(width) + static_cast<std::size_t>(xi)];
+    }
+  };
+
+  /// Search candidate, a block of `2^level x 2^level` translations at a given rotation.
+  struct Candidate {
+    std::size_t rotation;
+    int xi;
+    int yi;
+    double score;
+  };
+
+  param_type params_;
+  Sophus::SE2d origin_;
+  double resolution_;
+  int width_;
+  int height_;
+  float background_likelihood_;
+  std::vector<Level> pyramid_;
+
+  static std::vector<Level> make_pyramid(const ValueGrid2<float>& field, std::size_t depth, float background) {
+    auto pyramid = std::vector<Level>{};
+    pyramid.reserve(depth);
+    pyramid.push_back(Level{
+        field.data(), 0, static_cast<int>(field.width()), static_cast<int>(field.height()), background});
+    for (std::size_t level = 1; level < depth; ++level) {
+      const auto& previous = pyramid.back();
+      const int stride = 1 << (level - 1);
+      const int offset = (1 << level) - 1;
+      const int width = static_cast<int>(field.width()) + offset;
+      const int height = static_cast<int>(field.height()) + offset;
+      auto data = std::vector<float>(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+      auto it = data.begin();
+      for (int yi = -offset; yi < height - offset; ++yi) {
+        for (int xi = -offset; xi < width - offset; ++xi) {
+          *it++ = std::max(
+              std::max(previous.at(xi, yi), previous.at(xi + stride, yi)),
+              std::max(previous.at(xi, yi + stride), previous.at(xi + stride, yi + stride)));
+        }
+      }
+      pyramid.push_back(Level{std::move(data), offset, width, height, background});
+    }
+    return pyramid;
+  }
+
+  [[nodiscard]] double angular_step_for(const measurement_type& points) const {
+    if (params_.angular_step > 0.0) {
+      return params_.angular_step;
+    }
+    double max_range = 0.0;
+    for (const auto& [px, py] : points) {
+      max_range = std::max(max_range, std::hypot(px, py));
+    }
+    if (max_range <= resolution_) {
+      return Sophus::Constants<double>::pi() / 4;
+    }
+    return std::acos(1.0 - (resolution_ * resolution_) / (2.0 * max_range * max_range));
+  }
+
+  [[nodiscard]] double score_at(const Level& level, const std::vector<Eigen::Vector2i>& cells, int xi, int yi) const {
+    double result = 0.0;
+    for (const auto& cell : cells) {
+      const auto value = static_cast<double>(level.at(cell.x() + xi, cell.y() + yi));
+      result += value * value * value;
+    }
+    return result;
+  }
+
+  [[nodiscard]] std::vector<hypothesis_type> search(
+      const measurement_type& points,
+      const std::vector<double>& angles,
+      const Eigen::Vector2i& lower,
+      const Eigen::Vector2i& upper) const {
+    auto results = std::vector<hypothesis_type>{};
+    if (points.empty() || params_.max_hypotheses == 0 || (upper.array() < lower.array()).any()) {
+      return results;
+    }
+
+    // A candidate pose with rotation angle `theta` and cell offset `c` is located at the center of cell `c`
+    // in the likelihood field frame, so each point `p` falls into cell `floor(R(theta) * p / resolution + 0.5) + c`.
+    // Hence, discretized rotated scans can be computed once and shifted around.
+    auto rotated_scans = std::vector<std::vector<Eigen::Vector2i>>{};
+    rotated_scans.reserve(angles.size());
+    for (const double angle : angles) {
+      const auto rotation = Sophus::SO2d{angle};
+      auto& cells = rotated_scans.emplace_back();
+      cells.reserve(points.size());
+      for (const auto& [px, py] : points) {
+        const Eigen::Vector2d point = rotation * Eigen::Vector2d{px, py} / resolution_;
+        cells.emplace_back((point.array() + 0.5).floor().cast<int>().matrix());
+      }
+    }
+
+    const auto top_level = pyramid_.size() - 1;
+    const int top_stride = 1 << top_level;
+
+    auto candidates = std::vector<Candidate>{};
+    for (std::size_t rotation = 0; rotation < angles.size(); ++rotation) {
+      for (int xi = lower.x(); xi <= upper.x(); xi += top_stride) {
+        for (int yi = lower.y(); yi <= upper.y(); yi += top_stride) {
+          candidates.push_back(
+              Candidate{rotation, xi, yi, score_at(pyramid_[top_level], rotated_scans[rotation], xi, yi)});
+        }
+      }
+    }
+
+    const auto by_descending_score = [](const Candidate& first, const Candidate& second) {
+      return first.score > second.score;
+    };
+    std::sort(candidates.begin(), candidates.end(), by_descending_score);
+
+    const auto threshold = [&results, this]() {
+      return results.size() < params_.max_hypotheses ? std::numeric_limits<double>::lowest()
+                                                     : results.back().second;
+    };
+
+    const auto to_pose = [&angles, this](const Candidate& candidate) {
+      const Eigen::Vector2d translation{
+          (static_cast<double>(candidate.xi) + 0.5) * resolution_,
+          (static_cast<double>(candidate.yi) + 0.5) * resolution_};
+      return origin_ * Sophus::SE2d{Sophus::SO2d{angles[candidate.rotation]}, translation};
+    };
+
+    const auto accept = [&results, this](const Sophus::SE2d& pose, double score) {
+      // Keep hypotheses apart, only retaining the best scoring one of any cluster.
+      const auto is_near = [&pose, this](const hypothesis_type& hypothesis) {
+        const auto delta = hypothesis.first.inverse() * pose;
+        return delta.translation().norm() < params_.min_linear_separation &&
+               std::abs(delta.so2().log()) < params_.min_angular_separation;
+      };
+      for (const auto& hypothesis : results) {
+        if (hypothesis.second >= score && is_near(hypothesis)) {
+          return;
+        }
+      }
+      results.erase(std::remove_if(results.begin(), results.end(), is_near), results.end());
+      const auto position = std::upper_bound(
+          results.begin(), results.end(), score,
+          [](double value, const hypothesis_type& hypothesis) { return value > hypothesis.second; });
+      results.emplace(position, pose, score);
+      if (results.size() > params_.max_hypotheses) {
+        results.pop_back();
+      }
+    };
+
+    const auto branch = [&](const auto& self, std::size_t level, std::vector<Candidate>& current) -> void {
+      for (const auto& candidate : current) {
+        if (candidate.score <= threshold()) {
+          break;  // Candidates are sorted, none of the remaining ones can do better.
+        }
+        if (level == 0) {
+          accept(to_pose(candidate), candidate.score);
+          continue;
+        }
+        const int stride = 1 << (level - 1);
+        const auto& scan = rotated_scans[candidate.rotation];
+        auto children = std::vector<Candidate>{};
+        children.reserve(4);
+        for (const int dx : {0, stride}) {
+          for (const int dy : {0, stride}) {
+            const int xi = candidate.xi + dx;
+            const int yi = candidate.yi + dy;
+            if (xi <= upper.x() && yi <= upper.y()) {
+              children.push_back(Candidate{candidate.rotation, xi, yi, score_at(pyramid_[level - 1], scan, xi, yi)});
+            }
+          }
+        }
+        std::sort(children.begin(), children.end(), by_descending_score);
+        self(self, level - 1, children);
+      }
+    };
+
+    branch(branch, top_level, candidates);
+    return results;
+  }
+};
+
+}  // namespace beluga
+
+#endif
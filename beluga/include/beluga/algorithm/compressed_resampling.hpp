@@ -0,0 +1,202 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ALGORITHM_COMPRESSED_RESAMPLING_HPP
+#define BELUGA_ALGORITHM_COMPRESSED_RESAMPLING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <beluga/containers/tuple_vector.hpp>
+#include <beluga/primitives.hpp>
+#include <beluga/type_traits/particle_traits.hpp>
+#include <beluga/views/particles.hpp>
+
+#include <range/v3/range/access.hpp>
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/range/traits.hpp>
+
+/**
+ * \file
+ * \brief Implementation of resampling algorithms for compressed particle sets.
+ *
+ * A compressed particle set stores each distinct particle state once, along with the number of
+ * identical particles it stands for (see beluga::Multiplicity). Particle weights are the total weights of
+ * those identical particles, so that actions that only touch states and weights (reweighting, normalization)
+ * and weighted estimates work on compressed particle sets as is, while evaluating each distinct state once.
+ * Resampling produces counts of particles per source particle directly (see beluga::multinomial_counts()
+ * and beluga::residual_counts()), and beluga::compress() turns those counts into a compressed particle set.
+ * Particle sets can be decompressed (see beluga::views::decompress) whenever identical particles must
+ * evolve independently, e.g. before propagating them with a noisy motion model.
+ *
+ * These are library building blocks: beluga::Amcl and beluga_ros::Amcl keep uncompressed particle sets,
+ * as their adaptive (KLD) resampling does not draw counts per particle.
+ */
+
+namespace beluga {
+
+namespace detail {
+
+/// Draws multinomial counts for `weights`, adding them to `counts`.
+template <class URNG>
+void add_multinomial_counts(
+    const std::vector<double>& weights,
+    std::size_t count,
+    URNG& engine,
+    std::vector<std::size_t>& counts) {
+  const auto last = std::find_if(weights.rbegin(), weights.rend(), [](double weight) { return weight > 0.0; });
+  if (last == weights.rend()) {
+    if (count > 0) {
+      throw std::invalid_argument("Cannot resample particles with zero total weight");
+    }
+    return;
+  }
+
+  // Draw a binomial count per particle, conditioned on the counts drawn so far.
+  const auto last_index = static_cast<std::size_t>(std::distance(last, weights.rend())) - 1;
+  double remaining_weight = 0.0;
+  for (std::size_t index = 0; index <= last_index; ++index) {
+    remaining_weight += std::max(weights[index], 0.0);
+  }
+  std::size_t remaining = count;
+  for (std::size_t index = 0; index < last_index && remaining > 0; ++index) {
+    const double weight = std::max(weights[index], 0.0);
+    const double probability = std::clamp(weight / remaining_weight, 0.0, 1.0);
+    const auto drawn = std::binomial_distribution<std::size_t>{remaining, probability}(engine);
+    counts[index] += drawn;
+    remaining -= drawn;
+    remaining_weight -= weight;
+  }
+  // The last particle with a positive weight takes whatever is left, regardless of rounding errors.
+  counts[last_index] += remaining;
+}
+
+}  // namespace detail
+
+/// Draws multinomial resampling counts for a range of weights.
+/**
+ * Equivalent to drawing `count` particles with replacement, with probabilities proportional to their weights
+ * (as beluga::views::sample does), and counting how many times each particle was drawn. Counts are drawn with
+ * one binomial draw per particle, so the cost does not depend on `count`.
+ *
+ * \tparam Range A [forward range](https://en.cppreference.com/w/cpp/ranges/forward_range) of weights
+ *  or particles.
+ * \tparam URNG A random number generator type that satisfies
+ *  [UniformRandomBitGenerator](https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
+ * \param range Range of weights, or of particles to take the weights of.
+ * \param count Total number of particles to draw.
+ * \param engine Random number generator to draw counts with.
+ * \return The number of times each particle was drawn, in the same order.
+ * \throw std::invalid_argument If `count` is positive and no particle has a positive weight.
+ */
+template <class Range, class URNG>
+std::vector<std::size_t> multinomial_counts(Range&& range, std::size_t count, URNG& engine) {
+  auto weights = std::invoke([&range]() {
+    if constexpr (beluga::is_particle_range_v<Range>) {
+      return range | beluga::views::weights | ranges::to<std::vector<double>>;
+    } else {
+      return range | ranges::to<std::vector<double>>;
+    }
+  });
+  auto counts = std::vector<std::size_t>(weights.size(), 0);
+  detail::add_multinomial_counts(weights, count, engine, counts);
+  return counts;
+}
+
+/// Draws residual resampling counts for a range of weights.
+/**
+ * Each particle is first assigned as many particles as the integer part of its expected count
+ * (ie. `count` times its normalized weight), and the rest are drawn as in beluga::multinomial_counts()
+ * with the fractional parts of the expected counts as weights. This reduces resampling variance.
+ *
+ * \tparam Range A [forward range](https://en.cppreference.com/w/cpp/ranges/forward_range) of weights
+ *  or particles.
+ * \tparam URNG A random number generator type that satisfies
+ *  [UniformRandomBitGenerator](https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
+ * \param range Range of weights, or of particles to take the weights of.
+ * \param count Total number of particles to draw.
+ * \param engine Random number generator to draw counts with.
+ * \return The number of times each particle was drawn, in the same order.
+ * \throw std::invalid_argument If `count` is positive and no particle has a positive weight.
+ */
+template <class Range, class URNG>
+std::vector<std::size_t> residual_counts(Range&& range, std::size_t count, URNG& engine) {
+  auto weights = std::invoke([&range]() {
+    if constexpr (beluga::is_particle_range_v<Range>) {
+      return range | beluga::views::weights | ranges::to<std::vector<double>>;
+    } else {
+      return range | ranges::to<std::vector<double>>;
+    }
+  });
+
+  double total_weight = 0.0;
+  for (const double weight : weights) {
+    total_weight += std::max(weight, 0.0);
+  }
+
+  auto counts = std::vector<std::size_t>(weights.size(), 0);
+  std::size_t remaining = count;
+  if (total_weight > 0.0) {
+    for (std::size_t index = 0; index < weights.size(); ++index) {
+      const double expected = static_cast<double>(count) * std::max(weights[index], 0.0) / total_weight;
+      const double integral = std::floor(expected);
+      counts[index] = std::min(static_cast<std::size_t>(integral), remaining);
+      remaining -= counts[index];
+      weights[index] = expected - integral;  // Keep the fractional part as the residual weight.
+    }
+  }
+  detail::add_multinomial_counts(weights, remaining, engine, counts);
+  return counts;
+}
+
+/// Builds a compressed particle set out of a range of particles and resampling counts.
+/**
+ * Particles with zero counts are dropped. Every other particle is kept once, with its count
+ * as multiplicity and as weight (ie. unit weights for each of the particles it stands for).
+ *
+ * \tparam Range A [forward range](https://en.cppreference.com/w/cpp/ranges/forward_range) of particles.
+ * \tparam Counts A [forward range](https://en.cppreference.com/w/cpp/ranges/forward_range) of counts.
+ * \param particles Particles to take states from.
+ * \param counts Number of particles to draw from each particle, in the same order.
+ * \return A container with the compressed particle set.
+ */
+template <class Range, class Counts>
+auto compress(Range&& particles, Counts&& counts) {
+  static_assert(beluga::is_particle_range_v<Range>);
+  using state_type = beluga::state_t<ranges::range_value_t<Range>>;
+  using particle_type = std::tuple<state_type, beluga::Weight, beluga::Multiplicity>;
+
+  auto compressed = beluga::TupleVector<particle_type>{};
+  auto count_it = ranges::begin(counts);
+  for (const auto& state : particles | beluga::views::states) {
+    const auto count = static_cast<std::size_t>(*count_it++);
+    if (count > 0) {
+      compressed.push_back(
+          particle_type{state, beluga::Weight(static_cast<double>(count)), beluga::Multiplicity(count)});
+    }
+  }
+  return compressed;
+}
+
+}  // namespace beluga
+
+#endif
@@ -63,7 +63,7 @@ struct mean_fn {
     assert(weights_it != ranges::end(normalized_weights));
 
     for (; it != last; ++weights_it, ++it) {
-      accumulator += *weights_it * projection(*it);
+      accumulator += static_cast<Scalar>(*weights_it) * projection(*it);
     }
 
     assert(weights_it == ranges::end(normalized_weights));
@@ -257,7 +257,7 @@ struct covariance_fn {
 
     for (; it != last; ++weights_it, ++it) {
       const auto& value = projection(*it);
-      const auto weight = *weights_it;
+      const auto weight = static_cast<Scalar>(*weights_it);
       const auto centered = value - mean;
       accumulator.noalias() += weight * centered * centered.transpose();
       squared_weight_sum += weight * weight;
@@ -266,7 +266,7 @@ struct covariance_fn {
     assert(weights_it == ranges::end(normalized_weights));
     assert(squared_weight_sum < 1.0);
 
-    accumulator /= (1.0 - squared_weight_sum);  // apply the correction factor to yield an unbiased estimator
+    accumulator /= (Scalar{1.0} - squared_weight_sum);  // apply the correction factor to yield an unbiased estimator
     return accumulator;
   }
 
@@ -292,7 +292,7 @@ struct covariance_fn {
 
     for (; it != last; ++weights_it, ++it) {
       const auto& value = projection(*it);
-      const auto weight = *weights_it;
+      const auto weight = static_cast<Value>(*weights_it);
       const auto centered = value - mean;
       accumulator += weight * centered * centered;
       squared_weight_sum += weight * weight;
@@ -301,7 +301,7 @@ struct covariance_fn {
     assert(weights_it == ranges::end(normalized_weights));
     assert(squared_weight_sum < 1.0);
 
-    accumulator /= (1.0 - squared_weight_sum);  // apply the correction factor to yield an unbiased estimator
+    accumulator /= (Value{1.0} - squared_weight_sum);  // apply the correction factor to yield an unbiased estimator
     return accumulator;
   }
 
@@ -329,8 +329,9 @@ struct covariance_fn {
     // Algebra" by Mangelson et al. (https://robots.et.byu.edu/jmangelson/pubs/2020/mangelson2020tro.pdf).
     //
     // See section III. E) "Defining Random Variables over Poses" for more context.
+    using Scalar = typename Value::Scalar;
     auto accumulator = Value::Adjoint::Zero().eval();
-    auto squared_weight_sum = typename Value::Scalar{0.0};
+    auto squared_weight_sum = Scalar{0.0};
 
     auto it = ranges::begin(values);
     const auto last = ranges::end(values);
@@ -343,7 +344,7 @@ struct covariance_fn {
 
     for (; it != last; ++weights_it, ++it) {
       const auto& value = projection(*it);
-      const auto weight = *weights_it;
+      const auto weight = static_cast<Scalar>(*weights_it);
       const auto centered = (inverse_mean * value).log();
       accumulator.noalias() += weight * centered * centered.transpose();
       squared_weight_sum += weight * weight;
@@ -352,7 +353,7 @@ struct covariance_fn {
     assert(weights_it == ranges::end(normalized_weights));
     assert(squared_weight_sum < 1.0);
 
-    accumulator /= (1.0 - squared_weight_sum);  // apply the correction factor to yield an unbiased estimator
+    accumulator /= (Scalar{1.0} - squared_weight_sum);  // apply the correction factor to yield an unbiased estimator
     return accumulator;
   }
 
@@ -456,17 +457,17 @@ struct estimate_fn {
         values, normalized_weights, mean.translation(), [](const auto& value) { return value.translation(); });
 
     // Compute the orientation variance and re-normalize the rotation component (after using the non-normal result).
-    if (mean.so2().unit_complex().norm() < std::numeric_limits<double>::epsilon()) {
+    if (mean.so2().unit_complex().norm() < std::numeric_limits<Scalar>::epsilon()) {
       // Handle the case where both averages are too close to zero.
       // Return zero yaw and infinite variance.
-      covariance.coeffRef(2, 2) = std::numeric_limits<double>::infinity();
-      mean.so2() = Sophus::SO2<Scalar>{0.0};
+      covariance.coeffRef(2, 2) = std::numeric_limits<Scalar>::infinity();
+      mean.so2() = Sophus::SO2<Scalar>{Scalar{0.0}};
       // TODO(nahuel): Consider breaking the existing API and return
       // an optional to handle degenerate cases just like Sophus does.
     } else {
       // See circular standard deviation in
       // https://en.wikipedia.org/wiki/Directional_statistics#Dispersion.
-      covariance.coeffRef(2, 2) = -2.0 * std::log(mean.so2().unit_complex().norm());
+      covariance.coeffRef(2, 2) = Scalar{-2.0} * std::log(mean.so2().unit_complex().norm());
       mean.so2().normalize();
     }
 
@@ -34,6 +34,15 @@ class ExponentialFilter {
   /// Resets the output of the exponential filter to zero.
   constexpr void reset() noexcept { output_ = 0.; }
 
+  /// Resets the output of the exponential filter to a given value, e.g. to restore a previous filter state.
+  /**
+   * \param output Exponential filter output to resume filtering from.
+   */
+  constexpr void reset(double output) noexcept { output_ = output; }
+
+  /// Returns the current output of the exponential filter.
+  [[nodiscard]] constexpr double output() const noexcept { return output_; }
+
   /// Updates the exponential filter output given an input.
   /**
    * \param input Next value to be exponentially filtered.
@@ -0,0 +1,208 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ALGORITHM_GAUSS_NEWTON_SCAN_MATCHER_HPP
+#define BELUGA_ALGORITHM_GAUSS_NEWTON_SCAN_MATCHER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <beluga/sensor/data/value_grid.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Dense>
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+/**
+ * \file
+ * \brief Implementation of a Gauss-Newton scan matcher for local pose refinement over likelihood fields.
+ */
+
+namespace beluga {
+
+/// Parameters used to construct a GaussNewtonScanMatcher instance.
+struct GaussNewtonScanMatcherParam {
+  /// Maximum number of Gauss-Newton iterations.
+  std::size_t max_iterations = 5;
+  /// Translational and rotational step size below which iterations stop.
+  double convergence_threshold = 1e-4;
+  /// Maximum distance, in meters, a refined pose may deviate from the initial pose.
+  double max_linear_correction = 0.5;
+  /// Maximum angle, in radians, a refined pose may deviate from the initial pose.
+  double max_angular_correction = 0.5;
+};
+
+/// Gauss-Newton scan matcher for local pose refinement.
+/**
+ * Aligns a 2D scan to a likelihood field by maximizing the sum of the bilinearly interpolated
+ * likelihood at each scan point, starting from an initial pose guess. Each iteration linearizes
+ * the residuals of the scan points against the field gradient and solves the normal equations
+ * for a pose increment. See Kohlbrecher et al. \cite kohlbrecher2011hectorslam for further reference.
+ *
+ * Refinement is conservative: iterations that fail to improve the alignment (even after backtracking) end it,
+ * and so are refined poses that deviate too far from the initial guess.
+ *
+ * Residuals are taken as the deficit of each point likelihood with respect to the maximum likelihood
+ * in the field. Instances borrow a reference to the likelihood field (and thus their lifetime are bound).
+ */
+class GaussNewtonScanMatcher {
+ public:
+  /// Parameter type that the constructor uses to configure the scan matcher.
+  using param_type = GaussNewtonScanMatcherParam;
+  /// Measurement type for the scan matcher: a point cloud in the reference frame of the robot.
+  using measurement_type = std::vector<std::pair<double, double>>;
+
+  /// Constructs a scan matcher instance.
+  /**
+   * \param params Parameters to configure this instance.
+   *  See beluga::GaussNewtonScanMatcherParam for details.
+   * \param likelihood_field Likelihood field to align scans to.
+   * \param origin Likelihood field origin in the world frame.
+   * \param background_likelihood Likelihood to assume for points that fall outside the likelihood field.
+   */
+  GaussNewtonScanMatcher(
+      const param_type& params,
+      const ValueGrid2<float>& likelihood_field,
+      const Sophus::SE2d& origin = Sophus::SE2d{},
+      float background_likelihood = 0.0F)
+      : params_{params},
+        likelihood_field_{likelihood_field},
+        origin_{origin},
+        background_likelihood_{static_cast<double>(background_likelihood)},
+        max_likelihood_{make_max_likelihood(likelihood_field, background_likelihood)} {}
+
+  /// Returns the likelihood field this instance aligns scans to.
+  [[nodiscard]] const ValueGrid2<float>& likelihood_field() const { return likelihood_field_; }
+
+  /// Computes the alignment score of a given pose, ie. the sum of interpolated likelihoods at each scan point.
+  /**
+   * \param points 2D scan points in the reference frame of the robot.
+   * \param pose Robot pose in the world frame.
+   */
+  [[nodiscard]] double score(const measurement_type& points, const Sophus::SE2d& pose) const {
+    const auto transform = origin_.inverse() * pose;
+    double result = 0.0;
+    for (const auto& [px, py] : points) {
+      result += interpolate(transform * Eigen::Vector2d{px, py}).first;
+    }
+    return result;
+  }
+
+  /// Refines a pose so as to best align a scan to the likelihood field.
+  /**
+   * \param points 2D scan points in the reference frame of the robot.
+   * \param initial_pose Initial robot pose guess in the world frame.
+   * \return Refined robot pose in the world frame, or the initial pose if it could not be improved.
+   */
+  [[nodiscard]] Sophus::SE2d refine(const measurement_type& points, const Sophus::SE2d& initial_pose) const {
+    if (points.empty()) {
+      return initial_pose;
+    }
+
+    // Optimize over pose parameters (x, y, theta) in the likelihood field frame.
+    const auto initial_transform = origin_.inverse() * initial_pose;
+    Eigen::Vector3d parameters{
+        initial_transform.translation().x(), initial_transform.translation().y(), initial_transform.so2().log()};
+    double best_score = score_at(points, parameters);
+    const Eigen::Vector3d initial_parameters = parameters;
+
+    for (std::size_t iteration = 0; iteration < params_.max_iterations; ++iteration) {
+      const auto rotation = Sophus::SO2d{parameters.z()};
+      const Eigen::Vector2d translation = parameters.head<2>();
+
+      // Residuals are the likelihood deficits, so their Jacobians are the negated field gradients
+      // chained with the derivative of the transformed point with respect to the pose parameters.
+      Eigen::Matrix3d hessian = Eigen::Matrix3d::Zero();
+      Eigen::Vector3d gradient = Eigen::Vector3d::Zero();
+      for (const auto& [px, py] : points) {
+        const Eigen::Vector2d rotated = rotation * Eigen::Vector2d{px, py};
+        const auto [value, field_gradient] = interpolate(rotated + translation);
+        const Eigen::Vector3d jacobian{
+            field_gradient.x(), field_gradient.y(),
+            field_gradient.y() * rotated.x() - field_gradient.x() * rotated.y()};
+        hessian += jacobian * jacobian.transpose();
+        gradient += jacobian * (max_likelihood_ - value);
+      }
+
+      const auto decomposition = hessian.ldlt();
+      if (decomposition.info() != Eigen::Success || !decomposition.isPositive()) {
+        break;
+      }
+      Eigen::Vector3d step = decomposition.solve(gradient);
+      if (!step.allFinite()) {
+        break;
+      }
+
+      // Gauss-Newton steps may overshoot away from the optimum, so backtrack until the alignment improves.
+      double candidate_score = score_at(points, parameters + step);
+      for (std::size_t halving = 0; candidate_score <= best_score && halving < kMaxStepHalvings; ++halving) {
+        step *= 0.5;
+        candidate_score = score_at(points, parameters + step);
+      }
+      if (candidate_score <= best_score) {
+        break;
+      }
+
+      parameters += step;
+      best_score = candidate_score;
+      if (step.head<2>().norm() < params_.convergence_threshold &&
+          std::abs(step.z()) < params_.convergence_threshold) {
+        break;
+      }
+    }
+
+    const Eigen::Vector3d correction = parameters - initial_parameters;
+    if (correction.head<2>().norm() > params_.max_linear_correction ||
+        std::abs(Sophus::SO2d{correction.z()}.log()) > params_.max_angular_correction) {
+      return initial_pose;
+    }
+    return origin_ * Sophus::SE2d{Sophus::SO2d{parameters.z()}, parameters.head<2>()};
+  }
+
+ private:
+  static constexpr std::size_t kMaxStepHalvings = 4;
+
+  param_type params_;
+  const ValueGrid2<float>& likelihood_field_;
+  Sophus::SE2d origin_;
+  double background_likelihood_;
+  double max_likelihood_;
+
+  static double make_max_likelihood(const ValueGrid2<float>& likelihood_field, float background_likelihood) {
+    const auto& data = likelihood_field.data();
+    const auto it = std::max_element(data.begin(), data.end());
+    return static_cast<double>(it != data.end() ? std::max(*it, background_likelihood) : background_likelihood);
+  }
+
+  [[nodiscard]] double score_at(const measurement_type& points, const Eigen::Vector3d& parameters) const {
+    const auto transform = Sophus::SE2d{Sophus::SO2d{parameters.z()}, parameters.head<2>()};
+    double result = 0.0;
+    for (const auto& [px, py] : points) {
+      result += interpolate(transform * Eigen::Vector2d{px, py}).first;
+    }
+    return result;
+  }
+
+  [[nodiscard]] std::pair<double, Eigen::Vector2d> interpolate(const Eigen::Vector2d& point) const {
+    return likelihood_field_.interpolate_near(point, background_likelihood_);
+  }
+};
+
+}  // namespace beluga
+
+#endif
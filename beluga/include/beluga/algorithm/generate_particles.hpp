@@ -0,0 +1,128 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ALGORITHM_GENERATE_PARTICLES_HPP
+#define BELUGA_ALGORITHM_GENERATE_PARTICLES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <beluga/containers/tuple_vector.hpp>
+#include <beluga/type_traits/particle_traits.hpp>
+#include <beluga/views/particles.hpp>
+
+#include <range/v3/range/access.hpp>
+#include <range/v3/view/common.hpp>
+
+/**
+ * \file
+ * \brief Implementation of a bulk particle generation algorithm.
+ */
+
+namespace beluga {
+
+namespace detail {
+
+/// Number of particles generated per chunk, each with its own random number generator.
+inline constexpr std::size_t kParticleGenerationChunkSize = 4096;
+
+/// Type trait that checks if a distribution supports bulk generation into an iterator range.
+template <class Distribution, class Iterator, class Generator, class = void>
+struct has_bulk_generation : std::false_type {};
+
+/// `has_bulk_generation` specialization for distributions that support bulk generation.
+template <class Distribution, class Iterator, class Generator>
+struct has_bulk_generation<
+    Distribution,
+    Iterator,
+    Generator,
+    std::void_t<decltype(std::declval<const Distribution&>().generate(
+        std::declval<Iterator>(),
+        std::declval<Iterator>(),
+        std::declval<Generator&>()))>> : std::true_type {};
+
+}  // namespace detail
+
+/// Generates a set of particles with states sampled from a distribution.
+/**
+ * Particle buffers are allocated once and filled in place, in fixed size chunks that may be processed
+ * in parallel. Each chunk gets its own random number generator, seeded from `seed` and the chunk index,
+ * so results only depend on the seed (and not on the execution policy). Distributions that provide
+ * a `generate(first, last, generator) const` member function get to fill whole chunks at once (see
+ * beluga::MultivariateNormalDistribution and beluga::MultivariateUniformDistribution), other distributions
+ * are copied once per chunk and called once per particle.
+ *
+ * All particles are assigned unit weights.
+ *
+ * \tparam Particle The particle type.
+ * \tparam Generator The random number generator type that must meet the requirements of
+ * [RandomNumberEngine](https://en.cppreference.com/w/cpp/named_req/RandomNumberEngine).
+ * \tparam ExecutionPolicy An [execution policy](https://en.cppreference.com/w/cpp/algorithm/execution_policy_tag_t).
+ * \tparam Distribution A random state distribution. Must satisfy \ref RandomStateDistributionPage.
+ * \param policy The execution policy to use.
+ * \param distribution The distribution to sample particle states from.
+ * \param count The number of particles to generate.
+ * \param seed The seed to derive random number generator seeds from.
+ * \return A container with the generated particles.
+ */
+template <
+    class Particle,
+    class Generator = std::mt19937,
+    class ExecutionPolicy,
+    class Distribution,
+    std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+auto generate_particles(
+    ExecutionPolicy&& policy,
+    const Distribution& distribution,
+    std::size_t count,
+    typename Generator::result_type seed = std::random_device{}()) -> beluga::TupleVector<Particle> {
+  using weight_type = beluga::weight_t<Particle>;
+
+  auto particles = beluga::TupleVector<Particle>(count);
+  auto states = particles | beluga::views::states | ranges::views::common;
+  auto weights = particles | beluga::views::weights | ranges::views::common;
+  std::fill(std::begin(weights), std::end(weights), weight_type{1.0});
+
+  const auto begin = std::begin(states);
+  constexpr bool kBulkGeneration =
+      detail::has_bulk_generation<Distribution, std::decay_t<decltype(begin)>, Generator>::value;
+
+  const auto chunk_size = detail::kParticleGenerationChunkSize;
+  auto chunks = std::vector<std::size_t>((count + chunk_size - 1) / chunk_size);
+  std::iota(chunks.begin(), chunks.end(), std::size_t{0});
+  std::for_each(policy, chunks.begin(), chunks.end(), [&](std::size_t chunk) {
+    auto sequence = std::seed_seq{seed, static_cast<typename Generator::result_type>(chunk)};
+    auto generator = Generator{sequence};
+    const auto first = begin + static_cast<std::ptrdiff_t>(chunk * chunk_size);
+    const auto last = begin + static_cast<std::ptrdiff_t>(std::min(count, (chunk + 1) * chunk_size));
+    if constexpr (kBulkGeneration) {
+      distribution.generate(first, last, generator);
+    } else {
+      auto chunk_distribution = distribution;
+      std::generate(first, last, [&]() { return chunk_distribution(generator); });
+    }
+  });
+
+  return particles;
+}
+
+}  // namespace beluga
+
+#endif
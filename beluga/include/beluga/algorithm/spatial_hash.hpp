@@ -154,10 +154,11 @@ class spatial_hash<Tuple<Types...>, std::enable_if_t<(std::is_arithmetic_v<Types
 };
 
 /**
- * Specialization for Sophus::SE2d. Will calculate the spatial hash based on the translation and rotation.
+ * Specialization for Sophus::SE2 in single or double precision. Will calculate the spatial hash based on the
+ * translation and rotation.
  */
-template <>
-class spatial_hash<Sophus::SE2d, void> {
+template <class Scalar>
+class spatial_hash<Sophus::SE2<Scalar>, std::enable_if_t<std::is_floating_point_v<Scalar>, void>> {
  public:
   /// Constructs a spatial hasher given per-coordinate resolutions.
   /**
@@ -187,9 +188,10 @@ class spatial_hash<Sophus::SE2d, void> {
    * \param state The state to be hashed.
    * \return The calculated hash.
    */
-  std::size_t operator()(const Sophus::SE2d& state) const {
+  std::size_t operator()(const Sophus::SE2<Scalar>& state) const {
     const auto& position = state.translation();
-    return underlying_hasher_(std::make_tuple(position.x(), position.y(), state.so2().log()));
+    return underlying_hasher_(std::make_tuple(
+        static_cast<double>(position.x()), static_cast<double>(position.y()), static_cast<double>(state.so2().log())));
   }
 
  private:
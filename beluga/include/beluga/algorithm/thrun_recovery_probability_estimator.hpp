@@ -58,6 +58,22 @@ class ThrunRecoveryProbabilityEstimator {
     fast_filter_.reset();
   }
 
+  /// Reset the internal state of the estimator to given averages, e.g. to restore a previous estimator state.
+  /**
+   * \param slow_average Long-term average of the total weight of the particles.
+   * \param fast_average Short-term average of the total weight of the particles.
+   */
+  constexpr void reset(double slow_average, double fast_average) noexcept {
+    slow_filter_.reset(slow_average);
+    fast_filter_.reset(fast_average);
+  }
+
+  /// Returns the long-term average of the total weight of the particles.
+  [[nodiscard]] constexpr double slow_average() const noexcept { return slow_filter_.output(); }
+
+  /// Returns the short-term average of the total weight of the particles.
+  [[nodiscard]] constexpr double fast_average() const noexcept { return fast_filter_.output(); }
+
   /// Update the estimation based on a particle range.
   /**
    * \param range A range containing particles.
@@ -16,6 +16,7 @@
 #define BELUGA_CONTAINERS_HPP
 
 #include <beluga/containers/circular_array.hpp>
+#include <beluga/containers/default_init_allocator.hpp>
 #include <beluga/containers/tuple_vector.hpp>
 
 /**
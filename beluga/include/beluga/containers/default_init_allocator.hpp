@@ -0,0 +1,70 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_CONTAINERS_DEFAULT_INIT_ALLOCATOR_HPP
+#define BELUGA_CONTAINERS_DEFAULT_INIT_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * \file
+ * \brief Implementation of an allocator adaptor that default initializes elements.
+ */
+
+namespace beluga {
+
+/// Allocator adaptor that default initializes elements instead of value initializing them.
+/**
+ * Standard containers value initialize elements when resized, which zero-fills trivial types
+ * (e.g. weights) right before they get overwritten. With this adaptor, elements constructed
+ * without arguments are default initialized instead, and thus left uninitialized if trivial.
+ * Any other construction is forwarded to the underlying allocator.
+ *
+ * \tparam T Allocated element type.
+ * \tparam Allocator Underlying allocator type.
+ */
+template <class T, class Allocator = std::allocator<T>>
+class DefaultInitAllocator : public Allocator {
+  using traits = std::allocator_traits<Allocator>;
+
+ public:
+  /// Rebinds this allocator adaptor to another element type.
+  template <class U>
+  struct rebind {
+    /// Rebound allocator adaptor type.
+    using other = DefaultInitAllocator<U, typename traits::template rebind_alloc<U>>;
+  };
+
+  /// Inherited constructors.
+  using Allocator::Allocator;
+
+  /// Default initializes an object of type `U` in allocated uninitialized storage.
+  template <class U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void*>(ptr)) U;
+  }
+
+  /// Constructs an object of type `U` in allocated uninitialized storage using the underlying allocator.
+  template <class U, class... Args>
+  void construct(U* ptr, Args&&... args) {
+    traits::construct(static_cast<Allocator&>(*this), ptr, std::forward<Args>(args)...);
+  }
+};
+
+}  // namespace beluga
+
+#endif
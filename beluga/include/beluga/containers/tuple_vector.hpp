@@ -15,7 +15,10 @@
 #ifndef BELUGA_CONTAINERS_TUPLE_VECTOR_HPP
 #define BELUGA_CONTAINERS_TUPLE_VECTOR_HPP
 
+#include <algorithm>
+#include <memory>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <beluga/type_traits.hpp>
@@ -23,7 +26,6 @@
 #include <range/v3/algorithm/copy.hpp>
 #include <range/v3/iterator/insert_iterators.hpp>
 #include <range/v3/view/const.hpp>
-#include <range/v3/view/take.hpp>
 
 /**
  * \file
@@ -113,29 +115,16 @@ class TupleContainer<InternalContainer, std::tuple<Types...>> {
       resize(ranges::size(range));
       ranges::copy(range, begin());
     } else {
-      // Optimization to copy as much as we can before we start back inserting.
-      // Back insertion time is severely punished by having multiple containers.
-      //
-      // There are two bad cases for this implementation:
-      // - The capacity is too large compared to the size of the input range, so
-      //   we allocate and default construct unnecessarily.
-      // - The capacity is too low compared to the size of the input range, so
-      //   there will be a lot of back inserting.
-      //
-      // If common guidelines of calling reserve with the expected size are followed,
-      // then this is quite fast, even when we don't know the exact size of the range
-      // in advance.
-      resize(capacity());
-      // Copy elements until we reach current capacity.
-      auto limited_range = range | ranges::views::take(size());
-      auto [last_in, last_out] = ranges::copy(limited_range, begin());
-      const auto copied_size = static_cast<size_type>(ranges::distance(begin(), last_out));
-      if (size() == copied_size) {
-        // Back insert the remaining elements if any.
-        ranges::copy(last_in.base(), last, ranges::back_inserter(*this));
-      } else {
-        // Remove extra elements by resizing to the correct size.
-        resize(copied_size);
+      // Back insertion is punished by having multiple containers, each checking and growing its own
+      // capacity independently, so grow all of them in lockstep instead. Elements are constructed in
+      // place from the input range, no default construction is involved. If common guidelines of
+      // calling reserve with the expected size are followed, no reallocation takes place at all.
+      clear();
+      for (; first != last; ++first) {
+        if (size() == capacity()) {
+          reserve(std::max(2 * capacity(), kMinimumGrowth));
+        }
+        push_back_impl(*first, std::make_index_sequence<sizeof...(Types)>());
       }
     }
   }
@@ -195,11 +184,14 @@ class TupleContainer<InternalContainer, std::tuple<Types...>> {
   [[nodiscard]] constexpr auto end() { return all().end(); }
 
  private:
+  static constexpr size_type kMinimumGrowth = 16;
+
   std::tuple<InternalContainer<Types>...> sequences_;
 
   template <typename T, std::size_t... Ids>
-  constexpr void push_back_impl(T value, std::index_sequence<Ids...>) {
-    (std::get<Ids>(sequences_).push_back(std::get<Ids>(value)), ...);
+  constexpr void push_back_impl(T&& value, std::index_sequence<Ids...>) {
+    // Each element is only forwarded once, so moving from different elements of the same tuple is fine.
+    (std::get<Ids>(sequences_).push_back(std::get<Ids>(std::forward<T>(value))), ...);
   }
 
   [[nodiscard]] constexpr auto all() const {
@@ -215,14 +207,30 @@ class TupleContainer<InternalContainer, std::tuple<Types...>> {
 template <class T>
 using Vector = std::vector<T, std::allocator<T>>;
 
-/// Shorthand for a tuple of vectors with the default allocator.
+namespace detail {
+
+/// Vector alias template with an allocator rebound to each element type.
+template <class Allocator>
+struct rebound_vector {
+  /// Vector of `T` with the allocator rebound to `T`.
+  template <class T>
+  using type = std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+};
+
+}  // namespace detail
+
+/// Shorthand for a tuple of vectors.
 /**
  * This is needed so we can define deduction guides for this type.
+ *
+ * \tparam T Tuple of element types.
+ * \tparam Allocator Allocator type, rebound to each element type for each vector.
+ * See beluga::DefaultInitAllocator for an allocator adaptor that avoids zero-filling vectors on resize.
  */
-template <class T>
-class TupleVector : public TupleContainer<Vector, T> {
+template <class T, class Allocator = std::allocator<T>>
+class TupleVector : public TupleContainer<detail::rebound_vector<Allocator>::template type, T> {
   /// Inherited constructors.
-  using TupleContainer<Vector, T>::TupleContainer;
+  using TupleContainer<detail::rebound_vector<Allocator>::template type, T>::TupleContainer;
 };
 
 /// Deduction guide to construct from iterators.
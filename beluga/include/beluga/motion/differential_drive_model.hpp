@@ -69,17 +69,19 @@ struct DifferentialDriveModelParam {
 
 /// Sampled odometry model for a differential drive.
 /**
- * Supports 2D and (flattened) 3D state types.
+ * Supports 2D (in single or double precision) and (flattened) 3D state types.
+ * Noise is always computed in double precision.
  * This class satisfies \ref MotionModelPage.
  *
  * See Probabilistic Robotics \cite thrun2005probabilistic Chapter 5.4.2.
  *
- * \tparam StateType Type for particle's state. Either Sophus::SE2d or Sophus::SE3d.
+ * \tparam StateType Type for particle's state. Either Sophus::SE2d, Sophus::SE2f or Sophus::SE3d.
  */
 template <class StateType = Sophus::SE2d>
 class DifferentialDriveModel {
   static_assert(
-      std::is_same_v<StateType, Sophus::SE2d> or std::is_same_v<StateType, Sophus::SE3d>,
+      std::is_same_v<StateType, Sophus::SE2d> or std::is_same_v<StateType, Sophus::SE2f> or
+          std::is_same_v<StateType, Sophus::SE3d>,
       "Differential model only supports SE2 and SE3 state types.");
 
  public:
@@ -110,6 +112,8 @@ class DifferentialDriveModel {
     const auto& [pose, previous_pose] = action;
     if constexpr (std::is_same_v<state_type, Sophus::SE2d>) {
       return sampling_fn_2d(pose, previous_pose);
+    } else if constexpr (std::is_same_v<state_type, Sophus::SE2f>) {
+      return sampling_fn_2f(pose, previous_pose);
     } else {
       return sampling_fn_3d(pose, previous_pose);
     }
@@ -126,6 +130,14 @@ class DifferentialDriveModel {
     return [=](const state_type& state, auto& gen) { return To3d(two_d_sampling_fn(To2d(state), gen)); };
   }
 
+  [[nodiscard]] auto sampling_fn_2f(const Sophus::SE2f& pose, const Sophus::SE2f& previous_pose) const {
+    const auto two_d_sampling_fn = sampling_fn_2d(pose.cast<double>(), previous_pose.cast<double>());
+    return [=](const state_type& state, auto& gen) {
+      // Only the sampled motion is cast, so that states are composed in single precision.
+      return state * two_d_sampling_fn(Sophus::SE2d{}, gen).template cast<float>();
+    };
+  }
+
   [[nodiscard]] auto sampling_fn_2d(const Sophus::SE2d& pose, const Sophus::SE2d& previous_pose) const {
     const auto translation = pose.translation() - previous_pose.translation();
     const double distance = translation.norm();
@@ -176,6 +188,9 @@ class DifferentialDriveModel {
 /// Alias for a 2D differential drive model, for convinience.
 using DifferentialDriveModel2d = DifferentialDriveModel<Sophus::SE2d>;
 
+/// Alias for a single precision 2D differential drive model, for convinience.
+using DifferentialDriveModel2f = DifferentialDriveModel<Sophus::SE2f>;
+
 /// Alias for a 3D differential drive model, for convinience.
 using DifferentialDriveModel3d = DifferentialDriveModel<Sophus::SE3d>;
 
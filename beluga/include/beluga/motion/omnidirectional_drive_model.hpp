@@ -73,14 +73,22 @@ struct OmnidirectionalDriveModelParam {
 
 /// Sampled odometry model for an omnidirectional drive.
 /**
+ * Supports 2D state types in single or double precision. Noise is always computed in double precision.
  * This class satisfies \ref MotionModelPage.
+ *
+ * \tparam StateType Type for particle's state. Either Sophus::SE2d or Sophus::SE2f.
  */
+template <class StateType = Sophus::SE2d>
 class OmnidirectionalDriveModel {
+  static_assert(
+      std::is_same_v<StateType, Sophus::SE2d> or std::is_same_v<StateType, Sophus::SE2f>,
+      "Omnidirectional model only supports SE2 state types.");
+
  public:
   /// Current and previous odometry estimates as motion model control action.
-  using control_type = std::tuple<Sophus::SE2d, Sophus::SE2d>;
+  using control_type = std::tuple<StateType, StateType>;
   /// 2D pose as motion model state (to match that of the particles).
-  using state_type = Sophus::SE2d;
+  using state_type = StateType;
 
   /// Parameter type that the constructor uses to configure the motion model.
   using param_type = OmnidirectionalDriveModelParam;
@@ -100,7 +108,9 @@ class OmnidirectionalDriveModel {
    */
   template <class Control, typename = common_tuple_type_t<Control, control_type>>
   [[nodiscard]] auto operator()(Control&& action) const {
-    const auto& [pose, previous_pose] = action;
+    const auto& [control_pose, control_previous_pose] = action;
+    const Sophus::SE2d pose = control_pose.template cast<double>();
+    const Sophus::SE2d previous_pose = control_previous_pose.template cast<double>();
 
     const auto translation = pose.translation() - previous_pose.translation();
     const double distance = translation.norm();
@@ -140,8 +150,15 @@ class OmnidirectionalDriveModel {
       const auto second_rotation = Sophus::SO2d{distribution(gen, rotation_params)} * first_rotation.inverse();
       const auto translation =
           Eigen::Vector2d{distribution(gen, translation_params), -distribution(gen, strafe_params)};
-      return state * Sophus::SE2d{first_rotation, Eigen::Vector2d{0.0, 0.0}} *
-             Sophus::SE2d{second_rotation, translation};
+      if constexpr (std::is_same_v<state_type, Sophus::SE2d>) {
+        return state * Sophus::SE2d{first_rotation, Eigen::Vector2d{0.0, 0.0}} *
+               Sophus::SE2d{second_rotation, translation};
+      } else {
+        // Only the sampled motion is cast, so that states are composed in single precision.
+        const auto motion =
+            Sophus::SE2d{first_rotation, Eigen::Vector2d{0.0, 0.0}} * Sophus::SE2d{second_rotation, translation};
+        return state * motion.template cast<typename state_type::Scalar>();
+      }
     };
   }
 
@@ -156,6 +173,12 @@ class OmnidirectionalDriveModel {
   }
 };
 
+/// Alias for a 2D omnidirectional drive model, for convinience.
+using OmnidirectionalDriveModel2d = OmnidirectionalDriveModel<Sophus::SE2d>;
+
+/// Alias for a single precision 2D omnidirectional drive model, for convinience.
+using OmnidirectionalDriveModel2f = OmnidirectionalDriveModel<Sophus::SE2f>;
+
 }  // namespace beluga
 
 #endif
@@ -15,6 +15,9 @@
 #ifndef BELUGA_POLICIES_ON_MOTION_HPP
 #define BELUGA_POLICIES_ON_MOTION_HPP
 
+#include <optional>
+#include <utility>
+
 #include <Eigen/src/Geometry/AngleAxis.h>
 #include <beluga/policies/policy.hpp>
 #include <sophus/se2.hpp>
@@ -132,6 +135,12 @@ struct on_motion_policy : public on_motion_policy_base<Pose> {
     return moved;
   }
 
+  /// Returns the latest pose for motion comparison, if any.
+  [[nodiscard]] constexpr const std::optional<Pose>& latest_pose() const { return latest_pose_; }
+
+  /// Sets the latest pose for motion comparison, e.g. to roll back a decision that was not acted upon.
+  constexpr void set_latest_pose(std::optional<Pose> pose) { latest_pose_ = std::move(pose); }
+
  private:
   std::optional<Pose> latest_pose_;  ///< The latest pose for motion comparison.
 };
@@ -116,7 +116,7 @@ struct policy : public policy_base, public PolicyFn {
    * takes any amount of arguments so it can be composed with any other policy.
    */
   template <class... Args>
-  constexpr auto operator()(Args...) ->  //
+  constexpr auto operator()(const Args&...) ->  //
       std::enable_if_t<                  //
           std::is_invocable_r_v<bool, PolicyFn> && !std::is_invocable_r_v<bool, PolicyFn, Args...>,
           bool> {
@@ -58,6 +58,13 @@ using Weight = Numeric<double, struct WeightTag>;
 /// Cluster type, as a strongly typed `std::size_t`.
 using Cluster = Numeric<std::size_t, struct ClusterTag>;
 
+/// Multiplicity type, as a strongly typed `std::size_t`.
+/**
+ * Number of identical particles a single particle stands for in a compressed particle set
+ * (see beluga::compress()).
+ */
+using Multiplicity = Numeric<std::size_t, struct MultiplicityTag>;
+
 namespace state_detail {
 
 /// \cond state_detail
@@ -68,6 +68,10 @@
  *   would be generated by repeated invocations of x(g1) and y(g2) would be equal as long as g1 == g2
  * - x != y returns !(x == y)
  *
+ * Optionally, given first and last, forward iterators to values assignable from T, x.generate(first, last, g)
+ * assigns random objects according to the distribution to the range [first, last) in bulk, without modifying
+ * the internal state of the distribution. beluga::generate_particles() makes use of it when available.
+ *
  * \section RandomStateDistributionLinks See also
  * - beluga::MultivariateNormalDistribution
  */
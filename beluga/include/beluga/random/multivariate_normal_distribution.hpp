@@ -15,11 +15,15 @@
 #ifndef BELUGA_RANDOM_MULTIVARIATE_NORMAL_DISTRIBUTION_HPP
 #define BELUGA_RANDOM_MULTIVARIATE_NORMAL_DISTRIBUTION_HPP
 
+#include <iterator>
 #include <random>
 #include <utility>
 
 #include <beluga/random/multivariate_distribution_traits.hpp>
 
+#include <Eigen/Core>
+#include <sophus/common.hpp>
+
 /**
  * \file
  * \brief Implementation of a multivariate normal distribution.
@@ -27,6 +31,42 @@
 
 namespace beluga {
 
+namespace detail {
+
+/// Draws standard normal samples in bulk.
+/**
+ * Uses the Box-Muller transform, so that all but the uniform samples can be computed
+ * with (vectorizable) array operations.
+ *
+ * \tparam Scalar The scalar type of the samples.
+ * \tparam Generator The generator type that must meet the requirements of
+ * [UniformRandomBitGenerator](https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
+ * \param count Number of samples to draw.
+ * \param generator An uniform random bit generator object.
+ * \return An array of standard normal samples.
+ */
+template <class Scalar, class Generator>
+[[nodiscard]] Eigen::Array<Scalar, Eigen::Dynamic, 1> standard_normal_samples(Eigen::Index count, Generator& generator) {
+  using array_type = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+  const Eigen::Index pair_count = (count + 1) / 2;
+  auto uniform = std::uniform_real_distribution<Scalar>{};
+  array_type u1(pair_count);
+  array_type u2(pair_count);
+  for (Eigen::Index i = 0; i < pair_count; ++i) {
+    u1[i] = uniform(generator);
+    u2[i] = uniform(generator);
+  }
+  // Uniform samples lie in [0, 1), so take their complement before the logarithm.
+  const array_type radius = (Scalar{-2} * (Scalar{1} - u1).log()).sqrt();
+  const array_type angle = Scalar{2} * Sophus::Constants<Scalar>::pi() * u2;
+  array_type samples(2 * pair_count);
+  samples.head(pair_count) = radius * angle.cos();
+  samples.tail(pair_count) = radius * angle.sin();
+  return samples.head(count);
+}
+
+}  // namespace detail
+
 /// Multivariate normal distribution parameter set class.
 template <class Vector, class Matrix>
 class MultivariateNormalDistributionParam {
@@ -101,6 +141,33 @@ class MultivariateNormalDistributionParam {
     }
   }
 
+  /// Generates a batch of random objects from the distribution.
+  /**
+   * Standard normal noise for the whole batch is drawn and transformed at once.
+   *
+   * \tparam Generator The generator type that must meet the requirements of
+   * [UniformRandomBitGenerator](https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
+   * \param count Number of random objects to generate.
+   * \param generator An uniform random bit generator object.
+   * \return A matrix with one generated random object per column (or per row, for row vectors).
+   */
+  template <class Generator>
+  [[nodiscard]] auto batch(Eigen::Index count, Generator& generator) const {
+    const auto size = mean_.size();
+    const auto noise = detail::standard_normal_samples<scalar_type>(size * count, generator);
+    if constexpr (vector_type::ColsAtCompileTime == 1) {
+      using batch_type = Eigen::Matrix<scalar_type, vector_type::RowsAtCompileTime, Eigen::Dynamic>;
+      batch_type samples = transform_ * Eigen::Map<const batch_type>(noise.data(), size, count);
+      samples.colwise() += mean_;
+      return samples;
+    } else {
+      using batch_type = Eigen::Matrix<scalar_type, Eigen::Dynamic, vector_type::ColsAtCompileTime>;
+      batch_type samples = Eigen::Map<const batch_type>(noise.data(), count, size) * transform_;
+      samples.rowwise() += mean_;
+      return samples;
+    }
+  }
+
  private:
   vector_type mean_{vector_type::Zero()};
   matrix_type transform_{make_transform(vector_type::Ones().asDiagonal())};
@@ -262,6 +329,32 @@ class MultivariateNormalDistribution {
     return multivariate_distribution_traits<T>::from_vector(params(distribution_, generator));
   }
 
+  /// Generates random objects from the distribution in bulk.
+  /**
+   * Noise generation and transformation are batched, which is significantly faster than
+   * generating random objects one at a time. The internal state of the distribution is not
+   * used nor modified, so the generated sequence differs from that of successive calls.
+   *
+   * \tparam Iterator A forward iterator type, with values assignable from the result type.
+   * \tparam Generator The generator type that must meet the requirements of
+   * [UniformRandomBitGenerator](https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator).
+   * \param first Iterator to the first element to assign.
+   * \param last Iterator past the last element to assign.
+   * \param generator An uniform random bit generator object.
+   */
+  template <class Iterator, class Generator>
+  void generate(Iterator first, Iterator last, Generator& generator) const {
+    const auto count = static_cast<Eigen::Index>(std::distance(first, last));
+    const auto samples = params_.batch(count, generator);
+    for (Eigen::Index i = 0; first != last; ++first, ++i) {
+      if constexpr (vector_type::ColsAtCompileTime == 1) {
+        *first = multivariate_distribution_traits<T>::from_vector(samples.col(i));
+      } else {
+        *first = multivariate_distribution_traits<T>::from_vector(samples.row(i));
+      }
+    }
+  }
+
   /// Compares this object with other distribution object.
   /**
    * Two distribution objects are equal when parameter values and internal state are the same.
@@ -15,14 +15,23 @@
 #ifndef BELUGA_RANDOM_MULTIVARIATE_UNIFORM_DISTRIBUTION_HPP
 #define BELUGA_RANDOM_MULTIVARIATE_UNIFORM_DISTRIBUTION_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <random>
+#include <stdexcept>
+#include <vector>
 
+#include <sophus/common.hpp>
 #include <sophus/se2.hpp>
 #include <sophus/se3.hpp>
 
 #include <Eigen/Geometry>
 
 #include <beluga/sensor/data/occupancy_grid.hpp>
+#include <beluga/sensor/data/sparse_value_grid.hpp>
 
 /**
  * \file
@@ -31,6 +40,68 @@
 
 namespace beluga {
 
+namespace detail {
+
+/// Computes 2D rotations in bulk, given their angles.
+/**
+ * \param angles Rotation angles, in radians.
+ * \return A matrix with the unit complex number representation of one rotation per column.
+ */
+[[nodiscard]] inline Eigen::Matrix2Xd rotations_from_angles(const Eigen::ArrayXd& angles) {
+  Eigen::Matrix2Xd rotations(2, angles.size());
+  rotations.row(0) = angles.cos().matrix().transpose();
+  rotations.row(1) = angles.sin().matrix().transpose();
+  return rotations;
+}
+
+/// Draws uniformly distributed 2D rotations in bulk.
+/**
+ * \param count Number of rotations to draw.
+ * \param engine The random number generator engine.
+ * \return A matrix with the unit complex number representation of one rotation per column.
+ */
+template <class URNG>
+[[nodiscard]] Eigen::Matrix2Xd uniform_rotations(Eigen::Index count, URNG& engine) {
+  auto distribution =
+      std::uniform_real_distribution<double>{-Sophus::Constants<double>::pi(), Sophus::Constants<double>::pi()};
+  Eigen::ArrayXd angles(count);
+  for (Eigen::Index i = 0; i < count; ++i) {
+    angles[i] = distribution(engine);
+  }
+  return rotations_from_angles(angles);
+}
+
+/// Computes a randomly shifted low-discrepancy sequence of points in the unit hypercube.
+/**
+ * Points follow an additive recurrence (or Kronecker) sequence, with coefficients taken as the inverse
+ * powers of the unique positive root of \f$x^{d+1} = x + 1\f$, which spreads them evenly for any count.
+ * A random shift common to all points makes each point uniformly distributed.
+ *
+ * \tparam Dim Dimension of the unit hypercube, between 1 and 3.
+ * \param count Number of points to compute.
+ * \param engine The random number generator engine.
+ * \return An array with one point per column.
+ */
+template <int Dim, class URNG>
+[[nodiscard]] Eigen::Array<double, Dim, Eigen::Dynamic> low_discrepancy_sequence(Eigen::Index count, URNG& engine) {
+  static_assert(Dim >= 1 && Dim <= 3, "Unsupported low-discrepancy sequence dimension");
+  constexpr std::array<std::array<double, 3>, 3> kCoefficients{{
+      {0.6180339887498949, 0.0, 0.0},
+      {0.7548776662466927, 0.5698402909980532, 0.0},
+      {0.8191725133961645, 0.6710436067037893, 0.5497004779019703},
+  }};
+  auto distribution = std::uniform_real_distribution<double>{};
+  const Eigen::ArrayXd indices = Eigen::ArrayXd::LinSpaced(count, 0.0, static_cast<double>(count - 1));
+  Eigen::Array<double, Dim, Eigen::Dynamic> points(Dim, count);
+  for (int d = 0; d < Dim; ++d) {
+    const Eigen::ArrayXd values = distribution(engine) + indices * kCoefficients[Dim - 1][static_cast<std::size_t>(d)];
+    points.row(d) = (values - values.floor()).transpose();
+  }
+  return points;
+}
+
+}  // namespace detail
+
 /// Primary template for a multivariate uniform distribution.
 /**
  * \tparam T The result type for sampling from the distribution.
@@ -46,9 +117,13 @@ class MultivariateUniformDistribution<Sophus::SE2d, Eigen::AlignedBox2d> {
   /// Constructs a multivariate uniform distribution in SE(2) with 2D bounding region.
   /**
    * \param box The axis-aligned bounding region.
+   * \param stratified Whether to spread poses generated in bulk evenly over the region and rotations,
+   *  following a low-discrepancy sequence, instead of drawing them independently.
    */
-  explicit MultivariateUniformDistribution(const Eigen::AlignedBox2d& box)
-      : x_distribution_{box.min().x(), box.max().x()}, y_distribution_{box.min().y(), box.max().y()} {}
+  explicit MultivariateUniformDistribution(const Eigen::AlignedBox2d& box, bool stratified = false)
+      : x_distribution_{box.min().x(), box.max().x()},
+        y_distribution_{box.min().y(), box.max().y()},
+        stratified_{stratified} {}
 
   /// Generates a random 2D pose within the bounding region.
   /**
@@ -67,15 +142,61 @@ class MultivariateUniformDistribution<Sophus::SE2d, Eigen::AlignedBox2d> {
     };
   }
 
+  /// Generates random 2D poses within the bounding region in bulk.
+  /**
+   * Rotations are computed for all poses at once, with (vectorizable) array operations.
+   * The internal state of the distribution is not used nor modified.
+   *
+   * \tparam Iterator A forward iterator type, with values assignable from Sophus::SE2d.
+   * \tparam URNG The type of the random number generator.
+   * \param first Iterator to the first element to assign.
+   * \param last Iterator past the last element to assign.
+   * \param engine The random number generator engine.
+   */
+  template <class Iterator, class URNG>
+  void generate(Iterator first, Iterator last, URNG& engine) const {
+    const auto count = static_cast<Eigen::Index>(std::distance(first, last));
+    if (stratified_) {
+      const Eigen::Array3Xd points = detail::low_discrepancy_sequence<3>(count, engine);
+      const Eigen::Array2d min{x_distribution_.a(), y_distribution_.a()};
+      const Eigen::Array2d extent = Eigen::Array2d{x_distribution_.b(), y_distribution_.b()} - min;
+      const Eigen::Array2Xd translations = (points.topRows<2>().colwise() * extent).colwise() + min;
+      const auto rotations = detail::rotations_from_angles(
+          (2.0 * points.row(2) - 1.0).transpose() * Sophus::Constants<double>::pi());
+      for (Eigen::Index i = 0; first != last; ++first, ++i) {
+        *first = Sophus::SE2d{
+            Sophus::SO2d{rotations(0, i), rotations(1, i)},
+            Sophus::Vector2d{translations(0, i), translations(1, i)},
+        };
+      }
+      return;
+    }
+
+    auto x_distribution = std::uniform_real_distribution<double>{x_distribution_.param()};
+    auto y_distribution = std::uniform_real_distribution<double>{y_distribution_.param()};
+    const auto rotations = detail::uniform_rotations(count, engine);
+    for (Eigen::Index i = 0; first != last; ++first, ++i) {
+      *first = Sophus::SE2d{
+          Sophus::SO2d{rotations(0, i), rotations(1, i)},
+          Sophus::Vector2d{x_distribution(engine), y_distribution(engine)},
+      };
+    }
+  }
+
  private:
   std::uniform_real_distribution<double> x_distribution_;
   std::uniform_real_distribution<double> y_distribution_;
+  bool stratified_;
 };
 
 /// Deduction guide for bounding regions in SE2 space.
 MultivariateUniformDistribution(const Eigen::AlignedBox2d&)
     -> MultivariateUniformDistribution<Sophus::SE2d, Eigen::AlignedBox2d>;
 
+/// Deduction guide for stratified bounding regions in SE2 space.
+MultivariateUniformDistribution(const Eigen::AlignedBox2d&, bool)
+    -> MultivariateUniformDistribution<Sophus::SE2d, Eigen::AlignedBox2d>;
+
 /// Specialization of multivariate uniform distribution for bounding regions in 3D space.
 template <>
 class MultivariateUniformDistribution<Sophus::SE3d, Eigen::AlignedBox3d> {
@@ -83,11 +204,14 @@ class MultivariateUniformDistribution<Sophus::SE3d, Eigen::AlignedBox3d> {
   /// Constructs a multivariate uniform distribution in SE(3) with 3D bounding region.
   /**
    * \param box The axis-aligned bounding region.
+   * \param stratified Whether to spread translations generated in bulk evenly over the region,
+   *  following a low-discrepancy sequence, instead of drawing them independently.
    */
-  explicit MultivariateUniformDistribution(const Eigen::AlignedBox3d& box)
+  explicit MultivariateUniformDistribution(const Eigen::AlignedBox3d& box, bool stratified = false)
       : x_distribution_{box.min().x(), box.max().x()},
         y_distribution_{box.min().y(), box.max().y()},
-        z_distribution_{box.min().z(), box.max().z()} {}
+        z_distribution_{box.min().z(), box.max().z()},
+        stratified_{stratified} {}
 
   /// Generates a random 3D pose within the bounding region.
   /**
@@ -107,16 +231,55 @@ class MultivariateUniformDistribution<Sophus::SE3d, Eigen::AlignedBox3d> {
     };
   }
 
+  /// Generates random 3D poses within the bounding region in bulk.
+  /**
+   * The internal state of the distribution is not used nor modified.
+   *
+   * \tparam Iterator A forward iterator type, with values assignable from Sophus::SE3d.
+   * \tparam URNG The type of the random number generator.
+   * \param first Iterator to the first element to assign.
+   * \param last Iterator past the last element to assign.
+   * \param engine The random number generator engine.
+   */
+  template <class Iterator, class URNG>
+  void generate(Iterator first, Iterator last, URNG& engine) const {
+    if (stratified_) {
+      const auto count = static_cast<Eigen::Index>(std::distance(first, last));
+      const Eigen::Array3Xd points = detail::low_discrepancy_sequence<3>(count, engine);
+      const Eigen::Array3d min{x_distribution_.a(), y_distribution_.a(), z_distribution_.a()};
+      const Eigen::Array3d extent = Eigen::Array3d{x_distribution_.b(), y_distribution_.b(), z_distribution_.b()} - min;
+      for (Eigen::Index i = 0; first != last; ++first, ++i) {
+        *first = Sophus::SE3d{Sophus::SO3d::sampleUniform(engine), (points.col(i) * extent + min).matrix()};
+      }
+      return;
+    }
+
+    auto x_distribution = std::uniform_real_distribution<double>{x_distribution_.param()};
+    auto y_distribution = std::uniform_real_distribution<double>{y_distribution_.param()};
+    auto z_distribution = std::uniform_real_distribution<double>{z_distribution_.param()};
+    for (; first != last; ++first) {
+      *first = Sophus::SE3d{
+          Sophus::SO3d::sampleUniform(engine),
+          Sophus::Vector3d{x_distribution(engine), y_distribution(engine), z_distribution(engine)},
+      };
+    }
+  }
+
  private:
   std::uniform_real_distribution<double> x_distribution_;
   std::uniform_real_distribution<double> y_distribution_;
   std::uniform_real_distribution<double> z_distribution_;
+  bool stratified_;
 };
 
 /// Deduction guide for bounding regions in SE3 space.
 MultivariateUniformDistribution(const Eigen::AlignedBox3d&)
     -> MultivariateUniformDistribution<Sophus::SE3d, Eigen::AlignedBox3d>;
 
+/// Deduction guide for stratified bounding regions in SE3 space.
+MultivariateUniformDistribution(const Eigen::AlignedBox3d&, bool)
+    -> MultivariateUniformDistribution<Sophus::SE3d, Eigen::AlignedBox3d>;
+
 /// Specialization of multivariate uniform distribution for occupancy grids.
 /**
  * The range of the distribution is limited to the free space available in the occupancy grid.
@@ -130,11 +293,13 @@ class MultivariateUniformDistribution<Sophus::SE2d, OccupancyGrid> {
   /**
    * \tparam OccupancyGrid A type of the occupancy grid.
    * \param grid The occupancy grid from which free states will be computed.
+   * \param stratified Whether to spread poses generated in bulk evenly over free cells and rotations,
+   *  instead of drawing them independently. Free cells are split into as many contiguous strata as poses,
+   *  and each pose is drawn from its own stratum, with rotations following a low-discrepancy sequence.
+   * \throw std::invalid_argument If the grid has no free cells.
    */
-  constexpr explicit MultivariateUniformDistribution(const OccupancyGrid& grid)
-      : free_states_{compute_free_states(grid)}, distribution_{0, free_states_.size() - 1} {
-    assert(!free_states_.empty());
-  }
+  constexpr explicit MultivariateUniformDistribution(const OccupancyGrid& grid, bool stratified = false)
+      : free_states_{compute_free_states(grid)}, distribution_{0, free_states_.size() - 1}, stratified_{stratified} {}
 
   /// Generates a random 2D pose.
   /**
@@ -151,12 +316,53 @@ class MultivariateUniformDistribution<Sophus::SE2d, OccupancyGrid> {
     return {Sophus::SO2d::sampleUniform(engine), free_states_[distribution_(engine)]};
   }
 
+  /// Generates random 2D poses in bulk.
+  /**
+   * Rotations are computed for all poses at once, with (vectorizable) array operations.
+   * The internal state of the distribution is not used nor modified.
+   *
+   * \tparam Iterator A forward iterator type, with values assignable from Sophus::SE2d.
+   * \tparam URNG The type of the random number generator.
+   * \param first Iterator to the first element to assign.
+   * \param last Iterator past the last element to assign.
+   * \param engine The random number generator engine.
+   */
+  template <class Iterator, class URNG>
+  void generate(Iterator first, Iterator last, URNG& engine) const {
+    const auto count = static_cast<Eigen::Index>(std::distance(first, last));
+    if (stratified_) {
+      // Jittered stratification of free cell indices, with one stratum per pose.
+      const auto rotations = detail::rotations_from_angles(
+          (2.0 * detail::low_discrepancy_sequence<1>(count, engine).row(0) - 1.0).transpose() *
+          Sophus::Constants<double>::pi());
+      const double stride = static_cast<double>(free_states_.size()) / static_cast<double>(count);
+      auto jitter = std::uniform_real_distribution<double>{};
+      for (Eigen::Index i = 0; first != last; ++first, ++i) {
+        const auto index = std::min(
+            static_cast<std::size_t>((static_cast<double>(i) + jitter(engine)) * stride), free_states_.size() - 1);
+        *first = Sophus::SE2d{Sophus::SO2d{rotations(0, i), rotations(1, i)}, free_states_[index]};
+      }
+      return;
+    }
+
+    auto distribution = std::uniform_int_distribution<std::size_t>{distribution_.param()};
+    const auto rotations = detail::uniform_rotations(count, engine);
+    for (Eigen::Index i = 0; first != last; ++first, ++i) {
+      *first = Sophus::SE2d{Sophus::SO2d{rotations(0, i), rotations(1, i)}, free_states_[distribution(engine)]};
+    }
+  }
+
  private:
   std::vector<Eigen::Vector2d> free_states_;                 ///< Vector containing free states.
   std::uniform_int_distribution<std::size_t> distribution_;  ///< Uniform distribution for indices.
+  bool stratified_;                                          ///< Whether bulk generation is stratified.
 
   static std::vector<Eigen::Vector2d> compute_free_states(const OccupancyGrid& grid) {
-    return grid.coordinates_for(grid.free_cells(), OccupancyGrid::Frame::kGlobal) | ranges::to<std::vector>;
+    auto states = grid.coordinates_for(grid.free_cells(), OccupancyGrid::Frame::kGlobal) | ranges::to<std::vector>;
+    if (states.empty()) {
+      throw std::invalid_argument("Cannot sample from an occupancy grid without free cells");
+    }
+    return states;
   }
 };
 
@@ -165,6 +371,195 @@ template <class Derived>
 MultivariateUniformDistribution(const BaseOccupancyGrid2<Derived>&)
     -> MultivariateUniformDistribution<Sophus::SE2d, Derived>;
 
+/// Deduction guide for stratified 2D occupancy grids.
+template <class Derived>
+MultivariateUniformDistribution(const BaseOccupancyGrid2<Derived>&, bool)
+    -> MultivariateUniformDistribution<Sophus::SE2d, Derived>;
+
+/// Specialization of multivariate uniform distribution for 2D sparse grids (e.g. NDT maps).
+/**
+ * The range of the distribution is limited to the cells present in the sparse grid, all equally likely.
+ * The rotation is sampled uniformly and the translation is sampled uniformly within one of the cells.
+ */
+template <class MapType>
+class MultivariateUniformDistribution<Sophus::SE2d, SparseValueGrid<MapType, 2>> {
+ public:
+  /// Constructs a multivariate uniform distribution based on the provided sparse grid.
+  /**
+   * \param grid The sparse grid whose cells states will be sampled from.
+   * \throw std::invalid_argument If the grid has no cells.
+   */
+  explicit MultivariateUniformDistribution(const SparseValueGrid<MapType, 2>& grid)
+      : cell_centers_{compute_cell_centers(grid)},
+        cell_distribution_{0, cell_centers_.size() - 1},
+        offset_distribution_{-grid.resolution() / 2.0, grid.resolution() / 2.0} {}
+
+  /// Generates a random 2D pose.
+  /**
+   * \tparam URNG The type of the random number generator.
+   * \param engine The random number generator engine.
+   * \return A random Sophus::SE2d pose.
+   */
+  template <class URNG>
+  [[nodiscard]] Sophus::SE2d operator()(URNG& engine) {
+    const Eigen::Vector2d& center = cell_centers_[cell_distribution_(engine)];
+    const Eigen::Vector2d offset{offset_distribution_(engine), offset_distribution_(engine)};
+    return {Sophus::SO2d::sampleUniform(engine), center + offset};
+  }
+
+  /// Generates random 2D poses in bulk.
+  /**
+   * The internal state of the distribution is not used nor modified.
+   *
+   * \tparam Iterator A forward iterator type, with values assignable from Sophus::SE2d.
+   * \tparam URNG The type of the random number generator.
+   * \param first Iterator to the first element to assign.
+   * \param last Iterator past the last element to assign.
+   * \param engine The random number generator engine.
+   */
+  template <class Iterator, class URNG>
+  void generate(Iterator first, Iterator last, URNG& engine) const {
+    auto cell_distribution = std::uniform_int_distribution<std::size_t>{cell_distribution_.param()};
+    auto offset_distribution = std::uniform_real_distribution<double>{offset_distribution_.param()};
+    const auto rotations = detail::uniform_rotations(static_cast<Eigen::Index>(std::distance(first, last)), engine);
+    for (Eigen::Index i = 0; first != last; ++first, ++i) {
+      const Eigen::Vector2d& center = cell_centers_[cell_distribution(engine)];
+      const Eigen::Vector2d offset{offset_distribution(engine), offset_distribution(engine)};
+      *first = Sophus::SE2d{Sophus::SO2d{rotations(0, i), rotations(1, i)}, center + offset};
+    }
+  }
+
+ private:
+  std::vector<Eigen::Vector2d> cell_centers_;                     ///< Coordinates of each cell center.
+  std::uniform_int_distribution<std::size_t> cell_distribution_;  ///< Uniform distribution for cell indices.
+  std::uniform_real_distribution<double> offset_distribution_;    ///< Uniform distribution for offsets within cells.
+
+  static std::vector<Eigen::Vector2d> compute_cell_centers(const SparseValueGrid<MapType, 2>& grid) {
+    auto centers = std::vector<Eigen::Vector2d>{};
+    centers.reserve(grid.size());
+    for (const auto& [cell, value] : grid.data()) {
+      centers.push_back(grid.coordinates_at(cell));
+    }
+    if (centers.empty()) {
+      throw std::invalid_argument("Cannot sample from a sparse grid without cells");
+    }
+    return centers;
+  }
+};
+
+/// Deduction guide for 2D sparse grids.
+template <class MapType>
+MultivariateUniformDistribution(const SparseValueGrid<MapType, 2>&)
+    -> MultivariateUniformDistribution<Sophus::SE2d, SparseValueGrid<MapType, 2>>;
+
+/// Specialization of multivariate uniform distribution for 3D sparse grids (e.g. NDT maps).
+/**
+ * The range of the distribution is limited to the cells present in the sparse grid within a height band,
+ * all equally likely. For ground robots, this band would span the ground (or floors) in the map.
+ * The translation is sampled uniformly within one of these cells, clamped to the height band, and the
+ * rotation is an upright rotation about the vertical axis with uniformly sampled yaw.
+ */
+template <class MapType>
+class MultivariateUniformDistribution<Sophus::SE3d, SparseValueGrid<MapType, 3>> {
+ public:
+  /// Constructs a multivariate uniform distribution based on the provided sparse grid.
+  /**
+   * \param grid The sparse grid whose cells states will be sampled from.
+   * \param min_height Minimum height of the states to sample, in meters.
+   * \param max_height Maximum height of the states to sample, in meters.
+   * \throw std::invalid_argument If the grid has no cells within the height band.
+   */
+  explicit MultivariateUniformDistribution(
+      const SparseValueGrid<MapType, 3>& grid,
+      double min_height = std::numeric_limits<double>::lowest(),
+      double max_height = std::numeric_limits<double>::max())
+      : cell_centers_{compute_cell_centers(grid, min_height, max_height)},
+        cell_distribution_{0, cell_centers_.size() - 1},
+        offset_distribution_{-grid.resolution() / 2.0, grid.resolution() / 2.0},
+        yaw_distribution_{-Sophus::Constants<double>::pi(), Sophus::Constants<double>::pi()},
+        min_height_{min_height},
+        max_height_{max_height} {}
+
+  /// Generates a random 3D pose.
+  /**
+   * \tparam URNG The type of the random number generator.
+   * \param engine The random number generator engine.
+   * \return A random Sophus::SE3d pose.
+   */
+  template <class URNG>
+  [[nodiscard]] Sophus::SE3d operator()(URNG& engine) {
+    return sample(cell_distribution_, offset_distribution_, yaw_distribution_, engine);
+  }
+
+  /// Generates random 3D poses in bulk.
+  /**
+   * The internal state of the distribution is not used nor modified.
+   *
+   * \tparam Iterator A forward iterator type, with values assignable from Sophus::SE3d.
+   * \tparam URNG The type of the random number generator.
+   * \param first Iterator to the first element to assign.
+   * \param last Iterator past the last element to assign.
+   * \param engine The random number generator engine.
+   */
+  template <class Iterator, class URNG>
+  void generate(Iterator first, Iterator last, URNG& engine) const {
+    auto cell_distribution = std::uniform_int_distribution<std::size_t>{cell_distribution_.param()};
+    auto offset_distribution = std::uniform_real_distribution<double>{offset_distribution_.param()};
+    auto yaw_distribution = std::uniform_real_distribution<double>{yaw_distribution_.param()};
+    for (; first != last; ++first) {
+      *first = sample(cell_distribution, offset_distribution, yaw_distribution, engine);
+    }
+  }
+
+ private:
+  std::vector<Eigen::Vector3d> cell_centers_;                     ///< Coordinates of each cell center.
+  std::uniform_int_distribution<std::size_t> cell_distribution_;  ///< Uniform distribution for cell indices.
+  std::uniform_real_distribution<double> offset_distribution_;    ///< Uniform distribution for offsets within cells.
+  std::uniform_real_distribution<double> yaw_distribution_;       ///< Uniform distribution for yaw angles.
+  double min_height_;                                             ///< Minimum height of sampled states.
+  double max_height_;                                             ///< Maximum height of sampled states.
+
+  template <class URNG>
+  [[nodiscard]] Sophus::SE3d sample(
+      std::uniform_int_distribution<std::size_t>& cell_distribution,
+      std::uniform_real_distribution<double>& offset_distribution,
+      std::uniform_real_distribution<double>& yaw_distribution,
+      URNG& engine) const {
+    Eigen::Vector3d translation = cell_centers_[cell_distribution(engine)];
+    translation.x() += offset_distribution(engine);
+    translation.y() += offset_distribution(engine);
+    translation.z() = std::clamp(translation.z() + offset_distribution(engine), min_height_, max_height_);
+    return Sophus::SE3d{Sophus::SO3d::rotZ(yaw_distribution(engine)), translation};
+  }
+
+  static std::vector<Eigen::Vector3d>
+  compute_cell_centers(const SparseValueGrid<MapType, 3>& grid, double min_height, double max_height) {
+    // Keep cells that overlap the height band.
+    const double half_resolution = grid.resolution() / 2.0;
+    auto centers = std::vector<Eigen::Vector3d>{};
+    for (const auto& [cell, value] : grid.data()) {
+      const Eigen::Vector3d center = grid.coordinates_at(cell);
+      if (center.z() + half_resolution >= min_height && center.z() - half_resolution <= max_height) {
+        centers.push_back(center);
+      }
+    }
+    if (centers.empty()) {
+      throw std::invalid_argument("Cannot sample from a sparse grid without cells within the height band");
+    }
+    return centers;
+  }
+};
+
+/// Deduction guide for 3D sparse grids.
+template <class MapType>
+MultivariateUniformDistribution(const SparseValueGrid<MapType, 3>&)
+    -> MultivariateUniformDistribution<Sophus::SE3d, SparseValueGrid<MapType, 3>>;
+
+/// Deduction guide for 3D sparse grids with a height band.
+template <class MapType>
+MultivariateUniformDistribution(const SparseValueGrid<MapType, 3>&, double, double)
+    -> MultivariateUniformDistribution<Sophus::SE3d, SparseValueGrid<MapType, 3>>;
+
 }  // namespace beluga
 
 #endif
@@ -61,6 +61,7 @@
 
 #include <beluga/sensor/beam_model.hpp>
 #include <beluga/sensor/bearing_sensor_model.hpp>
+#include <beluga/sensor/bounded_weighting_function.hpp>
 #include <beluga/sensor/landmark_sensor_model.hpp>
 #include <beluga/sensor/likelihood_field_model.hpp>
 #include <beluga/sensor/ndt_sensor_model.hpp>
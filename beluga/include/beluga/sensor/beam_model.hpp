@@ -17,10 +17,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
 #include <random>
 #include <vector>
 
 #include <beluga/algorithm/raycasting.hpp>
+#include <beluga/sensor/bounded_weighting_function.hpp>
 
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/all.hpp>
@@ -54,6 +58,13 @@ struct BeamModelParam {
   double lambda_short{0.1};
   /// Maximum beam range. This is the expected value in case of a miss.
   double beam_max_range{60};
+  /// Ratio to the best weight so far below which particles may stop being weighted early.
+  /**
+   * Only used for bounded weighting, see beluga::actions::reweight_bounded. Zero disables bounded weighting.
+   */
+  double early_termination_ratio{0.0};
+  /// Number of beams evaluated between checks for early termination.
+  std::size_t early_termination_block_size{kDefaultEarlyTerminationBlockSize};
 };
 
 /// Beam sensor model for range finders.
@@ -94,6 +105,9 @@ class BeamSensorModel {
    */
   explicit BeamSensorModel(const param_type& params, OccupancyGrid grid) : params_{params}, grid_{std::move(grid)} {}
 
+  /// Returns the parameters this instance was configured with.
+  [[nodiscard]] const param_type& params() const { return params_; }
+
   /// Returns a state weighting function conditioned on 2D lidar hits.
   /**
    * \param points 2D lidar hit points in the reference frame of particle states.
@@ -102,52 +116,48 @@ class BeamSensorModel {
    */
   [[nodiscard]] auto operator()(measurement_type&& points) const {
     return [this, points = std::move(points)](const state_type& state) -> weight_type {
-      const auto beam = Ray2d{grid_, state, params_.beam_max_range};
-      const double n = 1. / (std::sqrt(2. * M_PI) * params_.sigma_hit);
-      return std::transform_reduce(
-          points.cbegin(), points.cend(), 0.0, std::plus{}, [this, &beam, n](const auto& point) {
-            // TODO(Ramiro): We're converting from range + bearing to cartesian points in the ROS node, but we want
-            // range
-            // + bearing here. We might want to make that conversion in the likelihood model instead, and let the
-            // measurement type be range, bearing instead of x, y.
-
-            // Compute the range according to the measurement.
-            const double z = std::sqrt(point.first * point.first + point.second * point.second);
-
-            // dirty hack to prevent SO2d from calculating the hypot again to normalize the vector.
-            auto beam_bearing = Sophus::SO2d{};
-            beam_bearing.data()[0] = point.first / z;
-            beam_bearing.data()[1] = point.second / z;
-
-            // Compute range according to the map (raycasting).
-            const double z_mean = beam.cast(beam_bearing).value_or(params_.beam_max_range);
-            // 1: Correct range with local measurement noise.
-            const double eta_hit =
-                2. / (std::erf((params_.beam_max_range - z_mean) / (std::sqrt(2.) * params_.sigma_hit)) -
-                      std::erf(-z_mean / (std::sqrt(2.) * params_.sigma_hit)));
-            const double d = (z - z_mean) / params_.sigma_hit;
-            double pz = params_.z_hit * eta_hit * n * std::exp(-(d * d) / 2.);
-
-            // 2: Unexpected objects.
-            if (z < z_mean) {
-              const double eta_short = 1. / (1. - std::exp(-params_.lambda_short * z_mean));
-              pz += params_.z_short * params_.lambda_short * eta_short * std::exp(-params_.lambda_short * z);
-            }
-
-            // 3 and 4: Max range return or random return.
-            if (z < params_.beam_max_range) {
-              pz += params_.z_rand / params_.beam_max_range;
-            } else {
-              pz += params_.z_max;
-            }
-
-            // TODO(glpuga): Investigate why AMCL and QuickMCL both use this formula for the weight.
-            // See https://github.com/Ekumen-OS/beluga/issues/153
-            return pz * pz * pz;
-          });
+      return std::transform_reduce(points.cbegin(), points.cend(), 0.0, std::plus{}, make_point_likelihood(state));
     };
   }
 
+  /// Returns a bounded state weighting function conditioned on 2D lidar hits.
+  /**
+   * The returned function computes the same weights as the one returned by the call operator,
+   * but it can stop raycasting beams early for states that cannot exceed a given weight.
+   * Beams are evaluated in a random order, in blocks of `early_termination_block_size` beams.
+   *
+   * \param points 2D lidar hit points in the reference frame of particle states.
+   * \param engine Random number generator to shuffle points with.
+   * \return a beluga::BoundedWeightingFunction instance borrowing a reference to this sensor model
+   *  (and thus their lifetime are bound).
+   */
+  template <class URNG>
+  [[nodiscard]] auto bounded(measurement_type&& points, URNG& engine) const {
+    std::shuffle(points.begin(), points.end(), engine);
+    auto point_bounds = std::vector<double>{};
+    point_bounds.reserve(points.size());
+    std::transform(points.cbegin(), points.cend(), std::back_inserter(point_bounds), [this](const auto& point) {
+      return point_likelihood_bound(point);
+    });
+    auto make_indexed_point_likelihood = [this, points = std::move(points)](const state_type& state) {
+      return [&points, point_likelihood = make_point_likelihood(state)](std::size_t index) {
+        return point_likelihood(points[index]);
+      };
+    };
+    return BoundedWeightingFunction<state_type, decltype(make_indexed_point_likelihood)>{
+        0.0, point_bounds, std::move(make_indexed_point_likelihood), params_.early_termination_block_size};
+  }
+
+  /// Returns a bounded state weighting function conditioned on 2D lidar hits.
+  /**
+   * Same as the overload above, except that points are shuffled with a default seeded generator
+   * (and thus always into the same order for measurements of the same size).
+   */
+  [[nodiscard]] auto bounded(measurement_type&& points) const {
+    auto engine = std::mt19937{};
+    return bounded(std::move(points), engine);
+  }
+
   /// Update the sensor model with a new occupancy grid map.
   /**
    * \param map New occupancy grid representing the static map.
@@ -157,6 +167,68 @@ class BeamSensorModel {
  private:
   param_type params_;
   OccupancyGrid grid_;
+
+  [[nodiscard]] auto make_point_likelihood(const state_type& state) const {
+    const double n = 1. / (std::sqrt(2. * M_PI) * params_.sigma_hit);
+    return [this, n, beam = Ray2d{grid_, state, params_.beam_max_range}](const auto& point) {
+      // TODO(Ramiro): We're converting from range + bearing to cartesian points in the ROS node, but we want
+      // range
+      // + bearing here. We might want to make that conversion in the likelihood model instead, and let the
+      // measurement type be range, bearing instead of x, y.
+
+      // Compute the range according to the measurement.
+      const double z = std::sqrt(point.first * point.first + point.second * point.second);
+
+      // dirty hack to prevent SO2d from calculating the hypot again to normalize the vector.
+      auto beam_bearing = Sophus::SO2d{};
+      beam_bearing.data()[0] = point.first / z;
+      beam_bearing.data()[1] = point.second / z;
+
+      // Compute range according to the map (raycasting).
+      const double z_mean = beam.cast(beam_bearing).value_or(params_.beam_max_range);
+      // 1: Correct range with local measurement noise.
+      const double eta_hit =
+          2. / (std::erf((params_.beam_max_range - z_mean) / (std::sqrt(2.) * params_.sigma_hit)) -
+                std::erf(-z_mean / (std::sqrt(2.) * params_.sigma_hit)));
+      const double d = (z - z_mean) / params_.sigma_hit;
+      double pz = params_.z_hit * eta_hit * n * std::exp(-(d * d) / 2.);
+
+      // 2: Unexpected objects.
+      if (z < z_mean) {
+        const double eta_short = 1. / (1. - std::exp(-params_.lambda_short * z_mean));
+        pz += params_.z_short * params_.lambda_short * eta_short * std::exp(-params_.lambda_short * z);
+      }
+
+      // 3 and 4: Max range return or random return.
+      if (z < params_.beam_max_range) {
+        pz += params_.z_rand / params_.beam_max_range;
+      } else {
+        pz += params_.z_max;
+      }
+
+      // TODO(glpuga): Investigate why AMCL and QuickMCL both use this formula for the weight.
+      // See https://github.com/Ekumen-OS/beluga/issues/153
+      return pz * pz * pz;
+    };
+  }
+
+  [[nodiscard]] double point_likelihood_bound(const std::pair<double, double>& point) const {
+    const double n = 1. / (std::sqrt(2. * M_PI) * params_.sigma_hit);
+    const double z = std::sqrt(point.first * point.first + point.second * point.second);
+
+    // 1: Hit normalizers are largest for expected ranges at either end of the beam.
+    const double eta_hit_bound = 2. / std::erf(params_.beam_max_range / (std::sqrt(2.) * params_.sigma_hit));
+    double pz = params_.z_hit * eta_hit_bound * n;
+
+    // 2: Short normalizers decrease with the expected range, which must exceed the measured range.
+    pz += params_.z_short * params_.lambda_short * std::exp(-params_.lambda_short * z) /
+          (1. - std::exp(-params_.lambda_short * z));
+
+    // 3 and 4: Max range return or random return.
+    pz += z < params_.beam_max_range ? params_.z_rand / params_.beam_max_range : params_.z_max;
+
+    return pz * pz * pz;
+  }
 };
 
 }  // namespace beluga
@@ -0,0 +1,125 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_SENSOR_BOUNDED_WEIGHTING_FUNCTION_HPP
+#define BELUGA_SENSOR_BOUNDED_WEIGHTING_FUNCTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \brief Implementation of a state weighting function that can stop evaluating measurements early.
+ */
+
+namespace beluga {
+
+/// Default number of points evaluated between checks for early termination.
+inline constexpr std::size_t kDefaultEarlyTerminationBlockSize = 16;
+
+/// Point evaluation counts for bounded weighting functions, see beluga::BoundedWeightingFunction.
+struct EarlyTerminationStats {
+  /// Number of points evaluated.
+  std::size_t evaluated{0};
+  /// Number of points that would have been evaluated without early termination.
+  std::size_t total{0};
+
+  /// Returns the fraction of point evaluations saved by early termination.
+  [[nodiscard]] double saved_fraction() const {
+    return total > 0 ? 1.0 - static_cast<double>(evaluated) / static_cast<double>(total) : 0.0;
+  }
+};
+
+/// State weighting function that can stop evaluating the points in a measurement early.
+/**
+ * Weights are the sum of a base weight and the likelihoods of every point in a measurement, as computed
+ * by most range finder sensor models. When called with a state alone, all points are evaluated and this
+ * function satisfies \ref StateWeightingFunctionPage. When called with a state and a weight bound, points are
+ * evaluated in blocks and, before each block, the weight so far plus an upper bound on the likelihoods of the
+ * points left is compared against the bound: if it cannot exceed it, evaluation stops and that upper bound is
+ * returned as a conservative weight (ie. one that never underestimates the weight of the state).
+ *
+ * Points should be evaluated in a random order, so that early blocks are representative of the whole
+ * measurement and not just of a sector of it.
+ *
+ * \tparam State Particle state type.
+ * \tparam PointLikelihoodFactory Callable that, given a state, returns a callable that computes the likelihood
+ *  of the i-th point in the measurement for that state.
+ */
+template <class State, class PointLikelihoodFactory>
+class BoundedWeightingFunction {
+ public:
+  /// Constructs a bounded weighting function.
+  /**
+   * \param base_weight Weight to add point likelihoods to.
+   * \param point_bounds Upper bounds on the likelihood of each point in the measurement, in evaluation order.
+   * \param make_point_likelihood Point likelihood factory.
+   * \param block_size Number of points evaluated between checks for early termination.
+   */
+  BoundedWeightingFunction(
+      double base_weight,
+      const std::vector<double>& point_bounds,
+      PointLikelihoodFactory make_point_likelihood,
+      std::size_t block_size = kDefaultEarlyTerminationBlockSize)
+      : base_weight_{base_weight},
+        tail_bounds_(point_bounds.size() + 1, 0.0),
+        make_point_likelihood_{std::move(make_point_likelihood)},
+        block_size_{std::max(block_size, std::size_t{1})} {
+    std::partial_sum(point_bounds.rbegin(), point_bounds.rend(), tail_bounds_.rbegin() + 1);
+  }
+
+  /// Returns the number of points in the measurement.
+  [[nodiscard]] std::size_t size() const { return tail_bounds_.size() - 1; }
+
+  /// Returns the weight of a state, evaluating all points in the measurement.
+  [[nodiscard]] double operator()(const State& state) const {
+    return (*this)(state, std::numeric_limits<double>::lowest()).first;
+  }
+
+  /// Returns the weight of a state, or an upper bound on it if it cannot exceed `bound`.
+  /**
+   * \param state State to weight.
+   * \param bound Weight bound below which evaluation can stop early.
+   * \return The (possibly conservative) weight and the number of points evaluated to compute it.
+   */
+  [[nodiscard]] std::pair<double, std::size_t> operator()(const State& state, double bound) const {
+    const auto point_likelihood = make_point_likelihood_(state);
+    const std::size_t count = size();
+    double weight = base_weight_;
+    for (std::size_t index = 0; index < count;) {
+      if (weight + tail_bounds_[index] < bound) {
+        return {weight + tail_bounds_[index], index};
+      }
+      const std::size_t end = std::min(index + block_size_, count);
+      for (; index < end; ++index) {
+        weight += point_likelihood(index);
+      }
+    }
+    return {weight, count};
+  }
+
+ private:
+  double base_weight_;
+  std::vector<double> tail_bounds_;
+  PointLikelihoodFactory make_point_likelihood_;
+  std::size_t block_size_;
+};
+
+}  // namespace beluga
+
+#endif
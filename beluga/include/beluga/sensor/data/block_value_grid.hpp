@@ -0,0 +1,201 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_SENSOR_DATA_BLOCK_VALUE_GRID_HPP
+#define BELUGA_SENSOR_DATA_BLOCK_VALUE_GRID_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <beluga/sensor/data/dense_grid.hpp>
+#include <beluga/sensor/data/value_grid.hpp>
+
+#include <Eigen/Core>
+
+/**
+ * \file
+ * \brief Implementation of a block-sparse value grid.
+ */
+
+namespace beluga {
+
+/// Generic 2D value grid stored in square blocks, where blocks of constant value take a single value.
+/**
+ * The grid is partitioned in `BlockSize` x `BlockSize` cell blocks. Blocks where all cells hold the same
+ * value (as is the case for most of a likelihood field far from obstacles) are collapsed into that value,
+ * and consecutive constant blocks of the same value share it. Every other block is stored in full.
+ *
+ * Lookups do not branch on block kind: each block holds an offset into value storage and a mask
+ * for the cell index within the block, which is zero for constant blocks.
+ *
+ * When instantiated, it satisfies \ref DenseGrid2Page.
+ *
+ * \tparam T Any copyable, equality comparable type.
+ * \tparam BlockSize Block side length, in cells. Must be a power of two.
+ */
+template <typename T, std::size_t BlockSize = 16>
+class BlockValueGrid2 : public BaseDenseGrid2<BlockValueGrid2<T, BlockSize>> {
+  static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "Block size must be a power of two.");
+
+ public:
+  /// Constructs the grid.
+  /**
+   * \param data Grid data, in row-major order.
+   * \param width Grid width. Must evenly divide `data` size.
+   * \param resolution Grid resolution.
+   */
+  explicit BlockValueGrid2(const std::vector<T>& data, std::size_t width, double resolution = 1.)
+      : width_(width),
+        height_(data.size() / width),
+        resolution_(resolution),
+        blocks_per_row_((width + BlockSize - 1) / BlockSize) {
+    assert(data.size() % width == 0);
+    const std::size_t blocks_per_column = (height_ + BlockSize - 1) / BlockSize;
+    blocks_.reserve(blocks_per_row_ * blocks_per_column);
+    auto last_constant_offset = std::optional<std::uint32_t>{};
+    for (std::size_t by = 0; by < blocks_per_column; ++by) {
+      for (std::size_t bx = 0; bx < blocks_per_row_; ++bx) {
+        const std::size_t x0 = bx * BlockSize;
+        const std::size_t y0 = by * BlockSize;
+        const std::size_t x1 = std::min(x0 + BlockSize, width_);
+        const std::size_t y1 = std::min(y0 + BlockSize, height_);
+        const T first = data[y0 * width_ + x0];
+        bool constant = true;
+        for (std::size_t yi = y0; constant && yi < y1; ++yi) {
+          for (std::size_t xi = x0; constant && xi < x1; ++xi) {
+            constant = data[yi * width_ + xi] == first;
+          }
+        }
+
+        if (constant) {
+          if (!last_constant_offset.has_value() || !(values_[*last_constant_offset] == first)) {
+            last_constant_offset = static_cast<std::uint32_t>(values_.size());
+            values_.push_back(first);
+          }
+          blocks_.push_back(Block{*last_constant_offset, 0});
+          continue;
+        }
+
+        // Cells past the grid edge pad the block, they are never looked up.
+        const std::size_t offset = values_.size();
+        values_.resize(offset + kBlockArea, first);
+        for (std::size_t yi = y0; yi < y1; ++yi) {
+          for (std::size_t xi = x0; xi < x1; ++xi) {
+            values_[offset + (yi - y0) * BlockSize + (xi - x0)] = data[yi * width_ + xi];
+          }
+        }
+        blocks_.push_back(Block{static_cast<std::uint32_t>(offset), kBlockMask});
+      }
+    }
+    assert(values_.size() <= std::numeric_limits<std::uint32_t>::max());
+  }
+
+  /// Constructs the grid from a dense linear grid.
+  /**
+   * \param grid Dense grid to copy data, width and resolution from.
+   */
+  explicit BlockValueGrid2(const ValueGrid2<T>& grid) : BlockValueGrid2(grid.data(), grid.width(), grid.resolution()) {}
+
+  /// Gets grid width.
+  [[nodiscard]] std::size_t width() const { return width_; }
+
+  /// Gets grid height.
+  [[nodiscard]] std::size_t height() const { return height_; }
+
+  /// Gets grid resolution.
+  [[nodiscard]] double resolution() const { return resolution_; }
+
+  /// Gets grid size (ie. number of grid cells).
+  [[nodiscard]] std::size_t size() const { return width_ * height_; }
+
+  /// Gets the number of values actually stored, across all blocks.
+  [[nodiscard]] std::size_t stored_size() const { return values_.size(); }
+
+  /// Gets the approximate number of bytes used to store grid data, block table included.
+  [[nodiscard]] std::size_t memory_size() const {
+    return values_.size() * sizeof(T) + blocks_.size() * sizeof(Block);
+  }
+
+  /// Computes index for given grid cell coordinates.
+  /**
+   * Indices are row-major, as if the grid was stored contiguously.
+   *
+   * \param xi Grid cell x-axis coordinate.
+   * \param yi Grid cell y-axis coordinate.
+   */
+  [[nodiscard]] std::size_t index_at(int xi, int yi) const {
+    return static_cast<std::size_t>(yi) * width_ + static_cast<std::size_t>(xi);
+  }
+
+  /// Computes index for given grid cell coordinates.
+  /**
+   * \param pi Grid cell coordinates.
+   */
+  [[nodiscard]] std::size_t index_at(const Eigen::Vector2i& pi) const { return index_at(pi.x(), pi.y()); }
+
+  using BaseDenseGrid2<BlockValueGrid2<T, BlockSize>>::data_at;
+
+  /// Gets cell data, if included.
+  /**
+   * \param xi Grid cell x-axis coordinate.
+   * \param yi Grid cell y-axis coordinate.
+   * \return Cell data if included, `std::nullopt` otherwise.
+   */
+  [[nodiscard]] std::optional<T> data_at(int xi, int yi) const {
+    return this->contains(xi, yi)
+               ? std::make_optional(value_at(static_cast<std::size_t>(xi), static_cast<std::size_t>(yi)))
+               : std::nullopt;
+  }
+
+  /// Gets cell data, if included.
+  /**
+   * \param index Grid cell index.
+   * \return Cell data if included, `std::nullopt` otherwise.
+   */
+  [[nodiscard]] std::optional<T> data_at(std::size_t index) const {
+    return index < size() ? std::make_optional(value_at(index % width_, index / width_)) : std::nullopt;
+  }
+
+ private:
+  /// Block record.
+  struct Block {
+    std::uint32_t offset;  ///< Offset of block data in value storage.
+    std::uint32_t mask;    ///< Mask for cell indices within the block.
+  };
+
+  static constexpr std::size_t kBlockArea = BlockSize * BlockSize;
+  static constexpr auto kBlockMask = static_cast<std::uint32_t>(kBlockArea - 1);
+
+  std::size_t width_;
+  std::size_t height_;
+  double resolution_;
+  std::size_t blocks_per_row_;
+  std::vector<Block> blocks_;
+  std::vector<T> values_;
+
+  [[nodiscard]] T value_at(std::size_t xi, std::size_t yi) const {
+    const auto& block = blocks_[(yi / BlockSize) * blocks_per_row_ + xi / BlockSize];
+    const auto local_index = static_cast<std::uint32_t>((yi % BlockSize) * BlockSize + xi % BlockSize);
+    return values_[block.offset + (local_index & block.mask)];
+  }
+};
+
+}  // namespace beluga
+
+#endif
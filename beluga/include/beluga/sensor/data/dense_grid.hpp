@@ -15,7 +15,9 @@
 #ifndef BELUGA_SENSOR_DATA_DENSE_GRID_HPP
 #define BELUGA_SENSOR_DATA_DENSE_GRID_HPP
 
+#include <cmath>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include <beluga/sensor/data/regular_grid.hpp>
@@ -62,6 +64,17 @@ namespace beluga {
  *   `g.data_near(x, y)` optionally returns cell data, if cell is included;
  * - given possibly const embedding space coordinates `p` of `Eigen::Vector2d` type,
  *   `g.data_near(p)` optionally returns cell data, if cell is included;
+ * - given possibly const embedding space coordinates `x` and `y` of type `double`,
+ *   and a possibly const `background` value of type `double`, `g.interpolate_near(x, y, background)`
+ *   returns cell data bilinearly interpolated between cell centers and its gradient, as an
+ *   `std::pair<double, Eigen::Vector2d>` value, taking `background` for cells that are not included;
+ * - given possibly const embedding space coordinates `p` of `Eigen::Vector2d` type,
+ *   and a possibly const `background` value of type `double`, `g.interpolate_near(p, background)`
+ *   is equivalent to `g.interpolate_near(p.x(), p.y(), background)`;
+ * - given possibly const embedding space coordinates `ps` of `Eigen::Matrix2Xd` type,
+ *   and a possibly const `background` value of type `double`, `g.interpolate_near(ps, background)`
+ *   returns interpolated cell data and gradients for each column in `ps`, as an
+ *   `std::pair<Eigen::VectorXd, Eigen::Matrix2Xd>` value;
  * - given possibly const grid cell coordinates `xi` and `yi` of type `int`,
  *   `g.neighborhood4(xi, yi)` computes the cell 4-connected neighborhood as
  *   a range of `Eigen::Vector2i` type;
@@ -134,6 +147,86 @@ class BaseDenseGrid2 : public BaseRegularGrid2<Derived> {
    */
   [[nodiscard]] auto data_near(const Eigen::Vector2d& p) const { return this->self().data_near(p.x(), p.y()); }
 
+  /// Gets cell data bilinearly interpolated near a point, and its gradient.
+  /**
+   * Cell centers are taken as interpolation nodes. Cells that are not included in the grid
+   * take the `background` value, so that interpolation is defined everywhere.
+   *
+   * \param x Plane x-axis coordinate.
+   * \param y Plane y-axis coordinate.
+   * \param background Value to assume for cells that are not included in the grid.
+   * \return Interpolated cell data and its gradient with respect to plane coordinates.
+   */
+  [[nodiscard]] std::pair<double, Eigen::Vector2d> interpolate_near(double x, double y, double background) const {
+    const double inverse_resolution = 1. / this->self().resolution();
+    const double u = x * inverse_resolution - 0.5;
+    const double v = y * inverse_resolution - 0.5;
+    const double u0 = std::floor(u);
+    const double v0 = std::floor(v);
+    const double tx = u - u0;
+    const double ty = v - v0;
+    const auto xi = static_cast<int>(u0);
+    const auto yi = static_cast<int>(v0);
+    const double v00 = value_or(xi, yi, background);
+    const double v10 = value_or(xi + 1, yi, background);
+    const double v01 = value_or(xi, yi + 1, background);
+    const double v11 = value_or(xi + 1, yi + 1, background);
+    return {
+        (1. - ty) * ((1. - tx) * v00 + tx * v10) + ty * ((1. - tx) * v01 + tx * v11),
+        Eigen::Vector2d{
+            ((1. - ty) * (v10 - v00) + ty * (v11 - v01)) * inverse_resolution,
+            ((1. - tx) * (v01 - v00) + tx * (v11 - v10)) * inverse_resolution}};
+  }
+
+  /// Gets cell data bilinearly interpolated near a point, and its gradient.
+  /**
+   * \param p Plane coordinates.
+   * \param background Value to assume for cells that are not included in the grid.
+   * \return Interpolated cell data and its gradient with respect to plane coordinates.
+   */
+  [[nodiscard]] std::pair<double, Eigen::Vector2d> interpolate_near(const Eigen::Vector2d& p, double background) const {
+    return this->self().interpolate_near(p.x(), p.y(), background);
+  }
+
+  /// Gets cell data bilinearly interpolated near many points, and its gradients.
+  /**
+   * Batched equivalent of the single point overloads. Only cell data lookups are done
+   * point by point, interpolation weights and gradients are computed in (vectorized) bulk.
+   *
+   * \param points Plane coordinates, one point per column.
+   * \param background Value to assume for cells that are not included in the grid.
+   * \return Interpolated cell data and its gradients with respect to plane coordinates, one per point.
+   */
+  [[nodiscard]] std::pair<Eigen::VectorXd, Eigen::Matrix2Xd> interpolate_near(
+      const Eigen::Matrix2Xd& points,
+      double background) const {
+    const double inverse_resolution = 1. / this->self().resolution();
+    const Eigen::Array2Xd coordinates = points.array() * inverse_resolution - 0.5;
+    const Eigen::Array2Xd corners = coordinates.floor();
+    const Eigen::ArrayXd tx = (coordinates.row(0) - corners.row(0)).transpose();
+    const Eigen::ArrayXd ty = (coordinates.row(1) - corners.row(1)).transpose();
+
+    const auto size = points.cols();
+    Eigen::ArrayXd v00(size);
+    Eigen::ArrayXd v10(size);
+    Eigen::ArrayXd v01(size);
+    Eigen::ArrayXd v11(size);
+    for (Eigen::Index i = 0; i < size; ++i) {
+      const auto xi = static_cast<int>(corners(0, i));
+      const auto yi = static_cast<int>(corners(1, i));
+      v00(i) = value_or(xi, yi, background);
+      v10(i) = value_or(xi + 1, yi, background);
+      v01(i) = value_or(xi, yi + 1, background);
+      v11(i) = value_or(xi + 1, yi + 1, background);
+    }
+
+    auto result = std::make_pair(Eigen::VectorXd(size), Eigen::Matrix2Xd(2, size));
+    result.first = ((1. - ty) * ((1. - tx) * v00 + tx * v10) + ty * ((1. - tx) * v01 + tx * v11)).matrix();
+    result.second.row(0) = (((1. - ty) * (v10 - v00) + ty * (v11 - v01)) * inverse_resolution).matrix().transpose();
+    result.second.row(1) = (((1. - tx) * (v01 - v00) + tx * (v11 - v10)) * inverse_resolution).matrix().transpose();
+    return result;
+  }
+
   /// Computes 4-connected neighborhood for cell.
   /**
    * \param xi Grid cell x-axis coordinate.
@@ -165,6 +258,12 @@ class BaseDenseGrid2 : public BaseRegularGrid2<Derived> {
   [[nodiscard]] auto neighborhood4(const Eigen::Vector2i& pi) const {
     return this->self().neighborhood4(pi.x(), pi.y());
   }
+
+ private:
+  [[nodiscard]] double value_or(int xi, int yi, double background) const {
+    const auto data = this->self().data_at(xi, yi);
+    return data.has_value() ? static_cast<double>(*data) : background;
+  }
 };
 
 }  // namespace beluga
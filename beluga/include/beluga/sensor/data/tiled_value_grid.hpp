@@ -0,0 +1,395 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_SENSOR_DATA_TILED_VALUE_GRID_HPP
+#define BELUGA_SENSOR_DATA_TILED_VALUE_GRID_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <beluga/sensor/data/dense_grid.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+/**
+ * \file
+ * \brief Implementation of a value grid that loads square tiles on demand.
+ */
+
+namespace beluga {
+
+/// Generic 2D value grid split in square tiles that are loaded on demand and kept in a bounded cache.
+/**
+ * Tiles are produced by a tile loader, ie. a callable that takes tile coordinates and returns the
+ * `tile_size` x `tile_size` values of that tile in row-major order, or no values if the tile is not
+ * available. Tile loaders may be called concurrently, from the thread that updates the region of interest
+ * and from a background thread.
+ *
+ * Only tiles in the cache can be looked up, every other cell is reported as not included. Tiles are brought
+ * into the cache when the region of interest is updated (eg. to the bounding box of the particle set grown by
+ * the sensor range), and evicted in least recently used order when the cache goes over capacity. Tiles can
+ * be prefetched in a background thread (eg. ahead of the robot motion) so that region updates do not block.
+ *
+ * Tiles for which the tile loader throws are not cached. They are reported as not included until a later
+ * region update or prefetch manages to load them.
+ *
+ * Copies share tiles and cache, so that one copy can be handed over to a sensor model while another is used
+ * to update the region of interest. Lookups are thread-safe, but they must not run concurrently with region
+ * updates. Region updates and prefetches must not run concurrently with each other either, so both are
+ * expected to be called from the same thread (eg. the filter thread).
+ *
+ * When instantiated, it satisfies \ref DenseGrid2Page.
+ *
+ * \tparam T Any copyable type but `bool`, as tile values are looked up through pointers.
+ */
+template <typename T>
+class TiledValueGrid2 : public BaseDenseGrid2<TiledValueGrid2<T>> {
+ public:
+  /// Tile loader type.
+  using tile_loader_type = std::function<std::vector<T>(const Eigen::Vector2i&)>;
+
+  /// Constructs the grid.
+  /**
+   * \param width Grid width, in cells.
+   * \param height Grid height, in cells.
+   * \param resolution Grid resolution.
+   * \param tile_size Tile side length, in cells.
+   * \param loader Tile loader.
+   * \param capacity Maximum number of tiles to keep in the cache, unless more are needed to cover the
+   *  region of interest.
+   */
+  TiledValueGrid2(
+      std::size_t width,
+      std::size_t height,
+      double resolution,
+      std::size_t tile_size,
+      tile_loader_type loader,
+      std::size_t capacity)
+      : cache_{std::make_shared<Cache>(width, height, resolution, tile_size, std::move(loader), capacity)} {
+    assert(tile_size > 0);
+  }
+
+  /// Gets grid width.
+  [[nodiscard]] std::size_t width() const { return cache_->width; }
+
+  /// Gets grid height.
+  [[nodiscard]] std::size_t height() const { return cache_->height; }
+
+  /// Gets grid resolution.
+  [[nodiscard]] double resolution() const { return cache_->resolution; }
+
+  /// Gets grid size (ie. number of grid cells).
+  [[nodiscard]] std::size_t size() const { return cache_->width * cache_->height; }
+
+  /// Gets tile side length, in cells.
+  [[nodiscard]] std::size_t tile_size() const { return cache_->tile_size; }
+
+  /// Gets the number of tiles in the cache.
+  [[nodiscard]] std::size_t cached_tiles() const { return cache_->tiles.size(); }
+
+  /// Computes index for given grid cell coordinates.
+  /**
+   * Indices are row-major, as if the grid was stored contiguously.
+   *
+   * \param xi Grid cell x-axis coordinate.
+   * \param yi Grid cell y-axis coordinate.
+   */
+  [[nodiscard]] std::size_t index_at(int xi, int yi) const {
+    return static_cast<std::size_t>(yi) * cache_->width + static_cast<std::size_t>(xi);
+  }
+
+  /// Computes index for given grid cell coordinates.
+  /**
+   * \param pi Grid cell coordinates.
+   */
+  [[nodiscard]] std::size_t index_at(const Eigen::Vector2i& pi) const { return index_at(pi.x(), pi.y()); }
+
+  using BaseDenseGrid2<TiledValueGrid2<T>>::data_at;
+
+  /// Gets cell data, if included and its tile is in the cache.
+  /**
+   * \param xi Grid cell x-axis coordinate.
+   * \param yi Grid cell y-axis coordinate.
+   * \return Cell data if available, `std::nullopt` otherwise.
+   */
+  [[nodiscard]] std::optional<T> data_at(int xi, int yi) const {
+    if (!this->contains(xi, yi)) {
+      return std::nullopt;
+    }
+    const auto x = static_cast<std::size_t>(xi);
+    const auto y = static_cast<std::size_t>(yi);
+    const std::size_t tile_size = cache_->tile_size;
+    const T* tile = cache_->resident[(y / tile_size) * cache_->tiles_per_row + x / tile_size];
+    return tile != nullptr ? std::make_optional(tile[(y % tile_size) * tile_size + x % tile_size]) : std::nullopt;
+  }
+
+  /// Gets cell data, if included and its tile is in the cache.
+  /**
+   * \param index Grid cell index.
+   * \return Cell data if available, `std::nullopt` otherwise.
+   */
+  [[nodiscard]] std::optional<T> data_at(std::size_t index) const {
+    return index < size() ? data_at(static_cast<int>(index % cache_->width), static_cast<int>(index / cache_->width))
+                          : std::nullopt;
+  }
+
+  /// Brings all tiles overlapping a region into the cache.
+  /**
+   * Tiles prefetched so far are moved into the cache first, and missing tiles are loaded right away.
+   * Least recently used tiles are then evicted until the cache is back within capacity. Tiles that fail
+   * to load are left out of the cache, to be retried on the next region update.
+   *
+   * Must not be called concurrently with lookups or prefetches.
+   *
+   * \param region Region of interest, in grid plane coordinates.
+   */
+  void update_region(const Eigen::AlignedBox2d& region) {
+    auto& cache = *cache_;
+    cache.merge_prefetched_tiles();
+    const auto required = cache.tiles_in(region);
+    // Touch tiles in reverse order so that those required end up at the front, in order.
+    for (auto it = required.rbegin(); it != required.rend(); ++it) {
+      cache.touch(*it);
+    }
+    cache.evict(std::max(cache.capacity, required.size()));
+  }
+
+  /// Loads all tiles overlapping a region that are not in the cache yet, in a background thread.
+  /**
+   * Prefetched tiles are moved into the cache on the next region update. Tiles for which the tile
+   * loader throws are dropped, to be loaded again when required.
+   *
+   * Must be called from the thread that updates the region of interest.
+   *
+   * \param region Region to prefetch, in grid plane coordinates.
+   */
+  void prefetch(const Eigen::AlignedBox2d& region) {
+    auto& cache = *cache_;
+    cache.enqueue(cache.tiles_in(region));
+  }
+
+ private:
+  struct Tile {
+    std::size_t index;
+    std::vector<T> values;
+  };
+
+  struct Cache {
+    std::size_t width;
+    std::size_t height;
+    double resolution;
+    std::size_t tile_size;
+    std::size_t tiles_per_row;
+    std::size_t tiles_per_column;
+    tile_loader_type loader;
+    std::size_t capacity;
+
+    // Cached tiles, most recently used first, and pointers to their values by tile index.
+    // Only accessed from the thread that updates the region of interest.
+    std::list<Tile> tiles;
+    std::unordered_map<std::size_t, typename std::list<Tile>::iterator> tiles_by_index;
+    std::vector<const T*> resident;
+
+    // Background loading state, guarded by the mutex.
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::size_t> queue;
+    std::unordered_set<std::size_t> pending;
+    std::vector<Tile> prefetched;
+    bool stop{false};
+    std::thread worker;
+
+    Cache(
+        std::size_t width,
+        std::size_t height,
+        double resolution,
+        std::size_t tile_size,
+        tile_loader_type loader,
+        std::size_t capacity)
+        : width{width},
+          height{height},
+          resolution{resolution},
+          tile_size{tile_size},
+          tiles_per_row{(width + tile_size - 1) / tile_size},
+          tiles_per_column{(height + tile_size - 1) / tile_size},
+          loader{std::move(loader)},
+          capacity{capacity},
+          resident(tiles_per_row * tiles_per_column, nullptr) {}
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    ~Cache() {
+      {
+        const auto lock = std::lock_guard{mutex};
+        stop = true;
+      }
+      condition.notify_all();
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+
+    [[nodiscard]] std::vector<std::size_t> tiles_in(const Eigen::AlignedBox2d& region) const {
+      auto indices = std::vector<std::size_t>{};
+      if (region.isEmpty() || width == 0 || height == 0) {
+        return indices;
+      }
+      const auto to_tile = [this](double coordinate, std::size_t count) {
+        const double cell = std::floor(coordinate / resolution);
+        const double clamped = std::clamp(cell, 0.0, static_cast<double>(count - 1));
+        return static_cast<std::size_t>(clamped) / tile_size;
+      };
+      if (region.max().x() < 0.0 || region.max().y() < 0.0 ||
+          region.min().x() >= static_cast<double>(width) * resolution ||
+          region.min().y() >= static_cast<double>(height) * resolution) {
+        return indices;
+      }
+      const std::size_t tx0 = to_tile(region.min().x(), width);
+      const std::size_t ty0 = to_tile(region.min().y(), height);
+      const std::size_t tx1 = to_tile(region.max().x(), width);
+      const std::size_t ty1 = to_tile(region.max().y(), height);
+      indices.reserve((tx1 - tx0 + 1) * (ty1 - ty0 + 1));
+      for (std::size_t ty = ty0; ty <= ty1; ++ty) {
+        for (std::size_t tx = tx0; tx <= tx1; ++tx) {
+          indices.push_back(ty * tiles_per_row + tx);
+        }
+      }
+      return indices;
+    }
+
+    [[nodiscard]] std::vector<T> load(std::size_t index) const {
+      auto values = loader(Eigen::Vector2i{
+          static_cast<int>(index % tiles_per_row), static_cast<int>(index / tiles_per_row)});
+      if (values.size() != tile_size * tile_size) {
+        values.clear();  // unavailable tile
+      }
+      return values;
+    }
+
+    void insert(Tile tile) {
+      if (tiles_by_index.count(tile.index) > 0) {
+        return;
+      }
+      tiles.push_front(std::move(tile));
+      const auto& front = tiles.front();
+      tiles_by_index.emplace(front.index, tiles.begin());
+      resident[front.index] = front.values.empty() ? nullptr : front.values.data();
+    }
+
+    void touch(std::size_t index) {
+      if (const auto it = tiles_by_index.find(index); it != tiles_by_index.end()) {
+        tiles.splice(tiles.begin(), tiles, it->second);
+        return;
+      }
+      {
+        // Tiles loaded here need not be loaded in the background anymore.
+        const auto lock = std::lock_guard{mutex};
+        pending.erase(index);
+      }
+      try {
+        insert(Tile{index, load(index)});
+      } catch (...) {
+        // Failed tiles are not cached, so that they are loaded again when required.
+      }
+    }
+
+    void evict(std::size_t count) {
+      while (tiles.size() > count) {
+        const std::size_t index = tiles.back().index;
+        resident[index] = nullptr;
+        tiles_by_index.erase(index);
+        tiles.pop_back();
+      }
+    }
+
+    void merge_prefetched_tiles() {
+      auto ready = std::vector<Tile>{};
+      {
+        const auto lock = std::lock_guard{mutex};
+        ready.swap(prefetched);
+      }
+      for (auto& tile : ready) {
+        insert(std::move(tile));
+      }
+    }
+
+    void enqueue(std::vector<std::size_t> indices) {
+      // Cached tiles are filtered out on the calling thread, the only one that updates them.
+      indices.erase(
+          std::remove_if(
+              indices.begin(), indices.end(), [this](std::size_t index) { return tiles_by_index.count(index) > 0; }),
+          indices.end());
+      {
+        const auto lock = std::lock_guard{mutex};
+        for (const std::size_t index : indices) {
+          if (pending.insert(index).second) {
+            queue.push_back(index);
+          }
+        }
+        if (!worker.joinable()) {
+          worker = std::thread{[this] { run(); }};
+        }
+      }
+      condition.notify_one();
+    }
+
+    void run() {
+      auto lock = std::unique_lock{mutex};
+      while (true) {
+        condition.wait(lock, [this] { return stop || !queue.empty(); });
+        if (stop) {
+          return;
+        }
+        const std::size_t index = queue.front();
+        queue.pop_front();
+        if (pending.count(index) == 0) {
+          continue;  // loaded in the foreground already
+        }
+        lock.unlock();
+        auto values = std::optional<std::vector<T>>{};
+        try {
+          values = load(index);
+        } catch (...) {
+          // There is no caller to report errors to in the background, failed tiles are loaded again when required.
+        }
+        lock.lock();
+        if (pending.erase(index) > 0 && values.has_value()) {
+          prefetched.push_back(Tile{index, std::move(values).value()});
+        }
+      }
+    }
+  };
+
+  std::shared_ptr<Cache> cache_;
+};
+
+}  // namespace beluga
+
+#endif
@@ -17,11 +17,17 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <limits>
 #include <random>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <beluga/actions/overlay.hpp>
 #include <beluga/algorithm/distance_map.hpp>
+#include <beluga/sensor/bounded_weighting_function.hpp>
+#include <beluga/sensor/data/block_value_grid.hpp>
 #include <beluga/sensor/data/occupancy_grid.hpp>
 #include <beluga/sensor/data/value_grid.hpp>
 #include <range/v3/action/transform.hpp>
@@ -62,6 +68,34 @@ struct LikelihoodFieldModelParam {
   double sigma_hit = 0.2;
   /// Whether to model unknown space or assume it free.
   bool model_unknown_space = false;
+  /// Number of downsampled likelihood field levels to build for coarse weighting.
+  /**
+   * Each level halves the resolution of the previous one, keeping the maximum likelihood of every
+   * 2x2 block of cells so that coarse weights never underestimate fine ones. Coarse weighting
+   * uses the last level. Zero disables coarse weighting.
+   */
+  std::size_t coarse_levels = 0;
+  /// Stride between the points used for coarse weighting.
+  std::size_t coarse_point_stride = 4;
+  /// Fraction of particles, those with the highest coarse weights, to weight in full resolution.
+  /**
+   * Only used for coarse-to-fine weighting, see beluga::actions::reweight_coarse_to_fine.
+   */
+  double fine_fraction = 0.1;
+  /// Whether to bilinearly interpolate the likelihood field or look up the nearest cell.
+  /**
+   * Interpolation yields smooth weights, which allow for coarser likelihood fields
+   * (and thus less memory) at comparable accuracy, at a slightly higher cost per point.
+   * Coarse weighting always looks up the nearest cell.
+   */
+  bool bilinear_interpolation = false;
+  /// Ratio to the best weight so far below which particles may stop being weighted early.
+  /**
+   * Only used for bounded weighting, see beluga::actions::reweight_bounded. Zero disables bounded weighting.
+   */
+  double early_termination_ratio = 0.0;
+  /// Number of points evaluated between checks for early termination.
+  std::size_t early_termination_block_size = kDefaultEarlyTerminationBlockSize;
 };
 
 /// Likelihood field sensor model for range finders.
@@ -77,16 +111,25 @@ struct LikelihoodFieldModelParam {
  *
  * \tparam OccupancyGrid Type representing an occupancy grid.
  *  It must satisfy \ref OccupancyGrid2Page.
+ * \tparam StateType Type for particle's state. Either Sophus::SE2d or Sophus::SE2f.
+ *  Measurements share its precision, but likelihoods and weights are always double precision.
+ * \tparam LikelihoodField Type used to store the likelihood field. It must satisfy \ref DenseGrid2Page
+ *  and be constructible from a beluga::ValueGrid2<float> instance, like beluga::BlockValueGrid2<float>
+ *  does. Downsampled likelihood fields for coarse weighting are always dense.
  */
-template <class OccupancyGrid>
+template <class OccupancyGrid, class StateType = Sophus::SE2d, class LikelihoodField = ValueGrid2<float>>
 class LikelihoodFieldModel {
+  static_assert(
+      std::is_same_v<StateType, Sophus::SE2d> or std::is_same_v<StateType, Sophus::SE2f>,
+      "Likelihood field model only supports SE2 state types.");
+
  public:
   /// State type of a particle.
-  using state_type = Sophus::SE2d;
+  using state_type = StateType;
   /// Weight type of the particle.
   using weight_type = double;
   /// Measurement type of the sensor: a point cloud for the range finder.
-  using measurement_type = std::vector<std::pair<double, double>>;
+  using measurement_type = std::vector<std::pair<typename StateType::Scalar, typename StateType::Scalar>>;
   /// Map representation type.
   using map_type = OccupancyGrid;
   /// Parameter type that the constructor uses to configure the likelihood field model.
@@ -101,13 +144,39 @@ class LikelihoodFieldModel {
    *  for particle states.
    */
   explicit LikelihoodFieldModel(const param_type& params, const map_type& grid)
+      : LikelihoodFieldModel(params, grid, make_likelihood_field(params, grid)) {}
+
+  /// Constructs a LikelihoodFieldModel instance off a precomputed likelihood field.
+  /**
+   * Meant for likelihood fields that are not computed in full upfront, like beluga::TiledValueGrid2
+   * instances that compute tiles on demand (see make_likelihood_field()). No downsampled likelihood
+   * fields are built, and the likelihood upper bound for bounded weighting is derived from parameters.
+   *
+   * \param params Parameters to configure this instance.
+   *  See beluga::LikelihoodFieldModelParam for details.
+   * \param likelihood_field Likelihood field, in the local frame of the map it was computed off.
+   * \param origin Transform from the global frame to the local frame of that map.
+   */
+  LikelihoodFieldModel(const param_type& params, LikelihoodField likelihood_field, const Sophus::SE2d& origin)
       : params_{params},
-        likelihood_field_{make_likelihood_field(params, grid)},
-        world_to_likelihood_field_transform_{grid.origin().inverse()} {}
+        max_likelihood_{make_max_likelihood(params)},
+        likelihood_field_{std::move(likelihood_field)},
+        world_to_likelihood_field_transform_{origin.inverse().template cast<typename StateType::Scalar>()} {}
+
+  /// Returns the parameters this instance was configured with.
+  [[nodiscard]] const param_type& params() const { return params_; }
 
   /// Returns the likelihood field, constructed from the provided map.
   [[nodiscard]] const auto& likelihood_field() const { return likelihood_field_; }
 
+  /// Returns the transform from the global frame to the local frame of the likelihood field.
+  [[nodiscard]] const StateType& world_to_likelihood_field_transform() const {
+    return world_to_likelihood_field_transform_;
+  }
+
+  /// Returns the downsampled likelihood fields, from finest to coarsest.
+  [[nodiscard]] const auto& likelihood_field_pyramid() const { return likelihood_field_pyramid_; }
+
   /// Returns a state weighting function conditioned on 2D lidar hits.
   /**
    * \param points 2D lidar hit points in the reference frame of particle states.
@@ -116,46 +185,116 @@ class LikelihoodFieldModel {
    */
   [[nodiscard]] auto operator()(measurement_type&& points) const {
     return [this, points = std::move(points)](const state_type& state) -> weight_type {
+      return std::transform_reduce(
+          points.cbegin(), points.cend(), 1.0, std::plus{}, make_point_likelihood(state));
+    };
+  }
+
+  /// Returns a bounded state weighting function conditioned on 2D lidar hits.
+  /**
+   * The returned function computes the same weights as the one returned by the call operator,
+   * but it can stop evaluating points early for states that cannot exceed a given weight.
+   * Points are evaluated in a random order, in blocks of `early_termination_block_size` points.
+   *
+   * \param points 2D lidar hit points in the reference frame of particle states.
+   * \param engine Random number generator to shuffle points with.
+   * \return a beluga::BoundedWeightingFunction instance borrowing a reference to this sensor model
+   *  (and thus their lifetime are bound).
+   */
+  template <class URNG>
+  [[nodiscard]] auto bounded(measurement_type&& points, URNG& engine) const {
+    std::shuffle(points.begin(), points.end(), engine);
+    const double max_point_likelihood = max_likelihood_ * max_likelihood_ * max_likelihood_;
+    const auto point_bounds = std::vector<double>(points.size(), max_point_likelihood);
+    auto make_indexed_point_likelihood = [this, points = std::move(points)](const state_type& state) {
+      return [&points, point_likelihood = make_point_likelihood(state)](std::size_t index) {
+        return point_likelihood(points[index]);
+      };
+    };
+    return BoundedWeightingFunction<state_type, decltype(make_indexed_point_likelihood)>{
+        1.0, point_bounds, std::move(make_indexed_point_likelihood), params_.early_termination_block_size};
+  }
+
+  /// Returns a bounded state weighting function conditioned on 2D lidar hits.
+  /**
+   * Same as the overload above, except that points are shuffled with a default seeded generator
+   * (and thus always into the same order for measurements of the same size).
+   */
+  [[nodiscard]] auto bounded(measurement_type&& points) const {
+    auto engine = std::mt19937{};
+    return bounded(std::move(points), engine);
+  }
+
+  /// Returns a coarse state weighting function conditioned on 2D lidar hits.
+  /**
+   * The returned function approximates the one returned by the call operator using the coarsest
+   * downsampled likelihood field and a strided subset of the points, scaling the sum of point
+   * likelihoods to account for the points left out. If no downsampled likelihood fields were
+   * built, the full resolution likelihood field is used.
+   *
+   * \param points 2D lidar hit points in the reference frame of particle states.
+   * \return a state weighting function satisfying \ref StateWeightingFunctionPage
+   *  and borrowing a reference to this sensor model (and thus their lifetime are bound).
+   */
+  [[nodiscard]] auto coarse(const measurement_type& points) const {
+    const auto stride = std::max(params_.coarse_point_stride, std::size_t{1});
+    auto subset = measurement_type{};
+    subset.reserve((points.size() + stride - 1) / stride);
+    for (std::size_t i = 0; i < points.size(); i += stride) {
+      subset.push_back(points[i]);
+    }
+    const double scale =
+        subset.empty() ? 0.0 : static_cast<double>(points.size()) / static_cast<double>(subset.size());
+    return [this, scale, points = std::move(subset)](const state_type& state) -> weight_type {
       const auto transform = world_to_likelihood_field_transform_ * state;
       const auto x_offset = transform.translation().x();
       const auto y_offset = transform.translation().y();
       const auto cos_theta = transform.so2().unit_complex().x();
       const auto sin_theta = transform.so2().unit_complex().y();
       const auto unknown_space_occupancy_prob = static_cast<float>(1. / params_.max_laser_distance);
-      return std::transform_reduce(
-          points.cbegin(), points.cend(), 1.0, std::plus{},
-          [this, x_offset, y_offset, cos_theta, sin_theta, unknown_space_occupancy_prob](const auto& point) {
-            // Transform the end point of the laser to the grid local coordinate system.
-            // Not using Eigen/Sophus because they make the routine x10 slower.
-            // See `benchmark_likelihood_field_model.cpp` for reference.
-            const auto x = point.first * cos_theta - point.second * sin_theta + x_offset;
-            const auto y = point.first * sin_theta + point.second * cos_theta + y_offset;
-            const auto pz =
-                static_cast<double>(likelihood_field_.data_near(x, y).value_or(unknown_space_occupancy_prob));
-            // TODO(glpuga): Investigate why AMCL and QuickMCL both use this formula for the weight.
-            // See https://github.com/Ekumen-OS/beluga/issues/153
-            return pz * pz * pz;
-          });
+      const auto likelihood_sum = [&](const auto& field) {
+        return std::transform_reduce(
+            points.cbegin(), points.cend(), 0.0, std::plus{},
+            [&field, x_offset, y_offset, cos_theta, sin_theta, unknown_space_occupancy_prob](const auto& point) {
+              const auto x = point.first * cos_theta - point.second * sin_theta + x_offset;
+              const auto y = point.first * sin_theta + point.second * cos_theta + y_offset;
+              const auto pz = static_cast<double>(field.data_near(x, y).value_or(unknown_space_occupancy_prob));
+              return pz * pz * pz;
+            });
+      };
+      // The full resolution likelihood field and downsampled ones may not share a type.
+      return 1.0 + scale * (likelihood_field_pyramid_.empty() ? likelihood_sum(likelihood_field_)
+                                                              : likelihood_sum(likelihood_field_pyramid_.back()));
     };
   }
 
   /// Update the sensor model with a new occupancy grid map.
   /**
-   * This method re-computes the underlying likelihood field.
+   * This method re-computes the underlying likelihood field and its downsampled levels.
    *
    * \param grid New occupancy grid representing the static map.
    */
   void update_map(const map_type& grid) {
-    likelihood_field_ = make_likelihood_field(params_, grid);
-    world_to_likelihood_field_transform_ = grid.origin().inverse();
+    auto likelihood_field = make_likelihood_field(params_, grid);
+    likelihood_field_pyramid_ = make_likelihood_field_pyramid(params_, likelihood_field);
+    max_likelihood_ = make_max_likelihood(params_, likelihood_field);
+    likelihood_field_ = LikelihoodField{std::move(likelihood_field)};
+    world_to_likelihood_field_transform_ = grid.origin().inverse().template cast<typename StateType::Scalar>();
   }
 
- private:
-  param_type params_;
-  ValueGrid2<float> likelihood_field_;
-  Sophus::SE2d world_to_likelihood_field_transform_;
-
-  static ValueGrid2<float> make_likelihood_field(const LikelihoodFieldModelParam& params, const OccupancyGrid& grid) {
+  /// Computes a likelihood field off an occupancy grid.
+  /**
+   * This is the likelihood field that instances compute on construction and map updates. It can also
+   * be used to compute likelihood fields piecewise, eg. for tiles of a larger map, as long as each piece
+   * is computed off an occupancy grid that extends past it by `max_obstacle_distance` on every side.
+   *
+   * \param params Parameters to compute the likelihood field with.
+   * \param grid Occupancy grid to compute the likelihood field of.
+   * \return The likelihood field, in the occupancy grid local frame.
+   */
+  [[nodiscard]] static ValueGrid2<float> make_likelihood_field(
+      const LikelihoodFieldModelParam& params,
+      const OccupancyGrid& grid) {
     const auto squared_distance = [&grid](std::size_t first, std::size_t second) {
       return static_cast<float>((grid.coordinates_at(first) - grid.coordinates_at(second)).squaredNorm());
     };
@@ -196,6 +335,93 @@ class LikelihoodFieldModel {
 
     return ValueGrid2<float>{std::move(likelihood_values), grid.width(), grid.resolution()};
   }
+
+ private:
+  param_type params_;
+  std::vector<ValueGrid2<float>> likelihood_field_pyramid_;
+  double max_likelihood_;
+  LikelihoodField likelihood_field_;
+  StateType world_to_likelihood_field_transform_;
+
+  // Downsampled likelihood fields and the maximum likelihood are computed off the dense likelihood field
+  // before it is moved into storage.
+  LikelihoodFieldModel(const param_type& params, const map_type& grid, ValueGrid2<float>&& likelihood_field)
+      : params_{params},
+        likelihood_field_pyramid_{make_likelihood_field_pyramid(params, likelihood_field)},
+        max_likelihood_{make_max_likelihood(params, likelihood_field)},
+        likelihood_field_{std::move(likelihood_field)},
+        world_to_likelihood_field_transform_{grid.origin().inverse().template cast<typename StateType::Scalar>()} {}
+
+  [[nodiscard]] auto make_point_likelihood(const state_type& state) const {
+    const auto transform = world_to_likelihood_field_transform_ * state;
+    const auto x_offset = transform.translation().x();
+    const auto y_offset = transform.translation().y();
+    const auto cos_theta = transform.so2().unit_complex().x();
+    const auto sin_theta = transform.so2().unit_complex().y();
+    const auto unknown_space_occupancy_prob = static_cast<float>(1. / params_.max_laser_distance);
+    return [this, x_offset, y_offset, cos_theta, sin_theta, unknown_space_occupancy_prob](const auto& point) {
+      // Transform the end point of the laser to the grid local coordinate system.
+      // Not using Eigen/Sophus because they make the routine x10 slower.
+      // See `benchmark_likelihood_field_model.cpp` for reference.
+      const auto x = point.first * cos_theta - point.second * sin_theta + x_offset;
+      const auto y = point.first * sin_theta + point.second * cos_theta + y_offset;
+      const auto pz =
+          params_.bilinear_interpolation
+              ? likelihood_field_.interpolate_near(x, y, static_cast<double>(unknown_space_occupancy_prob)).first
+              : static_cast<double>(likelihood_field_.data_near(x, y).value_or(unknown_space_occupancy_prob));
+      // TODO(glpuga): Investigate why AMCL and QuickMCL both use this formula for the weight.
+      // See https://github.com/Ekumen-OS/beluga/issues/153
+      return pz * pz * pz;
+    };
+  }
+
+  static double make_max_likelihood(
+      const LikelihoodFieldModelParam& params,
+      const ValueGrid2<float>& likelihood_field) {
+    // Interpolated likelihoods never exceed those of the cells (or the background) they are interpolated from.
+    const auto& data = likelihood_field.data();
+    const auto it = std::max_element(data.begin(), data.end());
+    const auto unknown_space_occupancy_prob = static_cast<double>(static_cast<float>(1. / params.max_laser_distance));
+    return it != data.end() ? std::max(static_cast<double>(*it), unknown_space_occupancy_prob)
+                            : unknown_space_occupancy_prob;
+  }
+
+  static double make_max_likelihood(const LikelihoodFieldModelParam& params) {
+    // Likelihoods peak at obstacles. Round up, as likelihood fields store them in single precision.
+    const double amplitude = params.z_hit / (params.sigma_hit * std::sqrt(2 * Sophus::Constants<double>::pi()));
+    const double offset = params.z_random / params.max_laser_distance;
+    const auto max_likelihood = static_cast<float>(std::max(amplitude + offset, 1. / params.max_laser_distance));
+    return static_cast<double>(std::nextafter(max_likelihood, std::numeric_limits<float>::infinity()));
+  }
+
+  static std::vector<ValueGrid2<float>> make_likelihood_field_pyramid(
+      const LikelihoodFieldModelParam& params,
+      const ValueGrid2<float>& likelihood_field) {
+    auto pyramid = std::vector<ValueGrid2<float>>{};
+    pyramid.reserve(params.coarse_levels);
+    for (std::size_t level = 0; level < params.coarse_levels; ++level) {
+      const auto& previous = pyramid.empty() ? likelihood_field : pyramid.back();
+      const std::size_t width = previous.width();
+      const std::size_t height = previous.height();
+      const std::size_t coarse_width = (width + 1) / 2;
+      const std::size_t coarse_height = (height + 1) / 2;
+      const auto& data = previous.data();
+      auto values = std::vector<float>(coarse_width * coarse_height);
+      for (std::size_t yi = 0; yi < coarse_height; ++yi) {
+        for (std::size_t xi = 0; xi < coarse_width; ++xi) {
+          const std::size_t x0 = 2 * xi;
+          const std::size_t y0 = 2 * yi;
+          const std::size_t x1 = std::min(x0 + 1, width - 1);
+          const std::size_t y1 = std::min(y0 + 1, height - 1);
+          values[yi * coarse_width + xi] = std::max(
+              std::max(data[y0 * width + x0], data[y0 * width + x1]),
+              std::max(data[y1 * width + x0], data[y1 * width + x1]));
+        }
+      }
+      pyramid.emplace_back(std::move(values), coarse_width, 2.0 * previous.resolution());
+    }
+    return pyramid;
+  }
 };
 
 }  // namespace beluga
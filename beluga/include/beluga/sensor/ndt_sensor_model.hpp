@@ -15,7 +15,9 @@
 #ifndef BELUGA_SENSOR_NDT_SENSOR_MODEL_HPP
 #define BELUGA_SENSOR_NDT_SENSOR_MODEL_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <stdexcept>
@@ -33,6 +35,7 @@
 #include <sophus/so2.hpp>
 
 #include <beluga/sensor/data/ndt_cell.hpp>
+#include <beluga/sensor/data/point_cloud.hpp>
 #include <beluga/sensor/data/sparse_value_grid.hpp>
 #include "beluga/eigen_compatibility.hpp"
 
@@ -55,10 +58,15 @@ struct CellHasher {
   }
 };
 
+/// Minimum variance along each axis for cells fitted to measurements, to avoid numeric errors down the line.
+inline constexpr double kMinNDTCellVariance = 1e-5;
+
+/// Minimum number of points for a measurement cluster to be fitted to an NDT cell.
+inline constexpr std::size_t kMinPointsPerNDTCell = 5;
+
 /// Fit a vector of points to an NDT cell, by computing its mean and covariance.
 template <int NDim, typename Scalar = double>
 inline NDTCell<NDim, Scalar> fit_points(const std::vector<Eigen::Vector<Scalar, NDim>>& points) {
-  static constexpr double kMinVariance = 1e-5;
   Eigen::Map<const Eigen::Matrix<Scalar, NDim, Eigen::Dynamic>> points_view(
       reinterpret_cast<const Scalar*>(points.data()), NDim, static_cast<int64_t>(points.size()));
   const Eigen::Vector<Scalar, NDim> mean = points_view.rowwise().mean();
@@ -66,10 +74,10 @@ inline NDTCell<NDim, Scalar> fit_points(const std::vector<Eigen::Vector<Scalar,
   // Use sample covariance.
   Eigen::Matrix<Scalar, NDim, Eigen::Dynamic> cov =
       (centered * centered.transpose()) / static_cast<double>(points_view.cols() - 1);
-  cov(0, 0) = std::max(cov(0, 0), kMinVariance);
-  cov(1, 1) = std::max(cov(1, 1), kMinVariance);
+  cov(0, 0) = std::max(cov(0, 0), kMinNDTCellVariance);
+  cov(1, 1) = std::max(cov(1, 1), kMinNDTCellVariance);
   if constexpr (NDim == 3) {
-    cov(2, 2) = std::max(cov(2, 2), kMinVariance);
+    cov(2, 2) = std::max(cov(2, 2), kMinNDTCellVariance);
   }
   return NDTCell<NDim, Scalar>{mean, cov};
 }
@@ -81,13 +89,11 @@ template <int NDim, typename Scalar = double>
 inline std::vector<NDTCell<NDim, Scalar>> to_cells(
     const std::vector<Eigen::Vector<Scalar, NDim>>& points,
     const double resolution) {
-  static constexpr int kMinPointsPerCell = 5;
-
   const Eigen::Map<const Eigen::Matrix<Scalar, NDim, Eigen::Dynamic>> points_view(
       reinterpret_cast<const Scalar*>(points.data()), NDim, static_cast<int64_t>(points.size()));
 
   std::vector<NDTCell<NDim, Scalar>> ret;
-  ret.reserve(static_cast<size_t>(points_view.cols()) / kMinPointsPerCell);
+  ret.reserve(static_cast<size_t>(points_view.cols()) / kMinPointsPerNDTCell);
 
   std::unordered_map<Eigen::Vector<int, NDim>, std::vector<Eigen::Vector<Scalar, NDim>>, CellHasher<NDim>> cell_grid;
   for (const Eigen::Vector<Scalar, NDim>& col : points) {
@@ -95,7 +101,7 @@ inline std::vector<NDTCell<NDim, Scalar>> to_cells(
   }
 
   for (const auto& [cell, points_in_cell] : cell_grid) {
-    if (points_in_cell.size() < kMinPointsPerCell) {
+    if (points_in_cell.size() < kMinPointsPerNDTCell) {
       continue;
     }
     ret.push_back(fit_points<NDim, Scalar>(points_in_cell));
@@ -103,6 +109,69 @@ inline std::vector<NDTCell<NDim, Scalar>> to_cells(
 
   return ret;
 }
+
+/// Given a 3D point cloud, its origin and a resolution, constructs a vector of NDT cells like `to_cells` above does.
+/**
+ * Points are transformed by `origin` (in their own precision) and clusterized as they are read, so point clouds
+ * are never copied. Instead, each cell accumulates the first and second moments of its points, relative to
+ * the first point in it for numerical stability.
+ *
+ * \param points Point collection as a 3xN Eigen matrix expression, e.g. a map over a message buffer.
+ * \param origin Transform from the point cloud frame to the frame cells are to be expressed in.
+ * \param resolution Cell size, in meters.
+ */
+template <typename Scalar = double, typename Derived>
+inline std::vector<NDTCell<3, Scalar>> to_cells(
+    const Eigen::MatrixBase<Derived>& points,
+    const Sophus::SE3d& origin,
+    const double resolution) {
+  static_assert(Derived::RowsAtCompileTime == 3, "Point clouds must be 3xN matrices");
+  using point_scalar = typename Derived::Scalar;
+  using point_type = Eigen::Vector<point_scalar, 3>;
+
+  struct Moments {
+    Eigen::Vector3d shift;
+    Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+    Eigen::Matrix3d sum_of_squares = Eigen::Matrix3d::Zero();
+    std::size_t count = 0;
+  };
+
+  const Eigen::Matrix<point_scalar, 3, 3> rotation = origin.so3().matrix().template cast<point_scalar>();
+  const point_type translation = origin.translation().template cast<point_scalar>();
+  const auto inverse_resolution = static_cast<point_scalar>(1.0 / resolution);
+
+  std::unordered_map<Eigen::Vector3i, Moments, CellHasher<3>> cell_grid;
+  for (Eigen::Index i = 0; i < points.cols(); ++i) {
+    const point_type point = rotation * points.col(i) + translation;
+    auto& moments = cell_grid[(point * inverse_resolution).template cast<int>()];
+    if (moments.count == 0) {
+      moments.shift = point.template cast<double>();
+    }
+    const Eigen::Vector3d delta = point.template cast<double>() - moments.shift;
+    moments.sum += delta;
+    moments.sum_of_squares += delta * delta.transpose();
+    ++moments.count;
+  }
+
+  std::vector<NDTCell<3, Scalar>> ret;
+  ret.reserve(cell_grid.size());
+  for (const auto& [cell, moments] : cell_grid) {
+    if (moments.count < kMinPointsPerNDTCell) {
+      continue;
+    }
+    const auto count = static_cast<double>(moments.count);
+    const Eigen::Vector3d mean = moments.shift + moments.sum / count;
+    // Use sample covariance.
+    Eigen::Matrix3d cov = (moments.sum_of_squares - moments.sum * moments.sum.transpose() / count) / (count - 1.0);
+    for (Eigen::Index j = 0; j < 3; ++j) {
+      cov(j, j) = std::max(cov(j, j), kMinNDTCellVariance);
+    }
+    ret.push_back(NDTCell<3, Scalar>{mean.template cast<Scalar>(), cov.template cast<Scalar>()});
+  }
+
+  return ret;
+}
+
 /// Default neighbor kernel for the 2D NDT sensor model.
 const std::vector<Eigen::Vector2i> kDefaultNeighborKernel2d = {
     Eigen::Vector2i{-1, -1},  //
@@ -203,6 +272,9 @@ class NDTSensorModel {
     assert(params_.minimum_likelihood >= 0);
   }
 
+  /// Returns the sparse grid representing the NDT map.
+  [[nodiscard]] const map_type& cells_data() const { return cells_data_; }
+
   /// Returns a state weighting function conditioned on 2D / 3D lidar hits.
   /**
    * \param points Lidar hit points in the reference frame of particle states.
@@ -210,12 +282,28 @@ class NDTSensorModel {
    *  and borrowing a reference to this sensor model (and thus their lifetime are bound).
    */
   [[nodiscard]] auto operator()(measurement_type&& points) const {
-    return [this, cells = detail::to_cells<ndt_cell_type::num_dim, typename ndt_cell_type::scalar_type>(
-                      points, cells_data_.resolution())](const state_type& state) -> weight_type {
-      return std::transform_reduce(
-          cells.cbegin(), cells.cend(), 1.0, std::plus{},
-          [this, state](const ndt_cell_type& ndt_cell) { return likelihood_at(state * ndt_cell); });
-    };
+    return make_state_weighting_function(
+        detail::to_cells<ndt_cell_type::num_dim, typename ndt_cell_type::scalar_type>(
+            points, cells_data_.resolution()));
+  }
+
+  /// Returns a state weighting function conditioned on 3D lidar hits, straight from a point cloud (3D only).
+  /**
+   * Unlike the overload above, points are neither copied nor converted up front: they are transformed
+   * by the point cloud origin and clusterized as they are read from the point cloud buffer.
+   *
+   * \tparam PointCloud A point cloud type satisfying \ref PointCloudPage.
+   * \param cloud Lidar hit points, with an origin in the reference frame of particle states.
+   * \return a state weighting function satisfying \ref StateWeightingFunctionPage
+   *  and borrowing a reference to this sensor model (and thus their lifetime are bound).
+   */
+  template <
+      class PointCloud,
+      int NDim = ndt_cell_type::num_dim,
+      std::enable_if_t<NDim == 3 && std::is_base_of_v<BasePointCloud<PointCloud>, PointCloud>, int> = 0>
+  [[nodiscard]] auto operator()(const PointCloud& cloud) const {
+    return make_state_weighting_function(detail::to_cells<typename ndt_cell_type::scalar_type>(
+        cloud.points(), cloud.origin(), cells_data_.resolution()));
   }
 
   /// Returns the L2 likelihood scaled by 'd1' and 'd2' set in the parameters for this instance for 'measurement', for
@@ -235,6 +323,14 @@ class NDTSensorModel {
  private:
   const param_type params_;
   const SparseGridT cells_data_;
+
+  [[nodiscard]] auto make_state_weighting_function(std::vector<ndt_cell_type> cells) const {
+    return [this, cells = std::move(cells)](const state_type& state) -> weight_type {
+      return std::transform_reduce(
+          cells.cbegin(), cells.cend(), 1.0, std::plus{},
+          [this, state](const ndt_cell_type& ndt_cell) { return likelihood_at(state * ndt_cell); });
+    };
+  }
 };
 
 namespace io {
@@ -0,0 +1,173 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_UTILITY_SCRATCH_ARENA_HPP
+#define BELUGA_UTILITY_SCRATCH_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \brief Implementation of a resettable monotonic memory resource for scratch memory.
+ */
+
+namespace beluga {
+
+/// Monotonic memory resource for short-lived scratch memory, meant to be reset on every filter cycle.
+/**
+ * Allocations are served by bumping an offset into a single buffer, and deallocations are no-ops.
+ * Allocations that do not fit in the buffer are forwarded to an upstream memory resource, and
+ * released on reset. On reset, the buffer grows to fit everything that was allocated since the
+ * last reset so that repeated cycles with similar memory requirements stop hitting upstream
+ * altogether (i.e. steady state cycles do not allocate).
+ *
+ * Like `std::pmr::monotonic_buffer_resource`, it is not thread-safe.
+ */
+class ScratchArena : public std::pmr::memory_resource {
+ public:
+  /// Constructs an arena.
+  /**
+   * \param initial_capacity Initial buffer size, in bytes.
+   * \param upstream Memory resource to get the buffer and overflow allocations from.
+   */
+  explicit ScratchArena(
+      std::size_t initial_capacity = 0,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream_{upstream} {
+    grow(initial_capacity);
+  }
+
+  /// Move constructor. Memory allocated from `other` is owned by this arena afterwards.
+  ScratchArena(ScratchArena&& other) noexcept
+      : upstream_{other.upstream_},
+        buffer_{std::exchange(other.buffer_, nullptr)},
+        capacity_{std::exchange(other.capacity_, 0)},
+        offset_{std::exchange(other.offset_, 0)},
+        overflow_{std::move(other.overflow_)},
+        overflow_size_{std::exchange(other.overflow_size_, 0)} {}
+
+  /// Move assignment operator. Memory allocated from `other` is owned by this arena afterwards.
+  ScratchArena& operator=(ScratchArena&& other) noexcept {
+    if (this != &other) {
+      release();
+      shrink();
+      upstream_ = other.upstream_;
+      buffer_ = std::exchange(other.buffer_, nullptr);
+      capacity_ = std::exchange(other.capacity_, 0);
+      offset_ = std::exchange(other.offset_, 0);
+      overflow_ = std::move(other.overflow_);
+      overflow_size_ = std::exchange(other.overflow_size_, 0);
+    }
+    return *this;
+  }
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /// Destructor. Releases all memory.
+  ~ScratchArena() override {
+    release();
+    shrink();
+  }
+
+  /// Invalidates all allocations so that memory can be reused.
+  /**
+   * If allocations overflowed the buffer since the last reset, the buffer is grown to fit them all.
+   * Memory allocated from this arena must not be used after a reset.
+   */
+  void reset() {
+    const std::size_t required = offset_ + overflow_size_;
+    release();
+    if (required > capacity_) {
+      shrink();
+      grow(required);
+    }
+    offset_ = 0;
+  }
+
+  /// Returns the buffer size, in bytes.
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+  /// Returns the number of bytes allocated since the last reset.
+  [[nodiscard]] std::size_t size() const noexcept { return offset_ + overflow_size_; }
+
+ private:
+  /// Overflow allocation record.
+  struct Block {
+    void* pointer;
+    std::size_t bytes;
+    std::size_t alignment;
+  };
+
+  static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+
+  std::pmr::memory_resource* upstream_;
+  std::byte* buffer_{nullptr};
+  std::size_t capacity_{0};
+  std::size_t offset_{0};
+  std::vector<Block> overflow_;
+  std::size_t overflow_size_{0};
+
+  void grow(std::size_t capacity) {
+    if (capacity > 0) {
+      buffer_ = static_cast<std::byte*>(upstream_->allocate(capacity, kAlignment));
+      capacity_ = capacity;
+    }
+  }
+
+  void shrink() noexcept {
+    if (buffer_ != nullptr) {
+      upstream_->deallocate(buffer_, capacity_, kAlignment);
+      buffer_ = nullptr;
+      capacity_ = 0;
+    }
+  }
+
+  void release() noexcept {
+    for (const auto& block : overflow_) {
+      upstream_->deallocate(block.pointer, block.bytes, block.alignment);
+    }
+    overflow_.clear();
+    overflow_size_ = 0;
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    const auto address = reinterpret_cast<std::uintptr_t>(buffer_) + offset_;  // NOLINT
+    const std::size_t padding = (alignment - address % alignment) % alignment;
+    if (buffer_ != nullptr && padding + bytes <= capacity_ - offset_) {
+      offset_ += padding;
+      void* pointer = buffer_ + offset_;
+      offset_ += bytes;
+      return pointer;
+    }
+    void* pointer = upstream_->allocate(bytes, alignment);
+    overflow_.push_back(Block{pointer, bytes, alignment});
+    overflow_size_ += bytes + alignment;
+    return pointer;
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace beluga
+
+#endif
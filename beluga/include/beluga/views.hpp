@@ -15,6 +15,7 @@
 #ifndef BELUGA_VIEWS_HPP
 #define BELUGA_VIEWS_HPP
 
+#include <beluga/views/decompress.hpp>
 #include <beluga/views/elements.hpp>
 #include <beluga/views/particles.hpp>
 #include <beluga/views/random_intersperse.hpp>
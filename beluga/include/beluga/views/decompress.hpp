@@ -0,0 +1,49 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_VIEWS_DECOMPRESS_HPP
+#define BELUGA_VIEWS_DECOMPRESS_HPP
+
+#include <cstddef>
+#include <tuple>
+
+#include <beluga/primitives.hpp>
+#include <beluga/type_traits/tuple_traits.hpp>
+
+#include <range/v3/view/for_each.hpp>
+#include <range/v3/view/repeat_n.hpp>
+
+/**
+ * \file
+ * \brief Implementation of a decompress range adaptor object.
+ */
+
+namespace beluga::views {
+
+/// [Range adaptor object](https://en.cppreference.com/w/cpp/named_req/RangeAdaptorObject) that
+/// expands a compressed particle set.
+/**
+ * Each particle in a compressed particle set (see beluga::compress()) is replaced by as many
+ * particles as its beluga::Multiplicity, with the same state and an even share of its weight.
+ */
+inline constexpr auto decompress = ranges::views::for_each([](const auto& particle) {
+  const auto multiplicity = static_cast<std::size_t>(beluga::element<beluga::Multiplicity>(particle));
+  const double weight = beluga::weight(particle) / static_cast<double>(multiplicity);
+  return ranges::views::repeat_n(
+      std::make_tuple(beluga::state(particle), beluga::Weight(weight)), static_cast<std::ptrdiff_t>(multiplicity));
+});
+
+}  // namespace beluga::views
+
+#endif
@@ -15,13 +15,17 @@
 #ifndef BELUGA_VIEWS_RANDOM_INTERSPERSE_HPP
 #define BELUGA_VIEWS_RANDOM_INTERSPERSE_HPP
 
+#include <cmath>
+#include <cstddef>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <random>
 #include <type_traits>
 
 #include <range/v3/functional/bind_back.hpp>
 #include <range/v3/utility/random.hpp>
+#include <range/v3/view/all.hpp>
 #include <range/v3/view/adaptor.hpp>
 
 /**
@@ -33,6 +37,75 @@ namespace beluga::views {
 
 namespace detail {
 
+/// Sequence of Bernoulli trials that draws a random number on each trial.
+class bernoulli_trials {
+ public:
+  /// Default constructor.
+  bernoulli_trials() = default;
+
+  /// Constructs a sequence of trials with a given probability of success.
+  explicit bernoulli_trials(double probability) : distribution_{probability} {}
+
+  /// Returns the outcome of the next trial.
+  template <class URNG>
+  [[nodiscard]] bool operator()(URNG& engine) {
+    return distribution_(engine);
+  }
+
+ private:
+  std::bernoulli_distribution distribution_;
+};
+
+/// Sequence of Bernoulli trials that draws a random number on each success.
+/**
+ * The number of failures before the next success is drawn from a geometric distribution
+ * by inverse transform sampling, and failures are counted down from there. This yields the same
+ * outcome distribution as beluga::views::detail::bernoulli_trials with one random number per success,
+ * which is far cheaper when successes are rare.
+ */
+class geometric_trials {
+ public:
+  /// Default constructor.
+  geometric_trials() = default;
+
+  /// Constructs a sequence of trials with a given probability of success.
+  explicit geometric_trials(double probability)
+      : log_failure_probability_{std::log1p(-probability)}, success_possible_{probability > 0.0} {}
+
+  /// Returns the outcome of the next trial.
+  template <class URNG>
+  [[nodiscard]] bool operator()(URNG& engine) {
+    if (!success_possible_) {
+      return false;
+    }
+    if (!failures_drawn_) {
+      failures_ = draw_failures(engine);
+      failures_drawn_ = true;
+    }
+    if (failures_ > 0) {
+      --failures_;
+      return false;
+    }
+    failures_drawn_ = false;
+    return true;
+  }
+
+ private:
+  template <class URNG>
+  [[nodiscard]] std::size_t draw_failures(URNG& engine) const {
+    // For U uniform in [0, 1), floor(log(1 - U) / log(1 - p)) is geometrically distributed.
+    const double uniform = std::uniform_real_distribution<double>{}(engine);
+    const double failures = std::floor(std::log1p(-uniform) / log_failure_probability_);
+    constexpr auto kMaxFailures = std::numeric_limits<std::size_t>::max();
+    return failures < static_cast<double>(kMaxFailures) ? static_cast<std::size_t>(failures) : kMaxFailures;
+  }
+
+  double log_failure_probability_{0.0};
+  bool success_possible_{false};
+  bool failures_drawn_{false};
+  std::size_t failures_{0};
+};
+
 /// Implementation of the random_intersperse view as a view adaptor.
 /**
  * \tparam Range A [forward range](https://en.cppreference.com/w/cpp/ranges/forward_range).
@@ -40,11 +113,16 @@ namespace detail {
  * \tparam URNG A random number generator that satisfies the
  *  [UniformRandomBitGenerator](https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator)
  *  requirements.
+ * \tparam Trials Sequence of Bernoulli trials that decides when to insert values.
  */
-template <class Range, class Fn, class URNG = typename ranges::detail::default_random_engine>
+template <
+    class Range,
+    class Fn,
+    class URNG = typename ranges::detail::default_random_engine,
+    class Trials = bernoulli_trials>
 struct random_intersperse_view
     : public ranges::view_adaptor<
-          random_intersperse_view<Range, Fn, URNG>,
+          random_intersperse_view<Range, Fn, URNG, Trials>,
           Range,
           // The cardinality value is unknown at compile time.
           // If the adapted range cardinality is finite then we know the resulting view is finite.
@@ -68,7 +146,7 @@ struct random_intersperse_view
       URNG& engine = ranges::detail::get_random_engine())
       : random_intersperse_view::view_adaptor{std::move(range)},
         fn_{std::move(fn)},
-        distribution_{probability},
+        trials_{probability},
         engine_{std::addressof(engine)} {}
 
  private:
@@ -112,14 +190,18 @@ struct random_intersperse_view
   [[nodiscard]] constexpr auto begin_adaptor() { return adaptor{this}; }
 
   /// Return whether we should intersperse a value or increment the input iterator.
-  [[nodiscard]] constexpr bool should_intersperse() { return distribution_(*engine_); }
+  [[nodiscard]] constexpr bool should_intersperse() { return trials_(*engine_); }
 
   ranges::semiregular_box_t<Fn> fn_;
-  std::bernoulli_distribution distribution_;
+  Trials trials_;
   URNG* engine_;
 };
 
 /// Implementation detail for a random_intersperse range adaptor object.
+/**
+ * \tparam Trials Sequence of Bernoulli trials that decides when to insert values.
+ */
+template <class Trials>
 struct random_intersperse_fn {
   /// Default insertion probability on each iteration.
   static constexpr double kDefaultProbability = 0.5;
@@ -153,7 +235,8 @@ struct random_intersperse_fn {
       }
     }();
 
-    return random_intersperse_view{ranges::views::all(std::forward<Range>(range)), std::move(gen), probability, engine};
+    using view_type = random_intersperse_view<ranges::views::all_t<Range>, decltype(gen), URNG, Trials>;
+    return view_type{ranges::views::all(std::forward<Range>(range)), std::move(gen), probability, engine};
   }
 
   /// Overload that unwraps the engine reference from a view closure.
@@ -187,7 +270,20 @@ struct random_intersperse_fn {
 /// [Range adaptor object](https://en.cppreference.com/w/cpp/named_req/RangeAdaptorObject) that
 /// will insert values from a generator function between contiguous elements from the source based
 /// on a given probability.
-inline constexpr detail::random_intersperse_fn random_intersperse;
+/**
+ * A random number is drawn for every element to decide whether to insert a value before it.
+ */
+inline constexpr detail::random_intersperse_fn<detail::bernoulli_trials> random_intersperse;
+
+/// [Range adaptor object](https://en.cppreference.com/w/cpp/named_req/RangeAdaptorObject) that
+/// will insert values from a generator function between contiguous elements from the source based
+/// on a given probability.
+/**
+ * Statistically equivalent to beluga::views::random_intersperse, but the number of elements to skip
+ * before the next insertion is drawn from a geometric distribution instead, so that random numbers
+ * are only drawn once per inserted value. Prefer it when insertion probabilities are low.
+ */
+inline constexpr detail::random_intersperse_fn<detail::geometric_trials> geometric_random_intersperse;
 
 }  // namespace beluga::views
 
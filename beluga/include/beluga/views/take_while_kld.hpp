@@ -16,6 +16,8 @@
 #define BELUGA_VIEWS_TAKE_WHILE_KLD_HPP
 
 #include <cmath>
+#include <functional>
+#include <memory_resource>
 #include <unordered_set>
 
 #include <range/v3/view/take.hpp>
@@ -35,6 +37,19 @@ namespace detail {
 /// Default upper standard normal quantile, P = 0.999
 constexpr double kDefaultKldZ = 3.;
 
+/// Polymorphic allocator that keeps using the same memory resource when containers are copied.
+/**
+ * `std::pmr::polymorphic_allocator` falls back to the default memory resource on container copy
+ * construction, which defeats the purpose for stateful callables that get copied around by views.
+ */
+template <class T>
+struct sticky_polymorphic_allocator : public std::pmr::polymorphic_allocator<T> {
+  using std::pmr::polymorphic_allocator<T>::polymorphic_allocator;
+
+  /// Returns a copy of this allocator, using the same memory resource.
+  [[nodiscard]] sticky_polymorphic_allocator select_on_container_copy_construction() const { return *this; }
+};
+
 }  // namespace detail
 
 /// Returns a callable object that verifies if the KLD condition is being satisfied.
@@ -61,6 +76,7 @@ constexpr double kDefaultKldZ = 3.;
  *  distrubution.
  * \param z Upper standard normal quantile for the probability that the error in the
  *  estimated distribution is less than epsilon.
+ * \param resource Memory resource to allocate spatial hash buckets from.
  * \return A callable object with prototype `(std::size_t hash) -> bool`.
  *  `hash` is the spatial hash of the particle being added. \n
  *  The returned callable object is stateful, tracking the total number of particles and
@@ -69,7 +85,11 @@ constexpr double kDefaultKldZ = 3.;
  *  and the KLD condition is satisfied, if not it will be true. \n
  *  i.e. A return value of true means that you need to keep sampling to satisfy the condition.
  */
-inline auto kld_condition(std::size_t min, double epsilon, double z = beluga::detail::kDefaultKldZ) {
+inline auto kld_condition(
+    std::size_t min,
+    double epsilon,
+    double z = beluga::detail::kDefaultKldZ,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
   auto target_size = [two_epsilon = 2 * epsilon, z](std::size_t k) {
     if (k <= 2U) {
       return std::numeric_limits<std::size_t>::max();
@@ -80,7 +100,10 @@ inline auto kld_condition(std::size_t min, double epsilon, double z = beluga::de
     return static_cast<std::size_t>(std::ceil(result));
   };
 
-  return [=, count = 0ULL, buckets = std::unordered_set<std::size_t>{}](std::size_t hash) mutable {
+  using bucket_set = std::unordered_set<
+      std::size_t, std::hash<std::size_t>, std::equal_to<>,
+      beluga::detail::sticky_polymorphic_allocator<std::size_t>>;
+  return [=, count = 0ULL, buckets = bucket_set{resource}](std::size_t hash) mutable {
     count++;
     buckets.insert(hash);
     return count <= min || count <= target_size(buckets.size());
@@ -103,6 +126,7 @@ struct take_while_kld_fn {
    * \param max Maximum samples to take.
    * \param epsilon See beluga::kld_condition() for details.
    * \param z See beluga::kld_condition() for details.
+   * \param resource See beluga::kld_condition() for details.
    *
    * The hasher will be called with range elements by default. If that is not possible,
    * it will assume that the range contains particles and invoke the hasher with the
@@ -115,7 +139,8 @@ struct take_while_kld_fn {
       std::size_t min,
       std::size_t max,
       double epsilon,
-      double z = beluga::detail::kDefaultKldZ) const {
+      double z = beluga::detail::kDefaultKldZ,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
     static_assert(ranges::input_range<Range>);
 
     auto proj = [&hasher]() {
@@ -131,8 +156,8 @@ struct take_while_kld_fn {
       }
     }();
 
-    return ranges::views::all(std::forward<Range>(range)) |                                      //
-           ranges::views::take_while(beluga::kld_condition(min, epsilon, z), std::move(proj)) |  //
+    return ranges::views::all(std::forward<Range>(range)) |                                                //
+           ranges::views::take_while(beluga::kld_condition(min, epsilon, z, resource), std::move(proj)) |  //
            ranges::views::take(max);
   }
 
@@ -144,6 +169,7 @@ struct take_while_kld_fn {
    * \param max Maximum samples to take.
    * \param epsilon See beluga::kld_condition() for details.
    * \param z See beluga::kld_condition() for details.
+   * \param resource See beluga::kld_condition() for details.
    */
   template <class Hasher>
   constexpr auto operator()(
@@ -151,8 +177,10 @@ struct take_while_kld_fn {
       std::size_t min,
       std::size_t max,
       double epsilon,
-      double z = beluga::detail::kDefaultKldZ) const {
-    return ranges::make_view_closure(ranges::bind_back(take_while_kld_fn{}, std::move(hasher), min, max, epsilon, z));
+      double z = beluga::detail::kDefaultKldZ,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
+    return ranges::make_view_closure(
+        ranges::bind_back(take_while_kld_fn{}, std::move(hasher), min, max, epsilon, z, resource));
   }
 };
 
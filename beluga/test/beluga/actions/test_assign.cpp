@@ -14,15 +14,18 @@
 
 #include <list>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include <beluga/actions/assign.hpp>
+#include <beluga/containers/tuple_vector.hpp>
 
 #include <range/v3/action/drop.hpp>
 #include <range/v3/action/remove.hpp>
 #include <range/v3/algorithm/equal.hpp>
+#include <range/v3/view/filter.hpp>
 #include <range/v3/view/indirect.hpp>
 #include <range/v3/view/move.hpp>
 #include <range/v3/view/reverse.hpp>
@@ -87,4 +90,13 @@ TEST(AssignAction, List) {
   ASSERT_TRUE(ranges::equal(input, std::list{3, 1}));
 }
 
+TEST(AssignAction, KeepsCapacity) {
+  auto input = beluga::TupleVector<std::tuple<int>>{std::make_tuple(1), std::make_tuple(2), std::make_tuple(3)};
+  input.reserve(16);
+  input |= ranges::views::reverse | ranges::views::filter([](const auto& value) { return std::get<0>(value) != 2; }) |
+           beluga::actions::assign;
+  ASSERT_TRUE(ranges::equal(input, std::vector{std::make_tuple(3), std::make_tuple(1)}));
+  ASSERT_EQ(input.capacity(), 16);
+}
+
 }  // namespace
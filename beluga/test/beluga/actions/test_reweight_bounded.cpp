@@ -0,0 +1,120 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <execution>
+#include <tuple>
+#include <vector>
+
+#include <range/v3/range/conversion.hpp>
+
+#include "beluga/actions/normalize.hpp"
+#include "beluga/actions/reweight_bounded.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/sensor/bounded_weighting_function.hpp"
+#include "beluga/views/particles.hpp"
+
+namespace {
+
+auto make_particles() {
+  return std::vector{
+      std::make_tuple(4, beluga::Weight(1.0)),  //
+      std::make_tuple(1, beluga::Weight(1.0)),  //
+      std::make_tuple(3, beluga::Weight(2.0)),  //
+      std::make_tuple(2, beluga::Weight(1.0))};
+}
+
+// Four points, each as likely as the state value, which never exceeds 4.
+auto make_model() {
+  constexpr auto kMakePointLikelihood = [](int value) {
+    return [value](std::size_t) { return static_cast<double>(value); };
+  };
+  return beluga::BoundedWeightingFunction<int, decltype(kMakePointLikelihood)>{
+      0.0, std::vector{4.0, 4.0, 4.0, 4.0}, kMakePointLikelihood, 1};
+}
+
+TEST(BoundedWeightingFunction, FullEvaluation) {
+  const auto model = make_model();
+  ASSERT_EQ(model.size(), 4U);
+  ASSERT_EQ(model(3), 12.0);
+  ASSERT_EQ(model(3, 12.0), std::make_pair(12.0, std::size_t{4}));
+}
+
+TEST(BoundedWeightingFunction, EarlyTermination) {
+  const auto model = make_model();
+  ASSERT_EQ(model(3, 16.0), std::make_pair(15.0, std::size_t{1}));
+  ASSERT_EQ(model(1, 10.0), std::make_pair(7.0, std::size_t{3}));
+  ASSERT_EQ(model(0, 100.0), std::make_pair(16.0, std::size_t{0}));
+}
+
+TEST(ReweightBoundedAction, DefaultExecutionPolicy) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_bounded(make_model(), 1.0);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(16, 13, 30, 14));
+}
+
+TEST(ReweightBoundedAction, SequencedExecutionPolicy) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_bounded(std::execution::seq, make_model(), 1.0);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(16, 13, 30, 14));
+}
+
+TEST(ReweightBoundedAction, ParallelExecutionPolicy) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_bounded(std::execution::par, make_model(), 1.0);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  // Weights depend on the order particles are weighted in, but they are never underestimated.
+  ASSERT_THAT(
+      weights, testing::ElementsAre(16, testing::AllOf(testing::Ge(4), testing::Le(16)),
+                                    testing::AllOf(testing::Ge(24), testing::Le(32)),
+                                    testing::AllOf(testing::Ge(8), testing::Le(16))));
+}
+
+TEST(ReweightBoundedAction, NoEarlyTermination) {
+  auto input = make_particles();
+  auto stats = beluga::EarlyTerminationStats{};
+  input |= beluga::actions::reweight_bounded(make_model(), 0.0, &stats);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(16, 4, 24, 8));
+  ASSERT_EQ(stats.evaluated, 16U);
+  ASSERT_EQ(stats.total, 16U);
+  ASSERT_EQ(stats.saved_fraction(), 0.0);
+}
+
+TEST(ReweightBoundedAction, Stats) {
+  auto input = make_particles();
+  auto stats = beluga::EarlyTerminationStats{};
+  input |= beluga::actions::reweight_bounded(make_model(), 1.0, &stats);
+  input |= beluga::actions::reweight_bounded(make_model(), 1.0, &stats);
+  ASSERT_EQ(stats.evaluated, 14U);
+  ASSERT_EQ(stats.total, 32U);
+  ASSERT_DOUBLE_EQ(stats.saved_fraction(), 18. / 32.);
+}
+
+TEST(ReweightBoundedAction, Composition) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_bounded(make_model(), 1.0) | beluga::actions::normalize;
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(
+      weights, testing::ElementsAre(
+                   testing::DoubleEq(16. / 73.), testing::DoubleEq(13. / 73.), testing::DoubleEq(30. / 73.),
+                   testing::DoubleEq(14. / 73.)));
+}
+
+}  // namespace
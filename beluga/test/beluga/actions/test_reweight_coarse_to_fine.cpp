@@ -0,0 +1,122 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <execution>
+#include <tuple>
+#include <vector>
+
+#include <range/v3/range/conversion.hpp>
+
+#include "beluga/actions/normalize.hpp"
+#include "beluga/actions/reweight_coarse_to_fine.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/views/particles.hpp"
+
+namespace {
+
+auto make_particles() {
+  return std::vector{
+      std::make_tuple(3, beluga::Weight(1.0)),  //
+      std::make_tuple(1, beluga::Weight(1.0)),  //
+      std::make_tuple(4, beluga::Weight(2.0)),  //
+      std::make_tuple(2, beluga::Weight(1.0))};
+}
+
+constexpr auto kCoarseModel = [](int value) { return value; };
+constexpr auto kFineModel = [](int value) { return 10 * value; };
+
+TEST(ReweightCoarseToFineAction, DefaultExecutionPolicy) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(kCoarseModel, kFineModel, 0.5);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(30, 10, 80, 20));
+}
+
+TEST(ReweightCoarseToFineAction, SequencedExecutionPolicy) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(std::execution::seq, kCoarseModel, kFineModel, 0.5);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(30, 10, 80, 20));
+}
+
+TEST(ReweightCoarseToFineAction, ParallelExecutionPolicy) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(std::execution::par, kCoarseModel, kFineModel, 0.5);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(30, 10, 80, 20));
+}
+
+TEST(ReweightCoarseToFineAction, NoFineWeighting) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(kCoarseModel, kFineModel, 0.0);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(3, 1, 8, 2));
+}
+
+TEST(ReweightCoarseToFineAction, FullFineWeighting) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(kCoarseModel, kFineModel, 1.0);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(weights, testing::ElementsAre(30, 10, 80, 20));
+}
+
+TEST(ReweightCoarseToFineAction, Composition) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(kCoarseModel, kFineModel, 0.25) | beluga::actions::normalize;
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_THAT(
+      weights, testing::ElementsAre(
+                   testing::DoubleEq(30. / 140.), testing::DoubleEq(10. / 140.), testing::DoubleEq(80. / 140.),
+                   testing::DoubleEq(20. / 140.)));
+}
+
+TEST(ReweightCoarseToFineAction, RescaleByMeanRatio) {
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(kCoarseModel, [](int value) { return value * value; }, 0.5);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  // States 3 and 4 are refined, with fine to coarse ratios of 3 and 4, so the rest are scaled by 3.5.
+  ASSERT_THAT(
+      weights, testing::ElementsAre(
+                   testing::DoubleEq(9.), testing::DoubleEq(3.5), testing::DoubleEq(32.), testing::DoubleEq(7.)));
+}
+
+TEST(ReweightCoarseToFineAction, RefinedOutweighUnrefined) {
+  // Coarse weights are upper bounds, which are loose for unlikely states (odd) and tight for likely ones (even).
+  const auto coarse_model = [](int value) { return value % 2 == 0 ? 1.0 : 0.9; };
+  const auto fine_model = [](int value) { return value % 2 == 0 ? 0.8 : 0.1; };
+  auto input = std::vector{
+      std::make_tuple(0, beluga::Weight(1.0)),  //
+      std::make_tuple(1, beluga::Weight(1.0)),  //
+      std::make_tuple(3, beluga::Weight(1.0)),  //
+      std::make_tuple(5, beluga::Weight(1.0))};
+  input |= beluga::actions::reweight_coarse_to_fine(coarse_model, fine_model, 0.25) | beluga::actions::normalize;
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  ASSERT_GT(weights[0], weights[1]);
+  ASSERT_GT(weights[0], weights[2]);
+  ASSERT_GT(weights[0], weights[3]);
+}
+
+TEST(ReweightCoarseToFineAction, ZeroApproximations) {
+  const auto coarse_model = [](int value) { return value > 1 ? value : 0; };
+  auto input = make_particles();
+  input |= beluga::actions::reweight_coarse_to_fine(coarse_model, kFineModel, 0.75);
+  auto weights = input | beluga::views::weights | ranges::to<std::vector>;
+  // States 3, 4 and 2 are refined, the zero approximation for state 1 stays zero.
+  ASSERT_THAT(weights, testing::ElementsAre(30, 0, 80, 20));
+}
+
+}  // namespace
@@ -14,17 +14,27 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstddef>
 #include <execution>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <Eigen/Core>
+#include <range/v3/range/conversion.hpp>
 #include <sophus/se2.hpp>
 
 #include "beluga/algorithm/amcl_core.hpp"
 #include "beluga/algorithm/spatial_hash.hpp"
 #include "beluga/containers/tuple_vector.hpp"
 #include "beluga/motion/differential_drive_model.hpp"
+#include "beluga/policies/every_n.hpp"
+#include "beluga/policies/on_motion.hpp"
+#include "beluga/policies/policy.hpp"
+#include "beluga/random/multivariate_normal_distribution.hpp"
 #include "beluga/sensor/beam_model.hpp"
 #include "beluga/sensor/likelihood_field_model.hpp"
 #include "beluga/test/static_occupancy_grid.hpp"
@@ -66,6 +76,29 @@ auto make_amcl(const beluga::AmclParams& params = {}) {
   };
   return amcl;
 }
+
+// Sensor model whose weights add up a state dependent likelihood per point, counting how many measurements it takes.
+struct AddingSensorModel {
+  using state_type = Sophus::SE2d;
+  using weight_type = double;
+  using measurement_type = std::vector<double>;
+  using map_type = int;
+
+  std::size_t* measurements_taken;
+
+  [[nodiscard]] auto operator()(measurement_type points) const {
+    ++*measurements_taken;
+    return [points = std::move(points)](const state_type& state) {
+      double weight = 1.0;
+      for (const double point : points) {
+        weight += point * (1.0 + std::abs(state.translation().x()));
+      }
+      return weight;
+    };
+  }
+
+  void update_map(map_type) {}
+};
 }  // namespace
 
 namespace beluga {
@@ -85,6 +118,15 @@ TEST(TestAmclCore, InitializeFromPose) {
   ASSERT_EQ(amcl.particles().size(), AmclParams{}.max_particles);
 }
 
+TEST(TestAmclCore, InitializeReservesParticles) {
+  auto amcl = make_amcl();
+  amcl.initialize(beluga::MultivariateNormalDistribution{Sophus::SE2d{}, Eigen::Matrix3d::Identity()});
+  ASSERT_EQ(amcl.particles().size(), AmclParams{}.max_particles);
+  ASSERT_GE(amcl.particles().capacity(), AmclParams{}.max_particles);
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  ASSERT_GE(amcl.particles().capacity(), AmclParams{}.max_particles);
+}
+
 TEST(TestAmclCore, UpdateWithNoParticles) {
   auto amcl = make_amcl();
   ASSERT_EQ(amcl.particles().size(), 0);
@@ -124,6 +166,82 @@ TEST(TestAmclCore, UpdateWithParticlesForced) {
   ASSERT_TRUE(estimate.has_value());
 }
 
+TEST(TestAmclCore, UpdateWithMeasurementFactory) {
+  auto amcl = make_amcl();
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  std::size_t measurements_made = 0;
+  auto make_measurement = [&measurements_made]() {
+    ++measurements_made;
+    return kDummyMeasurement;
+  };
+  auto estimate = amcl.update(kDummyControl, make_measurement);
+  ASSERT_TRUE(estimate.has_value());
+  ASSERT_EQ(measurements_made, 1);
+  estimate = amcl.update(kDummyControl, make_measurement);
+  ASSERT_FALSE(estimate.has_value());
+  ASSERT_EQ(measurements_made, 1);
+  amcl.force_update();
+  estimate = amcl.update(kDummyControl, make_measurement);
+  ASSERT_TRUE(estimate.has_value());
+  ASSERT_EQ(measurements_made, 2);
+}
+
+TEST(TestAmclCore, UpdateWithThrowingMeasurementFactory) {
+  auto amcl = make_amcl();
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  const auto control = Sophus::SE2d{Sophus::SO2d{}, Eigen::Vector2d{1.0, 0.0}};
+  auto throwing_factory = []() -> std::vector<std::pair<double, double>> {
+    throw std::runtime_error{"cannot make measurement"};
+  };
+  ASSERT_THROW(amcl.update(control, throwing_factory), std::runtime_error);
+  // The failed update must not consume the motion that made it due.
+  auto estimate = amcl.update(control, kDummyMeasurement);
+  ASSERT_TRUE(estimate.has_value());
+}
+
+TEST(TestAmclCore, UpdateWithMultipleMeasurements) {
+  auto amcl = make_amcl();
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  auto estimate = amcl.update(kDummyControl, {kDummyMeasurement, kDummyMeasurement});
+  ASSERT_TRUE(estimate.has_value());
+  estimate = amcl.update(kDummyControl, {kDummyMeasurement, kDummyMeasurement});
+  ASSERT_FALSE(estimate.has_value());
+}
+
+TEST(TestAmclCore, UpdateWithMultipleMeasurementsMergesThem) {
+  std::size_t measurements_taken = 0;
+  beluga::Amcl amcl{
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},  //
+      AddingSensorModel{&measurements_taken},                                 //
+      []() { return Sophus::SE2d{}; },
+      beluga::spatial_hash<Sophus::SE2d>{0.1, 0.1, 0.1},
+      beluga::make_policy([]() { return true; }),
+      beluga::make_policy([]() { return false; }),
+      beluga::AmclParams{},
+      std::execution::seq,
+  };
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+
+  // Measurements are merged into one, which the sensor model takes once per update.
+  ASSERT_TRUE(amcl.update(kDummyControl, std::vector{std::vector{2.0}, std::vector{3.0, 4.0}}).has_value());
+  ASSERT_EQ(measurements_taken, 1);
+
+  // Particles are not resampled, so weights are proportional to those of a single measurement with all points.
+  const auto states = amcl.particles() | beluga::views::states | ranges::to<std::vector>;
+  const auto weights = amcl.particles() | beluga::views::weights | ranges::to<std::vector>;
+  const auto expected_weight = [](const Sophus::SE2d& state) {
+    return 1.0 + (2.0 + 3.0 + 4.0) * (1.0 + std::abs(state.translation().x()));
+  };
+  const double ratio = static_cast<double>(weights.front()) / expected_weight(states.front());
+  for (std::size_t i = 0; i < states.size(); ++i) {
+    ASSERT_NEAR(static_cast<double>(weights[i]) / expected_weight(states[i]), ratio, 1e-9 * ratio);
+  }
+
+  const auto measurements = std::vector{std::vector{2.0}, std::vector{3.0}, std::vector{4.0}};
+  ASSERT_TRUE(amcl.update(kDummyControl, measurements).has_value());
+  ASSERT_EQ(measurements_taken, 2);
+}
+
 TEST(TestAmclCore, ParticlesDependentRandomStateGenerator) {
   auto params = beluga::AmclParams{};
   params.max_particles = AmclParams{}.max_particles;
@@ -171,6 +289,118 @@ TEST(TestAmclCore, SelectiveResampleCanBeConstructed) {
   ASSERT_TRUE(estimate.has_value());
 }
 
+TEST(TestAmclCore, CustomPolicies) {
+  constexpr double kResolution = 1.0;
+  // clang-format off
+  const auto map = beluga::testing::StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false ,
+    false, false, false, false , false,
+    false, false, true , false, false,
+    false, false , false, false, false,
+    false , false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  int resample_calls = 0;
+  beluga::Amcl amcl{
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},  //
+      beluga::BeamSensorModel{beluga::BeamModelParam{}, map},                 //
+      []() { return Sophus::SE2d{}; },
+      beluga::spatial_hash<Sophus::SE2d>{0.1, 0.1, 0.1},
+      beluga::make_policy([]() { return true; }),
+      beluga::make_policy([&resample_calls]() {
+        ++resample_calls;
+        return false;
+      }),
+      beluga::AmclParams{},
+      std::execution::seq,
+  };
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  // Updates are never skipped, not even without motion, and particles are never resampled.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(amcl.update(kDummyControl, kDummyMeasurement).has_value());
+    ASSERT_EQ(amcl.particles().size(), AmclParams{}.max_particles);
+  }
+  ASSERT_EQ(resample_calls, 3);
+}
+
+TEST(TestAmclCore, UpdateWithThrowingMeasurementFactoryAndCustomPolicies) {
+  constexpr double kResolution = 1.0;
+  const auto map = beluga::testing::StaticOccupancyGrid<2, 2>{{false, false, false, false}, kResolution};
+
+  bool first_call = true;
+  beluga::Amcl amcl{
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},  //
+      beluga::BeamSensorModel{beluga::BeamModelParam{}, map},                 //
+      []() { return Sophus::SE2d{}; },
+      beluga::spatial_hash<Sophus::SE2d>{0.1, 0.1, 0.1},
+      beluga::make_policy([&first_call]() { return std::exchange(first_call, false); }),
+      beluga::make_policy([]() { return false; }),
+      beluga::AmclParams{},
+      std::execution::seq,
+  };
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  auto throwing_factory = []() -> std::vector<std::pair<double, double>> {
+    throw std::runtime_error{"cannot make measurement"};
+  };
+  ASSERT_THROW(amcl.update(kDummyControl, throwing_factory), std::runtime_error);
+  // Policies that cannot be rolled back still get the update they decided on, but only once.
+  ASSERT_TRUE(amcl.update(kDummyControl, kDummyMeasurement).has_value());
+  ASSERT_FALSE(amcl.update(kDummyControl, kDummyMeasurement).has_value());
+}
+
+TEST(TestAmclCore, TypeErasedPolicies) {
+  constexpr double kResolution = 1.0;
+  // clang-format off
+  const auto map = beluga::testing::StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false ,
+    false, false, false, false , false,
+    false, false, true , false, false,
+    false, false , false, false, false,
+    false , false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  using particle_type = std::tuple<Sophus::SE2d, beluga::Weight>;
+  beluga::Amcl amcl{
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},  //
+      beluga::BeamSensorModel{beluga::BeamModelParam{}, map},                 //
+      []() { return Sophus::SE2d{}; },
+      beluga::spatial_hash<Sophus::SE2d>{0.1, 0.1, 0.1},
+      beluga::any_policy<Sophus::SE2d>{beluga::policies::on_motion<Sophus::SE2d>(0.1, 0.1)},
+      beluga::any_policy<beluga::TupleVector<particle_type>>{beluga::policies::every_n(2)},
+      beluga::AmclParams{},
+      std::execution::seq,
+  };
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  ASSERT_TRUE(amcl.update(kDummyControl, kDummyMeasurement).has_value());
+  ASSERT_FALSE(amcl.update(kDummyControl, kDummyMeasurement).has_value());
+}
+
+TEST(TestAmclCore, SinglePrecision) {
+  // clang-format off
+  const auto map = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false,
+    false, false, false, false, false,
+    false, false, true , false, false,
+    false, false, false, false, false,
+    false, false, false, false, false},
+    1.0};
+  // clang-format on
+  auto amcl = beluga::Amcl{
+      beluga::DifferentialDriveModel2f{beluga::DifferentialDriveModelParam{}},         //
+      beluga::LikelihoodFieldModel<StaticOccupancyGrid<5, 5>, Sophus::SE2f>{{}, map},  //
+      []() { return Sophus::SE2f{}; },                                                 //
+      beluga::spatial_hash<Sophus::SE2f>{0.1, 0.1, 0.1},                               //
+      beluga::AmclParams{},                                                            //
+      std::execution::seq,
+  };
+  amcl.initialize(Sophus::SE2f{}, Eigen::Vector3f::Ones().asDiagonal());
+  const auto estimate = amcl.update(Sophus::SE2f{}, std::vector{std::make_pair(0.0F, 0.0F)});
+  ASSERT_TRUE(estimate.has_value());
+  static_assert(std::is_same_v<std::decay_t<decltype(estimate->first)>, Sophus::SE2f>);
+}
+
 TEST(TestAmclCore, TestRandomParticlesInserting) {
   auto params = beluga::AmclParams{};
   params.min_particles = 2;
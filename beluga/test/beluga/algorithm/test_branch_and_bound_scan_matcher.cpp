@@ -0,0 +1,182 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include "beluga/algorithm/branch_and_bound_scan_matcher.hpp"
+#include "beluga/sensor/data/value_grid.hpp"
+
+namespace {
+
+using beluga::BranchAndBoundScanMatcher;
+using beluga::BranchAndBoundScanMatcherParam;
+
+constexpr std::size_t kWidth = 40;
+constexpr std::size_t kHeight = 30;
+constexpr double kResolution = 0.1;
+constexpr float kHit = 1.0F;
+constexpr float kMiss = 0.1F;
+
+// Cells occupied by an asymmetric set of walls, so that the true pose is the only global optimum.
+std::vector<Eigen::Vector2i> make_obstacles() {
+  auto obstacles = std::vector<Eigen::Vector2i>{};
+  for (int xi = 5; xi < 30; ++xi) {
+    obstacles.emplace_back(xi, 4);
+  }
+  for (int yi = 5; yi < 20; ++yi) {
+    obstacles.emplace_back(5, yi);
+  }
+  for (int xi = 20; xi < 26; ++xi) {
+    obstacles.emplace_back(xi, 22);
+  }
+  obstacles.emplace_back(33, 12);
+  obstacles.emplace_back(34, 12);
+  return obstacles;
+}
+
+beluga::ValueGrid2<float> make_likelihood_field(const std::vector<Eigen::Vector2i>& obstacles) {
+  auto data = std::vector<float>(kWidth * kHeight, kMiss);
+  for (const auto& cell : obstacles) {
+    data[static_cast<std::size_t>(cell.y()) * kWidth + static_cast<std::size_t>(cell.x())] = kHit;
+  }
+  return beluga::ValueGrid2<float>{std::move(data), kWidth, kResolution};
+}
+
+std::vector<std::pair<double, double>> make_scan(
+    const std::vector<Eigen::Vector2i>& obstacles,
+    const Sophus::SE2d& origin,
+    const Sophus::SE2d& pose) {
+  auto points = std::vector<std::pair<double, double>>{};
+  for (const auto& cell : obstacles) {
+    const Eigen::Vector2d point_in_map = origin * ((cell.cast<double>().array() + 0.5) * kResolution).matrix();
+    const Eigen::Vector2d point_in_robot = pose.inverse() * point_in_map;
+    points.emplace_back(point_in_robot.x(), point_in_robot.y());
+  }
+  return points;
+}
+
+TEST(BranchAndBoundScanMatcher, PyramidLevelsBoundFinerLevels) {
+  const auto field = make_likelihood_field(make_obstacles());
+  const auto matcher = BranchAndBoundScanMatcher{BranchAndBoundScanMatcherParam{}, field};
+  ASSERT_EQ(matcher.depth(), 6);
+  for (std::size_t level = 1; level < matcher.depth(); ++level) {
+    const int stride = 1 << (level - 1);
+    for (int yi = -stride; yi < static_cast<int>(kHeight); ++yi) {
+      for (int xi = -stride; xi < static_cast<int>(kWidth); ++xi) {
+        const float expected = std::max(
+            std::max(matcher.max_likelihood_at(level - 1, xi, yi), matcher.max_likelihood_at(level - 1, xi + stride, yi)),
+            std::max(
+                matcher.max_likelihood_at(level - 1, xi, yi + stride),
+                matcher.max_likelihood_at(level - 1, xi + stride, yi + stride)));
+        ASSERT_EQ(matcher.max_likelihood_at(level, xi, yi), expected);
+      }
+    }
+  }
+}
+
+TEST(BranchAndBoundScanMatcher, GlobalMatchFindsTruePose) {
+  const auto obstacles = make_obstacles();
+  const auto origin = Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{-1.0, 2.0}};
+  const auto matcher = BranchAndBoundScanMatcher{
+      BranchAndBoundScanMatcherParam{4, Sophus::Constants<double>::pi() / 4, 3, 0.5, 0.5},
+      make_likelihood_field(obstacles), origin};
+
+  // True pose lies on the search lattice: the center of cell (17, 13), rotated by 90 degrees.
+  const auto pose_in_map =
+      Sophus::SE2d{Sophus::SO2d{Sophus::Constants<double>::pi() / 2}, Eigen::Vector2d{1.75, 1.35}};
+  const auto pose = origin * pose_in_map;
+  const auto scan = make_scan(obstacles, origin, pose);
+
+  const auto hypotheses = matcher.match(scan);
+  ASSERT_FALSE(hypotheses.empty());
+  ASSERT_LE(hypotheses.size(), 3);
+  for (std::size_t i = 1; i < hypotheses.size(); ++i) {
+    ASSERT_GE(hypotheses[i - 1].second, hypotheses[i].second);
+  }
+
+  const auto& [best_pose, best_score] = hypotheses.front();
+  ASSERT_NEAR(best_score, static_cast<double>(obstacles.size()), 1e-6);
+  ASSERT_NEAR(best_pose.translation().x(), pose.translation().x(), 1e-6);
+  ASSERT_NEAR(best_pose.translation().y(), pose.translation().y(), 1e-6);
+  ASSERT_NEAR(best_pose.so2().log(), pose.so2().log(), 1e-6);
+  ASSERT_NEAR(matcher.score(scan, best_pose), best_score, 1e-6);
+}
+
+TEST(BranchAndBoundScanMatcher, GlobalMatchAgreesWithExhaustiveSearch) {
+  const auto obstacles = make_obstacles();
+  const auto field = make_likelihood_field(obstacles);
+  const auto params = BranchAndBoundScanMatcherParam{5, Sophus::Constants<double>::pi() / 4, 1, 0.5, 0.5};
+  const auto matcher = BranchAndBoundScanMatcher{params, field};
+
+  // Scan taken from a pose that is not on the search lattice.
+  const auto pose = Sophus::SE2d{Sophus::SO2d{2.2}, Eigen::Vector2d{2.12, 1.57}};
+  const auto scan = make_scan(obstacles, Sophus::SE2d{}, pose);
+
+  double expected_score = 0.0;
+  for (int i = 0; i < 8; ++i) {
+    const auto rotation = Sophus::SO2d{Sophus::Constants<double>::pi() * i / 4};
+    for (std::size_t yi = 0; yi < kHeight; ++yi) {
+      for (std::size_t xi = 0; xi < kWidth; ++xi) {
+        const auto translation = Eigen::Vector2d{
+            (static_cast<double>(xi) + 0.5) * kResolution, (static_cast<double>(yi) + 0.5) * kResolution};
+        expected_score = std::max(expected_score, matcher.score(scan, Sophus::SE2d{rotation, translation}));
+      }
+    }
+  }
+
+  const auto hypotheses = matcher.match(scan);
+  ASSERT_EQ(hypotheses.size(), 1);
+  ASSERT_NEAR(hypotheses.front().second, expected_score, 1e-6);
+}
+
+TEST(BranchAndBoundScanMatcher, WindowedMatchStaysWithinWindow) {
+  const auto obstacles = make_obstacles();
+  const auto matcher = BranchAndBoundScanMatcher{
+      BranchAndBoundScanMatcherParam{3, 0.05, 5, 0.1, 0.1}, make_likelihood_field(obstacles)};
+
+  const auto pose = Sophus::SE2d{Sophus::SO2d{0.1}, Eigen::Vector2d{1.75, 1.35}};
+  const auto scan = make_scan(obstacles, Sophus::SE2d{}, pose);
+  const auto center = Sophus::SE2d{Sophus::SO2d{0.0}, Eigen::Vector2d{1.6, 1.4}};
+
+  const auto hypotheses = matcher.match(scan, center, 0.3, 0.2);
+  ASSERT_FALSE(hypotheses.empty());
+  for (const auto& [hypothesis, score] : hypotheses) {
+    ASSERT_LE(std::abs(hypothesis.translation().x() - center.translation().x()), 0.3 + 1e-9);
+    ASSERT_LE(std::abs(hypothesis.translation().y() - center.translation().y()), 0.3 + 1e-9);
+    ASSERT_LE(std::abs(hypothesis.so2().log()), 0.2 + 0.05 + 1e-9);
+  }
+  const auto& best_pose = hypotheses.front().first;
+  ASSERT_NEAR(best_pose.translation().x(), 1.75, 1e-6);
+  ASSERT_NEAR(best_pose.translation().y(), 1.35, 1e-6);
+  ASSERT_NEAR(best_pose.so2().log(), 0.1, 1e-6);
+}
+
+TEST(BranchAndBoundScanMatcher, EmptyScanYieldsNoHypotheses) {
+  const auto matcher =
+      BranchAndBoundScanMatcher{BranchAndBoundScanMatcherParam{}, make_likelihood_field(make_obstacles())};
+  ASSERT_TRUE(matcher.match({}).empty());
+}
+
+}  // namespace
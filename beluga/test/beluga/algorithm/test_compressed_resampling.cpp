@@ -0,0 +1,171 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <range/v3/range/conversion.hpp>
+
+#include "beluga/actions/normalize.hpp"
+#include "beluga/actions/reweight.hpp"
+#include "beluga/algorithm/compressed_resampling.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/views/elements.hpp"
+#include "beluga/views/particles.hpp"
+
+namespace {
+
+TEST(MultinomialCounts, SumToCount) {
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{0.1, 0.2, 0.0, 0.7};
+  const auto counts = beluga::multinomial_counts(weights, 10'000, engine);
+  ASSERT_EQ(counts.size(), 4U);
+  ASSERT_EQ(std::accumulate(counts.begin(), counts.end(), std::size_t{0}), 10'000U);
+  ASSERT_EQ(counts[2], 0U);
+  ASSERT_NEAR(static_cast<double>(counts[0]), 1'000, 150);
+  ASSERT_NEAR(static_cast<double>(counts[1]), 2'000, 200);
+  ASSERT_NEAR(static_cast<double>(counts[3]), 7'000, 250);
+}
+
+TEST(MultinomialCounts, FollowWeights) {
+  constexpr std::size_t kCount = 100;
+  constexpr std::size_t kTrials = 2'000;
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{1.0, 2.0, 0.0, 3.0, 4.0};
+  const auto expected_proportions = std::vector{0.1, 0.2, 0.0, 0.3, 0.4};
+
+  auto sums = std::vector<double>(weights.size(), 0.0);
+  auto squared_sums = std::vector<double>(weights.size(), 0.0);
+  for (std::size_t trial = 0; trial < kTrials; ++trial) {
+    const auto counts = beluga::multinomial_counts(weights, kCount, engine);
+    for (std::size_t index = 0; index < counts.size(); ++index) {
+      sums[index] += static_cast<double>(counts[index]);
+      squared_sums[index] += static_cast<double>(counts[index] * counts[index]);
+    }
+  }
+
+  // Each count is binomially distributed, with the same mean and variance as when drawing particles one by one.
+  for (std::size_t index = 0; index < weights.size(); ++index) {
+    const double proportion = expected_proportions[index];
+    const double expected_mean = static_cast<double>(kCount) * proportion;
+    const double expected_variance = expected_mean * (1.0 - proportion);
+    const double mean = sums[index] / static_cast<double>(kTrials);
+    const double variance = squared_sums[index] / static_cast<double>(kTrials) - mean * mean;
+    const double standard_error = std::sqrt(expected_variance / static_cast<double>(kTrials));
+    EXPECT_NEAR(mean, expected_mean, 5.0 * standard_error + 1e-9) << "at index " << index;
+    EXPECT_NEAR(variance, expected_variance, 0.15 * expected_variance + 1e-9) << "at index " << index;
+  }
+}
+
+TEST(MultinomialCounts, TrailingZeroWeights) {
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{0.3, 0.3, 0.0, 0.0};
+  const auto counts = beluga::multinomial_counts(weights, 100, engine);
+  ASSERT_EQ(counts[0] + counts[1], 100U);
+  ASSERT_THAT(counts, testing::ElementsAre(testing::_, testing::_, 0U, 0U));
+}
+
+TEST(MultinomialCounts, ZeroWeights) {
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{0.0, 0.0};
+  ASSERT_THAT(beluga::multinomial_counts(weights, 0, engine), testing::ElementsAre(0U, 0U));
+  ASSERT_THROW(beluga::multinomial_counts(weights, 1, engine), std::invalid_argument);
+}
+
+TEST(ResidualCounts, IntegralExpectedCounts) {
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{1.0, 2.0, 0.0, 1.0};
+  ASSERT_THAT(beluga::residual_counts(weights, 8, engine), testing::ElementsAre(2U, 4U, 0U, 2U));
+}
+
+TEST(ResidualCounts, FractionalExpectedCounts) {
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{0.5, 0.25, 0.25};
+  for (int i = 0; i < 10; ++i) {
+    const auto counts = beluga::residual_counts(weights, 6, engine);
+    // Expected counts are 3, 1.5 and 1.5, so the first particle always gets 3 and the others 1 or 2.
+    ASSERT_THAT(counts, testing::ElementsAre(3U, testing::AnyOf(1U, 2U), testing::AnyOf(1U, 2U)));
+    ASSERT_EQ(counts[1] + counts[2], 3U);
+  }
+}
+
+TEST(ResidualCounts, FollowWeights) {
+  constexpr std::size_t kCount = 10;
+  constexpr std::size_t kTrials = 2'000;
+  auto engine = std::mt19937{42};
+  const auto weights = std::vector{0.15, 0.25, 0.6};
+
+  auto sums = std::vector<double>(weights.size(), 0.0);
+  for (std::size_t trial = 0; trial < kTrials; ++trial) {
+    const auto counts = beluga::residual_counts(weights, kCount, engine);
+    for (std::size_t index = 0; index < counts.size(); ++index) {
+      sums[index] += static_cast<double>(counts[index]);
+    }
+  }
+
+  // Residual resampling is unbiased: expected counts are proportional to weights, fractional parts included.
+  for (std::size_t index = 0; index < weights.size(); ++index) {
+    EXPECT_NEAR(sums[index] / static_cast<double>(kTrials), static_cast<double>(kCount) * weights[index], 0.05)
+        << "at index " << index;
+  }
+}
+
+TEST(ResidualCounts, FromParticles) {
+  auto engine = std::mt19937{42};
+  const auto particles = std::vector{
+      std::make_tuple(1, beluga::Weight(0.25)),  //
+      std::make_tuple(2, beluga::Weight(0.75))};
+  ASSERT_THAT(beluga::residual_counts(particles, 4, engine), testing::ElementsAre(1U, 3U));
+}
+
+TEST(Compress, DropsParticlesWithoutCounts) {
+  const auto particles = std::vector{
+      std::make_tuple(1, beluga::Weight(0.2)),  //
+      std::make_tuple(2, beluga::Weight(0.1)),  //
+      std::make_tuple(3, beluga::Weight(0.7))};
+  const auto counts = std::vector<std::size_t>{2, 0, 5};
+  auto compressed = beluga::compress(particles, counts);
+  ASSERT_THAT(compressed | beluga::views::states | ranges::to<std::vector>, testing::ElementsAre(1, 3));
+  ASSERT_THAT(compressed | beluga::views::weights | ranges::to<std::vector>, testing::ElementsAre(2.0, 5.0));
+  ASSERT_THAT(compressed | beluga::views::elements<2> | ranges::to<std::vector>, testing::ElementsAre(2U, 5U));
+}
+
+TEST(Compress, ReweightEachStateOnce) {
+  const auto particles = std::vector{
+      std::make_tuple(1, beluga::Weight(0.5)),  //
+      std::make_tuple(2, beluga::Weight(0.5))};
+  auto compressed = beluga::compress(particles, std::vector<std::size_t>{3, 1});
+
+  std::size_t evaluations = 0;
+  compressed |= beluga::actions::reweight([&evaluations](int state) {
+    ++evaluations;
+    return static_cast<double>(state);
+  }) | beluga::actions::normalize;
+
+  // Same weights as reweighting and normalizing the four particles the compressed set stands for.
+  ASSERT_EQ(evaluations, 2U);
+  ASSERT_THAT(
+      compressed | beluga::views::weights | ranges::to<std::vector>,
+      testing::ElementsAre(testing::DoubleEq(3. / 5.), testing::DoubleEq(2. / 5.)));
+}
+
+}  // namespace
@@ -25,6 +25,7 @@
 #include <range/v3/view/repeat_n.hpp>
 #include <range/v3/view/take_exactly.hpp>
 #include <range/v3/view/transform.hpp>
+#include <type_traits>
 #include <vector>
 
 #include <Eigen/Core>
@@ -244,6 +245,28 @@ TEST_F(PoseCovarianceEstimation, RandomWalkWithSmoothRotationAndNonUniformWeight
   ASSERT_THAT(covariance.col(2).eval(), Vector3Near({0.0000, 0.0000, 0.0855}, kTolerance));
 }
 
+TEST_F(PoseCovarianceEstimation, SinglePrecisionMatchesDoublePrecision) {
+  // test that single precision estimates match double precision ones, for the same states and weights
+  const auto states = std::vector{
+      SE2d{SO2d{Constants::pi() * 0.1}, Vector2d{0.0, -2.0}},  //
+      SE2d{SO2d{Constants::pi() * 0.2}, Vector2d{1.0, -1.0}},  //
+      SE2d{SO2d{Constants::pi() * 0.3}, Vector2d{2.0, 1.0}},   //
+      SE2d{SO2d{Constants::pi() * 0.2}, Vector2d{3.0, 2.0}},   //
+      SE2d{SO2d{Constants::pi() * 0.5}, Vector2d{2.0, 1.0}},   //
+  };
+  const auto single_precision_states =
+      states | ranges::views::transform([](const SE2d& state) { return state.cast<float>(); }) |
+      ranges::to<std::vector>;
+  const auto weights = std::vector{0.1, 0.4, 0.7, 0.1, 0.9};
+  constexpr double kTolerance = 0.0001;
+  const auto [pose, covariance] = beluga::estimate(states, weights);
+  const auto [single_precision_pose, single_precision_covariance] = beluga::estimate(single_precision_states, weights);
+  static_assert(std::is_same_v<std::decay_t<decltype(single_precision_pose)>, Sophus::SE2f>);
+  static_assert(std::is_same_v<std::decay_t<decltype(single_precision_covariance)>, Sophus::Matrix3f>);
+  ASSERT_THAT(single_precision_pose.cast<double>(), SE2Near(pose, kTolerance));
+  ASSERT_TRUE(single_precision_covariance.cast<double>().isApprox(covariance, kTolerance));
+}
+
 struct ScalarEstimation : public testing::Test {};
 
 TEST_F(ScalarEstimation, UniformWeightOverload) {
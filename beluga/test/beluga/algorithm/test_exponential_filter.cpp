@@ -42,4 +42,14 @@ TEST(ExponentialFilter, Reset) {
   ASSERT_NEAR(3.0, filter(3), 0.00001);
 }
 
+TEST(ExponentialFilter, ResetToOutput) {
+  auto filter = beluga::ExponentialFilter{0.1};
+  ASSERT_NEAR(1.0, filter(1), 0.00001);
+  ASSERT_NEAR(1.1, filter(2), 0.00001);
+  auto other_filter = beluga::ExponentialFilter{0.1};
+  other_filter.reset(filter.output());
+  ASSERT_DOUBLE_EQ(other_filter.output(), 1.1);
+  ASSERT_NEAR(filter(3), other_filter(3), 0.00001);
+}
+
 }  // namespace
@@ -0,0 +1,154 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include "beluga/algorithm/gauss_newton_scan_matcher.hpp"
+#include "beluga/sensor/data/value_grid.hpp"
+
+namespace {
+
+using beluga::GaussNewtonScanMatcher;
+using beluga::GaussNewtonScanMatcherParam;
+
+constexpr std::size_t kWidth = 60;
+constexpr std::size_t kHeight = 50;
+constexpr double kResolution = 0.05;
+constexpr double kSigma = 0.1;
+
+// Wall segments, in meters and along cell centers, that make up an L-shaped room corner plus a pillar.
+std::vector<Eigen::Vector2d> make_obstacles() {
+  constexpr double kSpacing = 0.025;
+  auto obstacles = std::vector<Eigen::Vector2d>{};
+  for (int i = 0; i < 79; ++i) {
+    obstacles.emplace_back(0.525 + i * kSpacing, 0.525);
+  }
+  for (int i = 1; i < 59; ++i) {
+    obstacles.emplace_back(0.525, 0.525 + i * kSpacing);
+  }
+  for (int i = 0; i < 12; ++i) {
+    obstacles.emplace_back(2.225, 1.2 + i * kSpacing);
+  }
+  return obstacles;
+}
+
+// A smooth likelihood field, gaussian on the distance to the nearest obstacle.
+beluga::ValueGrid2<float> make_likelihood_field(const std::vector<Eigen::Vector2d>& obstacles) {
+  auto data = std::vector<float>{};
+  data.reserve(kWidth * kHeight);
+  for (std::size_t yi = 0; yi < kHeight; ++yi) {
+    for (std::size_t xi = 0; xi < kWidth; ++xi) {
+      const auto center = Eigen::Vector2d{
+          (static_cast<double>(xi) + 0.5) * kResolution, (static_cast<double>(yi) + 0.5) * kResolution};
+      double squared_distance = std::numeric_limits<double>::infinity();
+      for (const auto& obstacle : obstacles) {
+        squared_distance = std::min(squared_distance, (center - obstacle).squaredNorm());
+      }
+      data.push_back(static_cast<float>(std::exp(-squared_distance / (2.0 * kSigma * kSigma))));
+    }
+  }
+  return beluga::ValueGrid2<float>{std::move(data), kWidth, kResolution};
+}
+
+std::vector<std::pair<double, double>> make_scan(
+    const std::vector<Eigen::Vector2d>& obstacles,
+    const Sophus::SE2d& origin,
+    const Sophus::SE2d& pose) {
+  auto points = std::vector<std::pair<double, double>>{};
+  for (std::size_t i = 0; i < obstacles.size(); i += 3) {
+    const Eigen::Vector2d point_in_robot = pose.inverse() * (origin * obstacles[i]);
+    points.emplace_back(point_in_robot.x(), point_in_robot.y());
+  }
+  return points;
+}
+
+TEST(GaussNewtonScanMatcher, ScoreMatchesFieldAtCellCenters) {
+  const auto field = make_likelihood_field(make_obstacles());
+  const auto matcher = GaussNewtonScanMatcher{GaussNewtonScanMatcherParam{}, field};
+  const auto points = std::vector<std::pair<double, double>>{{0.525, 0.525}, {1.025, 0.775}};
+  const double expected = static_cast<double>(field.data()[10 * kWidth + 10] + field.data()[15 * kWidth + 20]);
+  ASSERT_NEAR(matcher.score(points, Sophus::SE2d{}), expected, 1e-6);
+}
+
+TEST(GaussNewtonScanMatcher, RefinementConvergesToTruePose) {
+  const auto obstacles = make_obstacles();
+  const auto origin = Sophus::SE2d{Sophus::SO2d{0.2}, Eigen::Vector2d{-1.0, 0.5}};
+  const auto field = make_likelihood_field(obstacles);
+  auto params = GaussNewtonScanMatcherParam{};
+  params.max_iterations = 20;
+  const auto matcher = GaussNewtonScanMatcher{params, field, origin};
+
+  const auto pose = origin * Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{1.3, 1.1}};
+  const auto scan = make_scan(obstacles, origin, pose);
+  const auto initial_pose = pose * Sophus::SE2d{Sophus::SO2d{0.04}, Eigen::Vector2d{0.06, -0.05}};
+
+  const auto refined_pose = matcher.refine(scan, initial_pose);
+  const auto initial_error = pose.inverse() * initial_pose;
+  const auto refined_error = pose.inverse() * refined_pose;
+  ASSERT_LT(refined_error.translation().norm(), 0.2 * initial_error.translation().norm());
+  ASSERT_LT(std::abs(refined_error.so2().log()), 0.2 * std::abs(initial_error.so2().log()));
+  ASSERT_GT(matcher.score(scan, refined_pose), matcher.score(scan, initial_pose));
+}
+
+TEST(GaussNewtonScanMatcher, RefinementNeverWorsensScore) {
+  const auto obstacles = make_obstacles();
+  const auto field = make_likelihood_field(obstacles);
+  const auto matcher = GaussNewtonScanMatcher{GaussNewtonScanMatcherParam{}, field};
+  const auto pose = Sophus::SE2d{Sophus::SO2d{-0.1}, Eigen::Vector2d{1.4, 1.2}};
+  const auto scan = make_scan(obstacles, Sophus::SE2d{}, pose);
+  for (const auto& offset : {Sophus::SE2d{Sophus::SO2d{0.0}, Eigen::Vector2d{0.0, 0.0}},
+                             Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{0.2, 0.1}},
+                             Sophus::SE2d{Sophus::SO2d{-0.5}, Eigen::Vector2d{-0.4, 0.3}}}) {
+    const auto initial_pose = pose * offset;
+    ASSERT_GE(matcher.score(scan, matcher.refine(scan, initial_pose)), matcher.score(scan, initial_pose));
+  }
+}
+
+TEST(GaussNewtonScanMatcher, RefinementIsBoundedByCorrectionLimits) {
+  const auto obstacles = make_obstacles();
+  const auto field = make_likelihood_field(obstacles);
+  auto params = GaussNewtonScanMatcherParam{};
+  params.max_iterations = 20;
+  params.max_linear_correction = 0.01;
+  const auto matcher = GaussNewtonScanMatcher{params, field};
+  const auto pose = Sophus::SE2d{Sophus::SO2d{0.0}, Eigen::Vector2d{1.3, 1.1}};
+  const auto scan = make_scan(obstacles, Sophus::SE2d{}, pose);
+  const auto initial_pose = pose * Sophus::SE2d{Sophus::SO2d{0.0}, Eigen::Vector2d{0.08, 0.0}};
+  const auto refined_pose = matcher.refine(scan, initial_pose);
+  ASSERT_TRUE(refined_pose.translation().isApprox(initial_pose.translation()));
+  ASSERT_NEAR(refined_pose.so2().log(), initial_pose.so2().log(), 1e-9);
+}
+
+TEST(GaussNewtonScanMatcher, EmptyScanYieldsInitialPose) {
+  const auto field = make_likelihood_field(make_obstacles());
+  const auto matcher = GaussNewtonScanMatcher{GaussNewtonScanMatcherParam{}, field};
+  const auto initial_pose = Sophus::SE2d{Sophus::SO2d{0.5}, Eigen::Vector2d{1.0, 2.0}};
+  const auto refined_pose = matcher.refine({}, initial_pose);
+  ASSERT_TRUE(refined_pose.translation().isApprox(initial_pose.translation()));
+  ASSERT_NEAR(refined_pose.so2().log(), initial_pose.so2().log(), 1e-9);
+}
+
+}  // namespace
@@ -0,0 +1,101 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <execution>
+#include <random>
+#include <tuple>
+
+#include <Eigen/Core>
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include <range/v3/algorithm/all_of.hpp>
+#include <range/v3/algorithm/equal.hpp>
+
+#include "beluga/algorithm/estimation.hpp"
+#include "beluga/algorithm/generate_particles.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/random/multivariate_normal_distribution.hpp"
+#include "beluga/views/particles.hpp"
+
+namespace {
+
+using Particle = std::tuple<Sophus::SE2d, beluga::Weight>;
+
+// A distribution without bulk generation support.
+struct ConstantDistribution {
+  Sophus::SE2d state;
+
+  template <class Generator>
+  Sophus::SE2d operator()(Generator&) const {
+    return state;
+  }
+};
+
+TEST(GenerateParticles, SizeAndWeights) {
+  constexpr std::size_t kCount = 10'000;
+  const auto distribution = beluga::MultivariateNormalDistribution{Sophus::SE2d{}, Eigen::Matrix3d::Identity()};
+  const auto particles = beluga::generate_particles<Particle>(std::execution::seq, distribution, kCount);
+  ASSERT_EQ(particles.size(), kCount);
+  ASSERT_TRUE(ranges::all_of(beluga::views::weights(particles), [](auto weight) { return weight == 1.0; }));
+}
+
+TEST(GenerateParticles, EmptySet) {
+  const auto distribution = beluga::MultivariateNormalDistribution{Sophus::SE2d{}, Eigen::Matrix3d::Identity()};
+  const auto particles = beluga::generate_particles<Particle>(std::execution::par, distribution, 0);
+  ASSERT_EQ(particles.size(), 0);
+}
+
+TEST(GenerateParticles, SameResultsRegardlessOfExecutionPolicy) {
+  constexpr std::size_t kCount = 50'000;
+  constexpr std::mt19937::result_type kSeed = 42;
+  const auto distribution = beluga::MultivariateNormalDistribution{
+      Sophus::SE2d{Sophus::SO2d{0.5}, Eigen::Vector2d{1.0, 2.0}}, Eigen::Matrix3d::Identity()};
+  const auto sequential = beluga::generate_particles<Particle>(std::execution::seq, distribution, kCount, kSeed);
+  const auto parallel = beluga::generate_particles<Particle>(std::execution::par, distribution, kCount, kSeed);
+  ASSERT_TRUE(ranges::equal(
+      beluga::views::states(sequential), beluga::views::states(parallel),
+      [](const auto& first, const auto& second) { return first.log() == second.log(); }));
+}
+
+TEST(GenerateParticles, SampleMeanAndCovariance) {
+  constexpr std::size_t kCount = 100'000;
+  constexpr double kTolerance = 0.02;
+  const auto expected_mean = Sophus::SE2d{Sophus::SO2d{0.5}, Eigen::Vector2d{1.0, 2.0}};
+  const Eigen::Matrix3d expected_covariance = Eigen::Vector3d{0.25, 0.5, 0.1}.asDiagonal();
+  const auto distribution = beluga::MultivariateNormalDistribution{expected_mean, expected_covariance};
+  const auto particles = beluga::generate_particles<Particle>(std::execution::par, distribution, kCount);
+  const auto [mean, covariance] = beluga::estimate(beluga::views::states(particles));
+  ASSERT_NEAR(mean.translation().x(), expected_mean.translation().x(), kTolerance);
+  ASSERT_NEAR(mean.translation().y(), expected_mean.translation().y(), kTolerance);
+  ASSERT_NEAR(mean.so2().log(), expected_mean.so2().log(), kTolerance);
+  ASSERT_NEAR(covariance(0, 0), expected_covariance(0, 0), kTolerance);
+  ASSERT_NEAR(covariance(1, 1), expected_covariance(1, 1), kTolerance);
+  ASSERT_NEAR(covariance(2, 2), expected_covariance(2, 2), kTolerance);
+}
+
+TEST(GenerateParticles, DistributionWithoutBulkGeneration) {
+  constexpr std::size_t kCount = 5'000;
+  const auto state = Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{1.0, -1.0}};
+  const auto particles = beluga::generate_particles<Particle>(std::execution::par, ConstantDistribution{state}, kCount);
+  ASSERT_EQ(particles.size(), kCount);
+  ASSERT_TRUE(ranges::all_of(
+      beluga::views::states(particles), [&state](const auto& value) { return value.log() == state.log(); }));
+}
+
+}  // namespace
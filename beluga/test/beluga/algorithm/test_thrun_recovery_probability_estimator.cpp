@@ -69,6 +69,24 @@ TEST(ThrunRecoveryProbabilityEstimator, ProbabilityAfterUpdateAndReset) {
   ASSERT_EQ(estimator(input), 0.0);  // Test the probability after resetting the estimator.
 }
 
+TEST(ThrunRecoveryProbabilityEstimator, ProbabilityAfterRestore) {
+  const double alpha_slow = 0.5;
+  const double alpha_fast = 1.0;
+  auto estimator = beluga::ThrunRecoveryProbabilityEstimator{alpha_slow, alpha_fast};
+  auto input = std::vector<std::tuple<int, beluga::Weight>>{{5, 1.0}, {6, 2.0}, {7, 3.0}};
+  ASSERT_EQ(estimator(input), 0.0);
+  ASSERT_DOUBLE_EQ(estimator.slow_average(), 2.0);
+  ASSERT_DOUBLE_EQ(estimator.fast_average(), 2.0);
+
+  // Test that a restored estimator picks up where the original left off.
+  auto restored_estimator = beluga::ThrunRecoveryProbabilityEstimator{alpha_slow, alpha_fast};
+  restored_estimator.reset(estimator.slow_average(), estimator.fast_average());
+  input = std::vector<std::tuple<int, beluga::Weight>>{{5, 0.5}, {6, 1.0}, {7, 1.5}};
+  const double probability = restored_estimator(input);
+  ASSERT_NEAR(probability, 0.33, 0.01);
+  ASSERT_DOUBLE_EQ(probability, estimator(input));
+}
+
 class ThrunRecoveryProbabilityWithParam : public ::testing::TestWithParam<std::tuple<double, double, double>> {};
 
 TEST_P(ThrunRecoveryProbabilityWithParam, Probabilities) {
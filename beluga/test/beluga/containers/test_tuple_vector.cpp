@@ -32,7 +32,10 @@
 #include <range/v3/view/all.hpp>
 #include <range/v3/view/const.hpp>
 #include <range/v3/view/filter.hpp>
+#include <range/v3/view/iota.hpp>
+#include <range/v3/view/transform.hpp>
 
+#include "beluga/containers/default_init_allocator.hpp"
 #include "beluga/containers/tuple_vector.hpp"
 #include "beluga/primitives.hpp"
 #include "beluga/views/particles.hpp"
@@ -267,4 +270,69 @@ TEST(TupleVectorTest, AssignFromNonSizedRangeReserved) {
   ASSERT_TRUE(ranges::equal(input, output));
 }
 
+TEST(TupleVectorTest, AssignFromNonSizedRangeKeepsCapacity) {
+  auto input = std::array{std::make_tuple(1, 1.0), std::make_tuple(2, 2.0), std::make_tuple(3, 3.0)};
+  auto output = beluga::TupleVector<std::tuple<int, double>>{};
+  output.reserve(8);
+  output.assign_range(input | ranges::views::filter([](auto) { return true; }));
+  ASSERT_TRUE(ranges::equal(input, output));
+  ASSERT_EQ(output.capacity(), 8);
+}
+
+TEST(TupleVectorTest, AssignFromLargeNonSizedRange) {
+  auto input = ranges::views::iota(0, 1000) | ranges::views::transform([](int i) {
+                 return std::make_tuple(i, static_cast<double>(i) / 2.0);
+               });
+  auto output = beluga::TupleVector<std::tuple<int, double>>{};
+  output.resize(10);
+  output.assign_range(input | ranges::views::filter([](auto) { return true; }));
+  ASSERT_EQ(output.size(), 1000);
+  ASSERT_TRUE(ranges::equal(input, output));
+}
+
+TEST(TupleVectorTest, PushBackMovesElements) {
+  struct CopyCounter {
+    CopyCounter() = default;
+    CopyCounter(const CopyCounter& other) : copies{other.copies + 1} {}
+    CopyCounter(CopyCounter&& other) noexcept : copies{other.copies} {}
+    CopyCounter& operator=(const CopyCounter& other) {
+      copies = other.copies + 1;
+      return *this;
+    }
+    CopyCounter& operator=(CopyCounter&& other) noexcept {
+      copies = other.copies;
+      return *this;
+    }
+    ~CopyCounter() = default;
+    int copies = 0;
+  };
+
+  auto container = beluga::TupleVector<std::tuple<CopyCounter, int>>{};
+  container.reserve(2);
+  container.push_back(std::make_tuple(CopyCounter{}, 1));
+  auto value = std::make_tuple(CopyCounter{}, 2);
+  container.push_back(value);
+  ASSERT_EQ(container.size(), 2);
+  EXPECT_EQ(std::get<0>(ranges::views::all(container).front()).copies, 0);
+  EXPECT_EQ(std::get<0>(ranges::views::all(container).back()).copies, 1);
+}
+
+TEST(TupleVectorTest, CustomAllocator) {
+  using Element = std::tuple<State, int, double>;
+  auto container = beluga::TupleVector<Element, beluga::DefaultInitAllocator<Element>>{};
+  container.resize(3);
+  ASSERT_EQ(container.size(), 3);
+  for (auto&& [state, integer, real] : container) {
+    ASSERT_THAT(state, StateEq(State{}));
+    integer = 1;
+    real = 2.0;
+  }
+  container.push_back({{1, 2}, 3, 4.0});
+  ASSERT_EQ(container.size(), 4);
+  auto&& [state, integer, real] = ranges::views::all(container).back();
+  EXPECT_THAT(state, StateEq({1, 2}));
+  EXPECT_EQ(integer, 3);
+  EXPECT_EQ(real, 4.0);
+}
+
 }  // namespace
@@ -20,6 +20,7 @@
 #include <random>
 #include <sophus/se3.hpp>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include <Eigen/Core>
@@ -104,6 +105,22 @@ TEST_F(DifferentialDriveModelTest, RotateTranslateRotate) {
   ASSERT_THAT(result, SE2Near(SO2d{Constants::pi() / 2}, Vector2d{2.0, 2.0}, kTolerance));
 }
 
+TEST(DifferentialDriveModelSinglePrecision, RotateTranslateRotate) {
+  constexpr float kTolerance = 0.001F;
+  const auto motion_model = beluga::DifferentialDriveModel2f{beluga::DifferentialDriveModelParam{0.0, 0.0, 0.0, 0.0}};
+  auto generator = std::mt19937{std::random_device()()};
+  const auto control_action = std::make_tuple(
+      Sophus::SE2f{Sophus::SO2f{static_cast<float>(-Constants::pi() / 2)}, Eigen::Vector2f{1.0F, 2.0F}},
+      Sophus::SE2f{Sophus::SO2f{0.0F}, Eigen::Vector2f{0.0F, 0.0F}});
+  const auto state_sampling_function = motion_model(control_action);
+  const auto result = state_sampling_function(
+      Sophus::SE2f{Sophus::SO2f{static_cast<float>(Constants::pi())}, Eigen::Vector2f{3.0F, 4.0F}}, generator);
+  static_assert(std::is_same_v<std::decay_t<decltype(result)>, Sophus::SE2f>);
+  ASSERT_NEAR(result.translation().x(), 2.0F, kTolerance);
+  ASSERT_NEAR(result.translation().y(), 2.0F, kTolerance);
+  ASSERT_NEAR(result.so2().log(), static_cast<float>(Constants::pi() / 2), kTolerance);
+}
+
 template <class Range>
 auto get_statistics(Range&& range) {
   const auto size = static_cast<double>(std::distance(std::begin(range), std::end(range)));
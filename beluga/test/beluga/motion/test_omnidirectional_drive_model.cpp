@@ -19,6 +19,7 @@
 #include <functional>
 #include <random>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include <range/v3/view/common.hpp>
@@ -41,7 +42,7 @@ using Sophus::SE2d;
 using Sophus::SO2d;
 
 using beluga::testing::SE2Near;
-using UUT = beluga::OmnidirectionalDriveModel;
+using UUT = beluga::OmnidirectionalDriveModel2d;
 
 class OmnidirectionalDriveModelTest : public ::testing::Test {
  protected:
@@ -112,6 +113,23 @@ auto get_statistics(Range&& range) {
   return std::pair{mean, stddev};
 }
 
+TEST(OmnidirectionalDriveModelSinglePrecision, TranslateStrafe) {
+  constexpr float kTolerance = 0.001F;
+  const auto motion_model =
+      beluga::OmnidirectionalDriveModel2f{beluga::OmnidirectionalDriveModelParam{0.0, 0.0, 0.0, 0.0, 0.0}};
+  auto generator = std::mt19937{std::random_device()()};
+  const auto control_action = std::make_tuple(
+      Sophus::SE2f{Sophus::SO2f{0.0F}, Eigen::Vector2f{1.0F, 1.0F}},
+      Sophus::SE2f{Sophus::SO2f{0.0F}, Eigen::Vector2f{0.0F, 0.0F}});
+  const auto state_sampling_function = motion_model(control_action);
+  const auto result =
+      state_sampling_function(Sophus::SE2f{Sophus::SO2f{0.0F}, Eigen::Vector2f{2.0F, 3.0F}}, generator);
+  static_assert(std::is_same_v<std::decay_t<decltype(result)>, Sophus::SE2f>);
+  ASSERT_NEAR(result.translation().x(), 3.0F, kTolerance);
+  ASSERT_NEAR(result.translation().y(), 4.0F, kTolerance);
+  ASSERT_NEAR(result.so2().log(), 0.0F, kTolerance);
+}
+
 TEST(OmnidirectionalDriveModelSamples, Translate) {
   const double tolerance = 0.01;
   const double alpha = 0.2;
@@ -40,6 +40,20 @@ TEST(OnMotionPolicy, NoTriggerWithoutMotion2D) {
   ASSERT_FALSE(policy(pose2));  // Small motion should not trigger the policy
 }
 
+TEST(OnMotionPolicy, RollBackLatestPose2D) {
+  auto policy = beluga::policies::on_motion<Sophus::SE2d>(0.1, 0.05);
+  const Sophus::SE2d pose1(Sophus::SO2d(0.2), Eigen::Vector2d(1.0, 2.0));
+  const Sophus::SE2d pose2(Sophus::SO2d(0.25), Eigen::Vector2d(1.2, 2.2));
+
+  ASSERT_FALSE(policy.latest_pose().has_value());
+  ASSERT_TRUE(policy(pose1));
+  const auto latest_pose = policy.latest_pose();
+  ASSERT_TRUE(policy(pose2));
+  policy.set_latest_pose(latest_pose);  // Roll back the last decision
+  ASSERT_TRUE(policy(pose2));           // Second pose triggers the policy again
+  ASSERT_FALSE(policy(pose2));
+}
+
 TEST(OnMotionPolicy, TriggerOnMotion3D) {
   auto policy = beluga::policies::on_motion<Sophus::SE3d>(0.1, 0.05);
   const Sophus::SE3d pose1(Sophus::SO3d::rotX(0.2), Eigen::Vector3d(1.0, 2.0, 0.));
@@ -89,6 +89,26 @@ TEST_P(MultivariateNormalDistributionWithParam, DistributionCovarianceAndMean) {
   ASSERT_NEAR(covariance(1, 1), expected_covariance(1, 1), kTolerance);
 }
 
+TEST_P(MultivariateNormalDistributionWithParam, BulkDistributionCovarianceAndMean) {
+  constexpr double kTolerance = 0.01;
+  const Eigen::Vector2d& expected_mean = std::get<0>(GetParam());
+  const Eigen::Matrix2d& expected_covariance = std::get<1>(GetParam());
+  const auto distribution = beluga::MultivariateNormalDistribution{expected_mean, expected_covariance};
+  auto generator = std::mt19937{std::random_device()()};
+  auto sequence = std::vector<Eigen::Vector2d>(1'000'000);
+  distribution.generate(sequence.begin(), sequence.end(), generator);
+
+  const auto sum = std::accumulate(sequence.begin(), sequence.end(), Eigen::Vector2d{0, 0});
+  const auto mean = Eigen::Vector2d{sum / sequence.size()};
+  ASSERT_NEAR(mean(0), expected_mean(0), kTolerance);
+  ASSERT_NEAR(mean(1), expected_mean(1), kTolerance);
+  const auto covariance = beluga::covariance(sequence, mean);
+  ASSERT_NEAR(covariance(0, 0), expected_covariance(0, 0), kTolerance);
+  ASSERT_NEAR(covariance(0, 1), expected_covariance(0, 1), kTolerance);
+  ASSERT_NEAR(covariance(1, 0), expected_covariance(1, 0), kTolerance);
+  ASSERT_NEAR(covariance(1, 1), expected_covariance(1, 1), kTolerance);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     MeanCovariancePairs,
     MultivariateNormalDistributionWithParam,
@@ -108,6 +128,19 @@ TEST(MultivariateNormalDistribution, RowVector) {
   ASSERT_NEAR(mean(1), expected_mean(1), kTolerance);
 }
 
+TEST(MultivariateNormalDistribution, BulkRowVector) {
+  constexpr double kTolerance = 0.001;
+  auto generator = std::mt19937{std::random_device()()};
+  auto expected_mean = Eigen::RowVector2d{1.0, 2.0};
+  const auto distribution = beluga::MultivariateNormalDistribution{expected_mean, Eigen::Matrix2d::Zero()};
+  auto sequence = std::vector<Eigen::RowVector2d>(3);
+  distribution.generate(sequence.begin(), sequence.end(), generator);
+  for (const auto& value : sequence) {
+    ASSERT_NEAR(value(0), expected_mean(0), kTolerance);
+    ASSERT_NEAR(value(1), expected_mean(1), kTolerance);
+  }
+}
+
 TEST(MultivariateNormalDistribution, SO2Element) {
   constexpr double kTolerance = 0.001;
   auto generator = std::mt19937{std::random_device()()};
@@ -128,6 +161,20 @@ TEST(MultivariateNormalDistribution, SE2Element) {
   ASSERT_NEAR(mean.translation()(1), expected_mean.translation()(1), kTolerance);
 }
 
+TEST(MultivariateNormalDistribution, BulkSE2Element) {
+  constexpr double kTolerance = 0.001;
+  auto generator = std::mt19937{std::random_device()()};
+  auto expected_mean = Sophus::SE2d{Sophus::SO2d{1.57}, Eigen::Vector2d{1.0, 2.0}};
+  const auto distribution = beluga::MultivariateNormalDistribution{expected_mean, Eigen::Matrix3d::Zero()};
+  auto sequence = std::vector<Sophus::SE2d>(5);
+  distribution.generate(sequence.begin(), sequence.end(), generator);
+  for (const auto& value : sequence) {
+    ASSERT_NEAR(value.so2().log(), expected_mean.so2().log(), kTolerance);
+    ASSERT_NEAR(value.translation()(0), expected_mean.translation()(0), kTolerance);
+    ASSERT_NEAR(value.translation()(1), expected_mean.translation()(1), kTolerance);
+  }
+}
+
 TEST(MultivariateNormalDistribution, SO3Element) {
   auto generator = std::mt19937{std::random_device()()};
   auto expected_mean = Sophus::SO3d::exp(Eigen::Vector3d{0.5, 1.0, 1.5});
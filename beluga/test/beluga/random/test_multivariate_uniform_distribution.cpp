@@ -15,13 +15,22 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <functional>
+#include <map>
+#include <stdexcept>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <range/v3/range/primitives.hpp>
 #include <range/v3/view/take_exactly.hpp>
 
 #include "beluga/random/multivariate_uniform_distribution.hpp"
+#include "beluga/sensor/data/sparse_value_grid.hpp"
 #include "beluga/test/static_occupancy_grid.hpp"
 #include "beluga/testing/sophus_matchers.hpp"
 #include "beluga/views/sample.hpp"
@@ -42,6 +51,42 @@ TEST(MultivariateUniformDistribution, BoundingRegion2d) {
   ASSERT_THAT(pose.translation(), Vector2Near(region.min(), kTolerance));
 }
 
+TEST(MultivariateUniformDistribution, BulkBoundingRegion2d) {
+  constexpr double kTolerance = 0.01;
+  auto region = Eigen::AlignedBox2d{};
+  region.min() = Eigen::Vector2d{3.00, -2.00};
+  region.max() = region.min() + kTolerance * Eigen::Vector2d::Ones();
+  const auto distribution = beluga::MultivariateUniformDistribution{region};
+  auto engine = std::mt19937{std::random_device()()};
+  auto poses = std::vector<Sophus::SE2d>(10);
+  distribution.generate(poses.begin(), poses.end(), engine);
+  for (const auto& pose : poses) {
+    ASSERT_THAT(pose.translation(), Vector2Near(region.min(), kTolerance));
+    ASSERT_NEAR(pose.so2().unit_complex().norm(), 1.0, 1e-9);
+  }
+}
+
+TEST(MultivariateUniformDistribution, StratifiedBoundingRegion2d) {
+  constexpr std::size_t kSize = 1'000;
+  auto region = Eigen::AlignedBox2d{};
+  region.min() = Eigen::Vector2d{0.0, 0.0};
+  region.max() = Eigen::Vector2d{1.0, 2.0};
+  const auto distribution = beluga::MultivariateUniformDistribution{region, true};
+  auto engine = std::mt19937{std::random_device()()};
+  auto poses = std::vector<Sophus::SE2d>(kSize);
+  distribution.generate(poses.begin(), poses.end(), engine);
+
+  // Stratified poses cover every quadrant of the region evenly.
+  auto quadrants = std::array<std::size_t, 4>{};
+  for (const auto& pose : poses) {
+    ASSERT_TRUE(region.contains(pose.translation()));
+    ++quadrants[(pose.translation().x() > 0.5 ? 1 : 0) + (pose.translation().y() > 1.0 ? 2 : 0)];
+  }
+  for (const auto count : quadrants) {
+    ASSERT_NEAR(static_cast<double>(count), kSize / 4.0, 10.0);
+  }
+}
+
 TEST(MultivariateUniformDistribution, BoundingRegion3d) {
   constexpr double kTolerance = 0.01;
   auto region = Eigen::AlignedBox3d{};
@@ -53,6 +98,22 @@ TEST(MultivariateUniformDistribution, BoundingRegion3d) {
   ASSERT_THAT(pose.translation(), Vector3Near(region.min(), kTolerance));
 }
 
+TEST(MultivariateUniformDistribution, BulkBoundingRegion3d) {
+  constexpr double kTolerance = 0.01;
+  auto region = Eigen::AlignedBox3d{};
+  region.min() = Eigen::Vector3d{3.00, -2.00, 1.00};
+  region.max() = region.min() + kTolerance * Eigen::Vector3d::Ones();
+  for (const bool stratified : {false, true}) {
+    const auto distribution = beluga::MultivariateUniformDistribution{region, stratified};
+    auto engine = std::mt19937{std::random_device()()};
+    auto poses = std::vector<Sophus::SE3d>(10);
+    distribution.generate(poses.begin(), poses.end(), engine);
+    for (const auto& pose : poses) {
+      ASSERT_THAT(pose.translation(), Vector3Near(region.min(), kTolerance));
+    }
+  }
+}
+
 TEST(MultivariateUniformDistribution, GridSingleSlot) {
   constexpr double kTolerance = 0.001;
   constexpr double kResolution = 0.5;
@@ -81,6 +142,12 @@ TEST(MultivariateUniformDistribution, GridSingleFreeSlot) {
   ASSERT_THAT(pose.translation(), Vector2Near({2.5, 2.5}, kTolerance));
 }
 
+TEST(MultivariateUniformDistribution, GridWithoutFreeSlots) {
+  constexpr double kResolution = 1.0;
+  const auto grid = beluga::testing::StaticOccupancyGrid<2, 2>{{true, true, true, true}, kResolution};
+  ASSERT_THROW(beluga::MultivariateUniformDistribution{grid}, std::invalid_argument);
+}
+
 TEST(MultivariateUniformDistribution, GridSomeFreeSlots) {
   constexpr std::size_t kSize = 100'000;
   constexpr double kResolution = 1.0;
@@ -123,4 +190,124 @@ TEST(MultivariateUniformDistribution, GridSomeFreeSlots) {
   ASSERT_NEAR(static_cast<double>(buckets[Sophus::Vector2d(1.5, 2.5)]) / kSize, 0.25, kTolerance);
 }
 
+TEST(MultivariateUniformDistribution, BulkGridSomeFreeSlots) {
+  constexpr std::size_t kSize = 100'000;
+  constexpr double kResolution = 1.0;
+  const auto grid = beluga::testing::StaticOccupancyGrid<3, 3>{
+      {true, false, true,   //
+       false, true, false,  //
+       true, false, true},
+      kResolution,
+  };
+  const auto distribution = beluga::MultivariateUniformDistribution{grid};
+
+  auto engine = std::mt19937{std::random_device()()};
+  auto poses = std::vector<Sophus::SE2d>(kSize);
+  distribution.generate(poses.begin(), poses.end(), engine);
+
+  std::map<std::pair<double, double>, std::size_t> buckets;
+  double angle_sum = 0.0;
+  for (const auto& pose : poses) {
+    ++buckets[std::make_pair(pose.translation().x(), pose.translation().y())];
+    angle_sum += std::abs(pose.so2().log());
+  }
+
+  constexpr double kTolerance = 0.01;
+  ASSERT_EQ(ranges::size(buckets), 4);
+  ASSERT_NEAR(static_cast<double>(buckets[std::make_pair(1.5, 0.5)]) / kSize, 0.25, kTolerance);
+  ASSERT_NEAR(static_cast<double>(buckets[std::make_pair(0.5, 1.5)]) / kSize, 0.25, kTolerance);
+  ASSERT_NEAR(static_cast<double>(buckets[std::make_pair(2.5, 1.5)]) / kSize, 0.25, kTolerance);
+  ASSERT_NEAR(static_cast<double>(buckets[std::make_pair(1.5, 2.5)]) / kSize, 0.25, kTolerance);
+  // Uniformly distributed angles in [-pi, pi) have a mean absolute value of pi / 2.
+  ASSERT_NEAR(angle_sum / kSize, Sophus::Constants<double>::pi() / 2.0, kTolerance);
+}
+
+TEST(MultivariateUniformDistribution, StratifiedGridCoverage) {
+  constexpr double kResolution = 1.0;
+  const auto grid = beluga::testing::StaticOccupancyGrid<3, 3>{
+      {true, false, true,   //
+       false, true, false,  //
+       true, false, true},
+      kResolution,
+  };
+  const auto distribution = beluga::MultivariateUniformDistribution{grid, true};
+
+  // As many poses as free cells yields exactly one pose per free cell.
+  auto engine = std::mt19937{std::random_device()()};
+  auto poses = std::vector<Sophus::SE2d>(4);
+  distribution.generate(poses.begin(), poses.end(), engine);
+
+  std::map<std::pair<double, double>, std::size_t> buckets;
+  for (const auto& pose : poses) {
+    ++buckets[std::make_pair(pose.translation().x(), pose.translation().y())];
+  }
+  ASSERT_EQ(ranges::size(buckets), 4);
+  for (const auto& [cell, count] : buckets) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+struct CellHash {
+  template <int NDim>
+  std::size_t operator()(const Eigen::Vector<int, NDim>& cell) const {
+    std::size_t seed = 0;
+    for (int i = 0; i < NDim; ++i) {
+      seed = seed * 31 + std::hash<int>{}(cell[i]);
+    }
+    return seed;
+  }
+};
+
+template <int NDim>
+using SparseGrid = beluga::SparseValueGrid<std::unordered_map<Eigen::Vector<int, NDim>, double, CellHash>, NDim>;
+
+TEST(MultivariateUniformDistribution, SparseGrid2d) {
+  constexpr std::size_t kSize = 10'000;
+  const auto grid = SparseGrid<2>{{{Eigen::Vector2i{0, 0}, 1.0}, {Eigen::Vector2i{2, 1}, 1.0}}, 0.5};
+  auto distribution = beluga::MultivariateUniformDistribution{grid};
+
+  auto engine = std::mt19937{std::random_device()()};
+  auto poses = std::vector<Sophus::SE2d>(kSize);
+  distribution.generate(poses.begin(), poses.end() - kSize / 2, engine);
+  std::generate(poses.end() - kSize / 2, poses.end(), [&]() { return distribution(engine); });
+
+  std::size_t count = 0;
+  for (const auto& pose : poses) {
+    const Eigen::Vector2i cell = grid.cell_near(pose.translation());
+    ASSERT_TRUE(grid.data_at(cell).has_value());
+    count += cell.isZero() ? 1 : 0;
+  }
+
+  constexpr double kTolerance = 0.03;
+  ASSERT_NEAR(static_cast<double>(count) / kSize, 0.5, kTolerance);
+}
+
+TEST(MultivariateUniformDistribution, SparseGrid3dHeightBand) {
+  constexpr std::size_t kSize = 1'000;
+  const auto grid = SparseGrid<3>{{{Eigen::Vector3i{0, 0, 0}, 1.0}, {Eigen::Vector3i{1, 1, 5}, 1.0}}, 1.0};
+  auto distribution = beluga::MultivariateUniformDistribution{grid, -0.5, 0.5};
+
+  auto engine = std::mt19937{std::random_device()()};
+  auto poses = std::vector<Sophus::SE3d>(kSize);
+  distribution.generate(poses.begin(), poses.end() - kSize / 2, engine);
+  std::generate(poses.end() - kSize / 2, poses.end(), [&]() { return distribution(engine); });
+
+  for (const auto& pose : poses) {
+    ASSERT_GE(pose.translation().x(), 0.0);
+    ASSERT_LE(pose.translation().x(), 1.0);
+    ASSERT_GE(pose.translation().y(), 0.0);
+    ASSERT_LE(pose.translation().y(), 1.0);
+    ASSERT_GE(pose.translation().z(), 0.0);
+    ASSERT_LE(pose.translation().z(), 0.5);
+    // Poses are upright.
+    ASSERT_TRUE((pose.so3() * Eigen::Vector3d::UnitZ()).isApprox(Eigen::Vector3d::UnitZ()));
+  }
+}
+
+TEST(MultivariateUniformDistribution, SparseGridWithoutCells) {
+  const auto grid = SparseGrid<3>{{{Eigen::Vector3i{0, 0, 5}, 1.0}}, 1.0};
+  ASSERT_THROW(beluga::MultivariateUniformDistribution(grid, -0.5, 0.5), std::invalid_argument);
+  ASSERT_THROW(beluga::MultivariateUniformDistribution{SparseGrid<2>{}}, std::invalid_argument);
+}
+
 }  // namespace
@@ -0,0 +1,91 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "beluga/sensor/data/block_value_grid.hpp"
+#include "beluga/sensor/data/value_grid.hpp"
+
+namespace {
+
+// A 37x21 grid, ie. not a multiple of the block size, that is constant but for one row.
+beluga::ValueGrid2<float> make_dense_grid() {
+  constexpr std::size_t kWidth = 37;
+  constexpr std::size_t kHeight = 21;
+  auto data = std::vector<float>(kWidth * kHeight, 0.25F);
+  for (std::size_t xi = 0; xi < kWidth; ++xi) {
+    data[5 * kWidth + xi] = static_cast<float>(xi);
+  }
+  return beluga::ValueGrid2<float>{std::move(data), kWidth, 0.1};
+}
+
+TEST(BlockValueGrid2, Dimensions) {
+  const auto dense_grid = make_dense_grid();
+  const auto grid = beluga::BlockValueGrid2<float, 8>{dense_grid};
+  EXPECT_EQ(grid.width(), dense_grid.width());
+  EXPECT_EQ(grid.height(), dense_grid.height());
+  EXPECT_EQ(grid.size(), dense_grid.size());
+  EXPECT_DOUBLE_EQ(grid.resolution(), dense_grid.resolution());
+}
+
+TEST(BlockValueGrid2, ConstantBlocksAreCollapsed) {
+  const auto dense_grid = make_dense_grid();
+  const auto grid = beluga::BlockValueGrid2<float, 8>{dense_grid};
+  // Only the five blocks that the non-constant row crosses are stored in full,
+  // all constant blocks share a single value.
+  EXPECT_EQ(grid.stored_size(), 5U * 8U * 8U + 1U);
+  EXPECT_LT(grid.memory_size(), dense_grid.size() * sizeof(float));
+}
+
+TEST(BlockValueGrid2, DataAt) {
+  const auto dense_grid = make_dense_grid();
+  const auto grid = beluga::BlockValueGrid2<float, 8>{dense_grid};
+  for (int yi = -1; yi <= static_cast<int>(grid.height()); ++yi) {
+    for (int xi = -1; xi <= static_cast<int>(grid.width()); ++xi) {
+      ASSERT_EQ(grid.data_at(xi, yi), dense_grid.data_at(xi, yi));
+      ASSERT_EQ(grid.data_at(Eigen::Vector2i{xi, yi}), dense_grid.data_at(Eigen::Vector2i{xi, yi}));
+    }
+  }
+  for (std::size_t index = 0; index < grid.size() + 2; ++index) {
+    ASSERT_EQ(grid.data_at(index), dense_grid.data_at(index));
+  }
+  EXPECT_EQ(grid.index_at(3, 1), dense_grid.index_at(3, 1));
+}
+
+TEST(BlockValueGrid2, DataNear) {
+  const auto dense_grid = make_dense_grid();
+  const auto grid = beluga::BlockValueGrid2<float, 8>{dense_grid};
+  EXPECT_EQ(grid.data_near(1.05, 0.55), std::make_optional(10.0F));
+  EXPECT_EQ(grid.data_near(Eigen::Vector2d{3.0, 1.5}), std::make_optional(0.25F));
+  EXPECT_EQ(grid.data_near(-0.05, 0.55), std::nullopt);
+}
+
+TEST(BlockValueGrid2, InterpolateNear) {
+  const auto dense_grid = make_dense_grid();
+  const auto grid = beluga::BlockValueGrid2<float, 8>{dense_grid};
+  for (const auto& point : {Eigen::Vector2d{1.33, 0.57}, Eigen::Vector2d{0.81, 0.49}, Eigen::Vector2d{3.69, 2.05}}) {
+    const auto [value, gradient] = grid.interpolate_near(point, 0.1);
+    const auto [expected_value, expected_gradient] = dense_grid.interpolate_near(point, 0.1);
+    EXPECT_DOUBLE_EQ(value, expected_value);
+    EXPECT_TRUE(gradient.isApprox(expected_gradient));
+  }
+}
+
+}  // namespace
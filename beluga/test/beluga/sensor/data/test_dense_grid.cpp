@@ -110,6 +110,61 @@ TEST(DenseGrid2, NearestData) {
   EXPECT_EQ(grid.data_near(Eigen::Vector2d(0, 5.25)), std::nullopt);
 }
 
+TEST(DenseGrid2, InterpolatedData) {
+  const auto grid =
+      Image<5, 5>({{{0, 0, 0, 0, 0}, {0, 1, 1, 1, 0}, {0, 1, 2, 1, 0}, {0, 1, 1, 1, 0}, {0, 0, 0, 0, 0}}});
+
+  {
+    const auto [value, gradient] = grid.interpolate_near(2.5, 2.5, 0.);
+    EXPECT_DOUBLE_EQ(value, 2.);
+  }
+
+  {
+    const auto [value, gradient] = grid.interpolate_near(2.0, 2.5, 0.);
+    EXPECT_DOUBLE_EQ(value, 1.5);
+    EXPECT_DOUBLE_EQ(gradient.x(), 1.);
+    EXPECT_DOUBLE_EQ(gradient.y(), -0.5);
+  }
+
+  {
+    const auto [value, gradient] = grid.interpolate_near(Eigen::Vector2d(2.25, 2.0), 0.);
+    EXPECT_DOUBLE_EQ(value, 1.375);
+    EXPECT_DOUBLE_EQ(gradient.x(), 0.5);
+    EXPECT_DOUBLE_EQ(gradient.y(), 0.75);
+  }
+
+  {
+    const auto [value, gradient] = grid.interpolate_near(-1.0, 7.0, 3.);
+    EXPECT_DOUBLE_EQ(value, 3.);
+    EXPECT_DOUBLE_EQ(gradient.x(), 0.);
+    EXPECT_DOUBLE_EQ(gradient.y(), 0.);
+  }
+
+  {
+    const auto [value, gradient] = grid.interpolate_near(-0.25, 0.5, 3.);
+    EXPECT_DOUBLE_EQ(value, 2.25);
+    EXPECT_DOUBLE_EQ(gradient.x(), -3.);
+  }
+}
+
+TEST(DenseGrid2, BatchInterpolatedData) {
+  const auto grid =
+      Image<5, 5>({{{0, 0, 0, 0, 0}, {0, 1, 1, 1, 0}, {0, 1, 2, 1, 0}, {0, 1, 1, 1, 0}, {0, 0, 0, 0, 0}}});
+
+  Eigen::Matrix2Xd points(2, 6);
+  points << 2.5, 2.0, 2.25, -1.0, -0.25, 4.9,  //
+      2.5, 2.5, 2.0, 7.0, 0.5, 3.1;
+  const auto [values, gradients] = grid.interpolate_near(points, 3.);
+  ASSERT_EQ(values.size(), points.cols());
+  ASSERT_EQ(gradients.cols(), points.cols());
+  for (Eigen::Index i = 0; i < points.cols(); ++i) {
+    const auto [value, gradient] = grid.interpolate_near(Eigen::Vector2d{points.col(i)}, 3.);
+    EXPECT_DOUBLE_EQ(values(i), value);
+    EXPECT_DOUBLE_EQ(gradients(0, i), gradient.x());
+    EXPECT_DOUBLE_EQ(gradients(1, i), gradient.y());
+  }
+}
+
 TEST(DenseGrid2, Neighborhood4) {
   const auto grid = Image<5, 5>{};
 
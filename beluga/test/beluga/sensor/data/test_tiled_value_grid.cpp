@@ -0,0 +1,195 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include "beluga/sensor/data/tiled_value_grid.hpp"
+
+namespace {
+
+constexpr std::size_t kWidth = 18;
+constexpr std::size_t kHeight = 10;
+constexpr double kResolution = 0.5;
+constexpr std::size_t kTileSize = 4;
+
+// Cell values encode cell coordinates, and loads are counted.
+beluga::TiledValueGrid2<int> make_grid(const std::shared_ptr<std::atomic<int>>& loads, std::size_t capacity) {
+  auto loader = [loads](const Eigen::Vector2i& tile) {
+    loads->fetch_add(1);
+    const auto size = static_cast<int>(kTileSize);
+    auto values = std::vector<int>{};
+    for (int yi = 0; yi < size; ++yi) {
+      for (int xi = 0; xi < size; ++xi) {
+        values.push_back(100 * (tile.y() * size + yi) + tile.x() * size + xi);
+      }
+    }
+    return values;
+  };
+  return beluga::TiledValueGrid2<int>{kWidth, kHeight, kResolution, kTileSize, loader, capacity};
+}
+
+Eigen::AlignedBox2d make_region(double min_x, double min_y, double max_x, double max_y) {
+  return Eigen::AlignedBox2d{Eigen::Vector2d{min_x, min_y}, Eigen::Vector2d{max_x, max_y}};
+}
+
+TEST(TiledValueGrid2, Dimensions) {
+  const auto grid = make_grid(std::make_shared<std::atomic<int>>(0), 4);
+  EXPECT_EQ(grid.width(), kWidth);
+  EXPECT_EQ(grid.height(), kHeight);
+  EXPECT_EQ(grid.size(), kWidth * kHeight);
+  EXPECT_EQ(grid.tile_size(), kTileSize);
+  EXPECT_DOUBLE_EQ(grid.resolution(), kResolution);
+}
+
+TEST(TiledValueGrid2, NothingLoadedUpfront) {
+  const auto loads = std::make_shared<std::atomic<int>>(0);
+  const auto grid = make_grid(loads, 4);
+  EXPECT_EQ(grid.cached_tiles(), 0U);
+  EXPECT_EQ(grid.data_at(0, 0), std::nullopt);
+  EXPECT_EQ(loads->load(), 0);
+}
+
+TEST(TiledValueGrid2, UpdateRegion) {
+  const auto loads = std::make_shared<std::atomic<int>>(0);
+  auto grid = make_grid(loads, 4);
+  const auto view = grid;  // copies share tiles
+
+  // Cells 0 to 5 along x, 0 to 2 along y, ie. two tiles.
+  grid.update_region(make_region(0.1, 0.1, 2.5, 1.0));
+  EXPECT_EQ(view.cached_tiles(), 2U);
+  EXPECT_EQ(loads->load(), 2);
+  EXPECT_EQ(view.data_at(5, 1), std::make_optional(105));
+  EXPECT_EQ(view.data_at(7, 3), std::make_optional(307));
+  EXPECT_EQ(view.data_at(8, 1), std::nullopt);
+  EXPECT_EQ(view.data_near(Eigen::Vector2d{1.2, 0.7}), std::make_optional(102));
+  EXPECT_EQ(view.data_at(view.index_at(6, 2)), std::make_optional(206));
+
+  // Tiles in the cache are not loaded again.
+  grid.update_region(make_region(0.0, 0.0, 1.0, 1.0));
+  EXPECT_EQ(loads->load(), 2);
+
+  // Regions are clamped to the grid.
+  grid.update_region(make_region(-10.0, -10.0, 0.1, 0.1));
+  EXPECT_EQ(loads->load(), 2);
+  grid.update_region(make_region(20.0, 20.0, 30.0, 30.0));
+  EXPECT_EQ(loads->load(), 2);
+}
+
+TEST(TiledValueGrid2, LeastRecentlyUsedEviction) {
+  const auto loads = std::make_shared<std::atomic<int>>(0);
+  auto grid = make_grid(loads, 2);
+  grid.update_region(make_region(0.0, 0.0, 0.1, 0.1));  // tile (0, 0)
+  grid.update_region(make_region(2.0, 0.0, 2.1, 0.1));  // tile (1, 0)
+  grid.update_region(make_region(0.0, 0.0, 0.1, 0.1));  // tile (0, 0) again
+  grid.update_region(make_region(4.0, 0.0, 4.1, 0.1));  // tile (2, 0), evicts tile (1, 0)
+  EXPECT_EQ(grid.cached_tiles(), 2U);
+  EXPECT_EQ(loads->load(), 3);
+  EXPECT_TRUE(grid.data_at(0, 0).has_value());
+  EXPECT_FALSE(grid.data_at(4, 0).has_value());
+  EXPECT_TRUE(grid.data_at(8, 0).has_value());
+
+  // Regions larger than capacity are kept in full.
+  grid.update_region(make_region(0.0, 0.0, 8.9, 0.1));
+  EXPECT_EQ(grid.cached_tiles(), 5U);
+  for (int xi = 0; xi < static_cast<int>(kWidth); ++xi) {
+    EXPECT_EQ(grid.data_at(xi, 0), std::make_optional(xi));
+  }
+}
+
+TEST(TiledValueGrid2, Prefetch) {
+  const auto loads = std::make_shared<std::atomic<int>>(0);
+  auto grid = make_grid(loads, 4);
+  grid.prefetch(make_region(6.0, 4.0, 100.0, 100.0));  // tiles (3, 2) and (4, 2)
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+  while (loads->load() < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(loads->load(), 2);
+  // Prefetched tiles only become available on region updates.
+  EXPECT_EQ(grid.cached_tiles(), 0U);
+  grid.update_region(make_region(8.5, 4.5, 8.9, 4.9));
+  EXPECT_EQ(loads->load(), 2);
+  EXPECT_EQ(grid.cached_tiles(), 2U);
+  EXPECT_EQ(grid.data_at(17, 9), std::make_optional(917));
+  EXPECT_EQ(grid.data_at(12, 8), std::make_optional(812));
+}
+
+TEST(TiledValueGrid2, UnavailableTiles) {
+  auto loader = [](const Eigen::Vector2i& tile) {
+    return tile.x() == 0 ? std::vector<float>(kTileSize * kTileSize, 1.0F) : std::vector<float>{};
+  };
+  auto grid = beluga::TiledValueGrid2<float>{kWidth, kHeight, kResolution, kTileSize, loader, 4};
+  grid.update_region(make_region(0.0, 0.0, 2.5, 0.1));
+  EXPECT_EQ(grid.data_at(3, 0), std::make_optional(1.0F));
+  EXPECT_EQ(grid.data_at(4, 0), std::nullopt);
+  EXPECT_DOUBLE_EQ(grid.interpolate_near(2.0, 0.25, 0.5).first, 0.75);
+}
+
+TEST(TiledValueGrid2, PrefetchFailures) {
+  const auto loads = std::make_shared<std::atomic<int>>(0);
+  auto loader = [loads](const Eigen::Vector2i& tile) {
+    loads->fetch_add(1);
+    if (tile.x() == 4) {
+      throw std::runtime_error{"cannot load tile"};
+    }
+    return std::vector<float>(kTileSize * kTileSize, 1.0F);
+  };
+  auto grid = beluga::TiledValueGrid2<float>{kWidth, kHeight, kResolution, kTileSize, loader, 4};
+  grid.prefetch(make_region(6.0, 4.0, 100.0, 100.0));  // tiles (3, 2) and (4, 2)
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+  while (loads->load() < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(loads->load(), 2);
+  // Give the background thread time to handle the failure, loads are counted before the loader throws.
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  // Tiles that failed to load are not cached but loaded again, the rest are not affected.
+  grid.update_region(make_region(8.5, 4.5, 8.9, 4.9));
+  EXPECT_EQ(loads->load(), 3);
+  EXPECT_EQ(grid.cached_tiles(), 1U);
+  EXPECT_EQ(grid.data_at(17, 9), std::nullopt);
+  EXPECT_EQ(grid.data_at(12, 8), std::make_optional(1.0F));
+}
+
+TEST(TiledValueGrid2, RetryFailedTiles) {
+  const auto loads = std::make_shared<std::atomic<int>>(0);
+  auto loader = [loads](const Eigen::Vector2i&) {
+    if (loads->fetch_add(1) == 0) {
+      throw std::runtime_error{"cannot load tile"};
+    }
+    return std::vector<float>(kTileSize * kTileSize, 1.0F);
+  };
+  auto grid = beluga::TiledValueGrid2<float>{kWidth, kHeight, kResolution, kTileSize, loader, 4};
+  grid.update_region(make_region(0.0, 0.0, 0.1, 0.1));
+  EXPECT_EQ(grid.cached_tiles(), 0U);
+  EXPECT_EQ(grid.data_at(0, 0), std::nullopt);
+  grid.update_region(make_region(0.0, 0.0, 0.1, 0.1));
+  EXPECT_EQ(loads->load(), 2);
+  EXPECT_EQ(grid.cached_tiles(), 1U);
+  EXPECT_EQ(grid.data_at(0, 0), std::make_optional(1.0F));
+}
+
+}  // namespace
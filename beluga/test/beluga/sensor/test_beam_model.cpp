@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -81,6 +82,40 @@ TEST(BeamSensorModel, ImportanceWeight) {
   }
 }
 
+TEST(BeamSensorModel, BoundedImportanceWeight) {
+  constexpr double kResolution = 0.5;
+  // clang-format off
+  const auto grid = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false,
+    false, false, false, false, false,
+    false, false, true , false, false,
+    false, false, false, false, false,
+    false, false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  const auto params = GetParams();
+  auto sensor_model = UUT{params, grid};
+
+  const auto points = std::vector<std::pair<double, double>>{{1., 1.}, {0.75, 0.75}, {2.25, 2.25}};
+  const double expected_weight = sensor_model(std::vector(points))(grid.origin());
+  auto state_weighting_function = sensor_model.bounded(std::vector(points));
+  ASSERT_EQ(state_weighting_function.size(), 3U);
+  EXPECT_NEAR(expected_weight, state_weighting_function(grid.origin()), 1e-9);
+
+  {
+    const auto [weight, count] = state_weighting_function(grid.origin(), expected_weight);
+    EXPECT_EQ(count, 3U);
+    EXPECT_NEAR(expected_weight, weight, 1e-9);
+  }
+
+  {
+    const auto [weight, count] = state_weighting_function(grid.origin(), std::numeric_limits<double>::max());
+    EXPECT_EQ(count, 0U);
+    EXPECT_GE(weight, expected_weight);
+  }
+}
+
 TEST(BeamSensorModel, GridUpdates) {
   const auto origin = Sophus::SE2d{};
 
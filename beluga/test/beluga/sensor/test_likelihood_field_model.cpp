@@ -15,6 +15,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -22,6 +27,8 @@
 #include <range/v3/view/transform.hpp>
 #include <sophus/common.hpp>
 
+#include "beluga/sensor/data/block_value_grid.hpp"
+#include "beluga/sensor/data/tiled_value_grid.hpp"
 #include "beluga/sensor/likelihood_field_model.hpp"
 #include "beluga/test/static_occupancy_grid.hpp"
 
@@ -101,6 +108,40 @@ TEST(LikelihoodFieldModel, ImportanceWeight) {
   }
 }
 
+TEST(LikelihoodFieldModel, BoundedImportanceWeight) {
+  constexpr double kResolution = 0.5;
+  // clang-format off
+  const auto grid = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false,
+    false, false, false, false, false,
+    false, false, true , false, false,
+    false, false, false, false, false,
+    false, false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  const auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  auto sensor_model = UUT{params, grid};
+
+  const auto points = std::vector<std::pair<double, double>>{{1.20, 1.20}, {1.25, 1.25}, {1.30, 1.30}, {2.25, 2.25}};
+  const double expected_weight = sensor_model(std::vector(points))(grid.origin());
+  auto state_weighting_function = sensor_model.bounded(std::vector(points));
+  ASSERT_EQ(state_weighting_function.size(), 4U);
+  ASSERT_NEAR(expected_weight, state_weighting_function(grid.origin()), 1e-9);
+
+  {
+    const auto [weight, count] = state_weighting_function(grid.origin(), expected_weight);
+    ASSERT_EQ(count, 4U);
+    ASSERT_NEAR(expected_weight, weight, 1e-9);
+  }
+
+  {
+    const auto [weight, count] = state_weighting_function(grid.origin(), std::numeric_limits<double>::max());
+    ASSERT_EQ(count, 0U);
+    ASSERT_GE(weight, expected_weight);
+  }
+}
+
 TEST(LikelihoodFieldModel, GridWithOffset) {
   constexpr double kResolution = 2.0;
   // clang-format off
@@ -185,6 +226,119 @@ TEST(LikelihoodFieldModel, GridWithRotationAndOffset) {
   }
 }
 
+TEST(LikelihoodFieldModel, SinglePrecisionImportanceWeight) {
+  constexpr double kResolution = 2.0;
+  // clang-format off
+  const auto origin_rotation = Sophus::SO2d{Sophus::Constants<double>::pi() / 2};
+  const auto origin = Sophus::SE2d{origin_rotation, origin_rotation * Eigen::Vector2d{-5, -5}};
+
+  const auto grid = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false,
+    false, false, false, false, false,
+    false, false, true , false, false,
+    false, false, false, false, false,
+    false, false, false, false, true },
+    kResolution,
+    origin};
+  // clang-format on
+
+  const auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  const auto sensor_model = UUT{params, grid};
+  const auto single_precision_sensor_model =
+      beluga::LikelihoodFieldModel<StaticOccupancyGrid<5, 5>, Sophus::SE2f>{params, grid};
+
+  const auto points = std::vector<std::pair<double, double>>{{-4.5, 4.5}, {0.3, 0.7}, {1.1, -2.9}, {9.5, 9.5}};
+  auto single_precision_points = std::vector<std::pair<float, float>>{};
+  for (const auto& [x, y] : points) {
+    single_precision_points.emplace_back(static_cast<float>(x), static_cast<float>(y));
+  }
+
+  const auto state = Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{0.1, -0.2}};
+  const auto weight = sensor_model(std::vector{points})(state);
+  const auto single_precision_weight =
+      single_precision_sensor_model(std::move(single_precision_points))(state.cast<float>());
+  ASSERT_NEAR(weight, single_precision_weight, 1e-3);
+}
+
+TEST(LikelihoodFieldModel, BlockSparseLikelihoodField) {
+  constexpr std::size_t kSize = 64;
+  constexpr double kResolution = 0.1;
+  auto cells = std::array<bool, kSize * kSize>{};
+  for (std::size_t i = 5; i < 15; ++i) {
+    cells[10 * kSize + i] = true;
+  }
+  const auto grid = StaticOccupancyGrid<kSize, kSize>{cells, kResolution};
+
+  auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  params.max_obstacle_distance = 1.0;
+  const auto sensor_model = beluga::LikelihoodFieldModel<StaticOccupancyGrid<kSize, kSize>>{params, grid};
+  const auto sparse_sensor_model = beluga::LikelihoodFieldModel<
+      StaticOccupancyGrid<kSize, kSize>, Sophus::SE2d, beluga::BlockValueGrid2<float, 8>>{params, grid};
+
+  // Blocks beyond the maximum obstacle distance are constant, and collapsed.
+  const auto& dense_field = sensor_model.likelihood_field();
+  const auto& sparse_field = sparse_sensor_model.likelihood_field();
+  ASSERT_LT(sparse_field.stored_size(), dense_field.size() / 2);
+  for (int yi = 0; yi < static_cast<int>(kSize); ++yi) {
+    for (int xi = 0; xi < static_cast<int>(kSize); ++xi) {
+      ASSERT_EQ(sparse_field.data_at(xi, yi), dense_field.data_at(xi, yi));
+    }
+  }
+
+  const auto points = std::vector<std::pair<double, double>>{{0.5, 0.5}, {1.3, -0.2}, {-0.4, 2.1}, {10.0, 10.0}};
+  const auto state = Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{0.6, 0.8}};
+  ASSERT_DOUBLE_EQ(sensor_model(std::vector{points})(state), sparse_sensor_model(std::vector{points})(state));
+  ASSERT_DOUBLE_EQ(sensor_model.coarse(points)(state), sparse_sensor_model.coarse(points)(state));
+}
+
+TEST(LikelihoodFieldModel, PrecomputedTiledLikelihoodField) {
+  constexpr std::size_t kSize = 20;
+  constexpr std::size_t kTileSize = 8;
+  constexpr double kResolution = 0.25;
+  auto cells = std::array<bool, kSize * kSize>{};
+  for (std::size_t i = 3; i < 17; ++i) {
+    cells[12 * kSize + i] = true;
+  }
+  const auto origin = Sophus::SE2d{Sophus::SO2d{0.5}, Eigen::Vector2d{-1.0, 2.0}};
+  const auto grid = StaticOccupancyGrid<kSize, kSize>{cells, kResolution, origin};
+
+  const auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  using SensorModel = beluga::LikelihoodFieldModel<StaticOccupancyGrid<kSize, kSize>>;
+  const auto sensor_model = SensorModel{params, grid};
+
+  // Tiles are sliced off the likelihood field of the whole map.
+  const auto likelihood_field = SensorModel::make_likelihood_field(params, grid);
+  auto loader = [&likelihood_field](const Eigen::Vector2i& tile) {
+    auto values = std::vector<float>{};
+    for (int yi = 0; yi < static_cast<int>(kTileSize); ++yi) {
+      for (int xi = 0; xi < static_cast<int>(kTileSize); ++xi) {
+        const int x = tile.x() * static_cast<int>(kTileSize) + xi;
+        const int y = tile.y() * static_cast<int>(kTileSize) + yi;
+        values.push_back(likelihood_field.data_at(x, y).value_or(0.0F));
+      }
+    }
+    return values;
+  };
+  auto tiled_likelihood_field = beluga::TiledValueGrid2<float>{kSize, kSize, kResolution, kTileSize, loader, 9};
+  const auto tiled_sensor_model = beluga::LikelihoodFieldModel<
+      StaticOccupancyGrid<kSize, kSize>, Sophus::SE2d, beluga::TiledValueGrid2<float>>{
+      params, tiled_likelihood_field, origin};
+
+  const auto points = std::vector<std::pair<double, double>>{{0.5, 0.5}, {1.3, -0.2}, {-0.4, 2.1}, {3.0, 1.0}};
+  const auto state = origin * Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{2.0, 1.5}};
+
+  // No tiles loaded yet, every point is out of the map.
+  const double unknown_space_occupancy_prob = 1. / params.max_laser_distance;
+  ASSERT_NEAR(
+      tiled_sensor_model(std::vector{points})(state), 1.0 + 4.0 * std::pow(unknown_space_occupancy_prob, 3), 1e-6);
+
+  // With tiles covering the whole map, weights match those computed with a dense likelihood field.
+  tiled_likelihood_field.update_region(Eigen::AlignedBox2d{Eigen::Vector2d{0.0, 0.0}, Eigen::Vector2d{5.0, 5.0}});
+  ASSERT_DOUBLE_EQ(tiled_sensor_model(std::vector{points})(state), sensor_model(std::vector{points})(state));
+  const auto bounded = tiled_sensor_model.bounded(std::vector{points});
+  ASSERT_NEAR(bounded(state), sensor_model(std::vector{points})(state), 1e-9);
+}
+
 TEST(LikelihoodFieldModel, GridUpdates) {
   const auto origin = Sophus::SE2d{};
 
@@ -224,4 +378,135 @@ TEST(LikelihoodFieldModel, GridUpdates) {
   }
 }
 
+TEST(LikelihoodFieldModel, InterpolatedImportanceWeight) {
+  constexpr double kResolution = 0.5;
+  // clang-format off
+  const auto grid = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false,
+    false, false, false, false, false,
+    false, false, true , false, false,
+    false, false, false, false, false,
+    false, false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  params.bilinear_interpolation = true;
+  auto sensor_model = UUT{params, grid};
+
+  {
+    // Interpolation nodes are cell centers, where it matches nearest cell lookups.
+    auto state_weighting_function = sensor_model(std::vector<std::pair<double, double>>{{1.25, 1.25}});
+    ASSERT_NEAR(2.068, state_weighting_function(grid.origin()), 0.003);
+  }
+
+  {
+    // Halfway between cell centers, point likelihoods are averaged.
+    const double hit = static_cast<double>(sensor_model.likelihood_field().data_at(2, 2).value());
+    const double miss = static_cast<double>(sensor_model.likelihood_field().data_at(1, 2).value());
+    const double expected = 1.0 + std::pow((hit + miss) / 2.0, 3);
+    auto state_weighting_function = sensor_model(std::vector<std::pair<double, double>>{{1.0, 1.25}});
+    ASSERT_NEAR(expected, state_weighting_function(grid.origin()), 1e-6);
+  }
+
+  {
+    // Far away from the grid, the unknown space likelihood is assumed.
+    auto state_weighting_function = sensor_model(std::vector<std::pair<double, double>>{{-50.0, 50.0}});
+    ASSERT_NEAR(1.000, state_weighting_function(grid.origin()), 0.003);
+  }
+}
+
+TEST(LikelihoodFieldModel, LikelihoodFieldPyramid) {
+  constexpr double kResolution = 0.5;
+  // clang-format off
+  const auto grid = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, true ,
+    false, false, false, true , false,
+    false, false, true , false, false,
+    false, true , false, false, false,
+    true , false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  params.coarse_levels = 2;
+  auto sensor_model = UUT{params, grid};
+
+  const auto& pyramid = sensor_model.likelihood_field_pyramid();
+  ASSERT_EQ(pyramid.size(), 2);
+
+  const auto* previous = &sensor_model.likelihood_field();
+  for (const auto& level : pyramid) {
+    ASSERT_EQ(level.width(), (previous->width() + 1) / 2);
+    ASSERT_EQ(level.height(), (previous->height() + 1) / 2);
+    ASSERT_DOUBLE_EQ(level.resolution(), 2.0 * previous->resolution());
+    for (int yi = 0; yi < static_cast<int>(level.height()); ++yi) {
+      for (int xi = 0; xi < static_cast<int>(level.width()); ++xi) {
+        float expected = 0.0F;
+        for (int dy = 0; dy < 2; ++dy) {
+          for (int dx = 0; dx < 2; ++dx) {
+            expected = std::max(expected, previous->data_at(2 * xi + dx, 2 * yi + dy).value_or(0.0F));
+          }
+        }
+        ASSERT_EQ(level.data_at(xi, yi).value(), expected);
+      }
+    }
+    previous = &level;
+  }
+}
+
+TEST(LikelihoodFieldModel, CoarseImportanceWeight) {
+  constexpr double kResolution = 0.5;
+  // clang-format off
+  const auto grid = StaticOccupancyGrid<5, 5>{{
+    false, false, false, false, false,
+    false, false, false, false, false,
+    false, false, true , false, false,
+    false, false, false, false, false,
+    false, false, false, false, false},
+    kResolution};
+  // clang-format on
+
+  const auto points = std::vector<std::pair<double, double>>{{0.25, 0.25}, {1.25, 1.25}, {0.75, 2.25}, {2.25, 0.25}};
+  const auto poses = std::vector<Sophus::SE2d>{
+      Sophus::SE2d{}, Sophus::SE2d{Sophus::SO2d{0.1}, Eigen::Vector2d{0.1, -0.2}},
+      Sophus::SE2d{Sophus::SO2d{-0.3}, Eigen::Vector2d{0.4, 0.3}}};
+
+  auto params = beluga::LikelihoodFieldModelParam{2.0, 20.0, 0.5, 0.5, 0.2};
+  params.coarse_point_stride = 1;
+
+  {
+    // Without downsampled levels nor strided points, coarse weights match fine weights.
+    auto sensor_model = UUT{params, grid};
+    auto fine = sensor_model(std::vector<std::pair<double, double>>{points});
+    auto coarse = sensor_model.coarse(points);
+    for (const auto& pose : poses) {
+      ASSERT_NEAR(coarse(pose), fine(pose), 1e-9);
+    }
+  }
+
+  {
+    // With downsampled levels, coarse weights are upper bounds for fine weights.
+    params.coarse_levels = 1;
+    auto sensor_model = UUT{params, grid};
+    auto fine = sensor_model(std::vector<std::pair<double, double>>{points});
+    auto coarse = sensor_model.coarse(points);
+    for (const auto& pose : poses) {
+      ASSERT_GE(coarse(pose), fine(pose));
+    }
+    ASSERT_NEAR(2.068, sensor_model.coarse({{1.25, 1.25}})(Sophus::SE2d{}), 0.003);
+  }
+
+  {
+    // With strided points, the sum of point likelihoods is scaled accordingly.
+    params.coarse_levels = 0;
+    params.coarse_point_stride = 2;
+    auto sensor_model = UUT{params, grid};
+    const auto repeated_points = std::vector<std::pair<double, double>>{{1.25, 1.25}, {1.25, 1.25}};
+    ASSERT_NEAR(
+        sensor_model.coarse(repeated_points)(Sophus::SE2d{}),
+        sensor_model(std::vector<std::pair<double, double>>{repeated_points})(Sophus::SE2d{}), 1e-9);
+  }
+}
+
 }  // namespace
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -21,8 +23,10 @@
 
 #include <Eigen/Core>
 #include <sophus/se2.hpp>
+#include <sophus/se3.hpp>
 
 #include "beluga/sensor/data/ndt_cell.hpp"
+#include "beluga/sensor/data/point_cloud.hpp"
 #include "beluga/sensor/data/sparse_value_grid.hpp"
 #include "beluga/sensor/ndt_sensor_model.hpp"
 
@@ -36,6 +40,29 @@ Eigen::Matrix2Xd get_diagonal_covariance_2d(double x_var = 0.5, double y_var = 0
 
 using sparse_grid_2d_t = SparseValueGrid2<std::unordered_map<Eigen::Vector2i, NDTCell2d, detail::CellHasher<2>>>;
 using sparse_grid_3d_t = SparseValueGrid3<std::unordered_map<Eigen::Vector3i, NDTCell3d, detail::CellHasher<3>>>;
+
+class PointCloud3f : public BasePointCloud<PointCloud3f> {
+ public:
+  using Scalar = float;
+
+  explicit PointCloud3f(Eigen::Matrix3Xf points, Sophus::SE3d origin = Sophus::SE3d{})
+      : points_(std::move(points)), origin_(std::move(origin)) {}
+
+  [[nodiscard]] const auto& origin() const { return origin_; }
+
+  [[nodiscard]] auto points() const { return Eigen::Map<const Eigen::Matrix3Xf>(points_.data(), 3, points_.cols()); }
+
+ private:
+  Eigen::Matrix3Xf points_;
+  Sophus::SE3d origin_;
+};
+
+const NDTCell3d& find_cell_near(const std::vector<NDTCell3d>& cells, const Eigen::Vector3d& mean) {
+  return *std::min_element(cells.begin(), cells.end(), [&mean](const auto& first, const auto& second) {
+    return (first.mean - mean).norm() < (second.mean - mean).norm();
+  });
+}
+
 }  // namespace
 
 TEST(NDTSensorModel2DTests, CanConstruct) {
@@ -143,6 +170,45 @@ TEST(NDTSensorModel3DTests, ToCellsNotEnoughPointsInCell) {
   ASSERT_EQ(cells.size(), 0UL);
 }
 
+TEST(NDTSensorModel3DTests, ToCellsFromPointCloud) {
+  constexpr double kMapResolution = 0.5;
+  const auto origin = Sophus::SE3d{Sophus::SO3d::rotZ(0.5), Eigen::Vector3d{1.0, 2.0, 0.1}};
+
+  Eigen::Matrix3Xf points(3, 12);
+  // clang-format off
+  points << 0.27F, 0.28F, 0.32F, 0.27F, 0.33F, 0.27F, 1.39F, 1.4F,  1.44F, 1.39F, 1.45F,  1.39F,
+            0.08F, 0.1F,  0.11F, 0.12F, 0.13F, 0.14F, 0.04F, 0.06F, 0.07F, 0.08F, 0.09F,  0.1F,
+            0.1F,  0.2F,  0.2F,  0.2F,  0.2F,  0.1F,  0.1F,  0.2F,  0.2F,  0.2F,  0.15F, 0.15F;
+  // clang-format on
+
+  auto transformed_points = std::vector<Eigen::Vector3d>{};
+  for (Eigen::Index i = 0; i < points.cols(); ++i) {
+    transformed_points.emplace_back(origin * Eigen::Vector3d{points.col(i).cast<double>()});
+  }
+
+  const auto expected_cells = detail::to_cells(transformed_points, kMapResolution);
+  ASSERT_EQ(expected_cells.size(), 2UL);
+  const auto cells = detail::to_cells(points, origin, kMapResolution);
+  ASSERT_EQ(cells.size(), expected_cells.size());
+  for (const auto& cell : cells) {
+    const auto& expected_cell = find_cell_near(expected_cells, cell.mean);
+    ASSERT_TRUE(cell.mean.isApprox(expected_cell.mean, 1e-6));
+    ASSERT_TRUE(cell.covariance.isApprox(expected_cell.covariance, 1e-4));
+  }
+}
+
+TEST(NDTSensorModel3DTests, ToCellsFromPointCloudNotEnoughPointsInCell) {
+  constexpr double kMapResolution = 0.5;
+  Eigen::Matrix3Xf points(3, 3);
+  // clang-format off
+  points << 0.1F, 0.112F, 0.15F,
+            0.2F, 0.22F,  0.23F,
+            0.0F, 0.0F,   0.0F;
+  // clang-format on
+  const auto cells = detail::to_cells(points, Sophus::SE3d{}, kMapResolution);
+  ASSERT_EQ(cells.size(), 0UL);
+}
+
 TEST(NDTSensorModel3DTests, FitPoints) {
   {
     const std::vector meas{
@@ -210,6 +276,39 @@ TEST(NDTSensorModel3DTests, SensorModel) {
   ASSERT_DOUBLE_EQ(state_weighing_fn(Sophus::SE3d{Sophus::SO3d{}, Eigen::Vector3d{0, 0, 1.0}}), 1.0);
 }
 
+TEST(NDTSensorModel3DTests, SensorModelFromPointCloud) {
+  constexpr double kMapResolution = 0.5;
+  const std::vector map_data{
+      Eigen::Vector3d{0.1, 0.2, 0.0},  Eigen::Vector3d{0.112, 0.22, 0.1}, Eigen::Vector3d{0.15, 0.23, 0.1},
+      Eigen::Vector3d{0.1, 0.24, 0.1}, Eigen::Vector3d{0.16, 0.25, 0.1},  Eigen::Vector3d{0.1, 0.26, 0.0},
+  };
+  auto cells = detail::to_cells(map_data, kMapResolution);
+
+  typename sparse_grid_3d_t::map_type map_cells_data;
+  for (const auto& cell : cells) {
+    map_cells_data[(cell.mean.array() / kMapResolution).floor().cast<int>()] = cell;
+  }
+
+  // Points are given in a frame that is offset from that of the particle states.
+  const auto origin = Sophus::SE3d{Sophus::SO3d{}, Eigen::Vector3d{0.0, 0.0, 0.05}};
+  Eigen::Matrix3Xf points(3, static_cast<Eigen::Index>(map_data.size()));
+  for (std::size_t i = 0; i < map_data.size(); ++i) {
+    points.col(static_cast<Eigen::Index>(i)) = (map_data[i] - origin.translation()).cast<float>();
+  }
+
+  const NDTSensorModel model{{}, sparse_grid_3d_t{map_cells_data, kMapResolution}};
+  auto state_weighing_fn = model(PointCloud3f{std::move(points), origin});
+
+  // This is a perfect hit (up to single precision), so we should expect weight to be 1 + num_cells == 2.
+  ASSERT_NEAR(state_weighing_fn(Sophus::SE3d{}), 2.0, 1e-4);
+
+  // Subtle miss, this value should be close to 1 but not quite.
+  ASSERT_GT(state_weighing_fn(Sophus::SE3d{Sophus::SO3d{}, Eigen::Vector3d{0.1, 0.1, 0.0}}), 1.0);
+
+  // This is a perfect miss, so we should expect weight to be 1.
+  ASSERT_DOUBLE_EQ(state_weighing_fn(Sophus::SE3d{Sophus::SO3d{}, Eigen::Vector3d{-10, -10, 0.0}}), 1.0);
+}
+
 TEST(NDTSensorModel2DTests, SensorModel) {
   constexpr double kMapResolution = 0.5;
   const std::vector map_data{
@@ -0,0 +1,115 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "beluga/utility/scratch_arena.hpp"
+
+namespace {
+
+// Memory resource that counts upstream allocations.
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  [[nodiscard]] std::size_t allocations() const { return allocations_; }
+  [[nodiscard]] std::size_t outstanding() const { return outstanding_; }
+
+ private:
+  std::size_t allocations_{0};
+  std::size_t outstanding_{0};
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations_;
+    ++outstanding_;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+    --outstanding_;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(ScratchArena, AllocatesFromBuffer) {
+  auto upstream = CountingResource{};
+  auto arena = beluga::ScratchArena{1024, &upstream};
+  ASSERT_EQ(upstream.allocations(), 1);
+  ASSERT_EQ(arena.capacity(), 1024);
+  auto values = std::pmr::vector<double>{&arena};
+  values.reserve(64);
+  ASSERT_EQ(upstream.allocations(), 1);
+  ASSERT_GE(arena.size(), 64 * sizeof(double));
+}
+
+TEST(ScratchArena, RespectsAlignment) {
+  auto arena = beluga::ScratchArena{1024};
+  [[maybe_unused]] void* unaligned = arena.allocate(1, 1);
+  void* aligned = arena.allocate(64, 32);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 32, 0);  // NOLINT
+}
+
+TEST(ScratchArena, GrowsOnReset) {
+  auto upstream = CountingResource{};
+  auto arena = beluga::ScratchArena{0, &upstream};
+  for (int cycle = 0; cycle < 3; ++cycle) {
+    auto values = std::pmr::vector<int>{&arena};
+    for (int i = 0; i < 1000; ++i) {
+      values.push_back(i);
+    }
+    arena.reset();
+  }
+  // Only the first cycle should have gone upstream, besides growing the buffer once.
+  const auto allocations = upstream.allocations();
+  {
+    auto values = std::pmr::vector<int>{&arena};
+    for (int i = 0; i < 1000; ++i) {
+      values.push_back(i);
+    }
+  }
+  arena.reset();
+  ASSERT_EQ(upstream.allocations(), allocations);
+  ASSERT_EQ(upstream.outstanding(), 1);
+}
+
+TEST(ScratchArena, ResetInvalidatesAllocations) {
+  auto arena = beluga::ScratchArena{256};
+  [[maybe_unused]] void* first = arena.allocate(128);
+  ASSERT_GE(arena.size(), 128);
+  arena.reset();
+  ASSERT_EQ(arena.size(), 0);
+  ASSERT_EQ(arena.allocate(128), first);
+}
+
+TEST(ScratchArena, MoveTransfersOwnership) {
+  auto upstream = CountingResource{};
+  {
+    auto arena = beluga::ScratchArena{256, &upstream};
+    [[maybe_unused]] void* overflow = arena.allocate(512);
+    auto other = std::move(arena);
+    ASSERT_EQ(other.capacity(), 256);
+    ASSERT_EQ(upstream.outstanding(), 2);
+  }
+  ASSERT_EQ(upstream.outstanding(), 0);
+}
+
+}  // namespace
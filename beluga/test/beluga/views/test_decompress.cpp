@@ -0,0 +1,54 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include <range/v3/range/conversion.hpp>
+
+#include "beluga/algorithm/compressed_resampling.hpp"
+#include "beluga/containers/tuple_vector.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/views/decompress.hpp"
+#include "beluga/views/particles.hpp"
+
+namespace {
+
+TEST(DecompressView, SplitsWeights) {
+  const auto compressed = std::vector{
+      std::make_tuple(1, beluga::Weight(0.6), beluga::Multiplicity(3)),  //
+      std::make_tuple(2, beluga::Weight(0.4), beluga::Multiplicity(1))};
+  const auto particles = compressed | beluga::views::decompress | ranges::to<std::vector>;
+  ASSERT_THAT(particles | beluga::views::states | ranges::to<std::vector>, testing::ElementsAre(1, 1, 1, 2));
+  ASSERT_THAT(
+      particles | beluga::views::weights | ranges::to<std::vector>,
+      testing::Each(testing::DoubleNear(0.2, 1e-9)));
+}
+
+TEST(DecompressView, RoundTrip) {
+  const auto input = beluga::TupleVector<std::tuple<int, beluga::Weight>>{
+      std::make_tuple(1, beluga::Weight(1.0)),  //
+      std::make_tuple(2, beluga::Weight(1.0)),  //
+      std::make_tuple(3, beluga::Weight(1.0))};
+  auto compressed = beluga::compress(input, std::vector<std::size_t>{0, 2, 1});
+  const auto output = compressed | beluga::views::decompress | ranges::to<beluga::TupleVector>;
+  ASSERT_THAT(output | beluga::views::states | ranges::to<std::vector>, testing::ElementsAre(2, 2, 3));
+  ASSERT_THAT(output | beluga::views::weights | ranges::to<std::vector>, testing::ElementsAre(1.0, 1.0, 1.0));
+}
+
+}  // namespace
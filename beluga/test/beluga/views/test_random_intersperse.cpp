@@ -15,7 +15,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <random>
 #include <vector>
 
 #include <range/v3/algorithm/count.hpp>
@@ -163,4 +166,76 @@ INSTANTIATE_TEST_SUITE_P(
     RandomIntersperseViewWithParam,
     testing::Values(0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9));
 
+TEST(GeometricRandomIntersperseView, GuaranteedIntersperse) {
+  const double probability = 1.0;
+  auto input = std::array{10, 20, 30};
+  auto output = input |                                                                         //
+                beluga::views::geometric_random_intersperse([]() { return 4; }, probability) |  //
+                ranges::views::take_exactly(5) |                                                //
+                ranges::to<std::vector>;
+  ASSERT_THAT(output, testing::ElementsAre(10, 4, 4, 4, 4));
+}
+
+TEST(GeometricRandomIntersperseView, ZeroProbabilityIntersperseTakeFive) {
+  const double probability = 0.0;
+  auto input = std::array{10, 20, 30};
+  auto output = input |                                                                         //
+                beluga::views::geometric_random_intersperse([]() { return 4; }, probability) |  //
+                ranges::views::take(5) |                                                        //
+                ranges::to<std::vector>;
+  ASSERT_THAT(output, testing::ElementsAre(10, 20, 30));
+}
+
+// Returns the fraction of source elements followed by 0, 1, 2 and 3 or more inserted values.
+template <class Range>
+std::array<double, 4> insertion_run_histogram(Range&& output) {
+  auto histogram = std::array<double, 4>{};
+  std::size_t run = 0;
+  std::size_t total = 0;
+  for (const int value : output) {
+    if (value == 0) {
+      ++run;
+      continue;
+    }
+    if (total > 0) {
+      histogram[std::min(run, histogram.size() - 1)] += 1.0;
+    }
+    ++total;
+    run = 0;
+  }
+  for (auto& bin : histogram) {
+    bin /= static_cast<double>(total - 1);
+  }
+  return histogram;
+}
+
+class GeometricRandomIntersperseViewWithParam : public ::testing::TestWithParam<double> {};
+
+TEST_P(GeometricRandomIntersperseViewWithParam, TestPercentage) {
+  const double probability = GetParam();
+  const int size = 100'000;
+  auto output = ranges::views::iota(1, size + 1) |
+                beluga::views::geometric_random_intersperse([]() { return 0; }, probability);
+  const double count = static_cast<double>(ranges::count(output, 0));
+  const double actual_probability = count / (size + count);
+  ASSERT_NEAR(probability, actual_probability, 0.01);
+}
+
+TEST_P(GeometricRandomIntersperseViewWithParam, MatchesBernoulliTrials) {
+  const double probability = GetParam();
+  const int size = 100'000;
+  auto engine = std::mt19937{42};
+  const auto expected = insertion_run_histogram(
+      ranges::views::iota(1, size + 1) | beluga::views::random_intersperse([]() { return 0; }, probability, engine));
+  const auto actual = insertion_run_histogram(
+      ranges::views::iota(1, size + 1) |
+      beluga::views::geometric_random_intersperse([]() { return 0; }, probability, engine));
+  ASSERT_THAT(actual, testing::Pointwise(testing::DoubleNear(0.01), expected));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    GeometricRandomIntersperseViewParams,
+    GeometricRandomIntersperseViewWithParam,
+    testing::Values(0.001, 0.01, 0.1, 0.3, 0.5, 0.7));
+
 }  // namespace
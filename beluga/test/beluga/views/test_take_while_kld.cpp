@@ -31,6 +31,7 @@
 #include <range/v3/view/take_while.hpp>
 
 #include "beluga/primitives.hpp"
+#include "beluga/utility/scratch_arena.hpp"
 #include "beluga/views/take_while_kld.hpp"
 
 namespace {
@@ -176,6 +177,19 @@ TEST(TakeWhileKld, TakeLimit) {
   ASSERT_EQ(ranges::distance(output), 135);
 }
 
+TEST(TakeWhileKld, TakeLimitWithMemoryResource) {
+  const std::size_t min = 0;
+  const std::size_t max = 1200;
+  const double epsilon = 0.05;
+  auto arena = beluga::ScratchArena{};
+  auto output = ranges::views::generate([]() { return 1UL; }) |  //
+                ranges::views::intersperse(2UL) |                //
+                ranges::views::intersperse(3UL) |                //
+                beluga::views::take_while_kld(identity, min, max, epsilon, beluga::detail::kDefaultKldZ, &arena);
+  ASSERT_EQ(ranges::distance(output), 135);
+  ASSERT_GT(arena.size(), 0);
+}
+
 TEST(TakeWhileKld, TakeMinimum) {
   const std::size_t min = 200;
   const std::size_t max = 1200;
@@ -0,0 +1,239 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <execution>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include "beluga/actions/normalize.hpp"
+#include "beluga/actions/reweight.hpp"
+#include "beluga/actions/reweight_bounded.hpp"
+#include "beluga/algorithm/amcl_core.hpp"
+#include "beluga/algorithm/spatial_hash.hpp"
+#include "beluga/containers/tuple_vector.hpp"
+#include "beluga/motion/differential_drive_model.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/sensor/likelihood_field_model.hpp"
+#include "beluga/test/static_occupancy_grid.hpp"
+
+namespace {
+
+// Number of dynamic memory allocations so far, see global operator new replacements below.
+std::atomic<std::size_t> allocation_count{0};
+
+}  // namespace
+
+// Replace global allocation functions to count allocations, so that benchmarks can report them.
+// Note these replacements affect the whole executable, see CMakeLists.txt.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size)) {  // NOLINT(cppcoreguidelines-no-malloc)
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+namespace {
+
+constexpr std::size_t kGridSize = 100;
+constexpr double kGridResolution = 0.05;
+constexpr std::size_t kNumScanPoints = 180;
+
+using Grid = beluga::testing::StaticOccupancyGrid<kGridSize, kGridSize>;
+using Points = std::vector<std::pair<double, double>>;
+
+// Sensor model adaptor that hides the state weighting function type behind a `std::function`,
+// the way a runtime dispatched implementation does, so that it cannot be inlined into reweighting loops.
+template <class SensorModel>
+class TypeErasedSensorModel {
+ public:
+  using state_type = typename SensorModel::state_type;
+  using weight_type = typename SensorModel::weight_type;
+  using measurement_type = typename SensorModel::measurement_type;
+  using map_type = typename SensorModel::map_type;
+
+  explicit TypeErasedSensorModel(SensorModel sensor_model) : sensor_model_{std::move(sensor_model)} {}
+
+  [[nodiscard]] std::function<weight_type(const state_type&)> operator()(measurement_type&& measurement) const {
+    return sensor_model_(std::move(measurement));
+  }
+
+  void update_map(map_type map) { sensor_model_.update_map(std::move(map)); }
+
+ private:
+  SensorModel sensor_model_;
+};
+
+// A walled square map with an interior wall, and a scan of it taken from a known pose.
+struct Scenario {
+  std::unique_ptr<Grid> grid;
+  Sophus::SE2d pose;
+  Points points;
+};
+
+Scenario make_scenario() {
+  auto cells = std::make_unique<std::array<bool, kGridSize * kGridSize>>();
+  const auto occupy = [&cells](std::size_t xi, std::size_t yi) { (*cells)[yi * kGridSize + xi] = true; };
+  for (std::size_t i = 0; i < kGridSize; ++i) {
+    occupy(i, 0);
+    occupy(i, kGridSize - 1);
+    occupy(0, i);
+    occupy(kGridSize - 1, i);
+  }
+  for (std::size_t i = 20; i < 60; ++i) {
+    occupy(i, 30);
+  }
+
+  // Analytically raycast the map from the known pose.
+  const auto pose = Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{2.0, 3.0}};
+  auto points = Points{};
+  for (std::size_t i = 0; i < kNumScanPoints; ++i) {
+    const double angle =
+        2.0 * Sophus::Constants<double>::pi() * static_cast<double>(i) / static_cast<double>(kNumScanPoints);
+    const Eigen::Vector2d direction = (pose.so2() * Sophus::SO2d{angle}).unit_complex();
+    for (std::size_t step = 0; step < 2 * kGridSize; ++step) {
+      const double range = static_cast<double>(step) * kGridResolution / 2.0;
+      const Eigen::Vector2d end = pose.translation() + range * direction;
+      const auto xi = static_cast<std::size_t>(std::floor(end.x() / kGridResolution));
+      const auto yi = static_cast<std::size_t>(std::floor(end.y() / kGridResolution));
+      if ((*cells)[yi * kGridSize + xi]) {
+        points.emplace_back(range * std::cos(angle), range * std::sin(angle));
+        break;
+      }
+    }
+  }
+
+  return Scenario{std::make_unique<Grid>(*cells, kGridResolution), pose, std::move(points)};
+}
+
+template <class SensorModel>
+void BM_AmclUpdate(benchmark::State& state, SensorModel sensor_model, const Scenario& scenario) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  state.SetComplexityN(state.range(0));
+
+  auto params = beluga::AmclParams{};
+  params.min_particles = count;
+  params.max_particles = count;
+
+  auto amcl = beluga::Amcl{
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},  //
+      std::move(sensor_model),                                                //
+      [&scenario]() { return scenario.pose; },                                //
+      beluga::spatial_hash<Sophus::SE2d>{0.1, 0.1, 0.1},                      //
+      params,                                                                 //
+      std::execution::seq};
+
+  const Sophus::Matrix3d covariance = Eigen::Vector3d{0.25, 0.25, 0.1}.asDiagonal();
+  amcl.initialize(scenario.pose, covariance);
+
+  // Allocations per update include that of the measurement copy, which is moved into the filter.
+  const auto initial_allocation_count = allocation_count.load();
+  for (auto _ : state) {
+    amcl.force_update();
+    benchmark::DoNotOptimize(amcl.update(Sophus::SE2d{}, scenario.points));
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(allocation_count.load() - initial_allocation_count), benchmark::Counter::kAvgIterations);
+}
+
+void BM_AmclUpdate_StaticDispatch(benchmark::State& state) {
+  const auto scenario = make_scenario();
+  auto params = beluga::LikelihoodFieldModelParam{};
+  params.max_laser_distance = 5.0;
+  BM_AmclUpdate(state, beluga::LikelihoodFieldModel{params, *scenario.grid}, scenario);
+}
+
+void BM_AmclUpdate_TypeErasedWeighting(benchmark::State& state) {
+  const auto scenario = make_scenario();
+  auto params = beluga::LikelihoodFieldModelParam{};
+  params.max_laser_distance = 5.0;
+  BM_AmclUpdate(state, TypeErasedSensorModel{beluga::LikelihoodFieldModel{params, *scenario.grid}}, scenario);
+}
+
+// Particles spread uniformly over the map, as they are during global localization.
+beluga::TupleVector<std::tuple<Sophus::SE2d, beluga::Weight>> make_uniform_particles(std::size_t count) {
+  auto engine = std::mt19937{};
+  const double size = static_cast<double>(kGridSize) * kGridResolution;
+  auto position = std::uniform_real_distribution<double>{kGridResolution, size - kGridResolution};
+  const double pi = Sophus::Constants<double>::pi();
+  auto angle = std::uniform_real_distribution<double>{-pi, pi};
+  auto particles = beluga::TupleVector<std::tuple<Sophus::SE2d, beluga::Weight>>{};
+  for (std::size_t i = 0; i < count; ++i) {
+    particles.push_back(std::make_tuple(
+        Sophus::SE2d{Sophus::SO2d{angle(engine)}, Eigen::Vector2d{position(engine), position(engine)}},
+        beluga::Weight(1.0)));
+  }
+  return particles;
+}
+
+void BM_GlobalLocalizationReweight_Full(benchmark::State& state) {
+  const auto scenario = make_scenario();
+  auto params = beluga::LikelihoodFieldModelParam{};
+  params.max_laser_distance = 5.0;
+  const auto sensor_model = beluga::LikelihoodFieldModel{params, *scenario.grid};
+  auto particles = make_uniform_particles(static_cast<std::size_t>(state.range(0)));
+  state.SetComplexityN(state.range(0));
+  for (auto _ : state) {
+    particles |= beluga::actions::reweight(sensor_model(Points{scenario.points})) | beluga::actions::normalize;
+    benchmark::DoNotOptimize(particles);
+  }
+}
+
+void BM_GlobalLocalizationReweight_Bounded(benchmark::State& state) {
+  const auto scenario = make_scenario();
+  auto params = beluga::LikelihoodFieldModelParam{};
+  params.max_laser_distance = 5.0;
+  const auto sensor_model = beluga::LikelihoodFieldModel{params, *scenario.grid};
+  auto particles = make_uniform_particles(static_cast<std::size_t>(state.range(0)));
+  state.SetComplexityN(state.range(0));
+  auto stats = beluga::EarlyTerminationStats{};
+  for (auto _ : state) {
+    particles |= beluga::actions::reweight_bounded(sensor_model.bounded(Points{scenario.points}), 0.5, &stats) |
+                 beluga::actions::normalize;
+    benchmark::DoNotOptimize(particles);
+  }
+  state.counters["saved"] = stats.saved_fraction();
+}
+
+BENCHMARK(BM_AmclUpdate_StaticDispatch)->RangeMultiplier(4)->Range(500, 8000)->Complexity();
+BENCHMARK(BM_AmclUpdate_TypeErasedWeighting)->RangeMultiplier(4)->Range(500, 8000)->Complexity();
+BENCHMARK(BM_GlobalLocalizationReweight_Full)->RangeMultiplier(4)->Range(500, 8000)->Complexity();
+BENCHMARK(BM_GlobalLocalizationReweight_Bounded)->RangeMultiplier(4)->Range(500, 8000)->Complexity();
+
+}  // namespace
@@ -0,0 +1,119 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include "beluga/algorithm/branch_and_bound_scan_matcher.hpp"
+#include "beluga/sensor/data/value_grid.hpp"
+
+namespace {
+
+constexpr double kResolution = 0.05;
+constexpr std::size_t kNumPoints = 100;
+constexpr double kAngularSteps = 64;
+
+// A square map with randomly placed wall segments, and a scan of the walls around its center.
+struct Scenario {
+  beluga::ValueGrid2<float> likelihood_field;
+  std::vector<std::pair<double, double>> scan;
+};
+
+Scenario make_scenario(std::size_t size) {
+  auto generator = std::mt19937{42};  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+  auto distribution = std::uniform_int_distribution<std::size_t>{0, size - 1};
+
+  auto obstacles = std::vector<Eigen::Vector2i>{};
+  for (std::size_t segment = 0; segment < size / 4; ++segment) {
+    const auto x = distribution(generator);
+    const auto y = distribution(generator);
+    const bool horizontal = (segment % 2) == 0;
+    for (std::size_t i = 0; i < size / 16; ++i) {
+      const auto xi = horizontal ? (x + i) % size : x;
+      const auto yi = horizontal ? y : (y + i) % size;
+      obstacles.emplace_back(static_cast<int>(xi), static_cast<int>(yi));
+    }
+  }
+
+  auto data = std::vector<float>(size * size, 0.05F);
+  for (const auto& cell : obstacles) {
+    data[static_cast<std::size_t>(cell.y()) * size + static_cast<std::size_t>(cell.x())] = 1.0F;
+  }
+
+  const auto pose = Sophus::SE2d{
+      Sophus::SO2d{0.7}, Eigen::Vector2d{static_cast<double>(size) * kResolution / 2.0,
+                                         static_cast<double>(size) * kResolution / 2.0}};
+  auto scan = std::vector<std::pair<double, double>>{};
+  const auto stride = std::max(obstacles.size() / kNumPoints, std::size_t{1});
+  for (std::size_t i = 0; i < obstacles.size() && scan.size() < kNumPoints; i += stride) {
+    const Eigen::Vector2d point = pose.inverse() * ((obstacles[i].cast<double>().array() + 0.5) * kResolution).matrix();
+    scan.emplace_back(point.x(), point.y());
+  }
+
+  return Scenario{beluga::ValueGrid2<float>{std::move(data), size, kResolution}, std::move(scan)};
+}
+
+void BM_GlobalScanMatching(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  const auto depth = static_cast<std::size_t>(state.range(1));
+  state.SetComplexityN(state.range(0) * state.range(0));
+
+  const auto scenario = make_scenario(size);
+  auto params = beluga::BranchAndBoundScanMatcherParam{};
+  params.pyramid_depth = depth;
+  params.angular_step = 2.0 * Sophus::Constants<double>::pi() / kAngularSteps;
+  params.max_hypotheses = 5;
+  const auto matcher = beluga::BranchAndBoundScanMatcher{params, scenario.likelihood_field};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matcher.match(scenario.scan));
+  }
+}
+
+void BM_PyramidConstruction(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  state.SetComplexityN(state.range(0) * state.range(0));
+  const auto scenario = make_scenario(size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        beluga::BranchAndBoundScanMatcher{beluga::BranchAndBoundScanMatcherParam{}, scenario.likelihood_field});
+  }
+}
+
+// A single level pyramid amounts to an exhaustive correlative search.
+BENCHMARK(BM_GlobalScanMatching)
+    ->ArgsProduct({{128, 256}, {1}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GlobalScanMatching)
+    ->ArgsProduct({{128, 256, 512, 1024}, {7}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PyramidConstruction)
+    ->RangeMultiplier(2)
+    ->Range(256, 2048)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
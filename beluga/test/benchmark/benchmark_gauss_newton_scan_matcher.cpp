@@ -0,0 +1,156 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include "beluga/algorithm/gauss_newton_scan_matcher.hpp"
+#include "beluga/sensor/data/value_grid.hpp"
+
+namespace {
+
+constexpr std::size_t kSize = 200;
+constexpr double kResolution = 0.05;
+constexpr double kSigma = 0.2;
+constexpr std::size_t kNumPoses = 64;
+
+// A square room with a few pillars, and its smooth likelihood field.
+struct Scenario {
+  std::vector<Eigen::Vector2d> obstacles;
+  beluga::ValueGrid2<float> likelihood_field;
+};
+
+Scenario make_scenario() {
+  const double side = static_cast<double>(kSize) * kResolution;
+  auto obstacles = std::vector<Eigen::Vector2d>{};
+  for (std::size_t i = 0; i < kSize; ++i) {
+    const double offset = (static_cast<double>(i) + 0.5) * kResolution;
+    obstacles.emplace_back(offset, 0.5 * kResolution);
+    obstacles.emplace_back(offset, side - 0.5 * kResolution);
+    obstacles.emplace_back(0.5 * kResolution, offset);
+    obstacles.emplace_back(side - 0.5 * kResolution, offset);
+  }
+  for (const auto& center : {Eigen::Vector2d{3.0, 3.0}, Eigen::Vector2d{7.0, 4.0}, Eigen::Vector2d{4.5, 7.5}}) {
+    for (int i = -5; i <= 5; ++i) {
+      obstacles.emplace_back(center + Eigen::Vector2d{i * kResolution, 0.0});
+      obstacles.emplace_back(center + Eigen::Vector2d{0.0, i * kResolution});
+    }
+  }
+
+  // Brute force distances are fine for a one-off scenario setup.
+  auto data = std::vector<float>{};
+  data.reserve(kSize * kSize);
+  for (std::size_t yi = 0; yi < kSize; ++yi) {
+    for (std::size_t xi = 0; xi < kSize; ++xi) {
+      const auto center = Eigen::Vector2d{
+          (static_cast<double>(xi) + 0.5) * kResolution, (static_cast<double>(yi) + 0.5) * kResolution};
+      double squared_distance = std::numeric_limits<double>::infinity();
+      for (const auto& obstacle : obstacles) {
+        squared_distance = std::min(squared_distance, (center - obstacle).squaredNorm());
+      }
+      data.push_back(static_cast<float>(std::exp(-squared_distance / (2.0 * kSigma * kSigma))));
+    }
+  }
+  return Scenario{std::move(obstacles), beluga::ValueGrid2<float>{std::move(data), kSize, kResolution}};
+}
+
+// Simulates a scan by sampling visible obstacles within range, which is crude but adequate here.
+std::vector<std::pair<double, double>>
+make_scan(const std::vector<Eigen::Vector2d>& obstacles, const Sophus::SE2d& pose, std::size_t num_points) {
+  auto points = std::vector<std::pair<double, double>>{};
+  for (const auto& obstacle : obstacles) {
+    const Eigen::Vector2d point = pose.inverse() * obstacle;
+    if (point.norm() < 4.0) {
+      points.emplace_back(point.x(), point.y());
+    }
+  }
+  const auto stride = std::max(points.size() / num_points, std::size_t{1});
+  auto scan = std::vector<std::pair<double, double>>{};
+  for (std::size_t i = 0; i < points.size() && scan.size() < num_points; i += stride) {
+    scan.push_back(points[i]);
+  }
+  return scan;
+}
+
+void BM_PoseRefinement(benchmark::State& state) {
+  const auto num_points = static_cast<std::size_t>(state.range(0));
+  const auto max_iterations = static_cast<std::size_t>(state.range(1));
+
+  static const auto scenario = make_scenario();
+  auto params = beluga::GaussNewtonScanMatcherParam{};
+  params.max_iterations = max_iterations;
+  const auto matcher = beluga::GaussNewtonScanMatcher{params, scenario.likelihood_field};
+
+  // Initial guesses are perturbed like the estimates of a small particle filter would be.
+  auto generator = std::mt19937{42};  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+  auto linear_error = std::normal_distribution<double>{0.0, 0.1};
+  auto angular_error = std::normal_distribution<double>{0.0, 0.05};
+  auto position = std::uniform_real_distribution<double>{2.0, 8.0};
+  const double pi = Sophus::Constants<double>::pi();
+  auto heading = std::uniform_real_distribution<double>{-pi, pi};
+  auto cases = std::vector<std::tuple<Sophus::SE2d, Sophus::SE2d, std::vector<std::pair<double, double>>>>{};
+  for (std::size_t i = 0; i < kNumPoses; ++i) {
+    const auto pose =
+        Sophus::SE2d{Sophus::SO2d{heading(generator)}, Eigen::Vector2d{position(generator), position(generator)}};
+    const auto initial_pose =
+        pose * Sophus::SE2d{
+                   Sophus::SO2d{angular_error(generator)},
+                   Eigen::Vector2d{linear_error(generator), linear_error(generator)}};
+    cases.emplace_back(pose, initial_pose, make_scan(scenario.obstacles, pose, num_points));
+  }
+
+  std::size_t index = 0;
+  for (auto _ : state) {
+    const auto& [pose, initial_pose, scan] = cases[index++ % kNumPoses];
+    benchmark::DoNotOptimize(matcher.refine(scan, initial_pose));
+  }
+
+  double initial_linear_error = 0.0;
+  double initial_angular_error = 0.0;
+  double refined_linear_error = 0.0;
+  double refined_angular_error = 0.0;
+  for (const auto& [pose, initial_pose, scan] : cases) {
+    const auto initial_error = pose.inverse() * initial_pose;
+    const auto refined_error = pose.inverse() * matcher.refine(scan, initial_pose);
+    initial_linear_error += initial_error.translation().norm();
+    initial_angular_error += std::abs(initial_error.so2().log());
+    refined_linear_error += refined_error.translation().norm();
+    refined_angular_error += std::abs(refined_error.so2().log());
+  }
+  const auto count = static_cast<double>(kNumPoses);
+  state.counters["InitialLinearError"] = initial_linear_error / count;
+  state.counters["InitialAngularError"] = initial_angular_error / count;
+  state.counters["RefinedLinearError"] = refined_linear_error / count;
+  state.counters["RefinedAngularError"] = refined_angular_error / count;
+}
+
+// Arguments are the number of scan points and the maximum number of iterations.
+BENCHMARK(BM_PoseRefinement)
+    ->ArgsProduct({{60, 120, 240}, {1, 5}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,127 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <memory>
+#include <tuple>
+
+#include <Eigen/Core>
+
+#include <sophus/se2.hpp>
+#include <sophus/so2.hpp>
+
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view/take_exactly.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include "beluga/algorithm/generate_particles.hpp"
+#include "beluga/containers/tuple_vector.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/random/multivariate_normal_distribution.hpp"
+#include "beluga/random/multivariate_uniform_distribution.hpp"
+#include "beluga/test/static_occupancy_grid.hpp"
+#include "beluga/type_traits/particle_traits.hpp"
+#include "beluga/views/sample.hpp"
+
+namespace {
+
+constexpr std::size_t kGridSize = 200;
+
+using Particle = std::tuple<Sophus::SE2d, beluga::Weight>;
+using Grid = beluga::testing::StaticOccupancyGrid<kGridSize, kGridSize>;
+
+auto make_normal_distribution() {
+  const Sophus::Matrix3d covariance = Eigen::Vector3d{0.25, 0.25, 0.07}.asDiagonal();
+  return beluga::MultivariateNormalDistribution{Sophus::SE2d{Sophus::SO2d{0.5}, Eigen::Vector2d{1.0, 2.0}}, covariance};
+}
+
+// A map with every other row occupied.
+auto make_map_distribution(bool stratified = false) {
+  auto cells = std::make_unique<std::array<bool, kGridSize * kGridSize>>();
+  for (std::size_t i = 0; i < cells->size(); ++i) {
+    (*cells)[i] = (i / kGridSize) % 2 == 0;
+  }
+  return beluga::MultivariateUniformDistribution{Grid{*cells, 0.05}, stratified};
+}
+
+// Baseline: sample states one at a time, growing the particle set as it goes.
+template <class Distribution>
+void BM_Initialize_SampleView(benchmark::State& state, Distribution distribution) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  state.SetComplexityN(state.range(0));
+  for (auto _ : state) {
+    auto particles = beluga::views::sample(std::ref(distribution)) |                 //
+                     ranges::views::transform(beluga::make_from_state<Particle>) |  //
+                     ranges::views::take_exactly(count) |                           //
+                     ranges::to<beluga::TupleVector>;
+    benchmark::DoNotOptimize(particles);
+  }
+}
+
+template <class ExecutionPolicy, class Distribution>
+void BM_Initialize_Bulk(benchmark::State& state, ExecutionPolicy policy, Distribution distribution) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  state.SetComplexityN(state.range(0));
+  for (auto _ : state) {
+    auto particles = beluga::generate_particles<Particle>(policy, distribution, count);
+    benchmark::DoNotOptimize(particles);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Initialize_SampleView, Normal, make_normal_distribution())
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Initialize_Bulk, NormalSequential, std::execution::seq, make_normal_distribution())
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Initialize_Bulk, NormalParallel, std::execution::par, make_normal_distribution())
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Initialize_SampleView, Map, make_map_distribution())
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Initialize_Bulk, MapSequential, std::execution::seq, make_map_distribution())
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Initialize_Bulk, MapParallel, std::execution::par, make_map_distribution())
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Initialize_Bulk, MapStratifiedParallel, std::execution::par, make_map_distribution(true))
+    ->RangeMultiplier(4)
+    ->Range(1'000, 256'000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
@@ -14,7 +14,14 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -23,6 +30,17 @@
 #include <sophus/se2.hpp>
 #include <sophus/so2.hpp>
 
+#include <range/v3/range/conversion.hpp>
+
+#include "beluga/actions/normalize.hpp"
+#include "beluga/actions/reweight.hpp"
+#include "beluga/actions/reweight_coarse_to_fine.hpp"
+#include "beluga/primitives.hpp"
+#include "beluga/sensor/data/block_value_grid.hpp"
+#include "beluga/sensor/likelihood_field_model.hpp"
+#include "beluga/test/static_occupancy_grid.hpp"
+#include "beluga/views/particles.hpp"
+
 namespace {
 
 constexpr std::size_t kNumParticles = 2'000;
@@ -73,4 +91,199 @@ void BM_PointTransform_EigenSophus(benchmark::State& state) {
 BENCHMARK(BM_PointTransform_Baseline)->RangeMultiplier(2)->Range(128, 1024)->Complexity();
 BENCHMARK(BM_PointTransform_EigenSophus)->RangeMultiplier(2)->Range(128, 1024)->Complexity();
 
+constexpr std::size_t kGridSize = 200;
+constexpr double kGridResolution = 0.05;
+constexpr std::size_t kNumScanPoints = 360;
+
+using Grid = beluga::testing::StaticOccupancyGrid<kGridSize, kGridSize>;
+using Particle = std::tuple<Sophus::SE2d, beluga::Weight>;
+using Points = std::vector<std::pair<double, double>>;
+
+// A walled square map with a few interior walls, a scan of it and a set of particles
+// spread all over it, as during global localization.
+struct WeightingScenario {
+  std::unique_ptr<Grid> grid;
+  Points points;
+  std::vector<Particle> particles;
+};
+
+WeightingScenario make_weighting_scenario(std::size_t particle_count) {
+  auto cells = std::make_unique<std::array<bool, kGridSize * kGridSize>>();
+  const auto occupy = [&cells](std::size_t xi, std::size_t yi) { (*cells)[yi * kGridSize + xi] = true; };
+  for (std::size_t i = 0; i < kGridSize; ++i) {
+    occupy(i, 0);
+    occupy(i, kGridSize - 1);
+    occupy(0, i);
+    occupy(kGridSize - 1, i);
+  }
+  for (std::size_t i = 40; i < 120; ++i) {
+    occupy(i, 60);
+    occupy(150, i);
+  }
+  auto grid = std::make_unique<Grid>(*cells, kGridResolution);
+
+  // Analytically raycast the map from a known pose.
+  const auto pose = Sophus::SE2d{Sophus::SO2d{0.3}, Eigen::Vector2d{3.0, 6.0}};
+  auto points = Points{};
+  for (std::size_t i = 0; i < kNumScanPoints; ++i) {
+    const double angle =
+        2.0 * Sophus::Constants<double>::pi() * static_cast<double>(i) / static_cast<double>(kNumScanPoints);
+    const Eigen::Vector2d direction = (pose.so2() * Sophus::SO2d{angle}).unit_complex();
+    for (double range = 0.0; range < 10.0; range += kGridResolution / 2.0) {
+      const Eigen::Vector2d end = pose.translation() + range * direction;
+      const auto xi = static_cast<std::size_t>(std::floor(end.x() / kGridResolution));
+      const auto yi = static_cast<std::size_t>(std::floor(end.y() / kGridResolution));
+      if ((*cells)[yi * kGridSize + xi]) {
+        points.emplace_back(range * std::cos(angle), range * std::sin(angle));
+        break;
+      }
+    }
+  }
+
+  auto generator = std::mt19937{42};  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+  auto position = std::uniform_real_distribution<double>{0.0, static_cast<double>(kGridSize) * kGridResolution};
+  auto orientation = std::uniform_real_distribution<double>{-Sophus::Constants<double>::pi(),
+                                                            Sophus::Constants<double>::pi()};
+  auto particles = std::vector<Particle>{};
+  particles.reserve(particle_count);
+  particles.emplace_back(pose, beluga::Weight{1.0});
+  while (particles.size() < particle_count) {
+    particles.emplace_back(
+        Sophus::SE2d{Sophus::SO2d{orientation(generator)}, Eigen::Vector2d{position(generator), position(generator)}},
+        beluga::Weight{1.0});
+  }
+
+  return WeightingScenario{std::move(grid), std::move(points), std::move(particles)};
+}
+
+auto make_likelihood_field_model_params(std::size_t coarse_levels) {
+  auto params = beluga::LikelihoodFieldModelParam{};
+  params.max_laser_distance = 10.0;
+  params.coarse_levels = coarse_levels;
+  params.coarse_point_stride = 4;
+  params.fine_fraction = 0.1;
+  return params;
+}
+
+void BM_LikelihoodFieldModel_FullWeighting(benchmark::State& state) {
+  const auto count = state.range(0);
+  state.SetComplexityN(count);
+  const auto scenario = make_weighting_scenario(static_cast<std::size_t>(count));
+  const auto sensor_model = beluga::LikelihoodFieldModel{make_likelihood_field_model_params(0), *scenario.grid};
+  for (auto _ : state) {
+    auto particles = scenario.particles;
+    particles |= beluga::actions::reweight(sensor_model(Points(scenario.points)));
+    benchmark::DoNotOptimize(particles);
+  }
+}
+
+void BM_LikelihoodFieldModel_InterpolatedWeighting(benchmark::State& state) {
+  const auto count = state.range(0);
+  state.SetComplexityN(count);
+  const auto scenario = make_weighting_scenario(static_cast<std::size_t>(count));
+  auto params = make_likelihood_field_model_params(0);
+  params.bilinear_interpolation = true;
+  const auto sensor_model = beluga::LikelihoodFieldModel{params, *scenario.grid};
+  for (auto _ : state) {
+    auto particles = scenario.particles;
+    particles |= beluga::actions::reweight(sensor_model(Points(scenario.points)));
+    benchmark::DoNotOptimize(particles);
+  }
+}
+
+void BM_LikelihoodFieldModel_CoarseToFineWeighting(benchmark::State& state) {
+  const auto count = state.range(0);
+  state.SetComplexityN(count);
+  const auto scenario = make_weighting_scenario(static_cast<std::size_t>(count));
+  const auto sensor_model = beluga::LikelihoodFieldModel{make_likelihood_field_model_params(2), *scenario.grid};
+  const auto& params = sensor_model.params();
+
+  for (auto _ : state) {
+    auto particles = scenario.particles;
+    particles |= beluga::actions::reweight_coarse_to_fine(
+        sensor_model.coarse(scenario.points), sensor_model(Points(scenario.points)), params.fine_fraction);
+    benchmark::DoNotOptimize(particles);
+  }
+
+  // Compare against full resolution weighting: report the total variation distance between
+  // both normalized weight distributions and whether the most likely particle is preserved.
+  auto expected = scenario.particles;
+  expected |= beluga::actions::reweight(sensor_model(Points(scenario.points))) | beluga::actions::normalize;
+  auto actual = scenario.particles;
+  actual |= beluga::actions::reweight_coarse_to_fine(
+                sensor_model.coarse(scenario.points), sensor_model(Points(scenario.points)),
+                params.fine_fraction) |
+            beluga::actions::normalize;
+  const auto expected_weights = expected | beluga::views::weights | ranges::to<std::vector<double>>;
+  const auto actual_weights = actual | beluga::views::weights | ranges::to<std::vector<double>>;
+  double distance = 0.0;
+  for (std::size_t i = 0; i < expected_weights.size(); ++i) {
+    distance += std::abs(expected_weights[i] - actual_weights[i]) / 2.0;
+  }
+  state.counters["TotalVariation"] = distance;
+  const bool best_preserved =
+      std::max_element(expected_weights.begin(), expected_weights.end()) - expected_weights.begin() ==
+      std::max_element(actual_weights.begin(), actual_weights.end()) - actual_weights.begin();
+  state.counters["BestPreserved"] = best_preserved ? 1.0 : 0.0;
+}
+
+void BM_LikelihoodFieldModel_BlockSparseWeighting(benchmark::State& state) {
+  const auto count = state.range(0);
+  state.SetComplexityN(count);
+  const auto scenario = make_weighting_scenario(static_cast<std::size_t>(count));
+  const auto sensor_model = beluga::LikelihoodFieldModel<Grid, Sophus::SE2d, beluga::BlockValueGrid2<float>>{
+      make_likelihood_field_model_params(0), *scenario.grid};
+  for (auto _ : state) {
+    auto particles = scenario.particles;
+    particles |= beluga::actions::reweight(sensor_model(Points(scenario.points)));
+    benchmark::DoNotOptimize(particles);
+  }
+}
+
+using DenseLikelihoodField = beluga::ValueGrid2<float>;
+using BlockSparseLikelihoodField8 = beluga::BlockValueGrid2<float, 8>;
+using BlockSparseLikelihoodField16 = beluga::BlockValueGrid2<float, 16>;
+
+std::size_t memory_size(const beluga::ValueGrid2<float>& field) {
+  return field.size() * sizeof(float);
+}
+
+template <std::size_t BlockSize>
+std::size_t memory_size(const beluga::BlockValueGrid2<float, BlockSize>& field) {
+  return field.memory_size();
+}
+
+// Looks up the likelihood field at every scan point, for every particle, and reports how much memory it takes.
+template <class LikelihoodField>
+void BM_LikelihoodFieldLookup(benchmark::State& state) {
+  const auto scenario = make_weighting_scenario(kNumParticles);
+  const auto sensor_model = beluga::LikelihoodFieldModel<Grid, Sophus::SE2d, LikelihoodField>{
+      make_likelihood_field_model_params(0), *scenario.grid};
+  const auto& field = sensor_model.likelihood_field();
+  auto coordinates = std::vector<Eigen::Vector2d>{};
+  coordinates.reserve(scenario.particles.size() * scenario.points.size());
+  for (const auto& [pose, weight] : scenario.particles) {
+    for (const auto& [x, y] : scenario.points) {
+      coordinates.push_back(pose * Eigen::Vector2d{x, y});
+    }
+  }
+  for (auto _ : state) {
+    float sum = 0.0F;
+    for (const auto& point : coordinates) {
+      sum += field.data_near(point).value_or(0.0F);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(coordinates.size()));
+  state.counters["bytes"] = static_cast<double>(memory_size(field));
+}
+
+BENCHMARK(BM_LikelihoodFieldModel_FullWeighting)->RangeMultiplier(2)->Range(1'000, 16'000)->Complexity();
+BENCHMARK(BM_LikelihoodFieldModel_InterpolatedWeighting)->RangeMultiplier(2)->Range(1'000, 16'000)->Complexity();
+BENCHMARK(BM_LikelihoodFieldModel_CoarseToFineWeighting)->RangeMultiplier(2)->Range(1'000, 16'000)->Complexity();
+BENCHMARK(BM_LikelihoodFieldModel_BlockSparseWeighting)->RangeMultiplier(2)->Range(1'000, 16'000)->Complexity();
+BENCHMARK_TEMPLATE(BM_LikelihoodFieldLookup, DenseLikelihoodField);
+BENCHMARK_TEMPLATE(BM_LikelihoodFieldLookup, BlockSparseLikelihoodField8);
+BENCHMARK_TEMPLATE(BM_LikelihoodFieldLookup, BlockSparseLikelihoodField16);
+
 }  // namespace
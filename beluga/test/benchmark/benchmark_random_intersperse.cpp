@@ -0,0 +1,71 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+
+#include <range/v3/view/iota.hpp>
+
+#include "beluga/views/random_intersperse.hpp"
+
+namespace {
+
+constexpr int kSize = 100'000;
+
+// Counts the random numbers drawn, to report them.
+struct CountingEngine {
+  using result_type = std::mt19937::result_type;
+
+  static constexpr result_type min() { return std::mt19937::min(); }
+  static constexpr result_type max() { return std::mt19937::max(); }
+
+  result_type operator()() {
+    ++count;
+    return engine();
+  }
+
+  std::mt19937 engine;
+  std::size_t count{0};
+};
+
+template <class Adaptor>
+void BM_RandomIntersperse(benchmark::State& state, Adaptor adaptor) {
+  const double probability = static_cast<double>(state.range(0)) / 10'000.0;
+  auto engine = CountingEngine{};
+  std::size_t inserted = 0;
+  for (auto _ : state) {
+    for (const int value : ranges::views::iota(1, kSize + 1) | adaptor([]() { return 0; }, probability, engine)) {
+      inserted += value == 0 ? 1U : 0U;
+    }
+  }
+  state.counters["inserted"] = benchmark::Counter(static_cast<double>(inserted), benchmark::Counter::kAvgIterations);
+  state.counters["random_numbers"] =
+      benchmark::Counter(static_cast<double>(engine.count), benchmark::Counter::kAvgIterations);
+}
+
+void BM_RandomIntersperse_Bernoulli(benchmark::State& state) {
+  BM_RandomIntersperse(state, beluga::views::random_intersperse);
+}
+
+void BM_RandomIntersperse_Geometric(benchmark::State& state) {
+  BM_RandomIntersperse(state, beluga::views::geometric_random_intersperse);
+}
+
+// Insertion probabilities in units of 0.01%.
+BENCHMARK(BM_RandomIntersperse_Bernoulli)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1'000);
+BENCHMARK(BM_RandomIntersperse_Geometric)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1'000);
+
+}  // namespace
@@ -24,6 +24,8 @@
 #include <range/v3/view/filter.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include "beluga/actions/assign.hpp"
+#include "beluga/containers/default_init_allocator.hpp"
 #include "beluga/containers/tuple_vector.hpp"
 #include "beluga/primitives.hpp"
 #include "beluga/views/particles.hpp"
@@ -40,6 +42,7 @@ struct State {
 
 using Particle = std::tuple<State, beluga::Weight, beluga::Cluster>;
 using StructureOfArrays = beluga::TupleVector<std::tuple<State, beluga::Weight, beluga::Cluster>>;
+using DefaultInitStructureOfArrays = beluga::TupleVector<Particle, beluga::DefaultInitAllocator<Particle>>;
 using ArrayOfStructures = beluga::Vector<std::tuple<State, beluga::Weight, beluga::Cluster>>;
 
 struct Arrays {
@@ -233,10 +236,34 @@ void BM_AssignFromNonSizedReserved(benchmark::State& state) {
   }
 }
 
+// Resampling-like assignment, where the container is assigned a non-sized view of itself.
+template <class Container>
+void BM_AssignAction(benchmark::State& state) {
+  auto container = Container{};
+  container.resize(kParticleCount);
+  for (auto _ : state) {
+    container |= ranges::views::filter([](auto) { return true; }) | beluga::actions::assign;
+  }
+}
+
+template <class Container>
+void BM_Resize(benchmark::State& state) {
+  for (auto _ : state) {
+    auto container = Container{};
+    container.resize(kParticleCount);
+    benchmark::DoNotOptimize(container);
+  }
+}
+
 BENCHMARK(BM_Assign_Baseline_StructureOfArrays);
 BENCHMARK_TEMPLATE(BM_AssignFromSized, StructureOfArrays);
 BENCHMARK_TEMPLATE(BM_AssignFromNonSized, StructureOfArrays);
 BENCHMARK_TEMPLATE(BM_AssignFromNonSizedReserved, StructureOfArrays);
+BENCHMARK_TEMPLATE(BM_AssignFromNonSized, DefaultInitStructureOfArrays);
+BENCHMARK_TEMPLATE(BM_AssignFromNonSizedReserved, DefaultInitStructureOfArrays);
+BENCHMARK_TEMPLATE(BM_AssignAction, StructureOfArrays);
+BENCHMARK_TEMPLATE(BM_Resize, StructureOfArrays);
+BENCHMARK_TEMPLATE(BM_Resize, DefaultInitStructureOfArrays);
 BENCHMARK_TEMPLATE(BM_Transform, StructureOfArrays);
 BENCHMARK(BM_Assign_Baseline_ArrayOfStructures);
 BENCHMARK_TEMPLATE(BM_Transform, ArrayOfStructures);
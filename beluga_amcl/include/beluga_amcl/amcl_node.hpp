@@ -17,11 +17,16 @@
 
 #include <memory>
 #include <optional>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcpp"
 #include <message_filters/subscriber.h>
+#include <message_filters/sync_policies/approximate_time.h>
+#include <message_filters/synchronizer.h>
 #pragma GCC diagnostic pop
 
 #include <tf2_ros/buffer.h>
@@ -35,11 +40,15 @@
 #include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
 #include <nav_msgs/msg/occupancy_grid.hpp>
 #include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
 #include <std_srvs/srv/empty.hpp>
+#include <std_srvs/srv/trigger.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 
 #include <beluga/beluga.hpp>
 #include <beluga_ros/amcl.hpp>
+#include <beluga_ros/checkpoint.hpp>
+#include <beluga_ros/messages.hpp>
 #include "beluga_amcl/ros2_common.hpp"
 
 /**
@@ -59,6 +68,9 @@ class AmclNode : public BaseAMCLNode {
   ~AmclNode() override;
 
  protected:
+  /// Callback for lifecycle transitions from the UNCONFIGURED state to the INACTIVE state.
+  void do_configure(const rclcpp_lifecycle::State&) override;
+
   /// Callback for lifecycle transitions from the INACTIVE state to the ACTIVE state.
   void do_activate(const rclcpp_lifecycle::State&) override;
 
@@ -84,12 +96,40 @@ class AmclNode : public BaseAMCLNode {
   /// Callback for occupancy grid map updates.
   void map_callback(nav_msgs::msg::OccupancyGrid::SharedPtr);
 
+  /// Callback for updates of occupancy grid maps to keep in the map registry, for fast switching.
+  void registered_map_callback(const std::string& id, nav_msgs::msg::OccupancyGrid::SharedPtr);
+
   /// Callback for periodic particle cloud updates.
   void do_periodic_timer_callback() override;
 
   /// Callback for laser scan updates.
   void laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr);
 
+  /// Callback for synchronized laser scan updates from the primary and secondary laser scanners.
+  void synchronized_laser_callback(
+      sensor_msgs::msg::LaserScan::ConstSharedPtr,
+      sensor_msgs::msg::LaserScan::ConstSharedPtr);
+
+  /// Callback for primary laser scan updates when there is a secondary laser scanner.
+  /**
+   * Laser scans update the particle filter on their own only if no laser scan pair has been
+   * processed for longer than the secondary laser scan timeout, ie. if the secondary laser scanner stalled.
+   */
+  void primary_laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr);
+
+  /// Updates the particle filter with laser scans taken at about the same time, one per laser scanner.
+  /**
+   * Laser scans are fused into a single update, so that particles are propagated and resampled once.
+   * The base pose is looked up at the stamp of the first laser scan, which is also used for scan matching
+   * and for published messages.
+   *
+   * \param laser_scans Laser scan messages, the primary one first.
+   */
+  void process_laser_scans(const std::vector<sensor_msgs::msg::LaserScan::ConstSharedPtr>& laser_scans);
+
+  /// Callback for periodic particle filter checkpoints.
+  void checkpoint_timer_callback();
+
   /// Callback for pose (re)initialization.
   void do_initial_pose_callback(geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr) override;
 
@@ -105,6 +145,13 @@ class AmclNode : public BaseAMCLNode {
       std::shared_ptr<std_srvs::srv::Empty::Request> req,
       std::shared_ptr<std_srvs::srv::Empty::Response> res);
 
+  /// Callback for the services that switch the map used for localization to one in the map registry.
+  void switch_map_callback(
+      const std::string& id,
+      std::shared_ptr<rmw_request_id_t> request_header,
+      std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response);
+
   /// Initialize particles from an estimated pose and covariance.
   /**
    * If an exception occurs during the initialization, an error message is logged, and the initialization
@@ -126,6 +173,31 @@ class AmclNode : public BaseAMCLNode {
    */
   bool initialize_from_map();
 
+  /// Initialize particles from the particle filter checkpoint, if any.
+  /**
+   * If there is no checkpoint to restore from, or if it cannot be read, the initialization process
+   * is aborted, returning false. If the initialization is successful, the TF broadcast is enabled.
+   *
+   * \return True if the initialization is successful, false otherwise.
+   */
+  bool initialize_from_checkpoint();
+
+  /// Initialize particles around the poses that best match a laser scan against the map.
+  /**
+   * If scan matching fails to produce any hypotheses, or the sensor model does not support it, a warning
+   * is logged and the initialization process is aborted, returning false. If the initialization is
+   * successful, the TF broadcast is enabled.
+   *
+   * \param laser_scan Laser scan to match against the map.
+   * \return True if the initialization is successful, false otherwise.
+   */
+  bool initialize_from_scan_matching(const beluga_ros::LaserScan& laser_scan);
+
+  /// Compact particle cloud publisher.
+  rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::PointCloud2>::SharedPtr particle_pointcloud_pub_;
+  /// Compact particle cloud message, reused across publications.
+  beluga_ros::msg::PointCloud2 particle_pointcloud_message_;
+
   /// Occupancy grid map updates subscription.
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr map_sub_;
   /// Laser scan updates subscription.
@@ -136,20 +208,50 @@ class AmclNode : public BaseAMCLNode {
   rclcpp::Service<std_srvs::srv::Empty>::SharedPtr global_localization_server_;
   /// No motion update service server.
   rclcpp::Service<std_srvs::srv::Empty>::SharedPtr nomotion_update_server_;
+  /// Registered occupancy grid map updates subscriptions, one per map id.
+  std::vector<rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr> registered_map_subs_;
+  /// Map switching service servers, one per map id.
+  std::vector<rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr> switch_map_servers_;
+  /// Timer for particle filter checkpoints.
+  rclcpp::TimerBase::SharedPtr checkpoint_timer_;
+  /// Particle filter checkpoint writer, if checkpoints are enabled.
+  std::unique_ptr<beluga_ros::AsyncCheckpointWriter> checkpoint_writer_;
 
   /// Transform synchronization filter for laser scan updates.
   std::unique_ptr<tf2_ros::MessageFilter<sensor_msgs::msg::LaserScan>> laser_scan_filter_;
   /// Connection for laser scan updates filter and callback.
   message_filters::Connection laser_scan_connection_;
+  /// Secondary laser scan updates subscription, if any.
+  std::unique_ptr<message_filters::Subscriber<sensor_msgs::msg::LaserScan, rclcpp_lifecycle::LifecycleNode>>
+      secondary_laser_scan_sub_;
+  /// Transform synchronization filter for secondary laser scan updates, if any.
+  std::unique_ptr<tf2_ros::MessageFilter<sensor_msgs::msg::LaserScan>> secondary_laser_scan_filter_;
+  /// Laser scan synchronization policy, pairing primary and secondary laser scans with close stamps.
+  using LaserScanSyncPolicy =
+      message_filters::sync_policies::ApproximateTime<sensor_msgs::msg::LaserScan, sensor_msgs::msg::LaserScan>;
+  /// Synchronizer for primary and secondary laser scan updates, if any.
+  std::unique_ptr<message_filters::Synchronizer<LaserScanSyncPolicy>> laser_scan_synchronizer_;
+  /// Connection for primary laser scan updates filter and fallback callback, if there is a secondary laser scanner.
+  message_filters::Connection primary_laser_scan_connection_;
+  /// Time since the last laser scan pair after which primary laser scans are processed on their own.
+  rclcpp::Duration secondary_laser_scan_timeout_{0, 0};
+  /// Stamp of the last laser scan pair processed, if any.
+  std::optional<rclcpp::Time> last_synchronized_laser_scan_stamp_;
+  /// Stamp of the last primary laser scan processed, paired or on its own, if any.
+  std::optional<rclcpp::Time> last_primary_laser_scan_stamp_;
 
   /// Particle filter instance.
   std::unique_ptr<beluga_ros::Amcl> particle_filter_;
+  /// Maps to register once the particle filter is initialized, by id.
+  std::unordered_map<std::string, nav_msgs::msg::OccupancyGrid::SharedPtr> maps_to_register_;
   /// Last known pose estimate, if any.
   std::optional<std::pair<Sophus::SE2d, Eigen::Matrix3d>> last_known_estimate_;
   /// Last known map to odom correction estimate, if any.
   std::optional<Sophus::SE2d> last_known_odom_transform_in_map_;
   /// Whether to broadcast transforms or not.
   bool enable_tf_broadcast_{false};
+  /// Whether global localization by scan matching is pending on the next laser scan.
+  bool scan_matching_requested_{false};
 };
 
 }  // namespace beluga_amcl
@@ -33,6 +33,7 @@
 #include <nav_msgs/OccupancyGrid.h>
 #include <nav_msgs/SetMap.h>
 #include <sensor_msgs/LaserScan.h>
+#include <sensor_msgs/PointCloud2.h>
 #include <std_srvs/Empty.h>
 
 #include <memory>
@@ -43,6 +44,8 @@
 
 #include <beluga_amcl/AmclConfig.h>
 #include <beluga_ros/amcl.hpp>
+#include <beluga_ros/checkpoint.hpp>
+#include <beluga_ros/messages.hpp>
 
 /**
  * \file
@@ -113,6 +116,18 @@ class AmclNodelet : public nodelet::Nodelet {
   /// Callback for periodic pose saving.
   void save_pose_timer_callback(const ros::TimerEvent& ev);
 
+  /// Callback for periodic particle filter checkpoints.
+  void checkpoint_timer_callback(const ros::TimerEvent& ev);
+
+  /// Initialize particles from the particle filter checkpoint, if any.
+  /**
+   * If there is no checkpoint to restore from, or if it cannot be read, the initialization process
+   * is aborted, returning false. If the initialization is successful, the TF broadcast is enabled.
+   *
+   * \return True if the initialization is successful, false otherwise.
+   */
+  bool initialize_from_checkpoint();
+
   /// Initialize particles from an estimated pose and covariance.
   /**
    * If an exception occurs during the initialization, an error message is logged, and the initialization
@@ -144,10 +159,18 @@ class AmclNodelet : public nodelet::Nodelet {
   ros::Timer particle_cloud_timer_;
   /// Particle cloud publisher.
   ros::Publisher particle_cloud_pub_;
+  /// Compact particle cloud publisher.
+  ros::Publisher particle_pointcloud_pub_;
+  /// Compact particle cloud message, reused across publications.
+  beluga_ros::msg::PointCloud2 particle_pointcloud_message_;
   /// Estimated pose publisher.
   ros::Publisher pose_pub_;
   /// Timer for pose saving.
   ros::Timer save_pose_timer_;
+  /// Timer for particle filter checkpoints.
+  ros::Timer checkpoint_timer_;
+  /// Particle filter checkpoint writer, if checkpoints are enabled.
+  std::unique_ptr<beluga_ros::AsyncCheckpointWriter> checkpoint_writer_;
   /// Pose (re)initialization subscriber.
   ros::Subscriber initial_pose_sub_;
   /// Occupancy grid map updates subscriber
@@ -68,9 +68,8 @@ namespace beluga_amcl {
 using NDTMapRepresentation =
     beluga::SparseValueGrid2<std::unordered_map<Eigen::Vector2i, beluga::NDTCell2d, beluga::detail::CellHasher<2>>>;
 
-/// Type of a particle-dependent random state generator.
-using RandomStateGenerator = std::function<std::function<beluga::NDTSensorModel<NDTMapRepresentation>::state_type()>(
-    const beluga::TupleVector<std::tuple<beluga::NDTSensorModel<NDTMapRepresentation>::state_type, beluga::Weight>>)>;
+/// Type of a random state generator.
+using RandomStateGenerator = std::function<beluga::NDTSensorModel<NDTMapRepresentation>::state_type()>;
 
 /// Partial specialization of the core AMCL pipeline for convinience.
 template <class MotionModel, class ExecutionPolicy>
@@ -84,17 +83,17 @@ using NdtAmcl = beluga::Amcl<
 
 /// All combinations of supported NDT AMCL variants.
 using NdtAmclVariant = std::variant<
-    NdtAmcl<beluga::StationaryModel, std::execution::parallel_policy>,            //
-    NdtAmcl<beluga::StationaryModel, std::execution::sequenced_policy>,           //
-    NdtAmcl<beluga::DifferentialDriveModel2d, std::execution::parallel_policy>,   //
-    NdtAmcl<beluga::DifferentialDriveModel2d, std::execution::sequenced_policy>,  //
-    NdtAmcl<beluga::OmnidirectionalDriveModel, std::execution::parallel_policy>,  //
-    NdtAmcl<beluga::OmnidirectionalDriveModel, std::execution::sequenced_policy>  //
+    NdtAmcl<beluga::StationaryModel, std::execution::parallel_policy>,              //
+    NdtAmcl<beluga::StationaryModel, std::execution::sequenced_policy>,             //
+    NdtAmcl<beluga::DifferentialDriveModel2d, std::execution::parallel_policy>,     //
+    NdtAmcl<beluga::DifferentialDriveModel2d, std::execution::sequenced_policy>,    //
+    NdtAmcl<beluga::OmnidirectionalDriveModel2d, std::execution::parallel_policy>,  //
+    NdtAmcl<beluga::OmnidirectionalDriveModel2d, std::execution::sequenced_policy>  //
     >;
 
 /// Supported motion models.
 using MotionModelVariant =
-    std::variant<beluga::DifferentialDriveModel2d, beluga::StationaryModel, beluga::OmnidirectionalDriveModel>;
+    std::variant<beluga::DifferentialDriveModel2d, beluga::StationaryModel, beluga::OmnidirectionalDriveModel2d>;
 
 /// Supported execution policies.
 using ExecutionPolicyVariant = std::variant<std::execution::sequenced_policy, std::execution::parallel_policy>;
@@ -15,7 +15,10 @@
 #ifndef BELUGA_AMCL_ROS2_COMMON_HPP
 #define BELUGA_AMCL_ROS2_COMMON_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <execution>
+#include <memory>
 #include <rclcpp/node_options.hpp>
 #include <rclcpp_lifecycle/lifecycle_node.hpp>
 #include <rclcpp_lifecycle/state.hpp>
@@ -50,6 +53,18 @@ constexpr std::string_view kNav2OmnidirectionalModelName = "nav2_amcl::OmniMotio
 /// Supported execution policies.
 using ExecutionPolicyVariant = std::variant<std::execution::sequenced_policy, std::execution::parallel_policy>;
 
+/// Typed snapshot of the parameters read on every sensor update.
+struct ParameterSnapshot {
+  std::string global_frame_id;  ///< Frame of reference for the estimated pose.
+  std::string odom_frame_id;    ///< Odometry frame.
+  std::string base_frame_id;    ///< Robot base frame.
+  bool tf_broadcast;            ///< Whether to broadcast the map to odom transform.
+  double transform_tolerance;   ///< Time, in seconds, to post-date the map to odom transform with.
+  std::size_t max_beams;        ///< Maximum number of laser beams to use per update.
+  double laser_min_range;       ///< Minimum laser range, in meters.
+  double laser_max_range;       ///< Maximum laser range, in meters.
+};
+
 /// Base AMCL lifecycle node, with some basic common functionalities, such as transform tree utilities, common
 /// publishers, subscribers, lifecycle related callbacks and configuration points, enabling extension by inheritance.
 class BaseAMCLNode : public rclcpp_lifecycle::LifecycleNode {
@@ -63,6 +78,22 @@ class BaseAMCLNode : public rclcpp_lifecycle::LifecycleNode {
   /// Destructor for the base AMCL node.
   ~BaseAMCLNode() override;
 
+  /// Get the latest snapshot of frequently read parameters.
+  /**
+   * Snapshots are immutable, and retaken on the first call after parameters are set. Other than that,
+   * this checks a flag and copies a pointer, instead of looking up parameters by name under the node
+   * parameters lock like `get_parameter()` does, so it is cheap enough to call from sensor callbacks.
+   *
+   * Not thread-safe: it must only be called from callbacks in the common callback group,
+   * which never run concurrently.
+   */
+  [[nodiscard]] std::shared_ptr<const ParameterSnapshot> parameter_snapshot() {
+    if (parameter_snapshot_stale_.load(std::memory_order_acquire)) {
+      refresh_parameter_snapshot();
+    }
+    return parameter_snapshot_;
+  }
+
  protected:
   /// Callback for lifecycle transitions from the UNCONFIGURED state to the INACTIVE state.
   CallbackReturn on_configure(const rclcpp_lifecycle::State&) override;
@@ -136,6 +167,17 @@ class BaseAMCLNode : public rclcpp_lifecycle::LifecycleNode {
   rclcpp::SubscriptionOptions common_subscription_options_;
   /// Pose (re)initialization subscription.
   rclcpp::Subscription<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr initial_pose_sub_;
+
+ private:
+  /// Replace the parameter snapshot with one taken off current parameter values.
+  void refresh_parameter_snapshot();
+
+  /// Latest parameter snapshot, only accessed from callbacks in the common callback group.
+  std::shared_ptr<const ParameterSnapshot> parameter_snapshot_;
+  /// Whether parameters were set after the latest parameter snapshot was taken.
+  std::atomic<bool> parameter_snapshot_stale_{false};
+  /// Callback handle for parameter sets, to flag the parameter snapshot as stale.
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr on_set_parameters_callback_handle_;
 };
 }  // namespace beluga_amcl
 #endif
@@ -14,10 +14,12 @@
 
 #include <chrono>
 #include <cstddef>
+#include <exception>
 #include <execution>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <ratio>
 #include <stdexcept>
@@ -25,6 +27,7 @@
 #include <string_view>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include <tf2/convert.h>
 #include <tf2/exceptions.h>
@@ -57,15 +60,18 @@
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <std_srvs/srv/empty.hpp>
 
+#include <beluga/algorithm/estimation.hpp>
 #include <beluga/motion/differential_drive_model.hpp>
 #include <beluga/motion/omnidirectional_drive_model.hpp>
 #include <beluga/motion/stationary_model.hpp>
 #include <beluga/sensor/beam_model.hpp>
 #include <beluga/sensor/likelihood_field_model.hpp>
 #include <beluga_ros/amcl.hpp>
+#include <beluga_ros/checkpoint.hpp>
 #include <beluga_ros/messages.hpp>
 #include <beluga_ros/particle_cloud.hpp>
 #include <beluga_ros/tf2_sophus.hpp>
+#include <beluga_ros/tiled_map.hpp>
 #include "beluga_amcl/amcl_node.hpp"
 #include "beluga_amcl/ros2_common.hpp"
 
@@ -75,6 +81,8 @@ namespace {
 
 constexpr std::string_view kLikelihoodFieldModelName = "likelihood_field";
 constexpr std::string_view kBeamSensorModelName = "beam";
+constexpr std::string_view kUniformGlobalLocalizationModeName = "uniform";
+constexpr std::string_view kScanMatchingGlobalLocalizationModeName = "scan_matching";
 
 }  // namespace
 
@@ -85,6 +93,26 @@ AmclNode::AmclNode(const rclcpp::NodeOptions& options) : BaseAMCLNode{"amcl", ""
     declare_parameter("map_topic", rclcpp::ParameterValue("map"), descriptor);
   }
 
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Topic to subscribe to in order to receive laser scans from a secondary laser scanner, to be fused "
+        "with those in the scan topic. Empty to disable.";
+    declare_parameter("secondary_scan_topic", rclcpp::ParameterValue(""), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Time since the last laser scan pair, in seconds, after which laser scans from the primary laser scanner "
+        "update the particle filter on their own. Only used if a secondary scan topic is set.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = std::numeric_limits<double>::max();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("secondary_scan_timeout", rclcpp::ParameterValue(1.0), descriptor);
+  }
+
   {
     auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
     descriptor.description = "Which observation model to use [beam, likelihood_field].";
@@ -100,6 +128,90 @@ AmclNode::AmclNode(const rclcpp::NodeOptions& options) : BaseAMCLNode{"amcl", ""
     descriptor.floating_point_range[0].step = 0;
     declare_parameter("laser_likelihood_max_dist", rclcpp::ParameterValue(2.0), descriptor);
   }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Number of downsampled likelihood field levels to build for coarse-to-fine weighting, "
+        "used in likelihood field model. Zero disables coarse-to-fine weighting.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 0;
+    descriptor.integer_range[0].to_value = 8;
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("laser_likelihood_coarse_levels", rclcpp::ParameterValue(0), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Stride between the beams used for coarse weighting, used in likelihood field model.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 1;
+    descriptor.integer_range[0].to_value = std::numeric_limits<int>::max();
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("laser_likelihood_coarse_beam_stride", rclcpp::ParameterValue(4), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Fraction of particles, those with the highest coarse weights, to weight in full resolution, "
+        "used in likelihood field model.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = 1;
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("laser_likelihood_fine_fraction", rclcpp::ParameterValue(0.1), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Whether to bilinearly interpolate the likelihood field or look up the nearest cell, "
+        "used in likelihood field model.";
+    declare_parameter("laser_likelihood_interpolation", false, descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Path to an occupancy raster file of the map, to compute the likelihood field on demand, in tiles, off it. "
+        "Used in likelihood field model. If empty, the likelihood field is computed for the whole map upfront.";
+    declare_parameter("tiled_map_path", rclcpp::ParameterValue(std::string{}), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Side length of likelihood field tiles, in cells, used when a tiled map is set.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 1;
+    descriptor.integer_range[0].to_value = std::numeric_limits<int>::max();
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("tiled_map_tile_size", rclcpp::ParameterValue(256), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Number of likelihood field tiles to keep in memory, unless more are needed to cover the particle set, "
+        "used when a tiled map is set.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 1;
+    descriptor.integer_range[0].to_value = std::numeric_limits<int>::max();
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("tiled_map_max_tiles", rclcpp::ParameterValue(64), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Ratio to the best particle weight so far below which particles stop being weighted early, "
+        "used in likelihood field and beam models. Zero disables early termination.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = 1;
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("laser_early_termination_ratio", rclcpp::ParameterValue(0.0), descriptor);
+  }
   {
     auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
     descriptor.description = "Mixture weight for the probability of hitting an obstacle.";
@@ -173,6 +285,155 @@ AmclNode::AmclNode(const rclcpp::NodeOptions& options) : BaseAMCLNode{"amcl", ""
         "and ignore subsequent ones.";
     declare_parameter("first_map_only", false, descriptor);
   }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Set this to true to preprocess new maps in the background, and keep localizing against the current map "
+        "until they are ready. Particles are kept across such map updates.";
+    declare_parameter("background_map_updates", false, descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Maximum number of particles to publish in the compact particle cloud, subsampling as needed. "
+        "Set to 0 to publish all particles.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 0;
+    descriptor.integer_range[0].to_value = std::numeric_limits<int>::max();
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("particle_pointcloud_size", rclcpp::ParameterValue(0), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Ids of maps to keep preprocessed in a map registry, e.g. one per floor. Each map is received on the "
+        "maps/<id> topic, and the filter can be switched to it at no cost through the switch_map/<id> service.";
+    declare_parameter("map_ids", rclcpp::ParameterValue(std::vector<std::string>{}), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Path to the file to periodically save the full particle filter state to, and to restore it from "
+        "on startup. Leave empty to disable checkpoints.";
+    declare_parameter("checkpoint_path", rclcpp::ParameterValue(std::string{}), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Rate at which to save the full particle filter state to the checkpoint file.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = std::numeric_limits<double>::max();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("checkpoint_rate", rclcpp::ParameterValue(0.5), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "How to distribute particles on global localization requests [uniform, scan_matching]. "
+        "If scan_matching, particles are seeded around the best poses found by matching the next laser scan "
+        "against the map. Only supported by the likelihood field model.";
+    declare_parameter(
+        "global_localization_mode", rclcpp::ParameterValue(std::string(kUniformGlobalLocalizationModeName)),
+        descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Whether to stratify particles over free space on uniform global localization, "
+        "for an even coverage of the map with fewer particles.";
+    declare_parameter("global_localization_stratified", false, descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Maximum number of scan matching hypotheses to seed particles around.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 1;
+    descriptor.integer_range[0].to_value = std::numeric_limits<int>::max();
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("scan_matching_max_hypotheses", rclcpp::ParameterValue(10), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Number of levels in the max-pooled likelihood field pyramid used for scan matching.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 1;
+    descriptor.integer_range[0].to_value = 16;
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("scan_matching_pyramid_depth", rclcpp::ParameterValue(6), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Angular search step for scan matching, in radians. "
+        "If zero, it is derived from the map resolution and the range of the scan.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = 2 * Sophus::Constants<double>::pi();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("scan_matching_angular_step", rclcpp::ParameterValue(0.0), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Standard deviation of the translational spread of particles around each hypothesis.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = std::numeric_limits<double>::max();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("scan_matching_linear_std_dev", rclcpp::ParameterValue(0.1), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Standard deviation of the rotational spread of particles around each hypothesis.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = std::numeric_limits<double>::max();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("scan_matching_angular_std_dev", rclcpp::ParameterValue(0.05), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Maximum number of Gauss-Newton iterations to refine pose estimates with, by aligning laser scans "
+        "to the likelihood field. Zero disables pose refinement. Only supported by the likelihood field model.";
+    descriptor.integer_range.resize(1);
+    descriptor.integer_range[0].from_value = 0;
+    descriptor.integer_range[0].to_value = 100;
+    descriptor.integer_range[0].step = 1;
+    declare_parameter("pose_refinement_max_iterations", rclcpp::ParameterValue(0), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Maximum translational correction pose refinement may apply to an estimate, in meters.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = std::numeric_limits<double>::max();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("pose_refinement_max_linear_correction", rclcpp::ParameterValue(0.2), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description = "Maximum rotational correction pose refinement may apply to an estimate, in radians.";
+    descriptor.floating_point_range.resize(1);
+    descriptor.floating_point_range[0].from_value = 0;
+    descriptor.floating_point_range[0].to_value = Sophus::Constants<double>::pi();
+    descriptor.floating_point_range[0].step = 0;
+    declare_parameter("pose_refinement_max_angular_correction", rclcpp::ParameterValue(0.2), descriptor);
+  }
 }
 
 AmclNode::~AmclNode() {
@@ -181,13 +442,27 @@ AmclNode::~AmclNode() {
   on_shutdown(get_current_state());
 }
 
+void AmclNode::do_configure(const rclcpp_lifecycle::State&) {
+  particle_pointcloud_pub_ =
+      create_publisher<sensor_msgs::msg::PointCloud2>("particle_pointcloud", rclcpp::SensorDataQoS());
+}
+
 void AmclNode::do_activate(const rclcpp_lifecycle::State&) {
+  particle_pointcloud_pub_->on_activate();
+
   {
     map_sub_ = create_subscription<nav_msgs::msg::OccupancyGrid>(
         get_parameter("map_topic").as_string(), rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
         std::bind(&AmclNode::map_callback, this, std::placeholders::_1), common_subscription_options_);
     RCLCPP_INFO(get_logger(), "Subscribed to map_topic: %s", map_sub_->get_topic_name());
   }
+  for (const auto& id : get_parameter("map_ids").as_string_array()) {
+    registered_map_subs_.push_back(create_subscription<nav_msgs::msg::OccupancyGrid>(
+        "maps/" + id, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+        [this, id](nav_msgs::msg::OccupancyGrid::SharedPtr map) { registered_map_callback(id, std::move(map)); },
+        common_subscription_options_));
+    RCLCPP_INFO(get_logger(), "Subscribed to registered map topic: %s", registered_map_subs_.back()->get_topic_name());
+  }
   {
     using LaserScanSubscriber =
         message_filters::Subscriber<sensor_msgs::msg::LaserScan, rclcpp_lifecycle::LifecycleNode>;
@@ -201,9 +476,36 @@ void AmclNode::do_activate(const rclcpp_lifecycle::State&) {
         *laser_scan_sub_, *tf_buffer_, get_parameter("odom_frame_id").as_string(), 10, get_node_logging_interface(),
         get_node_clock_interface(), tf2::durationFromSec(get_parameter("transform_tolerance").as_double()));
 
-    laser_scan_connection_ =
-        laser_scan_filter_->registerCallback(std::bind(&AmclNode::laser_callback, this, std::placeholders::_1));
     RCLCPP_INFO(get_logger(), "Subscribed to scan_topic: %s", laser_scan_sub_->getTopic().c_str());
+
+    const auto secondary_scan_topic = get_parameter("secondary_scan_topic").as_string();
+    if (secondary_scan_topic.empty()) {
+      laser_scan_connection_ =
+          laser_scan_filter_->registerCallback(std::bind(&AmclNode::laser_callback, this, std::placeholders::_1));
+    } else {
+      secondary_laser_scan_sub_ = std::make_unique<LaserScanSubscriber>(
+          shared_from_this(), secondary_scan_topic, rmw_qos_profile_sensor_data, common_subscription_options_);
+      secondary_laser_scan_filter_ = std::make_unique<tf2_ros::MessageFilter<sensor_msgs::msg::LaserScan>>(
+          *secondary_laser_scan_sub_, *tf_buffer_, get_parameter("odom_frame_id").as_string(), 10,
+          get_node_logging_interface(), get_node_clock_interface(),
+          tf2::durationFromSec(get_parameter("transform_tolerance").as_double()));
+
+      // Pair laser scans with close stamps, so that each pair makes for a single filter update.
+      laser_scan_synchronizer_ = std::make_unique<message_filters::Synchronizer<LaserScanSyncPolicy>>(
+          LaserScanSyncPolicy(10), *laser_scan_filter_, *secondary_laser_scan_filter_);
+      laser_scan_connection_ = laser_scan_synchronizer_->registerCallback(std::bind(
+          &AmclNode::synchronized_laser_callback, this, std::placeholders::_1, std::placeholders::_2));
+
+      // Fall back to primary laser scans alone if the secondary laser scanner stalls.
+      secondary_laser_scan_timeout_ =
+          rclcpp::Duration::from_seconds(get_parameter("secondary_scan_timeout").as_double());
+      last_synchronized_laser_scan_stamp_.reset();
+      last_primary_laser_scan_stamp_.reset();
+      primary_laser_scan_connection_ = laser_scan_filter_->registerCallback(
+          std::bind(&AmclNode::primary_laser_callback, this, std::placeholders::_1));
+      RCLCPP_INFO(
+          get_logger(), "Subscribed to secondary_scan_topic: %s", secondary_laser_scan_sub_->getTopic().c_str());
+    }
   }
 
   const auto common_service_qos = [] {
@@ -229,18 +531,52 @@ void AmclNode::do_activate(const rclcpp_lifecycle::State&) {
           std::placeholders::_3),
       common_service_qos, common_callback_group_);
   RCLCPP_INFO(get_logger(), "Created request_nomotion_update service");
+
+  if (const auto checkpoint_path = get_parameter("checkpoint_path").as_string(); !checkpoint_path.empty()) {
+    const auto checkpoint_rate = get_parameter("checkpoint_rate").as_double();
+    if (checkpoint_rate > 0.0) {
+      checkpoint_writer_ = std::make_unique<beluga_ros::AsyncCheckpointWriter>(checkpoint_path);
+      checkpoint_timer_ = create_wall_timer(
+          std::chrono::duration<double>(1.0 / checkpoint_rate), [this]() { checkpoint_timer_callback(); },
+          common_callback_group_);
+      RCLCPP_INFO(get_logger(), "Saving particle filter checkpoints to %s", checkpoint_path.c_str());
+    }
+  }
+
+  for (const auto& id : get_parameter("map_ids").as_string_array()) {
+    switch_map_servers_.push_back(create_service<std_srvs::srv::Trigger>(
+        "switch_map/" + id,
+        [this, id](
+            std::shared_ptr<rmw_request_id_t> request_header, std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+            std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+          switch_map_callback(id, std::move(request_header), std::move(request), std::move(response));
+        },
+        common_service_qos, common_callback_group_));
+    RCLCPP_INFO(get_logger(), "Created %s service", switch_map_servers_.back()->get_service_name());
+  }
 }
 
 void AmclNode::do_deactivate(const rclcpp_lifecycle::State&) {
+  particle_pointcloud_pub_->on_deactivate();
   map_sub_.reset();
   laser_scan_connection_.disconnect();
+  primary_laser_scan_connection_.disconnect();
+  laser_scan_synchronizer_.reset();
+  secondary_laser_scan_filter_.reset();
+  secondary_laser_scan_sub_.reset();
   laser_scan_filter_.reset();
   laser_scan_sub_.reset();
   global_localization_server_.reset();
+  registered_map_subs_.clear();
+  switch_map_servers_.clear();
+  checkpoint_timer_.reset();
+  checkpoint_writer_.reset();
 }
 
 void AmclNode::do_cleanup(const rclcpp_lifecycle::State&) {
+  particle_pointcloud_pub_.reset();
   particle_filter_.reset();
+  maps_to_register_.clear();
   enable_tf_broadcast_ = false;
 }
 
@@ -304,6 +640,23 @@ auto AmclNode::get_sensor_model(std::string_view name, nav_msgs::msg::OccupancyG
     params.z_hit = get_parameter("z_hit").as_double();
     params.z_random = get_parameter("z_rand").as_double();
     params.sigma_hit = get_parameter("sigma_hit").as_double();
+    params.coarse_levels = static_cast<std::size_t>(get_parameter("laser_likelihood_coarse_levels").as_int());
+    params.coarse_point_stride =
+        static_cast<std::size_t>(get_parameter("laser_likelihood_coarse_beam_stride").as_int());
+    params.fine_fraction = get_parameter("laser_likelihood_fine_fraction").as_double();
+    params.bilinear_interpolation = get_parameter("laser_likelihood_interpolation").as_bool();
+    params.early_termination_ratio = get_parameter("laser_early_termination_ratio").as_double();
+    if (const auto tiled_map_path = get_parameter("tiled_map_path").as_string(); !tiled_map_path.empty()) {
+      // The occupancy raster stands for the map, so the map message only provides dimensions and origin.
+      auto raster =
+          std::make_shared<const beluga_ros::MappedOccupancyRaster>(tiled_map_path, map->info.width, map->info.height);
+      auto likelihood_field = beluga_ros::make_tiled_likelihood_field(
+          std::move(raster), map->info.resolution, params,
+          static_cast<std::size_t>(get_parameter("tiled_map_tile_size").as_int()),
+          static_cast<std::size_t>(get_parameter("tiled_map_max_tiles").as_int()));
+      return beluga_ros::TiledLikelihoodFieldModel{
+          params, std::move(likelihood_field), beluga_ros::OccupancyGrid{map}.origin()};
+    }
     return beluga::LikelihoodFieldModel{params, beluga_ros::OccupancyGrid{map}};
   }
   if (name == kBeamSensorModelName) {
@@ -315,6 +668,7 @@ auto AmclNode::get_sensor_model(std::string_view name, nav_msgs::msg::OccupancyG
     params.sigma_hit = get_parameter("sigma_hit").as_double();
     params.lambda_short = get_parameter("lambda_short").as_double();
     params.beam_max_range = get_parameter("laser_max_range").as_double();
+    params.early_termination_ratio = get_parameter("laser_early_termination_ratio").as_double();
     return beluga::BeamSensorModel{params, beluga_ros::OccupancyGrid{map}};
   }
   throw std::invalid_argument(std::string("Invalid sensor model: ") + std::string(name));
@@ -336,6 +690,17 @@ auto AmclNode::make_particle_filter(nav_msgs::msg::OccupancyGrid::SharedPtr map)
   params.spatial_resolution_x = get_parameter("spatial_resolution_x").as_double();
   params.spatial_resolution_y = get_parameter("spatial_resolution_y").as_double();
   params.spatial_resolution_theta = get_parameter("spatial_resolution_theta").as_double();
+  params.global_localization_stratified = get_parameter("global_localization_stratified").as_bool();
+  params.scan_matching_max_hypotheses =
+      static_cast<std::size_t>(get_parameter("scan_matching_max_hypotheses").as_int());
+  params.scan_matching_pyramid_depth = static_cast<std::size_t>(get_parameter("scan_matching_pyramid_depth").as_int());
+  params.scan_matching_angular_step = get_parameter("scan_matching_angular_step").as_double();
+  params.scan_matching_linear_std_dev = get_parameter("scan_matching_linear_std_dev").as_double();
+  params.scan_matching_angular_std_dev = get_parameter("scan_matching_angular_std_dev").as_double();
+  params.refinement_max_iterations =
+      static_cast<std::size_t>(get_parameter("pose_refinement_max_iterations").as_int());
+  params.refinement_max_linear_correction = get_parameter("pose_refinement_max_linear_correction").as_double();
+  params.refinement_max_angular_correction = get_parameter("pose_refinement_max_angular_correction").as_double();
 
   return std::make_unique<beluga_ros::Amcl>(
       beluga_ros::OccupancyGrid{map},                                        //
@@ -368,12 +733,29 @@ void AmclNode::map_callback(nav_msgs::msg::OccupancyGrid::SharedPtr map) {
       RCLCPP_INFO(get_logger(), "Initializing particle filter instance");
       particle_filter_ = make_particle_filter(std::move(map));
       RCLCPP_INFO(get_logger(), "Particle filter initialization completed");
-    } catch (const std::invalid_argument& error) {
+      for (auto& [id, registered_map] : maps_to_register_) {
+        particle_filter_->add_map(id, beluga_ros::OccupancyGrid{std::move(registered_map)});
+      }
+      maps_to_register_.clear();
+      if (initialize_from_checkpoint()) {
+        return;  // Success!
+      }
+    } catch (const std::exception& error) {
+      // Tiled maps may fail to open too, besides invalid parameters.
       RCLCPP_ERROR(get_logger(), "Could not initialize particle filter: %s", error.what());
       return;
     }
+  } else if (get_parameter("background_map_updates").as_bool()) {
+    RCLCPP_INFO(get_logger(), "Preprocessing the new map in the background");
+    particle_filter_->update_map_in_background(beluga_ros::OccupancyGrid{std::move(map)});
+    return;
   } else {
-    particle_filter_->update_map(beluga_ros::OccupancyGrid{std::move(map)});
+    try {
+      particle_filter_->update_map(beluga_ros::OccupancyGrid{std::move(map)});
+    } catch (const std::exception& error) {
+      RCLCPP_ERROR(get_logger(), "Could not update map, keeping the current one: %s", error.what());
+      return;
+    }
   }
 
   if (should_reset_initial_pose) {
@@ -400,28 +782,77 @@ void AmclNode::do_periodic_timer_callback() {
     return;
   }
 
+  const auto parameters = parameter_snapshot();
+
   if (particle_cloud_pub_->get_subscription_count() > 0) {
     auto message = beluga_ros::msg::PoseArray{};
     beluga_ros::assign_particle_cloud(particle_filter_->particles(), message);
-    beluga_ros::stamp_message(get_parameter("global_frame_id").as_string(), now(), message);
+    beluga_ros::stamp_message(parameters->global_frame_id, now(), message);
     particle_cloud_pub_->publish(message);
   }
 
+  if (particle_pointcloud_pub_->get_subscription_count() > 0) {
+    const auto& particles = particle_filter_->particles();
+    const auto size = static_cast<std::size_t>(get_parameter("particle_pointcloud_size").as_int());
+    beluga_ros::assign_particle_cloud(particles, size > 0 ? size : particles.size(), particle_pointcloud_message_);
+    beluga_ros::stamp_message(parameters->global_frame_id, now(), particle_pointcloud_message_);
+    particle_pointcloud_pub_->publish(particle_pointcloud_message_);
+  }
+
   if (particle_markers_pub_->get_subscription_count() > 0) {
     auto message = beluga_ros::msg::MarkerArray{};
     beluga_ros::assign_particle_cloud(particle_filter_->particles(), message);
-    beluga_ros::stamp_message(get_parameter("global_frame_id").as_string(), now(), message);
+    beluga_ros::stamp_message(parameters->global_frame_id, now(), message);
     particle_markers_pub_->publish(message);
   }
 }
 
 void AmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan) {
+  process_laser_scans({std::move(laser_scan)});
+}
+
+void AmclNode::synchronized_laser_callback(
+    sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan,
+    sensor_msgs::msg::LaserScan::ConstSharedPtr secondary_laser_scan) {
+  const auto stamp = rclcpp::Time(laser_scan->header.stamp);
+  if (last_primary_laser_scan_stamp_.has_value() && stamp <= last_primary_laser_scan_stamp_.value()) {
+    // When the secondary laser scanner resumes, it may be paired with a queued primary laser scan that was
+    // processed on its own already. Processing it again would count it twice and take odometry backwards.
+    RCLCPP_DEBUG(get_logger(), "Dropping laser scan pair, its primary laser scan was processed already");
+    return;
+  }
+  last_synchronized_laser_scan_stamp_ = stamp;
+  last_primary_laser_scan_stamp_ = stamp;
+  process_laser_scans({std::move(laser_scan), std::move(secondary_laser_scan)});
+}
+
+void AmclNode::primary_laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan) {
+  // The synchronizer is called first, so primary laser scans that completed a pair have been processed already.
+  // Those that did not may still be paired later on, see synchronized_laser_callback().
+  const auto stamp = rclcpp::Time(laser_scan->header.stamp);
+  if (!last_synchronized_laser_scan_stamp_.has_value()) {
+    last_synchronized_laser_scan_stamp_ = stamp;
+    return;
+  }
+  if (stamp - last_synchronized_laser_scan_stamp_.value() <= secondary_laser_scan_timeout_) {
+    return;
+  }
+  RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 2000, "No laser scans from the secondary laser scanner, updating with primary ones");
+  last_primary_laser_scan_stamp_ = stamp;
+  process_laser_scans({std::move(laser_scan)});
+}
+
+void AmclNode::process_laser_scans(const std::vector<sensor_msgs::msg::LaserScan::ConstSharedPtr>& laser_scans) {
+  const auto& laser_scan = laser_scans.front();
   if (!particle_filter_) {
     RCLCPP_WARN_THROTTLE(
         get_logger(), *get_clock(), 2000, "Ignoring laser data because the particle filter has not been initialized");
     return;
   }
 
+  const auto parameters = parameter_snapshot();
+
   auto base_pose_in_odom = Sophus::SE2d{};
   try {
     // Use the lookupTransform overload with no timeout since we're not using a dedicated
@@ -429,7 +860,7 @@ void AmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_
     tf2::convert(
         tf_buffer_
             ->lookupTransform(
-                get_parameter("odom_frame_id").as_string(), get_parameter("base_frame_id").as_string(),
+                parameters->odom_frame_id, parameters->base_frame_id,
                 tf2_ros::fromMsg(laser_scan->header.stamp))
             .transform,
         base_pose_in_odom);
@@ -438,42 +869,90 @@ void AmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_
     return;
   }
 
-  auto laser_pose_in_base = Sophus::SE3d{};
-  try {
+  // Laser scans are only made, and the base to laser transforms only looked up, for those scans the filter is
+  // going to use (or for scan matching, when requested).
+  auto make_laser_scan = [this, &parameters](const sensor_msgs::msg::LaserScan::ConstSharedPtr& message) {
+    auto laser_pose_in_base = Sophus::SE3d{};
     tf2::convert(
         tf_buffer_
             ->lookupTransform(
-                get_parameter("base_frame_id").as_string(), laser_scan->header.frame_id,
-                tf2_ros::fromMsg(laser_scan->header.stamp))
+                parameters->base_frame_id, message->header.frame_id,
+                tf2_ros::fromMsg(message->header.stamp))
             .transform,
         laser_pose_in_base);
+    return beluga_ros::LaserScan{
+        message,
+        laser_pose_in_base,
+        parameters->max_beams,
+        parameters->laser_min_range,
+        parameters->laser_max_range,
+    };
+  };
+
+  auto new_estimate = std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>>{};
+  auto update_duration = std::chrono::high_resolution_clock::duration{};
+  const auto map_swaps = particle_filter_->map_update_stats().swaps;
+  const auto early_termination_stats = particle_filter_->early_termination_stats();
+  try {
+    if (scan_matching_requested_) {
+      const auto scan = make_laser_scan(laser_scan);
+      scan_matching_requested_ = false;
+      if (!initialize_from_scan_matching(scan)) {
+        initialize_from_map();
+      }
+    }
+
+    const auto update_start_time = std::chrono::high_resolution_clock::now();
+    if (laser_scans.size() == 1) {
+      new_estimate = particle_filter_->update(base_pose_in_odom, [&]() { return make_laser_scan(laser_scan); });
+    } else {
+      new_estimate = particle_filter_->update(base_pose_in_odom, [&]() {
+        auto scans = std::vector<beluga_ros::LaserScan>{};
+        scans.reserve(laser_scans.size());
+        for (const auto& message : laser_scans) {
+          scans.push_back(make_laser_scan(message));
+        }
+        return scans;
+      });
+    }
+    const auto update_stop_time = std::chrono::high_resolution_clock::now();
+    update_duration = update_stop_time - update_start_time;
   } catch (const tf2::TransformException& error) {
     RCLCPP_ERROR(get_logger(), "Could not transform from base to laser: %s", error.what());
     return;
   }
 
-  const auto update_start_time = std::chrono::high_resolution_clock::now();
-  const auto new_estimate = particle_filter_->update(
-      base_pose_in_odom,  //
-      beluga_ros::LaserScan{
-          laser_scan,
-          laser_pose_in_base,
-          static_cast<std::size_t>(get_parameter("max_beams").as_int()),
-          get_parameter("laser_min_range").as_double(),
-          get_parameter("laser_max_range").as_double(),
-      });
-  const auto update_stop_time = std::chrono::high_resolution_clock::now();
-  const auto update_duration = update_stop_time - update_start_time;
+  if (const auto& stats = particle_filter_->map_update_stats(); stats.swaps != map_swaps) {
+    RCLCPP_INFO(
+        get_logger(), "New map swapped in - built in %.3fms, swapped in %.3fms",
+        std::chrono::duration<double, std::milli>(stats.last_build_duration).count(),
+        std::chrono::duration<double, std::milli>(stats.last_swap_duration).count());
+  }
 
   if (new_estimate.has_value()) {
     const auto& [base_pose_in_map, _] = new_estimate.value();
     last_known_odom_transform_in_map_ = base_pose_in_map * base_pose_in_odom.inverse();
     last_known_estimate_ = new_estimate;
 
-    RCLCPP_INFO(
-        get_logger(), "Particle filter update iteration stats: %ld particles %ld points - %.3fms",
-        particle_filter_->particles().size(), laser_scan->ranges.size(),
-        std::chrono::duration<double, std::milli>(update_duration).count());
+    const auto point_count = std::accumulate(
+        laser_scans.begin(), laser_scans.end(), std::size_t{0},
+        [](std::size_t count, const auto& message) { return count + message->ranges.size(); });
+    const auto& stats = particle_filter_->early_termination_stats();
+    const auto update_early_termination_stats = beluga::EarlyTerminationStats{
+        stats.evaluated - early_termination_stats.evaluated, stats.total - early_termination_stats.total};
+    if (update_early_termination_stats.total > 0UL) {
+      // Only bounded weighting counts point evaluations, ie. when laser_early_termination_ratio is non-zero.
+      RCLCPP_INFO(
+          get_logger(), "Particle filter update iteration stats: %ld particles %ld points - %.3fms - %.1f%% saved",
+          particle_filter_->particles().size(), point_count,
+          std::chrono::duration<double, std::milli>(update_duration).count(),
+          100.0 * update_early_termination_stats.saved_fraction());
+    } else {
+      RCLCPP_INFO(
+          get_logger(), "Particle filter update iteration stats: %ld particles %ld points - %.3fms",
+          particle_filter_->particles().size(), point_count,
+          std::chrono::duration<double, std::milli>(update_duration).count());
+    }
   }
 
   if (!last_known_estimate_.has_value()) {
@@ -482,15 +961,15 @@ void AmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_
   }
 
   // Transforms are always published to keep them current.
-  if (enable_tf_broadcast_ && get_parameter("tf_broadcast").as_bool()) {
+  if (enable_tf_broadcast_ && parameters->tf_broadcast) {
     if (last_known_odom_transform_in_map_.has_value()) {
       auto message = geometry_msgs::msg::TransformStamped{};
       // Sending a transform that is valid into the future so that odom can be used.
       const auto expiration_stamp = tf2_ros::fromMsg(laser_scan->header.stamp) +
-                                    tf2::durationFromSec(get_parameter("transform_tolerance").as_double());
+                                    tf2::durationFromSec(parameters->transform_tolerance);
       message.header.stamp = tf2_ros::toMsg(expiration_stamp);
-      message.header.frame_id = get_parameter("global_frame_id").as_string();
-      message.child_frame_id = get_parameter("odom_frame_id").as_string();
+      message.header.frame_id = parameters->global_frame_id;
+      message.child_frame_id = parameters->odom_frame_id;
       message.transform = tf2::toMsg(*last_known_odom_transform_in_map_);
       tf_broadcaster_->sendTransform(message);
     }
@@ -500,7 +979,7 @@ void AmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_
   if (new_estimate.has_value()) {
     auto message = geometry_msgs::msg::PoseWithCovarianceStamped{};
     message.header.stamp = laser_scan->header.stamp;
-    message.header.frame_id = get_parameter("global_frame_id").as_string();
+    message.header.frame_id = parameters->global_frame_id;
     const auto& [base_pose_in_map, base_pose_covariance] = new_estimate.value();
     tf2::toMsg(base_pose_in_map, message.pose.pose);
     tf2::covarianceEigenToRowMajor(base_pose_covariance, message.pose.covariance);
@@ -520,10 +999,113 @@ void AmclNode::do_initial_pose_callback(geometry_msgs::msg::PoseWithCovarianceSt
   initialize_from_estimate(last_known_estimate_.value());
 }
 
+void AmclNode::registered_map_callback(const std::string& id, nav_msgs::msg::OccupancyGrid::SharedPtr map) {
+  RCLCPP_INFO(get_logger(), "A new map was received for map id \"%s\"", id.c_str());
+
+  const auto global_frame_id = get_parameter("global_frame_id").as_string();
+  if (map->header.frame_id != global_frame_id) {
+    RCLCPP_WARN(
+        get_logger(), "Map frame \"%s\" doesn't match global frame \"%s\"", map->header.frame_id.c_str(),
+        global_frame_id.c_str());
+  }
+
+  if (!particle_filter_) {
+    // Maps are registered as soon as the particle filter is initialized, on the first map.
+    maps_to_register_.insert_or_assign(id, std::move(map));
+    return;
+  }
+
+  particle_filter_->add_map(id, beluga_ros::OccupancyGrid{std::move(map)});
+  RCLCPP_INFO(get_logger(), "Preprocessing map \"%s\" in the background", id.c_str());
+}
+
+void AmclNode::switch_map_callback(
+    const std::string& id,
+    [[maybe_unused]] std::shared_ptr<rmw_request_id_t> request_header,
+    [[maybe_unused]] std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+    std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+  if (!particle_filter_) {
+    response->success = false;
+    response->message = "The particle filter has not been initialized";
+    RCLCPP_WARN(get_logger(), "Ignoring map switch request because the particle filter has not been initialized");
+    return;
+  }
+
+  if (!particle_filter_->map_ready(id)) {
+    RCLCPP_WARN(get_logger(), "Map \"%s\" is not ready yet, waiting for it to be preprocessed", id.c_str());
+  }
+
+  if (!particle_filter_->switch_map(id)) {
+    response->success = false;
+    response->message = "Map \"" + id + "\" has not been received yet or failed to be preprocessed";
+    RCLCPP_WARN(
+        get_logger(), "Could not switch to map \"%s\": it has not been received yet or failed to be preprocessed",
+        id.c_str());
+    return;
+  }
+
+  response->success = true;
+  response->message = "Switched to map \"" + id + "\"";
+  RCLCPP_INFO(get_logger(), "Switched to map \"%s\"", id.c_str());
+}
+
+void AmclNode::checkpoint_timer_callback() {
+  if (!particle_filter_ || !last_known_estimate_.has_value()) {
+    return;
+  }
+  try {
+    // Particles are copied here, but written to disk on a worker thread.
+    if (!checkpoint_writer_->write(particle_filter_->checkpoint())) {
+      RCLCPP_WARN(get_logger(), "Skipping particle filter checkpoint, the previous one is still being saved");
+    }
+  } catch (const std::runtime_error& error) {
+    RCLCPP_ERROR(get_logger(), "Could not save particle filter checkpoint: %s", error.what());
+  }
+}
+
+bool AmclNode::initialize_from_checkpoint() {
+  const auto checkpoint_path = get_parameter("checkpoint_path").as_string();
+  if (checkpoint_path.empty()) {
+    return false;
+  }
+
+  RCLCPP_INFO(get_logger(), "Initializing particles from checkpoint %s", checkpoint_path.c_str());
+  try {
+    auto checkpoint = beluga_ros::load_checkpoint(checkpoint_path);
+    if (!checkpoint.has_value() || checkpoint->particles.empty()) {
+      RCLCPP_INFO(get_logger(), "No particle filter checkpoint to restore from");
+      return false;
+    }
+    particle_filter_->restore(std::move(checkpoint).value());
+  } catch (const std::runtime_error& error) {
+    RCLCPP_WARN(get_logger(), "Could not restore particle filter checkpoint: %s", error.what());
+    return false;
+  }
+
+  const auto& particles = particle_filter_->particles();
+  last_known_estimate_ = beluga::estimate(beluga::views::states(particles), beluga::views::weights(particles));
+  last_known_odom_transform_in_map_.reset();
+  enable_tf_broadcast_ = true;
+
+  RCLCPP_INFO(get_logger(), "Particle filter restored from checkpoint with %ld particles", particles.size());
+  return true;
+}
+
 void AmclNode::global_localization_callback(
     [[maybe_unused]] std::shared_ptr<rmw_request_id_t> request_header,
     [[maybe_unused]] std::shared_ptr<std_srvs::srv::Empty::Request> req,
     [[maybe_unused]] std::shared_ptr<std_srvs::srv::Empty::Response> res) {
+  const auto mode = get_parameter("global_localization_mode").as_string();
+  if (mode == kScanMatchingGlobalLocalizationModeName) {
+    RCLCPP_INFO(get_logger(), "Global localization by scan matching requested, waiting for the next laser scan");
+    scan_matching_requested_ = true;
+    return;
+  }
+  if (mode != kUniformGlobalLocalizationModeName) {
+    RCLCPP_WARN(
+        get_logger(), "Invalid global localization mode \"%s\", falling back to \"%s\"", mode.c_str(),
+        kUniformGlobalLocalizationModeName.data());
+  }
   initialize_from_map();
 }
 
@@ -574,12 +1156,40 @@ bool AmclNode::initialize_from_map() {
     return false;
   }
 
+  const auto initialization_start_time = std::chrono::high_resolution_clock::now();
   particle_filter_->initialize_from_map();
+  const auto initialization_duration = std::chrono::high_resolution_clock::now() - initialization_start_time;
+  enable_tf_broadcast_ = true;
+
+  RCLCPP_INFO(
+      get_logger(), "Particle filter initialized with %ld particles distributed across the map - %.3fms",
+      particle_filter_->particles().size(),
+      std::chrono::duration<double, std::milli>(initialization_duration).count());
+
+  return true;
+}
+
+bool AmclNode::initialize_from_scan_matching(const beluga_ros::LaserScan& laser_scan) {
+  RCLCPP_INFO(get_logger(), "Initializing particles from scan matching");
+
+  if (!particle_filter_) {
+    RCLCPP_ERROR(get_logger(), "Could not initialize particles: The particle filter has not been initialized");
+    return false;
+  }
+
+  const auto start_time = std::chrono::high_resolution_clock::now();
+  if (!particle_filter_->initialize_from_scan_matching(laser_scan)) {
+    RCLCPP_WARN(
+        get_logger(),
+        "Could not initialize particles from scan matching: No hypotheses found or sensor model not supported");
+    return false;
+  }
+  const auto duration = std::chrono::high_resolution_clock::now() - start_time;
   enable_tf_broadcast_ = true;
 
   RCLCPP_INFO(
-      get_logger(), "Particle filter initialized with %ld particles distributed across the map",
-      particle_filter_->particles().size());
+      get_logger(), "Particle filter initialized with %ld particles around scan matching hypotheses - %.3fms",
+      particle_filter_->particles().size(), std::chrono::duration<double, std::milli>(duration).count());
 
   return true;
 }
@@ -26,8 +26,11 @@
 #include <nav_msgs/OccupancyGrid.h>
 #include <nav_msgs/SetMap.h>
 #include <sensor_msgs/LaserScan.h>
+#include <sensor_msgs/PointCloud2.h>
 #include <std_srvs/Empty.h>
 
+#include <beluga/algorithm/estimation.hpp>
+#include <beluga_ros/checkpoint.hpp>
 #include <beluga_ros/laser_scan.hpp>
 #include <beluga_ros/occupancy_grid.hpp>
 #include <beluga_ros/particle_cloud.hpp>
@@ -60,6 +63,7 @@ void AmclNodelet::onInit() {
 
   particle_cloud_timer_ = nh.createTimer(ros::Duration(0.2), &AmclNodelet::particle_cloud_timer_callback, this);
   particle_cloud_pub_ = nh.advertise<geometry_msgs::PoseArray>("particlecloud", 2);
+  particle_pointcloud_pub_ = nh.advertise<sensor_msgs::PointCloud2>("particle_pointcloud", 2);
   pose_pub_ = nh.advertise<geometry_msgs::PoseWithCovarianceStamped>("amcl_pose", 2);
 
   if (config_.use_map_topic) {
@@ -80,6 +84,13 @@ void AmclNodelet::onInit() {
         nh.createTimer(ros::Duration(1.0 / config_.save_pose_rate), &AmclNodelet::save_pose_timer_callback, this);
   }
 
+  if (!config_.checkpoint_path.empty() && config_.checkpoint_rate > 0.0) {
+    checkpoint_writer_ = std::make_unique<beluga_ros::AsyncCheckpointWriter>(config_.checkpoint_path);
+    checkpoint_timer_ =
+        nh.createTimer(ros::Duration(1.0 / config_.checkpoint_rate), &AmclNodelet::checkpoint_timer_callback, this);
+    NODELET_INFO("Saving particle filter checkpoints to %s", config_.checkpoint_path.c_str());
+  }
+
   tf_buffer_ = std::make_unique<tf2_ros::Buffer>();
   tf_broadcaster_ = std::make_unique<tf2_ros::TransformBroadcaster>();
   tf_listener_ = std::make_unique<tf2_ros::TransformListener>(*tf_buffer_);
@@ -298,7 +309,12 @@ bool AmclNodelet::set_map_callback(nav_msgs::SetMap::Request& request, nav_msgs:
       return false;
     }
   } else {
-    particle_filter_->update_map(beluga_ros::OccupancyGrid{map});
+    try {
+      particle_filter_->update_map(beluga_ros::OccupancyGrid{map});
+    } catch (const std::invalid_argument& error) {
+      NODELET_ERROR("Could not update map, keeping the current one: %s", error.what());
+      return false;
+    }
   }
 
   last_known_map_ = map;
@@ -346,8 +362,17 @@ void AmclNodelet::handle_map_with_default_initial_pose(const nav_msgs::Occupancy
       NODELET_ERROR("Could not initialize particle filter: %s", error.what());
       return;
     }
+    if (initialize_from_checkpoint()) {
+      last_known_map_ = map;
+      return;  // Success!
+    }
   } else {
-    particle_filter_->update_map(beluga_ros::OccupancyGrid{map});
+    try {
+      particle_filter_->update_map(beluga_ros::OccupancyGrid{map});
+    } catch (const std::invalid_argument& error) {
+      NODELET_ERROR("Could not update map, keeping the current one: %s", error.what());
+      return;
+    }
   }
 
   if (should_reset_initial_pose) {
@@ -377,14 +402,20 @@ void AmclNodelet::particle_cloud_timer_callback(const ros::TimerEvent& ev) {
     return;
   }
 
-  if (particle_cloud_pub_.getNumSubscribers() == 0) {
-    return;
+  if (particle_cloud_pub_.getNumSubscribers() > 0) {
+    auto message = beluga_ros::msg::PoseArray{};
+    beluga_ros::assign_particle_cloud(particle_filter_->particles(), message);
+    beluga_ros::stamp_message(config_.global_frame_id, ev.current_real, message);
+    particle_cloud_pub_.publish(message);
   }
 
-  auto message = beluga_ros::msg::PoseArray{};
-  beluga_ros::assign_particle_cloud(particle_filter_->particles(), message);
-  beluga_ros::stamp_message(config_.global_frame_id, ev.current_real, message);
-  particle_cloud_pub_.publish(message);
+  if (particle_pointcloud_pub_.getNumSubscribers() > 0) {
+    const auto& particles = particle_filter_->particles();
+    const auto size = static_cast<std::size_t>(config_.particle_pointcloud_size);
+    beluga_ros::assign_particle_cloud(particles, size > 0 ? size : particles.size(), particle_pointcloud_message_);
+    beluga_ros::stamp_message(config_.global_frame_id, ev.current_real, particle_pointcloud_message_);
+    particle_pointcloud_pub_.publish(particle_pointcloud_message_);
+  }
 }
 
 void AmclNodelet::laser_callback(const sensor_msgs::LaserScan::ConstPtr& laser_scan) {
@@ -515,6 +546,48 @@ void AmclNodelet::save_pose_timer_callback(const ros::TimerEvent&) {
   }
 }
 
+void AmclNodelet::checkpoint_timer_callback(const ros::TimerEvent&) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!particle_filter_ || !last_known_estimate_.has_value()) {
+    return;
+  }
+  try {
+    // Particles are copied here, but written to disk on a worker thread.
+    if (!checkpoint_writer_->write(particle_filter_->checkpoint())) {
+      NODELET_WARN("Skipping particle filter checkpoint, the previous one is still being saved");
+    }
+  } catch (const std::runtime_error& error) {
+    NODELET_ERROR("Could not save particle filter checkpoint: %s", error.what());
+  }
+}
+
+bool AmclNodelet::initialize_from_checkpoint() {
+  if (config_.checkpoint_path.empty()) {
+    return false;
+  }
+
+  NODELET_INFO("Initializing particles from checkpoint %s", config_.checkpoint_path.c_str());
+  try {
+    auto checkpoint = beluga_ros::load_checkpoint(config_.checkpoint_path);
+    if (!checkpoint.has_value() || checkpoint->particles.empty()) {
+      NODELET_INFO("No particle filter checkpoint to restore from");
+      return false;
+    }
+    particle_filter_->restore(std::move(checkpoint).value());
+  } catch (const std::runtime_error& error) {
+    NODELET_WARN("Could not restore particle filter checkpoint: %s", error.what());
+    return false;
+  }
+
+  const auto& particles = particle_filter_->particles();
+  last_known_estimate_ = beluga::estimate(beluga::views::states(particles), beluga::views::weights(particles));
+  last_known_odom_transform_in_map_.reset();
+  enable_tf_broadcast_ = true;
+
+  NODELET_INFO("Particle filter restored from checkpoint with %ld particles", particles.size());
+  return true;
+}
+
 bool AmclNodelet::global_localization_callback(
     [[maybe_unused]] std_srvs::Empty::Request&,
     [[maybe_unused]] std_srvs::Empty::Response&) {
@@ -18,6 +18,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <random>
 #include <rclcpp/duration.hpp>
 #include <stdexcept>
 #include <string>
@@ -58,14 +59,12 @@
 #include <sensor_msgs/msg/laser_scan.hpp>
 
 #include <beluga/algorithm/amcl_core.hpp>
-#include <beluga/algorithm/estimation.hpp>
 #include <beluga/algorithm/spatial_hash.hpp>
 #include <beluga/motion/differential_drive_model.hpp>
 #include <beluga/motion/omnidirectional_drive_model.hpp>
 #include <beluga/motion/stationary_model.hpp>
-#include <beluga/random/multivariate_normal_distribution.hpp>
+#include <beluga/random/multivariate_uniform_distribution.hpp>
 #include <beluga/sensor/ndt_sensor_model.hpp>
-#include <beluga/views/particles.hpp>
 #include <beluga_ros/messages.hpp>
 #include <beluga_ros/particle_cloud.hpp>
 #include <beluga_ros/tf2_sophus.hpp>
@@ -235,17 +234,18 @@ auto NdtAmclNode::make_particle_filter() const -> std::unique_ptr<NdtAmclVariant
             get_parameter("spatial_resolution_x").as_double(), get_parameter("spatial_resolution_y").as_double(),
             get_parameter("spatial_resolution_theta").as_double());
 
-        RandomStateGenerator random_state_maker = [](const auto& particles) {
+        // Random states are drawn from map cells, so that the filter can adapt its size and recover.
+        auto sensor_model = get_sensor_model();
+        using Distribution = beluga::MultivariateUniformDistribution<Sophus::SE2d, NDTMapRepresentation>;
+        auto distribution = std::make_shared<Distribution>(sensor_model.cells_data());
+        RandomStateGenerator random_state_maker = [distribution]() {
           static thread_local auto generator = std::mt19937{std::random_device()()};
-          const auto estimate = beluga::estimate(beluga::views::states(particles), beluga::views::weights(particles));
-          return [estimate]() {
-            return beluga::MultivariateNormalDistribution{estimate.first, estimate.second}(generator);
-          };
+          return (*distribution)(generator);
         };
 
         return beluga::Amcl(
             std::move(motion_model),
-            get_sensor_model(),             //
+            std::move(sensor_model),        //
             std::move(random_state_maker),  //
             std::move(hasher),              //
             params,                         //
@@ -260,14 +260,16 @@ void NdtAmclNode::do_periodic_timer_callback() {
     return;
   }
 
+  const auto parameters = parameter_snapshot();
+
   if (particle_cloud_pub_->get_subscription_count() == 0) {
     return;
   }
   std::visit(
-      [this](const auto& particle_filter) {
+      [this, &parameters](const auto& particle_filter) {
         auto message = beluga_ros::msg::PoseArray{};
         beluga_ros::assign_particle_cloud(particle_filter.particles(), message);
-        beluga_ros::stamp_message(get_parameter("global_frame_id").as_string(), now(), message);
+        beluga_ros::stamp_message(parameters->global_frame_id, now(), message);
         particle_cloud_pub_->publish(message);
       },
       *particle_filter_);
@@ -282,6 +284,8 @@ void NdtAmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr las
     return;
   }
 
+  const auto parameters = parameter_snapshot();
+
   auto base_pose_in_odom = Sophus::SE2d{};
   try {
     // Use the lookupTransform overload with no timeout since we're not using a dedicated
@@ -289,7 +293,7 @@ void NdtAmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr las
     tf2::convert(
         tf_buffer_
             ->lookupTransform(
-                get_parameter("odom_frame_id").as_string(), get_parameter("base_frame_id").as_string(),
+                parameters->odom_frame_id, parameters->base_frame_id,
                 tf2_ros::fromMsg(laser_scan->header.stamp))
             .transform,
         base_pose_in_odom);
@@ -303,7 +307,7 @@ void NdtAmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr las
     tf2::convert(
         tf_buffer_
             ->lookupTransform(
-                get_parameter("base_frame_id").as_string(), laser_scan->header.frame_id,
+                parameters->base_frame_id, laser_scan->header.frame_id,
                 tf2_ros::fromMsg(laser_scan->header.stamp))
             .transform,
         laser_pose_in_base);
@@ -314,20 +318,22 @@ void NdtAmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr las
 
   const auto update_start_time = std::chrono::high_resolution_clock::now();
 
-  // TODO(nahuel, Ramiro): Remove this once we update the measurement type.
-  auto scan = beluga_ros::LaserScan{
-      laser_scan, laser_pose_in_base, static_cast<std::size_t>(get_parameter("max_beams").as_int()),
-      get_parameter("laser_min_range").as_double(), get_parameter("laser_max_range").as_double()};
-  auto measurement = scan.points_in_cartesian_coordinates() |  //
-                     ranges::views::transform([&scan](const auto& p) {
-                       return Eigen::Vector2d((scan.origin() * Sophus::Vector3d{p.x(), p.y(), 0}).head<2>());
-                     }) |
-                     ranges::to<std::vector>;
+  // Laser scans are only converted into measurements for those scans the filter is going to use.
+  auto make_measurement = [&parameters, &laser_scan, &laser_pose_in_base]() {
+    // TODO(nahuel, Ramiro): Remove this once we update the measurement type.
+    const auto scan = beluga_ros::LaserScan{
+        laser_scan, laser_pose_in_base, parameters->max_beams, parameters->laser_min_range,
+        parameters->laser_max_range};
+    return scan.points_in_cartesian_coordinates() |  //
+           ranges::views::transform([&scan](const auto& p) {
+             return Eigen::Vector2d((scan.origin() * Sophus::Vector3d{p.x(), p.y(), 0}).head<2>());
+           }) |
+           ranges::to<std::vector>;
+  };
+
   const auto new_estimate = std::visit(
-      [base_pose_in_odom, measurement = std::move(measurement)](auto& particle_filter) {
-        return particle_filter.update(
-            base_pose_in_odom,  //
-            std::move(measurement));
+      [&base_pose_in_odom, &make_measurement](auto& particle_filter) {
+        return particle_filter.update(base_pose_in_odom, make_measurement);
       },
       *particle_filter_);
 
@@ -353,15 +359,15 @@ void NdtAmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr las
   }
 
   // Transforms are always published to keep them current.
-  if (enable_tf_broadcast_ && get_parameter("tf_broadcast").as_bool()) {
+  if (enable_tf_broadcast_ && parameters->tf_broadcast) {
     if (last_known_odom_transform_in_map_.has_value()) {
       auto message = geometry_msgs::msg::TransformStamped{};
       // Sending a transform that is valid into the future so that odom can be used.
       const auto expiration_stamp = tf2_ros::fromMsg(laser_scan->header.stamp) +
-                                    tf2::durationFromSec(get_parameter("transform_tolerance").as_double());
+                                    tf2::durationFromSec(parameters->transform_tolerance);
       message.header.stamp = tf2_ros::toMsg(expiration_stamp);
-      message.header.frame_id = get_parameter("global_frame_id").as_string();
-      message.child_frame_id = get_parameter("odom_frame_id").as_string();
+      message.header.frame_id = parameters->global_frame_id;
+      message.child_frame_id = parameters->odom_frame_id;
       message.transform = tf2::toMsg(last_known_odom_transform_in_map_.value());
       tf_broadcaster_->sendTransform(message);
     }
@@ -371,7 +377,7 @@ void NdtAmclNode::laser_callback(sensor_msgs::msg::LaserScan::ConstSharedPtr las
   if (new_estimate.has_value()) {
     auto message = geometry_msgs::msg::PoseWithCovarianceStamped{};
     message.header.stamp = laser_scan->header.stamp;
-    message.header.frame_id = get_parameter("global_frame_id").as_string();
+    message.header.frame_id = parameters->global_frame_id;
     const auto& [base_pose_in_map, base_pose_covariance] = new_estimate.value();
     tf2::toMsg(base_pose_in_map, message.pose.pose);
     tf2::covarianceEigenToRowMajor(base_pose_covariance, message.pose.covariance);
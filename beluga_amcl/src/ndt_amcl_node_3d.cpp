@@ -21,9 +21,9 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <random>
 #include <range/v3/view/zip.hpp>
 #include <rclcpp/duration.hpp>
-#include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <sophus/se3.hpp>
 #include <stdexcept>
 #include <string>
@@ -70,10 +70,12 @@
 #include <beluga/motion/differential_drive_model.hpp>
 
 #include <beluga/random/multivariate_normal_distribution.hpp>
+#include <beluga/random/multivariate_uniform_distribution.hpp>
 #include <beluga/sensor/ndt_sensor_model.hpp>
 #include <beluga/views/particles.hpp>
 #include <beluga_ros/messages.hpp>
 #include <beluga_ros/particle_cloud.hpp>
+#include <beluga_ros/point_cloud.hpp>
 #include <beluga_ros/tf2_sophus.hpp>
 #include "beluga_amcl/ndt_amcl_node_3d.hpp"
 #include "beluga_amcl/ros2_common.hpp"
@@ -150,6 +152,22 @@ NdtAmclNode3D::NdtAmclNode3D(const rclcpp::NodeOptions& options) : BaseAMCLNode{
     descriptor.floating_point_range[0].step = 0;
     declare_parameter("d2", rclcpp::ParameterValue(0.6), descriptor);
   }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Minimum height of map cells to draw random particles from, in meters. "
+        "Along with the maximum height, it should span the ground for ground robots.";
+    declare_parameter("recovery_min_z", rclcpp::ParameterValue(-1.0), descriptor);
+  }
+
+  {
+    auto descriptor = rcl_interfaces::msg::ParameterDescriptor();
+    descriptor.description =
+        "Maximum height of map cells to draw random particles from, in meters. "
+        "Along with the minimum height, it should span the ground for ground robots.";
+    declare_parameter("recovery_max_z", rclcpp::ParameterValue(1.0), descriptor);
+  }
 }
 
 void NdtAmclNode3D::do_activate(const rclcpp_lifecycle::State&) {
@@ -298,9 +316,15 @@ auto NdtAmclNode3D::make_particle_filter() const -> std::unique_ptr<NdtAmclVaria
         auto hasher = beluga::spatial_hash<Sophus::SE3d>(
             get_parameter("spatial_resolution_x").as_double(), get_parameter("spatial_resolution_theta").as_double());
 
-        // We don't support randomly sampling from NDT maps, so we enforce a non-adaptive filter.
-        assert(params.min_particles == params.max_particles);
-        RandomStateGenerator random_state_maker = []() { return Sophus::SE3d{}; };
+        // Random states are drawn from map cells within a height band, to keep them on the ground,
+        // so that the filter can adapt its size and recover.
+        using Distribution = beluga::MultivariateUniformDistribution<Sophus::SE3d, NDTMapRepresentation>;
+        auto distribution = std::make_shared<Distribution>(
+            map_, get_parameter("recovery_min_z").as_double(), get_parameter("recovery_max_z").as_double());
+        RandomStateGenerator random_state_maker = [distribution]() {
+          static thread_local auto generator = std::mt19937{std::random_device()()};
+          return (*distribution)(generator);
+        };
 
         return beluga::Amcl(
             std::move(motion_model),
@@ -328,14 +352,16 @@ void NdtAmclNode3D::do_periodic_timer_callback() {
     return;
   }
 
+  const auto parameters = parameter_snapshot();
+
   if (particle_cloud_pub_->get_subscription_count() == 0) {
     return;
   }
   std::visit(
-      [this](const auto& particle_filter) {
+      [this, &parameters](const auto& particle_filter) {
         auto message = beluga_ros::msg::PoseArray{};
         beluga_ros::assign_particle_cloud(particle_filter.particles(), message);
-        beluga_ros::stamp_message(get_parameter("global_frame_id").as_string(), now(), message);
+        beluga_ros::stamp_message(parameters->global_frame_id, now(), message);
         particle_cloud_pub_->publish(message);
       },
       *particle_filter_);
@@ -350,6 +376,8 @@ void NdtAmclNode3D::laser_callback(sensor_msgs::msg::PointCloud2::ConstSharedPtr
     return;
   }
 
+  const auto parameters = parameter_snapshot();
+
   auto base_pose_in_odom = Sophus::SE3d{};
   auto laser_pose_in_base = Sophus::SE3d{};
   try {
@@ -358,14 +386,14 @@ void NdtAmclNode3D::laser_callback(sensor_msgs::msg::PointCloud2::ConstSharedPtr
     tf2::convert(
         tf_buffer_
             ->lookupTransform(
-                get_parameter("odom_frame_id").as_string(), get_parameter("base_frame_id").as_string(),
+                parameters->odom_frame_id, parameters->base_frame_id,
                 tf2_ros::fromMsg(laser_scan->header.stamp))
             .transform,
         base_pose_in_odom);
     tf2::convert(
         tf_buffer_
             ->lookupTransform(
-                get_parameter("base_frame_id").as_string(), laser_scan->header.frame_id,
+                parameters->base_frame_id, laser_scan->header.frame_id,
                 tf2_ros::fromMsg(laser_scan->header.stamp))
             .transform,
         laser_pose_in_base);
@@ -376,24 +404,19 @@ void NdtAmclNode3D::laser_callback(sensor_msgs::msg::PointCloud2::ConstSharedPtr
 
   const auto update_start_time = std::chrono::high_resolution_clock::now();
 
-  std::vector<Eigen::Vector3d> measurement;
-  measurement.reserve(laser_scan->height * laser_scan->width);
-
-  // Accessing XYZ as suggested here:
-  // https://docs.ros.org/en/jade/api/sensor_msgs/html/classsensor__msgs_1_1PointCloud2Iterator.html
-  auto iter_x = sensor_msgs::PointCloud2ConstIterator<float>(*laser_scan, "x");
-  auto iter_y = sensor_msgs::PointCloud2ConstIterator<float>(*laser_scan, "y");
-  auto iter_z = sensor_msgs::PointCloud2ConstIterator<float>(*laser_scan, "z");
-  for (; iter_x != iter_x.end() && iter_y != iter_y.end() && iter_z != iter_z.end(); ++iter_x, ++iter_y, ++iter_z) {
-    measurement.emplace_back(laser_pose_in_base * Eigen::Vector3d{*iter_x, *iter_y, *iter_z});
-  };
+  // Point clouds are wrapped rather than converted, so that the sensor model reads points in place
+  // (applying the laser pose as it clusterizes them), and only for those scans the filter is going to use.
+  auto cloud = std::optional<beluga_ros::PointCloud3<float>>{};
+  try {
+    cloud.emplace(laser_scan, laser_pose_in_base);
+  } catch (const std::invalid_argument& error) {
+    RCLCPP_ERROR_THROTTLE(get_logger(), *get_clock(), 2000, "Unsupported point cloud: %s", error.what());
+    return;
+  }
 
-  RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 2000, "Processing %ld points.", measurement.size());
   const auto new_estimate = std::visit(
-      [base_pose_in_odom, measurement = measurement](auto& particle_filter) {
-        return particle_filter.update(
-            base_pose_in_odom,  //
-            std::move(measurement));
+      [&base_pose_in_odom, &cloud](auto& particle_filter) {
+        return particle_filter.update(base_pose_in_odom, [&cloud]() { return cloud.value(); });
       },
       *particle_filter_);
 
@@ -409,7 +432,8 @@ void NdtAmclNode3D::laser_callback(sensor_msgs::msg::PointCloud2::ConstSharedPtr
         std::visit([](const auto& particle_filter) { return particle_filter.particles().size(); }, *particle_filter_);
 
     RCLCPP_INFO(
-        get_logger(), "Particle filter update iteration stats: %ld particles - %.3fms", num_particles,
+        get_logger(), "Particle filter update iteration stats: %ld particles %ld points - %.3fms", num_particles,
+        static_cast<std::size_t>(laser_scan->height) * laser_scan->width,
         std::chrono::duration<double, std::milli>(update_duration).count());
   }
 
@@ -419,15 +443,15 @@ void NdtAmclNode3D::laser_callback(sensor_msgs::msg::PointCloud2::ConstSharedPtr
   }
 
   // Transforms are always published to keep them current.
-  if (enable_tf_broadcast_ && get_parameter("tf_broadcast").as_bool()) {
+  if (enable_tf_broadcast_ && parameters->tf_broadcast) {
     if (last_known_odom_transform_in_map_.has_value()) {
       auto message = geometry_msgs::msg::TransformStamped{};
       // Sending a transform that is valid into the future so that odom can be used.
       const auto expiration_stamp = tf2_ros::fromMsg(laser_scan->header.stamp) +
-                                    tf2::durationFromSec(get_parameter("transform_tolerance").as_double());
+                                    tf2::durationFromSec(parameters->transform_tolerance);
       message.header.stamp = tf2_ros::toMsg(expiration_stamp);
-      message.header.frame_id = get_parameter("global_frame_id").as_string();
-      message.child_frame_id = get_parameter("odom_frame_id").as_string();
+      message.header.frame_id = parameters->global_frame_id;
+      message.child_frame_id = parameters->odom_frame_id;
       message.transform = tf2::toMsg(last_known_odom_transform_in_map_.value());
       tf_broadcaster_->sendTransform(message);
     }
@@ -437,7 +461,7 @@ void NdtAmclNode3D::laser_callback(sensor_msgs::msg::PointCloud2::ConstSharedPtr
   if (new_estimate.has_value()) {
     auto message = geometry_msgs::msg::PoseWithCovarianceStamped{};
     message.header.stamp = laser_scan->header.stamp;
-    message.header.frame_id = get_parameter("global_frame_id").as_string();
+    message.header.frame_id = parameters->global_frame_id;
 
     static constexpr double kMinimumVariance =
         1e-6;  // Make sure we covariance is not singular so that UT doesn't fail.
@@ -16,6 +16,10 @@
 #include <lifecycle_msgs/msg/state.hpp>
 #include <rclcpp/publisher.hpp>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace beluga_amcl {
 
 BaseAMCLNode::BaseAMCLNode(
@@ -395,6 +399,16 @@ BaseAMCLNode::BaseAMCLNode(
   common_subscription_options_ = rclcpp::SubscriptionOptions{};
   common_subscription_options_.callback_group = common_callback_group_;
 
+  refresh_parameter_snapshot();
+  // Parameters are set while holding the node parameters lock, which is also taken to read them back. Snapshots
+  // retaken after the stale flag is raised thus see new values, or the old ones if the parameter set was rejected.
+  on_set_parameters_callback_handle_ = add_on_set_parameters_callback([this](const std::vector<rclcpp::Parameter>&) {
+    parameter_snapshot_stale_.store(true, std::memory_order_release);
+    auto result = rcl_interfaces::msg::SetParametersResult{};
+    result.successful = true;
+    return result;
+  });
+
   if (get_parameter("autostart").as_bool()) {
     auto autostart_delay = std::chrono::duration<double>(get_parameter("autostart_delay").as_double());
     autostart_timer_ = create_wall_timer(autostart_delay, std::bind(&BaseAMCLNode::autostart_callback, this));
@@ -543,6 +557,21 @@ void BaseAMCLNode::autostart_callback() {
   autostart_timer_->cancel();
 }
 
+void BaseAMCLNode::refresh_parameter_snapshot() {
+  // The flag is cleared before parameters are read back, so that no parameter set goes unnoticed.
+  parameter_snapshot_stale_.store(false, std::memory_order_relaxed);
+  auto snapshot = std::make_shared<ParameterSnapshot>();
+  snapshot->global_frame_id = get_parameter("global_frame_id").as_string();
+  snapshot->odom_frame_id = get_parameter("odom_frame_id").as_string();
+  snapshot->base_frame_id = get_parameter("base_frame_id").as_string();
+  snapshot->tf_broadcast = get_parameter("tf_broadcast").as_bool();
+  snapshot->transform_tolerance = get_parameter("transform_tolerance").as_double();
+  snapshot->max_beams = static_cast<std::size_t>(get_parameter("max_beams").as_int());
+  snapshot->laser_min_range = get_parameter("laser_min_range").as_double();
+  snapshot->laser_max_range = get_parameter("laser_max_range").as_double();
+  parameter_snapshot_ = std::move(snapshot);
+}
+
 auto BaseAMCLNode::get_execution_policy() const -> ExecutionPolicyVariant {
   const auto name = get_parameter("execution_policy").as_string();
   if (name == "seq") {
@@ -0,0 +1,137 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rcutils/logging.h>
+#include <sensor_msgs/msg/laser_scan.hpp>
+
+#include "beluga_amcl/amcl_node.hpp"
+
+namespace {
+
+/// Node that exposes the laser scan processing pipeline.
+class AmclNodeUnderBenchmark : public beluga_amcl::AmclNode {
+ public:
+  using beluga_amcl::AmclNode::AmclNode;
+
+  void set_map(nav_msgs::msg::OccupancyGrid::SharedPtr map) { map_callback(std::move(map)); }
+
+  void set_transform(const geometry_msgs::msg::TransformStamped& transform) {
+    tf_buffer_->setTransform(transform, "benchmark", true);
+  }
+
+  void process_laser_scan(const sensor_msgs::msg::LaserScan::ConstSharedPtr& laser_scan) {
+    // The robot does not move, so updates must be forced.
+    particle_filter_->force_update();
+    process_laser_scans({laser_scan});
+  }
+};
+
+// A 10m x 10m room.
+auto make_map() {
+  constexpr std::uint32_t kSize = 200;
+  auto map = std::make_shared<nav_msgs::msg::OccupancyGrid>();
+  map->header.frame_id = "map";
+  map->info.resolution = 0.05F;
+  map->info.width = kSize;
+  map->info.height = kSize;
+  map->info.origin.orientation.w = 1.0;
+  map->data.assign(kSize * kSize, 0);
+  for (std::uint32_t i = 0; i < kSize; ++i) {
+    map->data[i] = 100;
+    map->data[(kSize - 1) * kSize + i] = 100;
+    map->data[i * kSize] = 100;
+    map->data[i * kSize + kSize - 1] = 100;
+  }
+  return map;
+}
+
+auto make_transform(const std::string& parent, const std::string& child, const rclcpp::Time& stamp) {
+  auto transform = geometry_msgs::msg::TransformStamped{};
+  transform.header.stamp = stamp;
+  transform.header.frame_id = parent;
+  transform.child_frame_id = child;
+  transform.transform.rotation.w = 1.0;
+  return transform;
+}
+
+auto make_laser_scan(const rclcpp::Time& stamp) {
+  constexpr std::size_t kBeamCount = 720;
+  auto laser_scan = std::make_shared<sensor_msgs::msg::LaserScan>();
+  laser_scan->header.stamp = stamp;
+  laser_scan->header.frame_id = "laser";
+  laser_scan->angle_min = static_cast<float>(-M_PI);
+  laser_scan->angle_max = static_cast<float>(M_PI);
+  laser_scan->angle_increment = static_cast<float>(2.0 * M_PI / kBeamCount);
+  laser_scan->range_min = 0.1F;
+  laser_scan->range_max = 10.0F;
+  laser_scan->ranges.assign(kBeamCount, 4.0F);
+  return laser_scan;
+}
+
+// Full laser scan processing, from transform lookups to pose and transform publication, with parameters
+// read once per laser scan. Arguments are the number of particles and the maximum number of beams.
+void BM_ProcessLaserScan(benchmark::State& state) {
+  const auto particle_count = state.range(0);
+  const auto max_beams = state.range(1);
+  auto options = rclcpp::NodeOptions{}
+                     .append_parameter_override("min_particles", particle_count)
+                     .append_parameter_override("max_particles", particle_count)
+                     .append_parameter_override("max_beams", max_beams)
+                     .append_parameter_override("set_initial_pose", true)
+                     .append_parameter_override("initial_pose.x", 5.0)
+                     .append_parameter_override("initial_pose.y", 5.0);
+  auto node = std::make_shared<AmclNodeUnderBenchmark>(options);
+  // Update stats are logged on every laser scan otherwise.
+  rcutils_logging_set_logger_level(node->get_logger().get_name(), RCUTILS_LOG_SEVERITY_WARN);
+  node->configure();
+  node->activate();
+  node->set_map(make_map());
+
+  const auto stamp = node->now();
+  node->set_transform(make_transform("odom", "base_footprint", stamp));
+  node->set_transform(make_transform("base_footprint", "laser", stamp));
+  const auto laser_scan = make_laser_scan(stamp);
+
+  for (auto _ : state) {
+    node->process_laser_scan(laser_scan);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ProcessLaserScan)
+    ->ArgsProduct({{250, 1000, 4000}, {60, 240}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  rclcpp::shutdown();
+  return 0;
+}
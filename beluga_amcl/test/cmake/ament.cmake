@@ -47,3 +47,10 @@ target_include_directories(test_ndt_amcl_3d_node
                            PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/test_utils)
 target_compile_options(test_ndt_amcl_3d_node PRIVATE -Wno-deprecated-copy)
 target_link_libraries(test_ndt_amcl_3d_node ndt_amcl_node_3d_component)
+
+find_package(benchmark QUIET)
+if(benchmark_FOUND)
+  add_executable(benchmark_amcl_node benchmark_amcl_node.cpp)
+  target_link_libraries(benchmark_amcl_node amcl_node_component
+                        benchmark::benchmark)
+endif()
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <lifecycle_msgs/msg/state.hpp>
 #include <rclcpp/utilities.hpp>
@@ -115,6 +116,20 @@ class BaseNodeFixture : public T {
     return false;
   }
 
+  bool request_switch_map(const std::string& id) {
+    if (!tester_node_->wait_for_switch_map_service(id, 500ms)) {
+      return false;
+    }
+    auto future = tester_node_->async_switch_map_request(id);
+    const bool done =
+        spin_until([&] { return future.wait_for(0s) == std::future_status::ready; }, 500ms, amcl_node_, tester_node_);
+    if (done) {
+      return future.get()->success;
+    }
+    tester_node_->prune_pending_switch_map_requests(id);
+    return false;
+  }
+
  protected:
   std::shared_ptr<AmclNodeUnderTest> amcl_node_;
   std::shared_ptr<beluga_amcl::testing::TesterNode> tester_node_;
@@ -236,6 +251,21 @@ TEST_F(TestNode, MapWithWrongFrame) {
   ASSERT_TRUE(wait_for_initialization());
 }
 
+TEST_F(TestNode, MapWithoutFreeCells) {
+  amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
+  amcl_node_->configure();
+  amcl_node_->activate();
+  tester_node_->publish_map();
+  ASSERT_TRUE(wait_for_initialization());
+
+  // Maps that cannot be used are rejected, the node keeps localizing against the current map.
+  tester_node_->publish_map_without_free_cells();
+  spin_for(50ms, tester_node_, amcl_node_);
+  ASSERT_TRUE(amcl_node_->is_initialized());
+  tester_node_->publish_laser_scan();
+  ASSERT_TRUE(wait_for_pose_estimate());
+}
+
 TEST_F(TestNode, SetInitialPose) {
   amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
   amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.x", 34.0});
@@ -268,6 +298,36 @@ TEST_F(TestNode, BroadcastWhenInitialPoseSet) {
   ASSERT_TRUE(wait_for_transform("map", "odom"));
 }
 
+TEST_F(TestNode, BroadcastWhenSecondaryScannerStalls) {
+  amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
+  amcl_node_->set_parameter(rclcpp::Parameter{"secondary_scan_topic", "secondary_scan"});
+  amcl_node_->set_parameter(rclcpp::Parameter{"secondary_scan_timeout", 0.0});
+  amcl_node_->configure();
+  amcl_node_->activate();
+  tester_node_->publish_map();
+  ASSERT_TRUE(wait_for_initialization());
+  ASSERT_FALSE(tester_node_->can_transform("map", "odom"));
+  // There are no secondary scans, so primary scans update the filter on their own once the timeout elapses.
+  tester_node_->publish_laser_scan();
+  spin_for(50ms, tester_node_, amcl_node_);
+  tester_node_->publish_laser_scan();
+  ASSERT_TRUE(wait_for_transform("map", "odom"));
+}
+
+TEST_F(TestNode, NoBroadcastBeforeSecondaryScanTimeout) {
+  amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
+  amcl_node_->set_parameter(rclcpp::Parameter{"secondary_scan_topic", "secondary_scan"});
+  amcl_node_->set_parameter(rclcpp::Parameter{"secondary_scan_timeout", 60.0});
+  amcl_node_->configure();
+  amcl_node_->activate();
+  tester_node_->publish_map();
+  ASSERT_TRUE(wait_for_initialization());
+  tester_node_->publish_laser_scan();
+  spin_for(50ms, tester_node_, amcl_node_);
+  tester_node_->publish_laser_scan();
+  ASSERT_FALSE(wait_for_transform("map", "odom"));
+}
+
 TEST_F(TestNode, NoBroadcastWhenNoInitialPose) {
   amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", false});
   amcl_node_->configure();
@@ -432,6 +492,59 @@ TEST_F(TestNode, KeepCurrentEstimate) {
   }
 }
 
+TEST_F(TestNode, BackgroundMapUpdates) {
+  amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
+  amcl_node_->set_parameter(rclcpp::Parameter{"background_map_updates", true});
+  amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.x", 34.0});
+  amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.y", 2.0});
+  amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.yaw", 0.3});
+  amcl_node_->configure();
+  amcl_node_->activate();
+  tester_node_->publish_map();
+  ASSERT_TRUE(wait_for_initialization());
+
+  // The first map is never preprocessed in the background.
+  ASSERT_FALSE(amcl_node_->particle_filter()->map_update_pending());
+
+  tester_node_->publish_map();
+  spin_for(50ms, tester_node_, amcl_node_);
+  ASSERT_EQ(amcl_node_->particle_filter()->map_update_stats().swaps, 0UL);
+
+  // The new map is swapped in on the first filter update after it is built.
+  for (int attempt = 0; attempt < 10 && amcl_node_->particle_filter()->map_update_pending(); ++attempt) {
+    tester_node_->publish_laser_scan();
+    ASSERT_TRUE(wait_for_pose_estimate());
+  }
+  ASSERT_EQ(amcl_node_->particle_filter()->map_update_stats().swaps, 1UL);
+  const auto [pose, _] = amcl_node_->estimate();
+  ASSERT_NEAR(pose.translation().x(), 34.0, 0.5);
+  ASSERT_NEAR(pose.translation().y(), 2.0, 0.5);
+}
+
+TEST_F(TestNode, SwitchRegisteredMaps) {
+  amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
+  amcl_node_->set_parameter(rclcpp::Parameter{"map_ids", std::vector<std::string>{"first_floor", "second_floor"}});
+  amcl_node_->configure();
+  amcl_node_->activate();
+
+  // Maps received before the particle filter is initialized are registered once it is.
+  tester_node_->publish_registered_map("first_floor");
+  spin_for(50ms, tester_node_, amcl_node_);
+  tester_node_->publish_map();
+  ASSERT_TRUE(wait_for_initialization());
+  ASSERT_FALSE(request_switch_map("second_floor"));
+  ASSERT_TRUE(request_switch_map("first_floor"));
+  ASSERT_EQ(amcl_node_->particle_filter()->active_map_id(), "first_floor");
+
+  tester_node_->publish_registered_map("second_floor");
+  spin_for(50ms, tester_node_, amcl_node_);
+  ASSERT_TRUE(request_switch_map("second_floor"));
+  ASSERT_EQ(amcl_node_->particle_filter()->active_map_id(), "second_floor");
+
+  tester_node_->publish_laser_scan();
+  ASSERT_TRUE(wait_for_pose_estimate());
+}
+
 TEST_F(TestNode, KeepCurrentEstimateAfterCleanup) {
   amcl_node_->set_parameter(rclcpp::Parameter{"always_reset_initial_pose", false});
   amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
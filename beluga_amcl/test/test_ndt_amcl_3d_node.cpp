@@ -209,6 +209,34 @@ TEST_P(TestInitializationWithModel, ParticleCount) {
   std::visit([](const auto& pf) { ASSERT_EQ(pf.particles().size(), 10UL); }, *ndt_amcl_node_->particle_filter());
 }
 
+TEST_P(TestInitializationWithModel, AdaptiveParticleCount) {
+  const auto* const motion_model = GetParam();
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"set_initial_pose", true});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"robot_model_type", motion_model});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"scan_topic", "point_cloud"});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"min_particles", 10});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"max_particles", 30});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"recovery_min_z", -1.0});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"recovery_max_z", 1.0});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.x", 34.0});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.y", 2.0});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.covariance_x", 0.001});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.covariance_y", 0.001});
+  ndt_amcl_node_->set_parameter(rclcpp::Parameter{"initial_pose.covariance_yaw", 0.001});
+  ndt_amcl_node_->configure();
+  ndt_amcl_node_->activate();
+
+  ASSERT_TRUE(wait_for_initialization());
+
+  std::visit([](const auto& pf) { ASSERT_EQ(pf.particles().size(), 30UL); }, *ndt_amcl_node_->particle_filter());
+
+  // Particles concentrated around the initial pose are resampled down to fewer than the maximum.
+  tester_node_->publish_3d_laser_scan();
+  ASSERT_TRUE(wait_for_pose_estimate());
+
+  std::visit([](const auto& pf) { ASSERT_LT(pf.particles().size(), 30UL); }, *ndt_amcl_node_->particle_filter());
+}
+
 class TestNode : public BaseNodeFixture<::testing::Test> {};
 
 TEST_F(TestNode, SetInitialPose) {
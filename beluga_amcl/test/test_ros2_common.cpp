@@ -166,4 +166,36 @@ TEST_F(TestROS2Common, InitialPoseCallbackDefault) {
   testing::spin_for(300ms, amcl, tester_node);
 }
 
+TEST_F(TestROS2Common, ParameterSnapshot) {
+  auto amcl = std::make_shared<BaseAMCLNode>(
+      "amcl", "", rclcpp::NodeOptions{}.append_parameter_override("base_frame_id", "base_link"));
+  const auto snapshot = amcl->parameter_snapshot();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->global_frame_id, "map");
+  EXPECT_EQ(snapshot->odom_frame_id, "odom");
+  EXPECT_EQ(snapshot->base_frame_id, "base_link");
+  EXPECT_TRUE(snapshot->tf_broadcast);
+  EXPECT_DOUBLE_EQ(snapshot->transform_tolerance, 1.0);
+  EXPECT_EQ(snapshot->max_beams, 60U);
+  EXPECT_DOUBLE_EQ(snapshot->laser_min_range, 0.0);
+  EXPECT_DOUBLE_EQ(snapshot->laser_max_range, 100.0);
+}
+
+TEST_F(TestROS2Common, ParameterSnapshotUpdates) {
+  auto amcl = std::make_shared<BaseAMCLNode>();
+  const auto initial_snapshot = amcl->parameter_snapshot();
+  amcl->set_parameter(rclcpp::Parameter{"max_beams", 100});
+  amcl->set_parameter(rclcpp::Parameter{"odom_frame_id", "odom_combined"});
+  // New snapshots are taken right away, without waiting for parameter events.
+  const auto snapshot = amcl->parameter_snapshot();
+  EXPECT_EQ(snapshot->max_beams, 100U);
+  EXPECT_EQ(snapshot->odom_frame_id, "odom_combined");
+  // Rejected parameter values never make it into snapshots.
+  ASSERT_FALSE(amcl->set_parameter(rclcpp::Parameter{"max_beams", 1}).successful);
+  EXPECT_EQ(amcl->parameter_snapshot()->max_beams, 100U);
+  // Snapshots are immutable.
+  EXPECT_EQ(initial_snapshot->max_beams, 60U);
+  EXPECT_EQ(initial_snapshot->odom_frame_id, "odom");
+}
+
 }  // namespace beluga_amcl
@@ -36,6 +36,7 @@
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <std_srvs/srv/empty.hpp>
+#include <std_srvs/srv/trigger.hpp>
 
 #include <beluga_ros/tf2_sophus.hpp>
 
@@ -117,6 +118,12 @@ class TesterNode : public rclcpp::Node {
 
   void publish_map() { map_publisher_->publish(make_dummy_map()); }
 
+  void publish_map_without_free_cells() {
+    auto map = make_dummy_map();
+    map.data = std::vector<std::int8_t>{100, 100, 100, 100};
+    map_publisher_->publish(map);
+  }
+
   void publish_map_with_wrong_frame() {
     auto map = make_dummy_map();
     map.header.frame_id = "non_existing_frame";
@@ -337,6 +344,35 @@ class TesterNode : public rclcpp::Node {
 
   auto prune_pending_nomotion_update_request() { nomotion_update_client_->prune_pending_requests(); }
 
+  void publish_registered_map(const std::string& id) {
+    auto& publisher = registered_map_publishers_[id];
+    if (!publisher) {
+      publisher = create_publisher<nav_msgs::msg::OccupancyGrid>(
+          "maps/" + id, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable());
+    }
+    publisher->publish(make_dummy_map());
+  }
+
+  auto& switch_map_client(const std::string& id) {
+    auto& client = switch_map_clients_[id];
+    if (!client) {
+      client = create_client<std_srvs::srv::Trigger>("switch_map/" + id);
+    }
+    return client;
+  }
+
+  template <class Rep, class Period>
+  bool wait_for_switch_map_service(const std::string& id, const std::chrono::duration<Rep, Period>& timeout) {
+    return switch_map_client(id)->wait_for_service(timeout);
+  }
+
+  auto async_switch_map_request(const std::string& id) {
+    auto request = std::make_shared<std_srvs::srv::Trigger::Request>();
+    return switch_map_client(id)->async_send_request(request);
+  }
+
+  auto prune_pending_switch_map_requests(const std::string& id) { switch_map_client(id)->prune_pending_requests(); }
+
  private:
   template <class Message>
   using PublisherPtr = std::shared_ptr<rclcpp::Publisher<Message>>;
@@ -345,6 +381,7 @@ class TesterNode : public rclcpp::Node {
   PublisherPtr<geometry_msgs::msg::PoseWithCovarianceStamped> initial_pose_publisher_;
   PublisherPtr<sensor_msgs::msg::LaserScan> laser_scan_publisher_;
   PublisherPtr<sensor_msgs::msg::PointCloud2> point_cloud_publisher_;
+  std::unordered_map<std::string, PublisherPtr<nav_msgs::msg::OccupancyGrid>> registered_map_publishers_;
 
   template <class Message>
   using SubscriberPtr = std::shared_ptr<rclcpp::Subscription<Message>>;
@@ -363,6 +400,7 @@ class TesterNode : public rclcpp::Node {
 
   std::shared_ptr<rclcpp::Client<std_srvs::srv::Empty>> global_localization_client_;
   std::shared_ptr<rclcpp::Client<std_srvs::srv::Empty>> nomotion_update_client_;
+  std::unordered_map<std::string, std::shared_ptr<rclcpp::Client<std_srvs::srv::Trigger>>> switch_map_clients_;
 };
 
 /// Spin a group of nodes until a condition is met.
@@ -41,7 +41,7 @@ include_directories(include ${catkin_INCLUDE_DIRS})
 add_definitions(${catkin_DEFINITIONS})
 
 add_library(${PROJECT_NAME})
-target_sources(${PROJECT_NAME} PRIVATE src/amcl.cpp)
+target_sources(${PROJECT_NAME} PRIVATE src/amcl.cpp src/checkpoint.cpp src/tiled_map.cpp)
 target_include_directories(
   ${PROJECT_NAME} PUBLIC $<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/include>
                          $<INSTALL_INTERFACE:include/${PROJECT_NAME}>)
@@ -15,17 +15,28 @@
 #ifndef BELUGA_ROS_AMCL_HPP
 #define BELUGA_ROS_AMCL_HPP
 
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
 #include <optional>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/take_exactly.hpp>
 
 #include <sophus/se2.hpp>
 
-#include <beluga/algorithm/spatial_hash.hpp>
-#include <beluga/algorithm/thrun_recovery_probability_estimator.hpp>
+#include <beluga/algorithm/amcl_core.hpp>
+#include <beluga/algorithm/branch_and_bound_scan_matcher.hpp>
+#include <beluga/algorithm/generate_particles.hpp>
+#include <beluga/algorithm/gauss_newton_scan_matcher.hpp>
 #include <beluga/containers.hpp>
 #include <beluga/motion.hpp>
 #include <beluga/policies.hpp>
@@ -33,8 +44,10 @@
 #include <beluga/sensor.hpp>
 #include <beluga/views/sample.hpp>
 
+#include <beluga_ros/checkpoint.hpp>
 #include <beluga_ros/laser_scan.hpp>
 #include <beluga_ros/occupancy_grid.hpp>
+#include <beluga_ros/tiled_map.hpp>
 
 /**
  * \file
@@ -92,8 +105,144 @@ struct AmclParams {
 
   /// \brief Spatial resolution around the z-axis to create buckets for KLD resampling.
   double spatial_resolution_theta = 10 * Sophus::Constants<double>::pi() / 180;
+
+  /// \brief Whether to stratify particles over free space when initializing from the map,
+  /// so that fewer particles cover it as evenly.
+  bool global_localization_stratified = false;
+
+  /// \brief Maximum number of scan matching hypotheses to seed particles around on global localization.
+  std::size_t scan_matching_max_hypotheses = 10UL;
+
+  /// \brief Number of levels in the max-pooled likelihood field pyramid used for scan matching.
+  std::size_t scan_matching_pyramid_depth = 6UL;
+
+  /// \brief Angular search step for scan matching, in radians. If not positive, it is derived
+  /// from the map resolution and the range of the scan.
+  double scan_matching_angular_step = 0.0;
+
+  /// \brief Standard deviation of the translational spread of particles around each scan matching hypothesis.
+  double scan_matching_linear_std_dev = 0.1;
+
+  /// \brief Standard deviation of the rotational spread of particles around each scan matching hypothesis.
+  double scan_matching_angular_std_dev = 0.05;
+
+  /// \brief Maximum number of Gauss-Newton iterations to refine pose estimates with after each update.
+  /// Zero disables pose refinement.
+  std::size_t refinement_max_iterations = 0UL;
+
+  /// \brief Maximum translational correction, in meters, that pose refinement may apply to an estimate.
+  double refinement_max_linear_correction = 0.2;
+
+  /// \brief Maximum rotational correction, in radians, that pose refinement may apply to an estimate.
+  double refinement_max_angular_correction = 0.2;
+};
+
+/// Statistics of map updates carried out in the background.
+struct MapUpdateStats {
+  /// \brief Number of background map builds completed so far.
+  std::size_t builds = 0UL;
+
+  /// \brief Number of built maps that were swapped into the filter so far.
+  std::size_t swaps = 0UL;
+
+  /// \brief Number of built maps that were discarded because a newer map superseded them.
+  std::size_t discards = 0UL;
+
+  /// \brief Number of maps that failed to build, and were thus discarded.
+  std::size_t failures = 0UL;
+
+  /// \brief Time it took to build the last map, off the filter update loop.
+  std::chrono::nanoseconds last_build_duration{0};
+
+  /// \brief Longest time it took to build a map so far.
+  std::chrono::nanoseconds max_build_duration{0};
+
+  /// \brief Time it took to swap the last built map into the filter, on the filter update loop.
+  std::chrono::nanoseconds last_swap_duration{0};
 };
 
+/// Returns the points of a laser scan in the reference frame of the robot, ie. transformed by the laser scan origin.
+std::vector<std::pair<double, double>> make_measurement(const beluga_ros::LaserScan& laser_scan);
+
+/// Returns the points of multiple laser scans in the reference frame of the robot, merged into a single measurement.
+/**
+ * Each laser scan is transformed by its own origin, so scanners may be mounted anywhere.
+ */
+std::vector<std::pair<double, double>> make_measurement(const std::vector<beluga_ros::LaserScan>& laser_scans);
+
+namespace detail {
+
+/// Interface to AMCL filters with statically resolved execution policy, motion model and sensor model.
+/**
+ * Implementations own the particle set and carry out the (hot) particle filter update step with
+ * all types known at compile time, which allows motion and sensor models to be inlined into
+ * particle processing loops. Dispatch happens once per call.
+ */
+class AmclInterface {
+ public:
+  /// Weighted SE(2) state particle type.
+  using particle_type = std::tuple<Sophus::SE2d, beluga::Weight>;
+  /// Measurement type: a point cloud in the reference frame of the robot.
+  using measurement_type = std::vector<std::pair<double, double>>;
+  /// Random state distribution type, to sample states from during resampling.
+  using distribution_type = beluga::MultivariateUniformDistribution<Sophus::SE2d, beluga_ros::OccupancyGrid>;
+
+  /// Virtual destructor.
+  virtual ~AmclInterface() = default;
+
+  /// Returns a reference to the current set of particles.
+  [[nodiscard]] virtual const beluga::TupleVector<particle_type>& particles() const = 0;
+
+  /// Replaces the current set of particles.
+  virtual void reset(beluga::TupleVector<particle_type> particles) = 0;
+
+  /// Updates the map the sensor model uses.
+  /**
+   * Maps that cannot be used are rejected before the sensor model is modified in any way.
+   */
+  virtual void update_map(beluga_ros::OccupancyGrid map) = 0;
+
+  /// Returns a callable that builds a sensor model for the given map, as configured for this filter.
+  /**
+   * The callable does not refer to this filter in any way, so it can be invoked on any thread.
+   * Its result is meant to be handed back to swap_sensor_model().
+   */
+  [[nodiscard]] virtual std::function<std::any()> make_sensor_model_builder(beluga_ros::OccupancyGrid map) const = 0;
+
+  /// Replaces the sensor model with one built by a callable returned by make_sensor_model_builder().
+  /**
+   * \return The sensor model that was replaced, so that it can be swapped back in later on.
+   */
+  virtual std::any swap_sensor_model(std::any sensor_model) = 0;
+
+  /// Propagates, reweights and possibly resamples particles.
+  /**
+   * \param base_pose_in_odom Base pose in the odometry frame.
+   * \param measurement Laser scan points in the reference frame of the robot.
+   * \param random_state_distribution Distribution to sample random states from when resampling.
+   * \param early_termination_stats Statistics to count point evaluations in, if weighting is bounded. May be null.
+   */
+  virtual void update(
+      const Sophus::SE2d& base_pose_in_odom,
+      measurement_type measurement,
+      distribution_type& random_state_distribution,
+      beluga::EarlyTerminationStats* early_termination_stats) = 0;
+
+  /// Returns a snapshot of the particle set and of the filter internals that evolve with it.
+  [[nodiscard]] virtual AmclCheckpoint checkpoint() const = 0;
+
+  /// Restores the particle set and the filter internals from a snapshot.
+  virtual void restore(AmclCheckpoint checkpoint) = 0;
+
+  /// Returns the likelihood field the sensor model uses, if any.
+  [[nodiscard]] virtual const beluga::ValueGrid2<float>* likelihood_field() const = 0;
+
+  /// Returns the likelihood the sensor model assumes for points that fall outside its likelihood field.
+  [[nodiscard]] virtual float unknown_space_likelihood() const = 0;
+};
+
+}  // namespace detail
+
 /// Implementation of the 2D Adaptive Monte Carlo Localization (AMCL) algorithm.
 /// Generic two-dimensional implementation of the Adaptive Monte Carlo Localization (AMCL) algorithm in 2D.
 class Amcl {
@@ -103,20 +252,28 @@ class Amcl {
 
   /// Motion model variant type for runtime selection support.
   using motion_model_variant = std::variant<
-      beluga::DifferentialDriveModel2d,   //
-      beluga::OmnidirectionalDriveModel,  //
+      beluga::DifferentialDriveModel2d,     //
+      beluga::OmnidirectionalDriveModel2d,  //
       beluga::StationaryModel>;
 
   /// Sensor model variant type for runtime selection support.
+  /**
+   * Tiled likelihood field models bring tiles around the particle set, grown by the maximum laser distance,
+   * into their cache on every update, and prefetch those tiles the particle set is headed to. Maps must match
+   * the dimensions of their likelihood field, only their origin is taken into account on map updates.
+   */
   using sensor_model_variant = std::variant<
       beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid>,  //
-      beluga::BeamSensorModel<beluga_ros::OccupancyGrid>>;
+      beluga::BeamSensorModel<beluga_ros::OccupancyGrid>,       //
+      beluga_ros::TiledLikelihoodFieldModel>;
 
   /// Execution policy variant type for runtime selection support.
   using execution_policy_variant = std::variant<std::execution::sequenced_policy, std::execution::parallel_policy>;
 
   /// Constructor.
   /**
+   * Variant alternatives are resolved once, here, into a statically typed filter implementation.
+   *
    * \param map Occupancy grid map.
    * \param motion_model Variant of motion model.
    * \param sensor_model Variant of sensor model.
@@ -131,15 +288,16 @@ class Amcl {
       execution_policy_variant execution_policy);
 
   /// Returns a reference to the current set of particles.
-  [[nodiscard]] const auto& particles() const { return particles_; }
+  [[nodiscard]] const beluga::TupleVector<particle_type>& particles() const { return filter_->particles(); }
 
   /// Initialize particles using a custom distribution.
   template <class Distribution>
   void initialize(Distribution distribution) {
-    particles_ = beluga::views::sample(std::move(distribution)) |                    //
-                 ranges::views::transform(beluga::make_from_state<particle_type>) |  //
-                 ranges::views::take_exactly(params_.max_particles) |                //
-                 ranges::to<beluga::TupleVector>;
+    filter_->reset(
+        beluga::views::sample(std::move(distribution)) |                    //
+        ranges::views::transform(beluga::make_from_state<particle_type>) |  //
+        ranges::views::take_exactly(params_.max_particles) |                //
+        ranges::to<beluga::TupleVector>);
     force_update_ = true;
   }
 
@@ -148,15 +306,98 @@ class Amcl {
    * \throw std::runtime_error If the provided covariance is invalid.
    */
   void initialize(Sophus::SE2d pose, Sophus::Matrix3d covariance) {
-    initialize(beluga::MultivariateNormalDistribution{pose, covariance});
+    initialize_in_bulk(beluga::MultivariateNormalDistribution{pose, covariance});
   }
 
   /// Initialize particles using the default map distribution.
-  void initialize_from_map() { initialize(std::ref(map_distribution_)); }
+  void initialize_from_map() {
+    swap_map_if_ready();
+    initialize_in_bulk(map_distribution_);
+  }
+
+  /// Initialize particles around the poses that best match a laser scan against the map.
+  /**
+   * Runs a branch-and-bound correlative scan matcher over the whole map to find the best scoring poses,
+   * then samples particles from a mixture of normal distributions centered at them, weighted by score.
+   * The max-pooled likelihood field pyramid the scan matcher requires is built on first use and rebuilt
+   * after map updates. Only likelihood field models are supported.
+   *
+   * \param laser_scan Laser scan data.
+   * \return True if particles were initialized, false if the sensor model is not supported
+   * or no hypotheses were found.
+   */
+  bool initialize_from_scan_matching(const beluga_ros::LaserScan& laser_scan);
 
   /// Update the map used for localization.
+  /**
+   * The sensor model and the map distribution are rebuilt right away, which may take a while for large maps.
+   * Any map update in progress in the background is superseded. If the active map came from the registry,
+   * it goes back to it.
+   *
+   * \throw std::invalid_argument If the map cannot be used (eg. it has no free cells to sample from).
+   * The filter is left untouched, and keeps localizing against the current map.
+   */
   void update_map(beluga_ros::OccupancyGrid map);
 
+  /// Update the map used for localization, preprocessing it in the background.
+  /**
+   * The sensor model (e.g. likelihood field) and the map distribution are built on a worker thread, while
+   * the filter keeps localizing against the current map. Once built, they are swapped in at the start of
+   * the next update or initialization, which only takes a few pointer moves. If a map update is already
+   * in progress, the given map is queued, replacing any other map that was queued before it.
+   * Destroying the filter waits for any map build in progress to complete. If the active map came from the
+   * registry, it goes back to it once the new map is swapped in. Maps that fail to build (e.g. maps without
+   * free space) are discarded and counted in map update statistics, and the filter keeps the current map.
+   *
+   * \param map Occupancy grid map.
+   */
+  void update_map_in_background(beluga_ros::OccupancyGrid map);
+
+  /// Returns true if a map update is in progress in the background, or queued for it.
+  [[nodiscard]] bool map_update_pending() const { return pending_map_.valid() || queued_map_.has_value(); }
+
+  /// Returns background map update statistics.
+  [[nodiscard]] const MapUpdateStats& map_update_stats() const { return map_update_stats_; }
+
+  /// Returns point evaluation statistics of bounded weighting, accumulated over all updates so far.
+  /**
+   * Points are only counted if the sensor model is configured with a non-zero early termination ratio.
+   */
+  [[nodiscard]] const beluga::EarlyTerminationStats& early_termination_stats() const {
+    return early_termination_stats_;
+  }
+
+  /// Adds a map to the map registry, preprocessing it in the background.
+  /**
+   * Registered maps are kept preprocessed (e.g. likelihood fields, map distributions) so that the filter
+   * can switch between them at no cost, as it is needed to localize in multi-floor buildings. Maps are built
+   * concurrently, each on its own worker thread. A map registered under the id of the active map replaces
+   * the latter in the registry, not in the filter. A map registered under the id of a map that is still being
+   * built supersedes it without waiting for that build to complete.
+   *
+   * \param id Map id.
+   * \param map Occupancy grid map.
+   */
+  void add_map(const std::string& id, beluga_ros::OccupancyGrid map);
+
+  /// Returns true if a map is in the registry and done preprocessing, or if it is the active map.
+  [[nodiscard]] bool map_ready(const std::string& id) const;
+
+  /// Switches the map used for localization to one in the registry.
+  /**
+   * Particles are kept as is. The active map goes back to the registry for later use, if it came from there. If the
+   * requested map is still being preprocessed, this waits for it to complete. Any map update in progress
+   * in the background is superseded. Maps that fail to build are dropped from the registry and counted as failures,
+   * and the current map is kept.
+   *
+   * \param id Id of the map to switch to.
+   * \return True if the map is now active, false if it is not in the registry or failed to build.
+   */
+  bool switch_map(const std::string& id);
+
+  /// Returns the id of the active map, if it was switched to from the registry.
+  [[nodiscard]] const std::optional<std::string>& active_map_id() const { return active_map_id_; }
+
   /// Update particles based on motion and sensor information.
   /**
    * This method performs a particle filter update step using motion and sensor data. It evaluates whether
@@ -165,6 +406,10 @@ class Amcl {
    * weights are adjusted accordingly. Also, according to the configured resampling policy, the particles
    * are resampled to maintain diversity and prevent degeneracy.
    *
+   * If enabled, the estimated pose is then refined by aligning the laser scan to the likelihood field
+   * with a few Gauss-Newton iterations. Refinement only affects the estimate, not the particles,
+   * and it is only supported for likelihood field models.
+   *
    * \param base_pose_in_odom Base pose in the odometry frame.
    * \param laser_scan Laser scan data.
    * \return An optional pair containing the estimated pose and covariance after the update,
@@ -173,26 +418,151 @@ class Amcl {
   auto update(Sophus::SE2d base_pose_in_odom, beluga_ros::LaserScan laser_scan)
       -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>>;
 
+  /// Update particles based on motion and sensor information, making the laser scan only if necessary.
+  /**
+   * Same as the overload above, except that the laser scan is made by a callable that is only invoked
+   * once the update policy decides that an update is due, so that callers can skip the work to make it
+   * (e.g. transform lookups) for those updates the policy rejects. If making the laser scan throws,
+   * the exception propagates and the update is skipped as if it had never been attempted.
+   *
+   * \param base_pose_in_odom Base pose in the odometry frame.
+   * \param make_laser_scan Callable to make the laser scan data with.
+   * \return An optional pair containing the estimated pose and covariance after the update,
+   *         or std::nullopt if no update was performed.
+   */
+  auto update(Sophus::SE2d base_pose_in_odom, const std::function<beluga_ros::LaserScan()>& make_laser_scan)
+      -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>>;
+
+  /// Update particles based on motion and information from multiple laser scanners.
+  /**
+   * Same as the single laser scan overload, except that the points of all laser scans are merged into a single
+   * measurement, as if they had been taken by a single sensor. Each laser scan is transformed to the reference
+   * frame of the robot using its own origin, so scanners may be mounted anywhere. Particles are thus propagated,
+   * reweighted and resampled once per cycle, no matter how many scanners there are.
+   *
+   * \param base_pose_in_odom Base pose in the odometry frame.
+   * \param laser_scans Laser scan data, one per scanner.
+   * \return An optional pair containing the estimated pose and covariance after the update,
+   *         or std::nullopt if no update was performed.
+   */
+  auto update(Sophus::SE2d base_pose_in_odom, std::vector<beluga_ros::LaserScan> laser_scans)
+      -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>>;
+
+  /// Update particles based on motion and information from multiple laser scanners, making scans only if necessary.
+  /**
+   * Same as the overload above, except that laser scans are made by a callable that is only invoked
+   * once the update policy decides that an update is due.
+   *
+   * \param base_pose_in_odom Base pose in the odometry frame.
+   * \param make_laser_scans Callable to make the laser scan data with, one per scanner.
+   * \return An optional pair containing the estimated pose and covariance after the update,
+   *         or std::nullopt if no update was performed.
+   */
+  auto update(
+      Sophus::SE2d base_pose_in_odom,
+      const std::function<std::vector<beluga_ros::LaserScan>()>& make_laser_scans)
+      -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>>;
+
+  /// Returns a snapshot of the filter state, to restore it later on (e.g. after a restart).
+  /**
+   * The snapshot includes the particle set, the weight averages used to estimate random state probabilities
+   * and the latest odometry poses the filter was updated with. It does not include the map.
+   */
+  [[nodiscard]] AmclCheckpoint checkpoint() const { return filter_->checkpoint(); }
+
+  /// Restores the filter state from a snapshot, see checkpoint().
+  /**
+   * An update is forced on the next iteration of the filter, as with any other initialization.
+   *
+   * \param checkpoint Filter state snapshot.
+   */
+  void restore(AmclCheckpoint checkpoint) {
+    filter_->restore(std::move(checkpoint));
+    force_update_ = true;
+  }
+
   /// Force a manual update of the particles on the next iteration of the filter.
   void force_update() { force_update_ = true; }
 
  private:
-  beluga::TupleVector<particle_type> particles_;
+  /// A map built in the background, ready to be swapped into the filter.
+  struct PreparedMap {
+    std::uint64_t generation;
+    Sophus::SE2d origin;
+    beluga::MultivariateUniformDistribution<Sophus::SE2d, beluga_ros::OccupancyGrid> distribution;
+    std::any sensor_model;
+    std::chrono::nanoseconds build_duration;
+  };
+
+  /// A map in the registry, either being built or ready.
+  struct RegisteredMap {
+    std::future<PreparedMap> build;
+    std::optional<PreparedMap> map;
+  };
+
+  /// Returns a callable that builds a map, and that can be invoked on any thread.
+  [[nodiscard]] std::function<PreparedMap()> make_map_builder(
+      beluga_ros::OccupancyGrid map,
+      std::uint64_t generation) const;
+
+  /// Builds a map on a worker thread.
+  [[nodiscard]] std::future<PreparedMap> build_map(beluga_ros::OccupancyGrid map, std::uint64_t generation) const;
+
+  /// Drops superseded registry map builds that are done.
+  void prune_retired_map_builds();
+
+  /// Starts building a map in the background, to be swapped in by swap_map_if_ready().
+  void start_map_build(beluga_ros::OccupancyGrid map);
+
+  /// Swaps a prepared map into the filter, putting the active map back in the registry if it came from there.
+  void activate_map(PreparedMap map, std::optional<std::string> id);
+
+  /// Swaps a map built in the background into the filter if it is ready, or discards it if it was superseded.
+  void swap_map_if_ready();
+
+  /// Replaces particles with a new set generated in bulk, using the configured execution policy.
+  template <class Distribution>
+  void initialize_in_bulk(const Distribution& distribution) {
+    std::visit(
+        [&, this](const auto& policy) {
+          filter_->reset(beluga::generate_particles<particle_type>(policy, distribution, params_.max_particles));
+        },
+        execution_policy_);
+    force_update_ = true;
+  }
+
+  /// Carries out the update step for a measurement made by a callable, only if the update policy says so.
+  auto update_with_measurement(
+      const Sophus::SE2d& base_pose_in_odom,
+      const std::function<std::vector<std::pair<double, double>>()>& make_points)
+      -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>>;
+
+  /// Refines a pose estimate by aligning scan points to the likelihood field, if supported.
+  Sophus::SE2d refine_estimate(const Sophus::SE2d& pose, const std::vector<std::pair<double, double>>& points);
 
   AmclParams params_;
   beluga::MultivariateUniformDistribution<Sophus::SE2d, beluga_ros::OccupancyGrid> map_distribution_;
-  motion_model_variant motion_model_;
-  sensor_model_variant sensor_model_;
   execution_policy_variant execution_policy_;
+  std::unique_ptr<detail::AmclInterface> filter_;
+  Sophus::SE2d map_origin_;
+  std::optional<beluga::BranchAndBoundScanMatcher> scan_matcher_;
+  std::optional<beluga::GaussNewtonScanMatcher> pose_refiner_;
 
-  beluga::spatial_hash<Sophus::SE2d> spatial_hasher_;
-  beluga::ThrunRecoveryProbabilityEstimator random_probability_estimator_;
-  beluga::any_policy<Sophus::SE2d> update_policy_;
-  beluga::any_policy<decltype(particles_)> resample_policy_;
-
-  beluga::RollingWindow<Sophus::SE2d, 2> control_action_window_;
+  beluga::amcl_update_policy_t<Sophus::SE2d> update_policy_;
 
   bool force_update_{true};
+
+  std::uint64_t map_generation_{0};
+  std::future<PreparedMap> pending_map_;
+  std::optional<beluga_ros::OccupancyGrid> queued_map_;
+  MapUpdateStats map_update_stats_;
+  beluga::EarlyTerminationStats early_termination_stats_;
+
+  std::unordered_map<std::string, RegisteredMap> map_registry_;
+  std::optional<std::string> active_map_id_;
+  // Futures returned by std::async block on destruction until their task is done, so superseded
+  // registry map builds are kept here until then.
+  std::vector<std::future<PreparedMap>> retired_map_builds_;
 };
 
 }  // namespace beluga_ros
@@ -26,6 +26,7 @@
  */
 
 #include <beluga_ros/amcl.hpp>
+#include <beluga_ros/checkpoint.hpp>
 #include <beluga_ros/laser_scan.hpp>
 #include <beluga_ros/occupancy_grid.hpp>
 #include <beluga_ros/particle_cloud.hpp>
@@ -33,5 +34,6 @@
 #include <beluga_ros/sparse_point_cloud.hpp>
 #include <beluga_ros/tf2_eigen.hpp>
 #include <beluga_ros/tf2_sophus.hpp>
+#include <beluga_ros/tiled_map.hpp>
 
 #endif
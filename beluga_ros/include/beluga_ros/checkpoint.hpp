@@ -0,0 +1,122 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ROS_CHECKPOINT_HPP
+#define BELUGA_ROS_CHECKPOINT_HPP
+
+#include <future>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <sophus/se2.hpp>
+
+#include <beluga/containers.hpp>
+#include <beluga/primitives.hpp>
+
+/**
+ * \file
+ * \brief Utilities to checkpoint and restore particle filter state.
+ */
+
+namespace beluga_ros {
+
+/// Snapshot of the state of an AMCL particle filter, to restore it later on (e.g. after a restart).
+struct AmclCheckpoint {
+  /// \brief Weighted particle set.
+  beluga::TupleVector<std::tuple<Sophus::SE2d, beluga::Weight>> particles;
+
+  /// \brief Long-term average of particle weights, as tracked to estimate random state probabilities.
+  double slow_average = 0.0;
+
+  /// \brief Short-term average of particle weights, as tracked to estimate random state probabilities.
+  double fast_average = 0.0;
+
+  /// \brief Latest base poses in the odometry frame the filter was updated with, the most recent first.
+  std::vector<Sophus::SE2d> control_actions;
+};
+
+/// Writes a checkpoint in a compact binary format.
+/**
+ * Particle states and weights are written as raw double precision values, in host byte order,
+ * after a short header to identify the format.
+ *
+ * \param stream Output stream to write to. It should be opened in binary mode.
+ * \param checkpoint Checkpoint to write.
+ * \throws std::runtime_error If writing to the stream fails.
+ */
+void write_checkpoint(std::ostream& stream, const AmclCheckpoint& checkpoint);
+
+/// Reads a checkpoint written by write_checkpoint().
+/**
+ * \param stream Input stream to read from. It should be opened in binary mode.
+ * \return The checkpoint read.
+ * \throws std::runtime_error If the stream does not hold a valid checkpoint.
+ */
+AmclCheckpoint read_checkpoint(std::istream& stream);
+
+/// Saves a checkpoint to a file, see write_checkpoint().
+/**
+ * The checkpoint is first written to a temporary file next to the target file, then moved in place,
+ * so that the target file always holds a complete checkpoint even if the process is killed mid-write.
+ *
+ * \param path Path to the checkpoint file.
+ * \param checkpoint Checkpoint to save.
+ * \throws std::runtime_error If the checkpoint cannot be saved.
+ */
+void save_checkpoint(const std::string& path, const AmclCheckpoint& checkpoint);
+
+/// Loads a checkpoint from a file, see read_checkpoint().
+/**
+ * \param path Path to the checkpoint file.
+ * \return The checkpoint loaded, or std::nullopt if there is no such file.
+ * \throws std::runtime_error If the file does not hold a valid checkpoint.
+ */
+std::optional<AmclCheckpoint> load_checkpoint(const std::string& path);
+
+/// Saves checkpoints to a file on a worker thread.
+class AsyncCheckpointWriter {
+ public:
+  /// Constructor.
+  /**
+   * \param path Path to the checkpoint file.
+   */
+  explicit AsyncCheckpointWriter(std::string path) : path_{std::move(path)} {}
+
+  /// Starts saving a checkpoint, unless the previous one is still being saved.
+  /**
+   * \param checkpoint Checkpoint to save.
+   * \return True if the checkpoint is being saved, false if it was skipped.
+   * \throws std::runtime_error If the previous checkpoint could not be saved.
+   */
+  bool write(AmclCheckpoint checkpoint);
+
+  /// Waits for the checkpoint being saved, if any.
+  /**
+   * \throws std::runtime_error If the checkpoint could not be saved.
+   */
+  void wait();
+
+ private:
+  std::string path_;
+  std::future<void> pending_write_;
+};
+
+}  // namespace beluga_ros
+
+#endif  // BELUGA_ROS_CHECKPOINT_HPP
@@ -15,7 +15,12 @@
 #ifndef BELUGA_ROS_PARTICLE_CLOUD_HPP
 #define BELUGA_ROS_PARTICLE_CLOUD_HPP
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <type_traits>
@@ -115,6 +120,65 @@ struct almost_equal_to<Sophus::SE3<Scalar>> {
   const Scalar angular_resolution;  ///< Resolution for rotational coordinates, in radians.
 };
 
+/// Lay out a point cloud message as a packed sequence of single precision floating point fields.
+/**
+ * Fields are only reset if the message layout does not match already, so that repeated
+ * assignments to the same message do not reallocate its fields.
+ */
+template <std::size_t N>
+void assign_float_fields(const std::array<const char*, N>& names, beluga_ros::msg::PointCloud2& message) {
+  constexpr auto kFieldSize = static_cast<std::uint32_t>(sizeof(float));
+  const auto layout_matches = [&]() {
+    if (message.fields.size() != N || message.point_step != N * kFieldSize) {
+      return false;
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+      const auto& field = message.fields[i];
+      if (field.name != names[i] || field.offset != i * kFieldSize ||
+          field.datatype != beluga_ros::msg::PointField::FLOAT32 || field.count != 1) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (layout_matches()) {
+    return;
+  }
+  message.fields.clear();
+  message.fields.reserve(N);
+  for (std::size_t i = 0; i < N; ++i) {
+    auto& field = message.fields.emplace_back();
+    field.name = names[i];
+    field.offset = static_cast<std::uint32_t>(i) * kFieldSize;
+    field.datatype = beluga_ros::msg::PointField::FLOAT32;
+    field.count = 1;
+  }
+  message.point_step = static_cast<std::uint32_t>(N) * kFieldSize;
+}
+
+/// Flatten a planar pose and its weight into x, y, z, yaw, and weight values.
+template <typename Scalar>
+std::array<float, 5> to_float_fields(const Sophus::SE2<Scalar>& state, double weight) {
+  return {
+      static_cast<float>(state.translation().x()), static_cast<float>(state.translation().y()), 0.0F,
+      static_cast<float>(state.so2().log()), static_cast<float>(weight)};
+}
+
+/// Flatten a pose and its weight into x, y, z, qx, qy, qz, qw, and weight values.
+template <typename Scalar>
+std::array<float, 8> to_float_fields(const Sophus::SE3<Scalar>& state, double weight) {
+  const auto& rotation = state.unit_quaternion();
+  return {
+      static_cast<float>(state.translation().x()),
+      static_cast<float>(state.translation().y()),
+      static_cast<float>(state.translation().z()),
+      static_cast<float>(rotation.x()),
+      static_cast<float>(rotation.y()),
+      static_cast<float>(rotation.z()),
+      static_cast<float>(rotation.w()),
+      static_cast<float>(weight)};
+}
+
 }  // namespace detail
 
 /// Assign a pose distribution to a particle cloud message.
@@ -145,6 +209,93 @@ assign_particle_cloud(Particles&& particles, std::size_t size, beluga_ros::msg::
   return message;
 }
 
+/// Assign a pose distribution to a compact, point cloud particle cloud message.
+/**
+ * Particles are written straight into the message buffer as packed single precision floats: `x`, `y`, `z`,
+ * `yaw`, and `weight` fields for planar poses, and `x`, `y`, `z`, `qx`, `qy`, `qz`, `qw`, and `weight`
+ * fields for 3D poses. Weights are normalized. If the distribution holds more than `size` particles, it is
+ * subsampled by (deterministic) systematic selection. Particles selected more than once are written once,
+ * their weight being proportional to the number of times they were selected, so the message may end up
+ * holding less than `size` points. Message fields and buffer are reused across assignments.
+ *
+ * \param particles Pose distribution, as a particle cloud itself.
+ * \param size Maximum number of points in the particle cloud.
+ * \param[out] message Particle cloud message to be assigned.
+ * \tparam Particles A sized range type whose value type satisfies \ref ParticlePage "Particle" named requirements.
+ */
+template <
+    class Particles,
+    class Particle = ranges::range_value_t<Particles>,
+    class State = typename beluga::state_t<Particle>,
+    class Scalar = typename State::Scalar,
+    typename = std::enable_if_t<
+        std::is_same_v<State, typename Sophus::SE2<Scalar>> || std::is_same_v<State, typename Sophus::SE3<Scalar>>>>
+beluga_ros::msg::PointCloud2&
+assign_particle_cloud(Particles&& particles, std::size_t size, beluga_ros::msg::PointCloud2& message) {
+  static_assert(ranges::sized_range<decltype(particles)>);
+  if constexpr (std::is_same_v<State, typename Sophus::SE2<Scalar>>) {
+    detail::assign_float_fields<5>({"x", "y", "z", "yaw", "weight"}, message);
+  } else {
+    detail::assign_float_fields<8>({"x", "y", "z", "qx", "qy", "qz", "qw", "weight"}, message);
+  }
+  message.height = 1;
+  message.is_bigendian = false;
+  message.is_dense = true;
+
+  const auto count = static_cast<std::size_t>(ranges::size(particles));
+  const auto sample_size = std::min(size, count);
+
+  // Weights are taken to be uniform if they do not add up to anything.
+  auto total_weight = 0.0;
+  for (const auto& particle : particles) {
+    total_weight += static_cast<double>(beluga::weight(particle));
+  }
+  const bool uniform = !(total_weight > 0.0);
+  const auto weight_of = [uniform](const auto& particle) {
+    return uniform ? 1.0 : static_cast<double>(beluga::weight(particle));
+  };
+  if (uniform) {
+    total_weight = static_cast<double>(count);
+  }
+
+  // Shrinking the buffer keeps its capacity, so steady state assignments do not allocate.
+  message.data.resize(static_cast<std::size_t>(message.point_step) * sample_size);
+  std::size_t points = 0;
+  const auto write_point = [&message, &points](const auto& state, double weight) {
+    const auto values = detail::to_float_fields(state, weight);
+    std::memcpy(message.data.data() + points * message.point_step, values.data(), sizeof(values));
+    ++points;
+  };
+
+  if (sample_size == count) {
+    for (const auto& particle : particles) {
+      write_point(beluga::state(particle), weight_of(particle) / total_weight);
+    }
+  } else if (sample_size > 0) {
+    const auto step = total_weight / static_cast<double>(sample_size);
+    auto threshold = step / 2.0;
+    auto cumulative_weight = 0.0;
+    std::size_t selected = 0;
+    for (const auto& particle : particles) {
+      cumulative_weight += weight_of(particle);
+      std::size_t copies = 0;
+      while (selected < sample_size && threshold < cumulative_weight) {
+        threshold += step;
+        ++selected;
+        ++copies;
+      }
+      if (copies > 0) {
+        write_point(beluga::state(particle), static_cast<double>(copies) / static_cast<double>(sample_size));
+      }
+    }
+  }
+
+  message.data.resize(static_cast<std::size_t>(message.point_step) * points);
+  message.width = static_cast<std::uint32_t>(points);
+  message.row_step = message.point_step * message.width;
+  return message;
+}
+
 /// Assign a distribution to a particle cloud message.
 /**
  * Particle cloud sample size will match that of the given distribution.
@@ -0,0 +1,103 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BELUGA_ROS_TILED_MAP_HPP
+#define BELUGA_ROS_TILED_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <sophus/se2.hpp>
+
+#include <beluga/sensor/data/tiled_value_grid.hpp>
+#include <beluga/sensor/likelihood_field_model.hpp>
+
+#include <beluga_ros/occupancy_grid.hpp>
+
+/**
+ * \file
+ * \brief Utilities to compute likelihood fields of large maps on demand, off disk.
+ */
+
+namespace beluga_ros {
+
+/// Read-only memory mapping of an occupancy raster file.
+/**
+ * Occupancy rasters hold the cell data of a `nav_msgs/OccupancyGrid` message as is, ie. one signed byte per
+ * cell in row-major order, assuming a [standard ROS trinary interpretation](https://wiki.ros.org/map_server).
+ * Being memory-mapped, only those parts of the file that are read get paged in.
+ */
+class MappedOccupancyRaster {
+ public:
+  /// Maps an occupancy raster file.
+  /**
+   * \param path Path to the occupancy raster file.
+   * \param width Raster width, in cells.
+   * \param height Raster height, in cells.
+   * \throws std::runtime_error If the file cannot be mapped or its size does not match raster dimensions.
+   */
+  MappedOccupancyRaster(const std::string& path, std::size_t width, std::size_t height);
+
+  MappedOccupancyRaster(const MappedOccupancyRaster&) = delete;
+  MappedOccupancyRaster& operator=(const MappedOccupancyRaster&) = delete;
+  MappedOccupancyRaster(MappedOccupancyRaster&&) = delete;
+  MappedOccupancyRaster& operator=(MappedOccupancyRaster&&) = delete;
+
+  /// Unmaps the occupancy raster file.
+  ~MappedOccupancyRaster();
+
+  /// Gets raster width.
+  [[nodiscard]] std::size_t width() const { return width_; }
+
+  /// Gets raster height.
+  [[nodiscard]] std::size_t height() const { return height_; }
+
+  /// Gets raster cell data, in row-major order.
+  [[nodiscard]] const std::int8_t* data() const { return data_; }
+
+ private:
+  const std::int8_t* data_{nullptr};
+  std::size_t width_;
+  std::size_t height_;
+};
+
+/// Makes a likelihood field that computes its tiles on demand, off an occupancy raster.
+/**
+ * Each tile is computed off the occupancy grid that covers it and extends past it by `max_obstacle_distance`,
+ * so that tiles match the corresponding parts of a likelihood field computed for the whole map at once.
+ * The result can be used with a beluga::LikelihoodFieldModel, see its precomputed likelihood field constructor.
+ *
+ * \param raster Occupancy raster to compute likelihood field tiles off.
+ * \param resolution Raster resolution, in meters.
+ * \param params Likelihood field model parameters.
+ * \param tile_size Tile side length, in cells.
+ * \param capacity Maximum number of tiles to keep in memory, see beluga::TiledValueGrid2.
+ * \return A tiled likelihood field, with no tiles loaded yet.
+ */
+beluga::TiledValueGrid2<float> make_tiled_likelihood_field(
+    std::shared_ptr<const MappedOccupancyRaster> raster,
+    double resolution,
+    const beluga::LikelihoodFieldModelParam& params,
+    std::size_t tile_size,
+    std::size_t capacity);
+
+/// Likelihood field model backed by a tiled likelihood field, see make_tiled_likelihood_field().
+using TiledLikelihoodFieldModel =
+    beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid, Sophus::SE2d, beluga::TiledValueGrid2<float>>;
+
+}  // namespace beluga_ros
+
+#endif  // BELUGA_ROS_TILED_MAP_HPP
@@ -14,16 +14,270 @@
 
 #include <beluga_ros/amcl.hpp>
 
-#include <beluga/actions/assign.hpp>
+#include <algorithm>
+#include <any>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <range/v3/view/map.hpp>
+
+#include <Eigen/Geometry>
+
 #include <beluga/actions/normalize.hpp>
 #include <beluga/actions/propagate.hpp>
 #include <beluga/actions/reweight.hpp>
+#include <beluga/actions/reweight_bounded.hpp>
+#include <beluga/actions/reweight_coarse_to_fine.hpp>
 #include <beluga/algorithm/estimation.hpp>
+#include <beluga/algorithm/spatial_hash.hpp>
+#include <beluga/algorithm/thrun_recovery_probability_estimator.hpp>
+#include <beluga/utility/scratch_arena.hpp>
 #include <beluga/views/random_intersperse.hpp>
 #include <beluga/views/take_while_kld.hpp>
 
 namespace beluga_ros {
 
+// TODO(nahuel): Remove this once we update the measurement type.
+std::vector<std::pair<double, double>> make_measurement(const beluga_ros::LaserScan& laser_scan) {
+  return laser_scan.points_in_cartesian_coordinates() |  //
+         ranges::views::transform([&laser_scan](const auto& p) {
+           const auto result = laser_scan.origin() * Sophus::Vector3d{p.x(), p.y(), 0};
+           return std::make_pair(result.x(), result.y());
+         }) |
+         ranges::to<std::vector>;
+}
+
+std::vector<std::pair<double, double>> make_measurement(const std::vector<beluga_ros::LaserScan>& laser_scans) {
+  auto measurement = std::vector<std::pair<double, double>>{};
+  for (const auto& laser_scan : laser_scans) {
+    auto points = make_measurement(laser_scan);
+    measurement.insert(measurement.end(), points.begin(), points.end());
+  }
+  return measurement;
+}
+
+namespace {
+
+/// Statically typed AMCL filter implementation.
+template <class ExecutionPolicy, class MotionModel, class SensorModel>
+class AmclImplementation final : public detail::AmclInterface {
+ public:
+  AmclImplementation(
+      ExecutionPolicy execution_policy,
+      MotionModel motion_model,
+      SensorModel sensor_model,
+      const AmclParams& params)
+      : params_{params},
+        execution_policy_{std::move(execution_policy)},
+        motion_model_{std::move(motion_model)},
+        sensor_model_{std::move(sensor_model)},
+        spatial_hasher_{params_.spatial_resolution_x, params_.spatial_resolution_y, params_.spatial_resolution_theta},
+        random_probability_estimator_{params_.alpha_slow, params_.alpha_fast},
+        resample_policy_{beluga::make_amcl_resample_policy(params_.resample_interval, params_.selective_resampling)} {}
+
+  [[nodiscard]] const beluga::TupleVector<particle_type>& particles() const override { return particles_; }
+
+  void reset(beluga::TupleVector<particle_type> particles) override {
+    particles_ = std::move(particles);
+    // Resampling keeps particle buffers capacity, so size them for the largest particle set upfront.
+    particles_.reserve(params_.max_particles);
+    resampled_particles_.reserve(params_.max_particles);
+  }
+
+  void update_map(beluga_ros::OccupancyGrid map) override {
+    if constexpr (kTiledLikelihoodField) {
+      sensor_model_ = make_tiled_sensor_model(sensor_model_, map);
+    } else {
+      sensor_model_.update_map(std::move(map));
+    }
+  }
+
+  [[nodiscard]] std::function<std::any()> make_sensor_model_builder(beluga_ros::OccupancyGrid map) const override {
+    if constexpr (kTiledLikelihoodField) {
+      // Copies of tiled sensor models are cheap, as they share tiles.
+      return [sensor_model = sensor_model_, map = std::move(map)]() {
+        return std::any{make_tiled_sensor_model(sensor_model, map)};
+      };
+    } else {
+      return [params = sensor_model_.params(), map = std::move(map)]() { return std::any{SensorModel{params, map}}; };
+    }
+  }
+
+  std::any swap_sensor_model(std::any sensor_model) override {
+    auto previous_sensor_model = std::any{std::move(sensor_model_)};
+    sensor_model_ = std::any_cast<SensorModel>(std::move(sensor_model));
+    return previous_sensor_model;
+  }
+
+  void update(
+      const Sophus::SE2d& base_pose_in_odom,
+      measurement_type measurement,
+      distribution_type& random_state_distribution,
+      beluga::EarlyTerminationStats* early_termination_stats) override {
+    // Scratch memory from the previous update is no longer in use.
+    scratch_arena_.reset();
+
+    particles_ |=
+        beluga::actions::propagate(execution_policy_, motion_model_(control_action_window_ << base_pose_in_odom));
+
+    if constexpr (kTiledLikelihoodField) {
+      // Copies share the tile cache, so this brings tiles into the sensor model likelihood field.
+      auto likelihood_field = sensor_model_.likelihood_field();
+      likelihood_field.update_region(region_of_interest(Sophus::SE2d{}));
+    }
+
+    reweight(std::move(measurement), early_termination_stats);
+
+    const double random_state_probability = random_probability_estimator_(particles_);
+
+    if (resample_policy_(particles_)) {
+      auto random_state = ranges::compose(beluga::make_from_state<particle_type>, std::ref(random_state_distribution));
+
+      if (random_state_probability > 0.0) {
+        random_probability_estimator_.reset();
+      }
+
+      // Resample into a second buffer and swap, so that particle buffers are reused.
+      resampled_particles_.assign_range(
+          particles_ | beluga::views::sample |
+          beluga::views::geometric_random_intersperse(std::move(random_state), random_state_probability) |
+          beluga::views::take_while_kld(
+              spatial_hasher_,        //
+              params_.min_particles,  //
+              params_.max_particles,  //
+              params_.kld_epsilon,    //
+              params_.kld_z,          //
+              &scratch_arena_));
+      std::swap(particles_, resampled_particles_);
+    }
+
+    if constexpr (kTiledLikelihoodField) {
+      if (control_action_window_.size() > 1) {
+        // Assume the robot keeps moving as it did since the last update, and load tiles ahead of it.
+        const auto motion = control_action_window_[1].inverse() * control_action_window_[0];
+        auto likelihood_field = sensor_model_.likelihood_field();
+        likelihood_field.prefetch(region_of_interest(motion));
+      }
+    }
+  }
+
+  [[nodiscard]] AmclCheckpoint checkpoint() const override {
+    auto checkpoint = AmclCheckpoint{};
+    checkpoint.particles = particles_;
+    checkpoint.slow_average = random_probability_estimator_.slow_average();
+    checkpoint.fast_average = random_probability_estimator_.fast_average();
+    for (std::size_t index = 0; index < control_action_window_.size(); ++index) {
+      checkpoint.control_actions.push_back(control_action_window_[index]);
+    }
+    return checkpoint;
+  }
+
+  void restore(AmclCheckpoint checkpoint) override {
+    reset(std::move(checkpoint.particles));
+    random_probability_estimator_.reset(checkpoint.slow_average, checkpoint.fast_average);
+    control_action_window_.clear();
+    // Most recent control actions go last, so that they end up first.
+    for (auto it = checkpoint.control_actions.rbegin(); it != checkpoint.control_actions.rend(); ++it) {
+      control_action_window_ << *it;
+    }
+  }
+
+  [[nodiscard]] const beluga::ValueGrid2<float>* likelihood_field() const override {
+    if constexpr (std::is_same_v<SensorModel, beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid>>) {
+      return &sensor_model_.likelihood_field();
+    } else {
+      return nullptr;
+    }
+  }
+
+  [[nodiscard]] float unknown_space_likelihood() const override {
+    if constexpr (std::is_same_v<SensorModel, beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid>>) {
+      return static_cast<float>(1. / sensor_model_.params().max_laser_distance);
+    } else {
+      return 0.0F;
+    }
+  }
+
+ private:
+  static constexpr bool kTiledLikelihoodField = std::is_same_v<SensorModel, beluga_ros::TiledLikelihoodFieldModel>;
+
+  // Tiled likelihood fields are computed off a fixed occupancy raster, which maps must stand for.
+  // Only instantiated for tiled likelihood field models.
+  static SensorModel make_tiled_sensor_model(const SensorModel& sensor_model, const beluga_ros::OccupancyGrid& map) {
+    const auto& likelihood_field = sensor_model.likelihood_field();
+    if (map.width() != likelihood_field.width() || map.height() != likelihood_field.height() ||
+        map.resolution() != likelihood_field.resolution()) {
+      throw std::invalid_argument{"Map dimensions do not match those of the tiled likelihood field"};
+    }
+    return SensorModel{sensor_model.params(), likelihood_field, map.origin()};
+  }
+
+  // Bounding box of particle positions moved along some motion, in the likelihood field frame,
+  // grown by the maximum laser distance to cover every point a laser scan could hit.
+  [[nodiscard]] Eigen::AlignedBox2d region_of_interest(const Sophus::SE2d& motion) const {
+    const auto& transform = sensor_model_.world_to_likelihood_field_transform();
+    auto region = Eigen::AlignedBox2d{};
+    for (const auto& state : beluga::views::states(particles_)) {
+      region.extend((transform * state * motion).translation());
+    }
+    if (!region.isEmpty()) {
+      const double padding = sensor_model_.params().max_laser_distance;
+      region.min().array() -= padding;
+      region.max().array() += padding;
+    }
+    return region;
+  }
+
+  void reweight(measurement_type measurement, beluga::EarlyTerminationStats* early_termination_stats) {
+    if constexpr (std::is_same_v<SensorModel, beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid>>) {
+      if (sensor_model_.params().coarse_levels > 0) {
+        auto coarse_model = sensor_model_.coarse(measurement);
+        particles_ |= beluga::actions::reweight_coarse_to_fine(
+                          execution_policy_, std::move(coarse_model), sensor_model_(std::move(measurement)),
+                          sensor_model_.params().fine_fraction) |
+                      beluga::actions::normalize(execution_policy_);
+        return;
+      }
+    }
+
+    if (const double ratio = sensor_model_.params().early_termination_ratio; ratio > 0.0) {
+      particles_ |= beluga::actions::reweight_bounded(
+                        execution_policy_, sensor_model_.bounded(std::move(measurement), shuffle_engine_), ratio,
+                        early_termination_stats) |
+                    beluga::actions::normalize(execution_policy_);
+      return;
+    }
+
+    particles_ |= beluga::actions::reweight(execution_policy_, sensor_model_(std::move(measurement))) |  //
+                  beluga::actions::normalize(execution_policy_);
+  }
+
+  AmclParams params_;
+  ExecutionPolicy execution_policy_;
+  MotionModel motion_model_;
+  SensorModel sensor_model_;
+
+  beluga::TupleVector<particle_type> particles_;
+  beluga::TupleVector<particle_type> resampled_particles_;
+  beluga::ScratchArena scratch_arena_;
+  beluga::spatial_hash<Sophus::SE2d> spatial_hasher_;
+  beluga::ThrunRecoveryProbabilityEstimator random_probability_estimator_;
+  beluga::amcl_resample_policy_t resample_policy_;
+
+  beluga::RollingWindow<Sophus::SE2d, 2> control_action_window_;
+  std::mt19937 shuffle_engine_;
+};
+
+}  // namespace
+
 Amcl::Amcl(
     beluga_ros::OccupancyGrid map,
     motion_model_variant motion_model,
@@ -31,73 +285,314 @@ Amcl::Amcl(
     const AmclParams& params = AmclParams(),
     execution_policy_variant execution_policy = std::execution::seq)
     : params_{params},
-      map_distribution_{map},
-      motion_model_{std::move(motion_model)},
-      sensor_model_{std::move(sensor_model)},
-      execution_policy_{std::move(execution_policy)},
-      spatial_hasher_{params_.spatial_resolution_x, params_.spatial_resolution_y, params_.spatial_resolution_theta},
-      random_probability_estimator_{params_.alpha_slow, params_.alpha_fast},
-      update_policy_{beluga::policies::on_motion<Sophus::SE2d>(params_.update_min_d, params_.update_min_a)},
-      resample_policy_{beluga::policies::every_n(params_.resample_interval)} {
-  if (params_.selective_resampling) {
-    resample_policy_ = resample_policy_ && beluga::policies::on_effective_size_drop;
-  }
+      map_distribution_{map, params_.global_localization_stratified},
+      execution_policy_{execution_policy},
+      map_origin_{map.origin()},
+      update_policy_{beluga::make_amcl_update_policy<Sophus::SE2d>(params_.update_min_d, params_.update_min_a)} {
+  // Resolve all variants once, so that the update step does not need to dispatch on them.
+  filter_ = std::visit(
+      [this](auto policy, auto motion, auto sensor) -> std::unique_ptr<detail::AmclInterface> {
+        using implementation_type = AmclImplementation<decltype(policy), decltype(motion), decltype(sensor)>;
+        return std::make_unique<implementation_type>(std::move(policy), std::move(motion), std::move(sensor), params_);
+      },
+      std::move(execution_policy), std::move(motion_model), std::move(sensor_model));
 }
 
 void Amcl::update_map(beluga_ros::OccupancyGrid map) {
-  map_distribution_ = beluga::MultivariateUniformDistribution{map};
-  std::visit([&](auto& sensor_model) { sensor_model.update_map(std::move(map)); }, sensor_model_);
+  // Everything is built before any state is modified, so that maps that cannot be used leave the filter untouched.
+  if (active_map_id_.has_value()) {
+    // The active map goes back to the registry, so it cannot be updated in place. It is built right here,
+    // as the caller waits for it anyway.
+    auto prepared_map = make_map_builder(std::move(map), map_generation_ + 1)();
+    // Builds in progress are left to complete, they will be discarded.
+    ++map_generation_;
+    queued_map_.reset();
+    activate_map(std::move(prepared_map), std::nullopt);
+    return;
+  }
+  auto distribution = beluga::MultivariateUniformDistribution{map, params_.global_localization_stratified};
+  const auto origin = map.origin();
+  filter_->update_map(std::move(map));
+  // Builds in progress are left to complete, they will be discarded.
+  ++map_generation_;
+  queued_map_.reset();
+  map_distribution_ = std::move(distribution);
+  map_origin_ = origin;
+  scan_matcher_.reset();
+  pose_refiner_.reset();
+}
+
+void Amcl::update_map_in_background(beluga_ros::OccupancyGrid map) {
+  ++map_generation_;
+  if (pending_map_.valid()) {
+    queued_map_ = std::move(map);
+    return;
+  }
+  start_map_build(std::move(map));
+}
+
+auto Amcl::make_map_builder(beluga_ros::OccupancyGrid map, std::uint64_t generation) const
+    -> std::function<PreparedMap()> {
+  // The builder must not refer to this instance, so that it can run concurrently with filter updates.
+  auto build_sensor_model = filter_->make_sensor_model_builder(map);
+  return [generation, stratified = params_.global_localization_stratified,
+          build_sensor_model = std::move(build_sensor_model), map = std::move(map)]() {
+    const auto start_time = std::chrono::steady_clock::now();
+    auto distribution = beluga::MultivariateUniformDistribution{map, stratified};
+    auto sensor_model = build_sensor_model();
+    return PreparedMap{
+        generation, map.origin(), std::move(distribution), std::move(sensor_model),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time)};
+  };
+}
+
+auto Amcl::build_map(beluga_ros::OccupancyGrid map, std::uint64_t generation) const -> std::future<PreparedMap> {
+  return std::async(std::launch::async, make_map_builder(std::move(map), generation));
+}
+
+void Amcl::prune_retired_map_builds() {
+  retired_map_builds_.erase(
+      std::remove_if(
+          retired_map_builds_.begin(), retired_map_builds_.end(),
+          [](const auto& build) { return build.wait_for(std::chrono::seconds{0}) == std::future_status::ready; }),
+      retired_map_builds_.end());
+}
+
+void Amcl::start_map_build(beluga_ros::OccupancyGrid map) {
+  pending_map_ = build_map(std::move(map), map_generation_);
+}
+
+void Amcl::activate_map(PreparedMap map, std::optional<std::string> id) {
+  std::swap(map_distribution_, map.distribution);
+  std::swap(map_origin_, map.origin);
+  map.sensor_model = filter_->swap_sensor_model(std::move(map.sensor_model));
+  scan_matcher_.reset();
+  pose_refiner_.reset();
+  if (active_map_id_.has_value()) {
+    map_registry_.insert_or_assign(
+        std::move(active_map_id_).value(), RegisteredMap{std::future<PreparedMap>{}, std::move(map)});
+  }
+  active_map_id_ = std::move(id);
+}
+
+void Amcl::add_map(const std::string& id, beluga_ros::OccupancyGrid map) {
+  if (active_map_id_ == id) {
+    active_map_id_.reset();
+  }
+  prune_retired_map_builds();
+  auto build = build_map(std::move(map), 0);
+  if (const auto it = map_registry_.find(id); it != map_registry_.end()) {
+    if (it->second.build.valid()) {
+      // Superseded builds are not waited for here, but they must still complete before being dropped.
+      retired_map_builds_.push_back(std::move(it->second.build));
+    }
+    it->second = RegisteredMap{std::move(build), std::nullopt};
+    return;
+  }
+  map_registry_.emplace(id, RegisteredMap{std::move(build), std::nullopt});
+}
+
+bool Amcl::map_ready(const std::string& id) const {
+  if (active_map_id_ == id) {
+    return true;
+  }
+  const auto it = map_registry_.find(id);
+  if (it == map_registry_.end()) {
+    return false;
+  }
+  const auto& [build, map] = it->second;
+  return map.has_value() || build.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+bool Amcl::switch_map(const std::string& id) {
+  if (active_map_id_ == id) {
+    return true;
+  }
+  auto it = map_registry_.find(id);
+  if (it == map_registry_.end()) {
+    return false;
+  }
+
+  auto map = std::optional<PreparedMap>{};
+  try {
+    map = it->second.map.has_value() ? std::move(it->second.map).value() : it->second.build.get();
+  } catch (const std::exception&) {
+    // Maps that failed to build are dropped from the registry, the filter keeps localizing against the current map.
+    ++map_update_stats_.failures;
+    map_registry_.erase(it);
+    return false;
+  }
+  map_registry_.erase(it);
+
+  // Map updates in progress would otherwise override the switch once done.
+  ++map_generation_;
+  queued_map_.reset();
+
+  activate_map(std::move(map).value(), id);
+  force_update_ = true;
+  return true;
+}
+
+void Amcl::swap_map_if_ready() {
+  prune_retired_map_builds();
+  if (!pending_map_.valid() || pending_map_.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+    return;
+  }
+
+  auto prepared_map = std::optional<PreparedMap>{};
+  try {
+    prepared_map = pending_map_.get();
+    ++map_update_stats_.builds;
+    map_update_stats_.last_build_duration = prepared_map->build_duration;
+    map_update_stats_.max_build_duration =
+        std::max(map_update_stats_.max_build_duration, prepared_map->build_duration);
+  } catch (const std::exception&) {
+    // Build errors must not reach the filter update loop, the filter keeps localizing against the current map.
+    ++map_update_stats_.failures;
+  }
+
+  if (queued_map_.has_value()) {
+    // Superseded by a queued map, which only the last generation can stand for.
+    if (prepared_map.has_value()) {
+      ++map_update_stats_.discards;
+    }
+    auto map = std::move(queued_map_).value();
+    queued_map_.reset();
+    start_map_build(std::move(map));
+    return;
+  }
+
+  if (!prepared_map.has_value()) {
+    return;
+  }
+
+  if (prepared_map->generation != map_generation_) {
+    // Superseded by a synchronous map update.
+    ++map_update_stats_.discards;
+    return;
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  activate_map(std::move(prepared_map).value(), std::nullopt);
+  ++map_update_stats_.swaps;
+  map_update_stats_.last_swap_duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+}
+
+bool Amcl::initialize_from_scan_matching(const beluga_ros::LaserScan& laser_scan) {
+  swap_map_if_ready();
+  const auto* likelihood_field = filter_->likelihood_field();
+  if (likelihood_field == nullptr) {
+    return false;
+  }
+
+  if (!scan_matcher_.has_value()) {
+    auto matcher_params = beluga::BranchAndBoundScanMatcherParam{};
+    matcher_params.pyramid_depth = params_.scan_matching_pyramid_depth;
+    matcher_params.angular_step = params_.scan_matching_angular_step;
+    matcher_params.max_hypotheses = params_.scan_matching_max_hypotheses;
+    scan_matcher_.emplace(matcher_params, *likelihood_field, map_origin_, filter_->unknown_space_likelihood());
+  }
+
+  const auto hypotheses = scan_matcher_->match(make_measurement(laser_scan));
+  if (hypotheses.empty() || hypotheses.front().second <= 0.0) {
+    return false;
+  }
+
+  const double linear_variance = params_.scan_matching_linear_std_dev * params_.scan_matching_linear_std_dev;
+  const double angular_variance = params_.scan_matching_angular_std_dev * params_.scan_matching_angular_std_dev;
+  const Sophus::Matrix3d covariance = Eigen::Vector3d{linear_variance, linear_variance, angular_variance}.asDiagonal();
+
+  auto distributions = hypotheses | ranges::views::transform([&covariance](const auto& hypothesis) {
+                         return beluga::MultivariateNormalDistribution{hypothesis.first, covariance};
+                       }) |
+                       ranges::to<std::vector>;
+  const auto scores = hypotheses | ranges::views::values | ranges::to<std::vector>;
+  auto selector = std::discrete_distribution<std::size_t>{scores.begin(), scores.end()};
+  initialize([distributions = std::move(distributions), selector = std::move(selector)](auto& generator) mutable {
+    return distributions[selector(generator)](generator);
+  });
+  return true;
 }
 
 auto Amcl::update(Sophus::SE2d base_pose_in_odom, beluga_ros::LaserScan laser_scan)
     -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>> {
-  if (particles_.empty()) {
+  return update(base_pose_in_odom, [&laser_scan]() { return std::move(laser_scan); });
+}
+
+auto Amcl::update(Sophus::SE2d base_pose_in_odom, const std::function<beluga_ros::LaserScan()>& make_laser_scan)
+    -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>> {
+  return update_with_measurement(
+      base_pose_in_odom, [&make_laser_scan]() { return make_measurement(make_laser_scan()); });
+}
+
+auto Amcl::update(Sophus::SE2d base_pose_in_odom, std::vector<beluga_ros::LaserScan> laser_scans)
+    -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>> {
+  return update(base_pose_in_odom, [&laser_scans]() { return std::move(laser_scans); });
+}
+
+auto Amcl::update(
+    Sophus::SE2d base_pose_in_odom,
+    const std::function<std::vector<beluga_ros::LaserScan>()>& make_laser_scans)
+    -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>> {
+  return update_with_measurement(
+      base_pose_in_odom, [&make_laser_scans]() { return make_measurement(make_laser_scans()); });
+}
+
+auto Amcl::update_with_measurement(
+    const Sophus::SE2d& base_pose_in_odom,
+    const std::function<std::vector<std::pair<double, double>>()>& make_points)
+    -> std::optional<std::pair<Sophus::SE2d, Sophus::Matrix3d>> {
+  // Maps built in the background are swapped in between updates, never during one.
+  swap_map_if_ready();
+
+  if (filter_->particles().empty()) {
     return std::nullopt;
   }
 
+  // Policies keep track of the last update, so roll back their decision if the measurement cannot be made.
+  const auto latest_update_pose = update_policy_.latest_pose();
   if (!update_policy_(base_pose_in_odom) && !force_update_) {
     return std::nullopt;
   }
 
-  // TODO(nahuel): Remove this once we update the measurement type.
-  auto measurement = laser_scan.points_in_cartesian_coordinates() |  //
-                     ranges::views::transform([&laser_scan](const auto& p) {
-                       const auto result = laser_scan.origin() * Sophus::Vector3d{p.x(), p.y(), 0};
-                       return std::make_pair(result.x(), result.y());
-                     }) |
-                     ranges::to<std::vector>;
-
-  std::visit(
-      [&, this](auto& policy, auto& motion_model, auto& sensor_model) {
-        particles_ |=
-            beluga::actions::propagate(policy, motion_model(control_action_window_ << base_pose_in_odom)) |  //
-            beluga::actions::reweight(policy, sensor_model(std::move(measurement))) |                        //
-            beluga::actions::normalize(policy);
-      },
-      execution_policy_, motion_model_, sensor_model_);
+  auto measurement = std::vector<std::pair<double, double>>{};
+  try {
+    measurement = make_points();
+  } catch (...) {
+    update_policy_.set_latest_pose(latest_update_pose);
+    throw;
+  }
+  const auto refinement_points =
+      params_.refinement_max_iterations > 0 ? measurement : std::vector<std::pair<double, double>>{};
 
-  const double random_state_probability = random_probability_estimator_(particles_);
+  filter_->update(base_pose_in_odom, std::move(measurement), map_distribution_, &early_termination_stats_);
 
-  if (resample_policy_(particles_)) {
-    auto random_state = ranges::compose(beluga::make_from_state<particle_type>, std::ref(map_distribution_));
+  force_update_ = false;
+  const auto& particles = filter_->particles();
+  auto [pose, covariance] = beluga::estimate(beluga::views::states(particles), beluga::views::weights(particles));
+  if (params_.refinement_max_iterations > 0) {
+    pose = refine_estimate(pose, refinement_points);
+  }
+  return std::make_pair(pose, covariance);
+}
 
-    if (random_state_probability > 0.0) {
-      random_probability_estimator_.reset();
-    }
+Sophus::SE2d Amcl::refine_estimate(const Sophus::SE2d& pose, const std::vector<std::pair<double, double>>& points) {
+  const auto* likelihood_field = filter_->likelihood_field();
+  if (likelihood_field == nullptr) {
+    return pose;
+  }
 
-    particles_ |= beluga::views::sample |
-                  beluga::views::random_intersperse(std::move(random_state), random_state_probability) |
-                  beluga::views::take_while_kld(
-                      spatial_hasher_,        //
-                      params_.min_particles,  //
-                      params_.max_particles,  //
-                      params_.kld_epsilon,    //
-                      params_.kld_z) |
-                  beluga::actions::assign;
+  // The refiner borrows the likelihood field, so it must be rebuilt if the field ever moves.
+  if (!pose_refiner_.has_value() || &pose_refiner_->likelihood_field() != likelihood_field) {
+    auto refiner_params = beluga::GaussNewtonScanMatcherParam{};
+    refiner_params.max_iterations = params_.refinement_max_iterations;
+    refiner_params.max_linear_correction = params_.refinement_max_linear_correction;
+    refiner_params.max_angular_correction = params_.refinement_max_angular_correction;
+    pose_refiner_.emplace(refiner_params, *likelihood_field, map_origin_, filter_->unknown_space_likelihood());
   }
 
-  force_update_ = false;
-  return beluga::estimate(beluga::views::states(particles_), beluga::views::weights(particles_));
+  return pose_refiner_->refine(points, pose);
 }
 
 }  // namespace beluga_ros
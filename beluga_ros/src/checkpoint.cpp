@@ -0,0 +1,171 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <beluga_ros/checkpoint.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace beluga_ros {
+
+namespace {
+
+constexpr std::array<char, 4> kMagic = {'B', 'L', 'G', 'C'};
+constexpr std::uint32_t kVersion = 1;
+
+// Bounds the number of elements to read, so that corrupted files do not trigger huge allocations.
+constexpr std::uint64_t kMaxParticles = 100'000'000;
+constexpr std::uint64_t kMaxControlActions = 16;
+
+template <class T>
+void write_value(std::ostream& stream, const T& value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <class T>
+T read_value(std::istream& stream) {
+  T value{};
+  stream.read(reinterpret_cast<char*>(&value), sizeof(T));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (!stream) {
+    throw std::runtime_error{"Checkpoint is truncated"};
+  }
+  return value;
+}
+
+void write_pose(std::ostream& stream, const Sophus::SE2d& pose) {
+  write_value(stream, pose.translation().x());
+  write_value(stream, pose.translation().y());
+  write_value(stream, pose.so2().log());
+}
+
+Sophus::SE2d read_pose(std::istream& stream) {
+  const auto x = read_value<double>(stream);
+  const auto y = read_value<double>(stream);
+  const auto theta = read_value<double>(stream);
+  return Sophus::SE2d{Sophus::SO2d{theta}, Sophus::Vector2d{x, y}};
+}
+
+}  // namespace
+
+void write_checkpoint(std::ostream& stream, const AmclCheckpoint& checkpoint) {
+  stream.write(kMagic.data(), static_cast<std::streamsize>(kMagic.size()));
+  write_value(stream, kVersion);
+
+  write_value(stream, static_cast<std::uint64_t>(checkpoint.particles.size()));
+  for (const auto& [state, weight] : checkpoint.particles) {
+    write_pose(stream, state);
+    write_value(stream, static_cast<double>(weight));
+  }
+
+  write_value(stream, checkpoint.slow_average);
+  write_value(stream, checkpoint.fast_average);
+
+  write_value(stream, static_cast<std::uint64_t>(checkpoint.control_actions.size()));
+  for (const auto& pose : checkpoint.control_actions) {
+    write_pose(stream, pose);
+  }
+
+  if (!stream) {
+    throw std::runtime_error{"Failed to write checkpoint"};
+  }
+}
+
+AmclCheckpoint read_checkpoint(std::istream& stream) {
+  auto magic = std::array<char, 4>{};
+  stream.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+  if (!stream || magic != kMagic) {
+    throw std::runtime_error{"Not a checkpoint"};
+  }
+  if (read_value<std::uint32_t>(stream) != kVersion) {
+    throw std::runtime_error{"Unsupported checkpoint version"};
+  }
+
+  auto checkpoint = AmclCheckpoint{};
+  const auto particle_count = read_value<std::uint64_t>(stream);
+  if (particle_count > kMaxParticles) {
+    throw std::runtime_error{"Checkpoint is corrupted"};
+  }
+  checkpoint.particles.reserve(static_cast<std::size_t>(particle_count));
+  for (std::uint64_t i = 0; i < particle_count; ++i) {
+    const auto state = read_pose(stream);
+    const auto weight = read_value<double>(stream);
+    checkpoint.particles.emplace_back(state, beluga::Weight{weight});
+  }
+
+  checkpoint.slow_average = read_value<double>(stream);
+  checkpoint.fast_average = read_value<double>(stream);
+
+  const auto control_action_count = read_value<std::uint64_t>(stream);
+  if (control_action_count > kMaxControlActions) {
+    throw std::runtime_error{"Checkpoint is corrupted"};
+  }
+  checkpoint.control_actions.reserve(static_cast<std::size_t>(control_action_count));
+  for (std::uint64_t i = 0; i < control_action_count; ++i) {
+    checkpoint.control_actions.push_back(read_pose(stream));
+  }
+  return checkpoint;
+}
+
+void save_checkpoint(const std::string& path, const AmclCheckpoint& checkpoint) {
+  const auto temporary_path = path + ".tmp";
+  {
+    auto stream = std::ofstream{temporary_path, std::ios::binary | std::ios::trunc};
+    if (!stream) {
+      throw std::runtime_error{"Failed to open " + temporary_path + " for writing"};
+    }
+    write_checkpoint(stream, checkpoint);
+    stream.close();
+    if (!stream) {
+      throw std::runtime_error{"Failed to write checkpoint to " + temporary_path};
+    }
+  }
+  if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    std::remove(temporary_path.c_str());
+    throw std::runtime_error{"Failed to move checkpoint to " + path};
+  }
+}
+
+std::optional<AmclCheckpoint> load_checkpoint(const std::string& path) {
+  auto stream = std::ifstream{path, std::ios::binary};
+  if (!stream) {
+    return std::nullopt;
+  }
+  return read_checkpoint(stream);
+}
+
+bool AsyncCheckpointWriter::write(AmclCheckpoint checkpoint) {
+  if (pending_write_.valid()) {
+    if (pending_write_.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+      return false;
+    }
+    pending_write_.get();  // rethrows errors, if any
+  }
+  pending_write_ = std::async(std::launch::async, [path = path_, checkpoint = std::move(checkpoint)]() {
+    save_checkpoint(path, checkpoint);
+  });
+  return true;
+}
+
+void AsyncCheckpointWriter::wait() {
+  if (pending_write_.valid()) {
+    pending_write_.get();
+  }
+}
+
+}  // namespace beluga_ros
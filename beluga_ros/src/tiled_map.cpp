@@ -0,0 +1,122 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <beluga_ros/tiled_map.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if BELUGA_ROS_VERSION == 1
+#include <boost/smart_ptr.hpp>
+#endif
+
+#include <beluga_ros/messages.hpp>
+#include <beluga_ros/occupancy_grid.hpp>
+
+namespace beluga_ros {
+
+MappedOccupancyRaster::MappedOccupancyRaster(const std::string& path, std::size_t width, std::size_t height)
+    : width_{width}, height_{height} {
+  const int fd = ::open(path.c_str(), O_RDONLY);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+  if (fd < 0) {
+    throw std::runtime_error{"Failed to open occupancy raster " + path};
+  }
+  struct stat status {};
+  if (::fstat(fd, &status) != 0 || status.st_size <= 0 || static_cast<std::size_t>(status.st_size) != width * height) {
+    ::close(fd);
+    throw std::runtime_error{"Occupancy raster " + path + " does not match its dimensions"};
+  }
+  void* address = ::mmap(nullptr, width * height, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // the mapping outlives the file descriptor
+  if (address == MAP_FAILED) {  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    throw std::runtime_error{"Failed to map occupancy raster " + path};
+  }
+  data_ = static_cast<const std::int8_t*>(address);
+}
+
+MappedOccupancyRaster::~MappedOccupancyRaster() {
+  ::munmap(const_cast<std::int8_t*>(data_), width_ * height_);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+}
+
+beluga::TiledValueGrid2<float> make_tiled_likelihood_field(
+    std::shared_ptr<const MappedOccupancyRaster> raster,
+    double resolution,
+    const beluga::LikelihoodFieldModelParam& params,
+    std::size_t tile_size,
+    std::size_t capacity) {
+  const std::size_t width = raster->width();
+  const std::size_t height = raster->height();
+  const auto margin = static_cast<std::size_t>(std::ceil(params.max_obstacle_distance / resolution));
+  const auto unknown_space_occupancy_prob = static_cast<float>(1. / params.max_laser_distance);
+
+  auto load_tile = [raster = std::move(raster), resolution, params, tile_size, margin,
+                    unknown_space_occupancy_prob](const Eigen::Vector2i& tile) {
+    // Tile cells, and those of the window around them that tile likelihoods depend on.
+    const std::size_t x0 = static_cast<std::size_t>(tile.x()) * tile_size;
+    const std::size_t y0 = static_cast<std::size_t>(tile.y()) * tile_size;
+    const std::size_t x1 = std::min(x0 + tile_size, raster->width());
+    const std::size_t y1 = std::min(y0 + tile_size, raster->height());
+    const std::size_t window_x0 = x0 > margin ? x0 - margin : 0;
+    const std::size_t window_y0 = y0 > margin ? y0 - margin : 0;
+    const std::size_t window_x1 = std::min(x1 + margin, raster->width());
+    const std::size_t window_y1 = std::min(y1 + margin, raster->height());
+    const std::size_t window_width = window_x1 - window_x0;
+    const std::size_t window_height = window_y1 - window_y0;
+
+#if BELUGA_ROS_VERSION == 2
+    auto message = std::make_shared<beluga_ros::msg::OccupancyGrid>();
+#elif BELUGA_ROS_VERSION == 1
+    auto message = boost::make_shared<beluga_ros::msg::OccupancyGrid>();
+#else
+#error BELUGA_ROS_VERSION is not defined or invalid
+#endif
+    message->info.resolution = static_cast<float>(resolution);
+    message->info.width = static_cast<std::uint32_t>(window_width);
+    message->info.height = static_cast<std::uint32_t>(window_height);
+    message->info.origin.orientation.w = 1.0;
+    message->data.resize(window_width * window_height);
+    for (std::size_t yi = window_y0; yi < window_y1; ++yi) {
+      const std::int8_t* row = raster->data() + yi * raster->width();
+      std::copy(
+          row + window_x0, row + window_x1,
+          message->data.begin() + static_cast<std::ptrdiff_t>((yi - window_y0) * window_width));
+    }
+
+    using SensorModel = beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid>;
+    const auto window = SensorModel::make_likelihood_field(params, beluga_ros::OccupancyGrid{std::move(message)});
+
+    // Cells past the raster edge pad the tile, they are never looked up.
+    auto values = std::vector<float>(tile_size * tile_size, unknown_space_occupancy_prob);
+    for (std::size_t yi = y0; yi < y1; ++yi) {
+      for (std::size_t xi = x0; xi < x1; ++xi) {
+        values[(yi - y0) * tile_size + (xi - x0)] = window.data()[(yi - window_y0) * window_width + (xi - window_x0)];
+      }
+    }
+    return values;
+  };
+
+  return beluga::TiledValueGrid2<float>{width, height, resolution, tile_size, std::move(load_tile), capacity};
+}
+
+}  // namespace beluga_ros
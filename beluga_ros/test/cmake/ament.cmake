@@ -42,3 +42,11 @@ target_link_libraries(test_particle_cloud beluga_ros)
 ament_add_gmock(test_point_cloud test_point_cloud.cpp)
 target_compile_options(test_point_cloud PRIVATE -Wno-deprecated-copy)
 target_link_libraries(test_point_cloud beluga_ros)
+
+ament_add_gmock(test_checkpoint test_checkpoint.cpp)
+target_compile_options(test_checkpoint PRIVATE -Wno-deprecated-copy)
+target_link_libraries(test_checkpoint beluga_ros)
+
+ament_add_gmock(test_tiled_map test_tiled_map.cpp)
+target_compile_options(test_tiled_map PRIVATE -Wno-deprecated-copy)
+target_link_libraries(test_tiled_map beluga_ros)
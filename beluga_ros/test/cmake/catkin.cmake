@@ -62,3 +62,17 @@ target_link_libraries(
   ${PROJECT_NAME}
   ${catkin_LIBRARIES}
   gmock_main)
+
+catkin_add_gmock(test_checkpoint test_checkpoint.cpp)
+target_link_libraries(
+  test_checkpoint
+  ${PROJECT_NAME}
+  ${catkin_LIBRARIES}
+  gmock_main)
+
+catkin_add_gmock(test_tiled_map test_tiled_map.cpp)
+target_link_libraries(
+  test_tiled_map
+  ${PROJECT_NAME}
+  ${catkin_LIBRARIES}
+  gmock_main)
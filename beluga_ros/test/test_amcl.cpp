@@ -14,19 +14,29 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <execution>
 #include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Core>
+#include <sophus/common.hpp>
+#include <sophus/se3.hpp>
+#include <sophus/so3.hpp>
 
 #if BELUGA_ROS_VERSION == 1
 #include <boost/smart_ptr.hpp>
 #endif
 
 #include <beluga/motion/differential_drive_model.hpp>
+#include <beluga/sensor/data/tiled_value_grid.hpp>
 #include <beluga/sensor/likelihood_field_model.hpp>
 
 #include "beluga_ros/amcl.hpp"
@@ -35,7 +45,7 @@
 
 namespace {
 
-auto make_dummy_occupancy_grid() {
+auto make_dummy_occupancy_grid(std::int8_t occupancy = 0) {
   constexpr std::size_t kWidth = 100;
   constexpr std::size_t kHeight = 200;
 
@@ -52,7 +62,7 @@ auto make_dummy_occupancy_grid() {
   message->info.origin.position.x = 1;
   message->info.origin.position.y = 2;
   message->info.origin.position.z = 0;
-  message->data = std::vector<std::int8_t>(kWidth * kHeight);
+  message->data = std::vector<std::int8_t>(kWidth * kHeight, occupancy);
 
   return beluga_ros::OccupancyGrid{message};
 }
@@ -69,9 +79,21 @@ auto make_dummy_laser_scan() {
   return beluga_ros::LaserScan(message);
 }
 
-auto make_amcl() {
+auto make_short_range_laser_scan(const Sophus::SE3d& origin = Sophus::SE3d{}) {
+#if BELUGA_ROS_VERSION == 2
+  auto message = std::make_shared<beluga_ros::msg::LaserScan>();
+#elif BELUGA_ROS_VERSION == 1
+  auto message = boost::make_shared<beluga_ros::msg::LaserScan>();
+#endif
+  message->ranges = std::vector<float>{1., 2., 3.};
+  message->angle_increment = 0.5F;
+  message->range_min = 0.1F;
+  message->range_max = 100.F;
+  return beluga_ros::LaserScan(message, origin);
+}
+
+auto make_amcl(beluga_ros::AmclParams params = beluga_ros::AmclParams{}) {
   auto map = make_dummy_occupancy_grid();
-  auto params = beluga_ros::AmclParams{};
   params.max_particles = 50UL;
   return beluga_ros::Amcl{
       map,                                                                     //
@@ -99,6 +121,20 @@ TEST(TestAmcl, InitializeFromPose) {
   ASSERT_EQ(amcl.particles().size(), 50UL);
 }
 
+TEST(TestAmcl, InitializeFromScanMatching) {
+  auto amcl = make_amcl();
+  ASSERT_TRUE(amcl.initialize_from_scan_matching(make_short_range_laser_scan()).has_value());
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+  auto estimate = amcl.update(Sophus::SE2d{}, make_short_range_laser_scan());
+  ASSERT_TRUE(estimate.has_value());
+}
+
+TEST(TestAmcl, InitializeFromScanMatchingWithNoPoints) {
+  auto amcl = make_amcl();
+  ASSERT_FALSE(amcl.initialize_from_scan_matching(make_dummy_laser_scan()));
+  ASSERT_EQ(amcl.particles().size(), 0);
+}
+
 TEST(TestAmcl, UpdateWithNoParticles) {
   auto amcl = make_amcl();
   ASSERT_EQ(amcl.particles().size(), 0);
@@ -115,6 +151,54 @@ TEST(TestAmcl, UpdateWithParticles) {
   ASSERT_TRUE(estimate.has_value());
 }
 
+TEST(TestAmcl, UpdateWithPoseRefinement) {
+  auto params = beluga_ros::AmclParams{};
+  params.refinement_max_iterations = 5UL;
+  auto amcl = make_amcl(params);
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  auto estimate = amcl.update(Sophus::SE2d{}, make_short_range_laser_scan());
+  ASSERT_TRUE(estimate.has_value());
+  amcl.update_map(make_dummy_occupancy_grid());
+  amcl.force_update();
+  estimate = amcl.update(Sophus::SE2d{}, make_short_range_laser_scan());
+  ASSERT_TRUE(estimate.has_value());
+}
+
+TEST(TestAmcl, MakeMeasurementFromMultipleLaserScans) {
+  const auto first_origin = Sophus::SE3d{Sophus::SO3d{}, Eigen::Vector3d{1.0, 0.0, 0.0}};
+  const auto second_origin =
+      Sophus::SE3d{Sophus::SO3d::rotZ(Sophus::Constants<double>::pi() / 2.0), Eigen::Vector3d{0.0, 2.0, 0.0}};
+  const auto first_laser_scan = make_short_range_laser_scan(first_origin);
+  const auto second_laser_scan = make_short_range_laser_scan(second_origin);
+  const auto measurement = beluga_ros::make_measurement(std::vector{first_laser_scan, second_laser_scan});
+
+  // Points of each laser scan are transformed by its own origin, then merged in order.
+  const auto first_points = beluga_ros::make_measurement(first_laser_scan);
+  const auto second_points = beluga_ros::make_measurement(second_laser_scan);
+  ASSERT_EQ(first_points.size(), 3UL);
+  ASSERT_EQ(second_points.size(), 3UL);
+  ASSERT_EQ(measurement.size(), 6UL);
+  for (std::size_t i = 0; i < 3; ++i) {
+    const double angle = 0.5 * static_cast<double>(i);
+    const double range = 1.0 + static_cast<double>(i);
+    const double x = range * std::cos(angle);
+    const double y = range * std::sin(angle);
+    ASSERT_NEAR(measurement[i].first, x + 1.0, 1e-5);
+    ASSERT_NEAR(measurement[i].second, y, 1e-5);
+    ASSERT_NEAR(measurement[i + 3].first, -y, 1e-5);
+    ASSERT_NEAR(measurement[i + 3].second, x + 2.0, 1e-5);
+  }
+}
+
+TEST(TestAmcl, UpdateWithMultipleLaserScans) {
+  auto amcl = make_amcl();
+  amcl.initialize(Sophus::SE2d{}, Eigen::Vector3d::Ones().asDiagonal());
+  const auto second_origin = Sophus::SE3d{Sophus::SO3d::rotZ(Sophus::Constants<double>::pi()), Eigen::Vector3d{}};
+  auto laser_scans = std::vector{make_short_range_laser_scan(), make_short_range_laser_scan(second_origin)};
+  auto estimate = amcl.update(Sophus::SE2d{}, std::move(laser_scans));
+  ASSERT_TRUE(estimate.has_value());
+}
+
 TEST(TestAmcl, UpdateWithParticlesWithMotion) {
   auto amcl = make_amcl();
   ASSERT_EQ(amcl.particles().size(), 0);
@@ -149,4 +233,264 @@ TEST(TestAmcl, UpdateWithParticlesForced) {
   ASSERT_TRUE(estimate.has_value());
 }
 
+TEST(TestAmcl, UpdateWithEarlyTermination) {
+  auto map = make_dummy_occupancy_grid();
+  auto sensor_params = beluga::LikelihoodFieldModelParam{};
+  sensor_params.early_termination_ratio = 0.5;
+  auto params = beluga_ros::AmclParams{};
+  params.max_particles = 50UL;
+  auto amcl = beluga_ros::Amcl{
+      map,                                                                    //
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},  //
+      beluga::LikelihoodFieldModel{sensor_params, map},                       //
+      params,                                                                 //
+      std::execution::seq,
+  };
+  amcl.initialize_from_map();
+  ASSERT_EQ(amcl.early_termination_stats().total, 0UL);
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_short_range_laser_scan()).has_value());
+  const auto& stats = amcl.early_termination_stats();
+  ASSERT_GT(stats.total, 0UL);
+  ASSERT_LE(stats.evaluated, stats.total);
+  ASSERT_GE(stats.saved_fraction(), 0.0);
+}
+
+TEST(TestAmcl, UpdateWithoutEarlyTermination) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_short_range_laser_scan()).has_value());
+  ASSERT_EQ(amcl.early_termination_stats().total, 0UL);
+}
+
+TEST(TestAmcl, UpdateWithTiledLikelihoodField) {
+  // Tiles are 2m wide, so the 10m x 20m map spans 5 x 10 tiles.
+  constexpr std::size_t kTileSize = 20;
+  const auto farthest_column = std::make_shared<std::atomic<int>>(-1);
+  auto loader = [farthest_column](const Eigen::Vector2i& tile) {
+    int column = farthest_column->load();
+    while (column < tile.x() && !farthest_column->compare_exchange_weak(column, tile.x())) {
+    }
+    return std::vector<float>(kTileSize * kTileSize, 1.0F);
+  };
+  const auto likelihood_field = beluga::TiledValueGrid2<float>{100, 200, 0.1, kTileSize, loader, 4};
+
+  auto map = make_dummy_occupancy_grid();
+  auto sensor_params = beluga::LikelihoodFieldModelParam{};
+  sensor_params.max_laser_distance = 0.5;
+  auto params = beluga_ros::AmclParams{};
+  params.max_particles = 50UL;
+  auto amcl = beluga_ros::Amcl{
+      map,                                                                                   //
+      beluga::DifferentialDriveModel{beluga::DifferentialDriveModelParam{}},                 //
+      beluga_ros::TiledLikelihoodFieldModel{sensor_params, likelihood_field, map.origin()},  //
+      params,                                                                                //
+      std::execution::seq,
+  };
+
+  // Particles sit 2m away from the map origin, in the corner between the first four tiles.
+  const auto pose = Sophus::SE2d{Sophus::SO2d{}, Eigen::Vector2d{3.0, 4.0}};
+  amcl.initialize(pose, Eigen::Vector3d::Constant(1e-4).asDiagonal());
+  ASSERT_EQ(likelihood_field.cached_tiles(), 0UL);
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_short_range_laser_scan()).has_value());
+  ASSERT_EQ(likelihood_field.cached_tiles(), 4UL);
+  ASSERT_TRUE(likelihood_field.data_at(19, 19).has_value());
+  ASSERT_TRUE(likelihood_field.data_at(20, 20).has_value());
+  ASSERT_FALSE(likelihood_field.data_at(40, 20).has_value());
+  ASSERT_EQ(farthest_column->load(), 1);
+
+  // As the robot moves forward, so does the region of interest, and tiles ahead of it are prefetched.
+  const auto base_pose_in_odom = Sophus::SE2d{Sophus::SO2d{}, Eigen::Vector2d{2.0, 0.0}};
+  ASSERT_TRUE(amcl.update(base_pose_in_odom, make_short_range_laser_scan()).has_value());
+  ASSERT_TRUE(likelihood_field.data_at(40, 20).has_value());
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+  while (farthest_column->load() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(farthest_column->load(), 3);
+
+  // Maps must match the dimensions of the tiled likelihood field.
+  amcl.update_map(map);
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+}
+
+TEST(TestAmcl, UpdateMapFailure) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+
+  // Maps without free cells cannot be sampled from, and are rejected.
+  ASSERT_THROW(amcl.update_map(make_dummy_occupancy_grid(100)), std::invalid_argument);
+
+  // The filter keeps localizing against the current map.
+  amcl.initialize_from_map();
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+
+  // Same for maps that would replace one from the registry.
+  amcl.add_map("first_floor", make_dummy_occupancy_grid());
+  ASSERT_TRUE(amcl.switch_map("first_floor"));
+  ASSERT_THROW(amcl.update_map(make_dummy_occupancy_grid(100)), std::invalid_argument);
+  ASSERT_EQ(amcl.active_map_id(), "first_floor");
+}
+
+TEST(TestAmcl, UpdateMapInBackground) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  amcl.update_map_in_background(make_dummy_occupancy_grid());
+  ASSERT_TRUE(amcl.map_update_pending());
+
+  // Updates go on against the current map until the new one is built and swapped in.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (amcl.map_update_stats().swaps == 0UL && std::chrono::steady_clock::now() < deadline) {
+    amcl.force_update();
+    ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(amcl.map_update_stats().swaps, 1UL);
+  ASSERT_EQ(amcl.map_update_stats().builds, 1UL);
+  ASSERT_EQ(amcl.map_update_stats().discards, 0UL);
+  ASSERT_GT(amcl.map_update_stats().last_build_duration.count(), 0);
+  ASSERT_FALSE(amcl.map_update_pending());
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+}
+
+TEST(TestAmcl, UpdateMapInBackgroundSuperseded) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  amcl.update_map_in_background(make_dummy_occupancy_grid());
+  amcl.update_map_in_background(make_dummy_occupancy_grid());
+  amcl.update_map_in_background(make_dummy_occupancy_grid());
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (amcl.map_update_pending() && std::chrono::steady_clock::now() < deadline) {
+    amcl.initialize_from_map();
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  // The first map is superseded by the last one, and the one in between is never built.
+  ASSERT_EQ(amcl.map_update_stats().builds, 2UL);
+  ASSERT_EQ(amcl.map_update_stats().discards, 1UL);
+  ASSERT_EQ(amcl.map_update_stats().swaps, 1UL);
+
+  // Synchronous map updates supersede background ones.
+  amcl.update_map_in_background(make_dummy_occupancy_grid());
+  amcl.update_map(make_dummy_occupancy_grid());
+  while (amcl.map_update_pending() && std::chrono::steady_clock::now() < deadline) {
+    amcl.initialize_from_map();
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(amcl.map_update_stats().discards, 2UL);
+  ASSERT_EQ(amcl.map_update_stats().swaps, 1UL);
+}
+
+TEST(TestAmcl, UpdateMapInBackgroundFailure) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  // Maps without free cells cannot be sampled from, and thus fail to build.
+  amcl.update_map_in_background(make_dummy_occupancy_grid(100));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (amcl.map_update_pending() && std::chrono::steady_clock::now() < deadline) {
+    amcl.force_update();
+    ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_FALSE(amcl.map_update_pending());
+  ASSERT_EQ(amcl.map_update_stats().failures, 1UL);
+  ASSERT_EQ(amcl.map_update_stats().builds, 0UL);
+  ASSERT_EQ(amcl.map_update_stats().swaps, 0UL);
+
+  // Updates go on against the current map.
+  amcl.force_update();
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+}
+
+TEST(TestAmcl, CheckpointAndRestore) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{0.0, {1.0, 0.0}}, make_dummy_laser_scan()).has_value());
+  const auto checkpoint = amcl.checkpoint();
+  ASSERT_EQ(checkpoint.particles.size(), amcl.particles().size());
+  ASSERT_EQ(checkpoint.control_actions.size(), 2UL);
+  ASSERT_DOUBLE_EQ(checkpoint.control_actions.front().translation().x(), 1.0);
+  ASSERT_GT(checkpoint.slow_average, 0.0);
+
+  auto restored_amcl = make_amcl();
+  restored_amcl.restore(checkpoint);
+  ASSERT_EQ(restored_amcl.particles().size(), checkpoint.particles.size());
+  const auto restored_checkpoint = restored_amcl.checkpoint();
+  ASSERT_DOUBLE_EQ(restored_checkpoint.slow_average, checkpoint.slow_average);
+  ASSERT_DOUBLE_EQ(restored_checkpoint.fast_average, checkpoint.fast_average);
+  ASSERT_EQ(restored_checkpoint.control_actions.size(), 2UL);
+  ASSERT_DOUBLE_EQ(restored_checkpoint.control_actions.front().translation().x(), 1.0);
+  ASSERT_DOUBLE_EQ(restored_checkpoint.control_actions.back().translation().x(), 0.0);
+  ASSERT_TRUE(restored_amcl.update(Sophus::SE2d{0.0, {1.0, 0.0}}, make_dummy_laser_scan()).has_value());
+}
+
+TEST(TestAmcl, MapRegistry) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  ASSERT_FALSE(amcl.active_map_id().has_value());
+  ASSERT_FALSE(amcl.map_ready("first_floor"));
+  ASSERT_FALSE(amcl.switch_map("first_floor"));
+
+  amcl.add_map("first_floor", make_dummy_occupancy_grid());
+  amcl.add_map("second_floor", make_dummy_occupancy_grid());
+
+  // Switching waits for maps that are not ready yet.
+  ASSERT_TRUE(amcl.switch_map("first_floor"));
+  ASSERT_EQ(amcl.active_map_id(), "first_floor");
+  ASSERT_TRUE(amcl.map_ready("first_floor"));
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+
+  // Switched out maps go back to the registry.
+  ASSERT_TRUE(amcl.switch_map("second_floor"));
+  ASSERT_EQ(amcl.active_map_id(), "second_floor");
+  ASSERT_TRUE(amcl.map_ready("first_floor"));
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+  ASSERT_TRUE(amcl.switch_map("first_floor"));
+  ASSERT_TRUE(amcl.map_ready("second_floor"));
+
+  // Map updates make for an unregistered active map.
+  amcl.update_map(make_dummy_occupancy_grid());
+  ASSERT_FALSE(amcl.active_map_id().has_value());
+  ASSERT_TRUE(amcl.map_ready("first_floor"));
+  ASSERT_TRUE(amcl.switch_map("first_floor"));
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+}
+
+TEST(TestAmcl, MapRegistrySupersededBuilds) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+
+  // Maps registered again under the same id supersede those still being built, failed builds included.
+  amcl.add_map("first_floor", make_dummy_occupancy_grid(100));
+  amcl.add_map("first_floor", make_dummy_occupancy_grid());
+  ASSERT_TRUE(amcl.switch_map("first_floor"));
+  ASSERT_EQ(amcl.map_update_stats().failures, 0UL);
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+}
+
+TEST(TestAmcl, MapRegistryFailure) {
+  auto amcl = make_amcl();
+  amcl.initialize_from_map();
+  amcl.add_map("first_floor", make_dummy_occupancy_grid());
+  ASSERT_TRUE(amcl.switch_map("first_floor"));
+
+  // Maps without free cells cannot be sampled from, and thus fail to build.
+  amcl.add_map("broken_floor", make_dummy_occupancy_grid(100));
+  ASSERT_FALSE(amcl.switch_map("broken_floor"));
+  ASSERT_EQ(amcl.map_update_stats().failures, 1UL);
+  ASSERT_EQ(amcl.active_map_id(), "first_floor");
+  ASSERT_FALSE(amcl.map_ready("broken_floor"));
+  ASSERT_FALSE(amcl.switch_map("broken_floor"));
+  ASSERT_EQ(amcl.map_update_stats().failures, 1UL);
+
+  // Updates go on against the current map.
+  amcl.force_update();
+  ASSERT_TRUE(amcl.update(Sophus::SE2d{}, make_dummy_laser_scan()).has_value());
+  ASSERT_EQ(amcl.particles().size(), 50UL);
+}
+
 }  // namespace
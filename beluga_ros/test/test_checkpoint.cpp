@@ -0,0 +1,118 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include <sophus/se2.hpp>
+
+#include <beluga/primitives.hpp>
+
+#include "beluga_ros/checkpoint.hpp"
+
+namespace {
+
+beluga_ros::AmclCheckpoint make_checkpoint() {
+  auto checkpoint = beluga_ros::AmclCheckpoint{};
+  for (int i = 0; i < 100; ++i) {
+    const auto state = Sophus::SE2d{Sophus::SO2d{0.01 * i}, Sophus::Vector2d{0.1 * i, -0.2 * i}};
+    checkpoint.particles.emplace_back(state, beluga::Weight{0.01});
+  }
+  checkpoint.slow_average = 0.25;
+  checkpoint.fast_average = 0.5;
+  checkpoint.control_actions = {Sophus::SE2d{Sophus::SO2d{0.3}, Sophus::Vector2d{1.0, 2.0}}, Sophus::SE2d{}};
+  return checkpoint;
+}
+
+void expect_equal(const beluga_ros::AmclCheckpoint& checkpoint, const beluga_ros::AmclCheckpoint& expected) {
+  ASSERT_EQ(checkpoint.particles.size(), expected.particles.size());
+  for (std::size_t i = 0; i < checkpoint.particles.size(); ++i) {
+    const auto& [state, weight] = checkpoint.particles[i];
+    const auto& [expected_state, expected_weight] = expected.particles[i];
+    ASSERT_TRUE(state.translation().isApprox(expected_state.translation()));
+    ASSERT_DOUBLE_EQ(state.so2().log(), expected_state.so2().log());
+    ASSERT_DOUBLE_EQ(weight, expected_weight);
+  }
+  ASSERT_DOUBLE_EQ(checkpoint.slow_average, expected.slow_average);
+  ASSERT_DOUBLE_EQ(checkpoint.fast_average, expected.fast_average);
+  ASSERT_EQ(checkpoint.control_actions.size(), expected.control_actions.size());
+  for (std::size_t i = 0; i < checkpoint.control_actions.size(); ++i) {
+    const auto& pose = checkpoint.control_actions[i];
+    const auto& expected_pose = expected.control_actions[i];
+    ASSERT_TRUE(pose.translation().isApprox(expected_pose.translation()));
+    ASSERT_DOUBLE_EQ(pose.so2().log(), expected_pose.so2().log());
+  }
+}
+
+std::string make_temporary_path(const std::string& name) {
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+TEST(TestCheckpoint, RoundTrip) {
+  const auto checkpoint = make_checkpoint();
+  auto stream = std::stringstream{};
+  beluga_ros::write_checkpoint(stream, checkpoint);
+  // Header, particles, weight averages and control actions.
+  ASSERT_EQ(stream.str().size(), 8UL + 8UL + 100UL * 32UL + 16UL + 8UL + 2UL * 24UL);
+  expect_equal(beluga_ros::read_checkpoint(stream), checkpoint);
+}
+
+TEST(TestCheckpoint, InvalidCheckpoints) {
+  {
+    auto stream = std::stringstream{"not a checkpoint"};
+    ASSERT_THROW(beluga_ros::read_checkpoint(stream), std::runtime_error);
+  }
+  {
+    auto stream = std::stringstream{};
+    beluga_ros::write_checkpoint(stream, make_checkpoint());
+    auto truncated_stream = std::stringstream{stream.str().substr(0, 100)};
+    ASSERT_THROW(beluga_ros::read_checkpoint(truncated_stream), std::runtime_error);
+  }
+}
+
+TEST(TestCheckpoint, SaveAndLoad) {
+  const auto path = make_temporary_path("beluga_ros_test_checkpoint.bin");
+  ASSERT_FALSE(beluga_ros::load_checkpoint(path).has_value());
+  const auto checkpoint = make_checkpoint();
+  beluga_ros::save_checkpoint(path, checkpoint);
+  const auto loaded_checkpoint = beluga_ros::load_checkpoint(path);
+  ASSERT_TRUE(loaded_checkpoint.has_value());
+  expect_equal(loaded_checkpoint.value(), checkpoint);
+  ASSERT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+TEST(TestCheckpoint, AsyncWriter) {
+  const auto path = make_temporary_path("beluga_ros_test_async_checkpoint.bin");
+  auto writer = beluga_ros::AsyncCheckpointWriter{path};
+  const auto checkpoint = make_checkpoint();
+  ASSERT_TRUE(writer.write(checkpoint));
+  writer.wait();
+  const auto loaded_checkpoint = beluga_ros::load_checkpoint(path);
+  ASSERT_TRUE(loaded_checkpoint.has_value());
+  expect_equal(loaded_checkpoint.value(), checkpoint);
+
+  // Write errors are reported on the next write, or wait.
+  auto failing_writer = beluga_ros::AsyncCheckpointWriter{"/nonexistent/directory/checkpoint.bin"};
+  ASSERT_TRUE(failing_writer.write(checkpoint));
+  ASSERT_THROW(failing_writer.wait(), std::runtime_error);
+}
+
+}  // namespace
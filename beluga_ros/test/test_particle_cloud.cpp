@@ -186,4 +186,97 @@ TEST(TestParticleCloud3, AssignNoMarkers) {
   EXPECT_EQ(message.markers.size(), 0U);
 }
 
+TEST(TestParticleCloud, AssignPointCloud) {
+  using Constants = Sophus::Constants<double>;
+  const auto particles = std::vector{
+      std::make_tuple(
+          Sophus::SE2d{Sophus::SO2d{Constants::pi() / 2.0}, Eigen::Vector2d{1.0, 2.0}}, beluga::Weight(1.0)),
+      std::make_tuple(Sophus::SE2d{Sophus::SO2d{}, Eigen::Vector2d{-1.0, 0.5}}, beluga::Weight(3.0)),
+  };
+  auto message = beluga_ros::msg::PointCloud2{};
+  beluga_ros::assign_particle_cloud(particles, message);
+  ASSERT_EQ(message.width, 2U);
+  EXPECT_EQ(message.height, 1U);
+  EXPECT_EQ(message.fields.size(), 5U);
+  EXPECT_EQ(message.point_step, 5 * sizeof(float));
+  EXPECT_EQ(message.data.size(), 2 * message.point_step);
+  auto x = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "x");
+  auto y = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "y");
+  auto z = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "z");
+  auto yaw = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "yaw");
+  auto weight = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "weight");
+  EXPECT_FLOAT_EQ(*x, 1.0F);
+  EXPECT_FLOAT_EQ(*y, 2.0F);
+  EXPECT_FLOAT_EQ(*z, 0.0F);
+  EXPECT_FLOAT_EQ(*yaw, static_cast<float>(Constants::pi() / 2.0));
+  EXPECT_FLOAT_EQ(*weight, 0.25F);
+  ++x, ++y, ++z, ++yaw, ++weight;
+  EXPECT_FLOAT_EQ(*x, -1.0F);
+  EXPECT_FLOAT_EQ(*y, 0.5F);
+  EXPECT_FLOAT_EQ(*z, 0.0F);
+  EXPECT_FLOAT_EQ(*yaw, 0.0F);
+  EXPECT_FLOAT_EQ(*weight, 0.75F);
+}
+
+TEST(TestParticleCloud, AssignSubsampledPointCloud) {
+  auto particles = std::vector<std::tuple<Sophus::SE2d, beluga::Weight>>{};
+  for (int i = 0; i < 100; ++i) {
+    const auto x = static_cast<double>(i);
+    particles.emplace_back(Sophus::SE2d{Sophus::SO2d{}, Eigen::Vector2d{x, 0.0}}, beluga::Weight(1.0));
+  }
+  auto message = beluga_ros::msg::PointCloud2{};
+  beluga_ros::assign_particle_cloud(particles, 10U, message);
+  ASSERT_EQ(message.width, 10U);
+  auto x = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "x");
+  auto weight = beluga_ros::msg::PointCloud2ConstIterator<float>(message, "weight");
+  for (int i = 0; i < 10; ++i, ++x, ++weight) {
+    EXPECT_FLOAT_EQ(*x, static_cast<float>(10 * i + 5));  // evenly spread
+    EXPECT_FLOAT_EQ(*weight, 0.1F);
+  }
+
+  // Heavy particles are selected many times, but written once.
+  std::get<1>(particles[42]) = beluga::Weight(9900.0);
+  beluga_ros::assign_particle_cloud(particles, 10U, message);
+  ASSERT_EQ(message.width, 1U);
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "x"), 42.0F);
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "weight"), 1.0F);
+}
+
+TEST(TestParticleCloud, ReusePointCloud) {
+  auto particles = std::vector<std::tuple<Sophus::SE2d, beluga::Weight>>(100, std::make_tuple(Sophus::SE2d{}, 1.0));
+  auto message = beluga_ros::msg::PointCloud2{};
+  beluga_ros::assign_particle_cloud(particles, message);
+  ASSERT_EQ(message.width, 100U);
+  const auto* const buffer = message.data.data();
+  particles.resize(50);
+  beluga_ros::assign_particle_cloud(particles, message);
+  EXPECT_EQ(message.width, 50U);
+  EXPECT_EQ(message.row_step, 50 * message.point_step);
+  EXPECT_EQ(message.data.data(), buffer);
+  particles.clear();
+  beluga_ros::assign_particle_cloud(particles, message);
+  EXPECT_EQ(message.width, 0U);
+  EXPECT_EQ(message.fields.size(), 5U);
+}
+
+TEST(TestParticleCloud3, AssignPointCloud) {
+  const auto rotation = Eigen::Quaternion<double>{0.8497105, 0.0, 0.3728217, 0.3728217}.normalized();
+  const auto particles = std::vector{
+      std::make_tuple(Sophus::SE3d{Sophus::SO3d{rotation}, Eigen::Vector3d{1.0, 2.0, 3.0}}, beluga::Weight(2.0)),
+  };
+  auto message = beluga_ros::msg::PointCloud2{};
+  beluga_ros::assign_particle_cloud(particles, message);
+  ASSERT_EQ(message.width, 1U);
+  EXPECT_EQ(message.fields.size(), 8U);
+  EXPECT_EQ(message.point_step, 8 * sizeof(float));
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "x"), 1.0F);
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "y"), 2.0F);
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "z"), 3.0F);
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "qx"), static_cast<float>(rotation.x()));
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "qy"), static_cast<float>(rotation.y()));
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "qz"), static_cast<float>(rotation.z()));
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "qw"), static_cast<float>(rotation.w()));
+  EXPECT_FLOAT_EQ(*beluga_ros::msg::PointCloud2ConstIterator<float>(message, "weight"), 1.0F);
+}
+
 }  // namespace
@@ -0,0 +1,109 @@
+// Copyright 2024 Ekumen, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#if BELUGA_ROS_VERSION == 1
+#include <boost/smart_ptr.hpp>
+#endif
+
+#include <beluga/sensor/likelihood_field_model.hpp>
+
+#include "beluga_ros/messages.hpp"
+#include "beluga_ros/occupancy_grid.hpp"
+#include "beluga_ros/tiled_map.hpp"
+
+namespace {
+
+constexpr std::size_t kWidth = 50;
+constexpr std::size_t kHeight = 30;
+constexpr double kResolution = 0.1;
+
+// An occupancy raster with a few walls and some unknown space, as stored in a file.
+std::vector<std::int8_t> make_raster() {
+  auto data = std::vector<std::int8_t>(kWidth * kHeight, 0);
+  for (std::size_t xi = 5; xi < 45; ++xi) {
+    data[10 * kWidth + xi] = 100;
+  }
+  for (std::size_t yi = 12; yi < 28; ++yi) {
+    data[yi * kWidth + 30] = 100;
+    data[yi * kWidth + 2] = -1;
+  }
+  return data;
+}
+
+std::string write_raster(const std::vector<std::int8_t>& data) {
+  const auto path = (std::filesystem::temp_directory_path() / "beluga_ros_test_tiled_map.raster").string();
+  auto file = std::ofstream{path, std::ios::binary};
+  file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));  // NOLINT
+  return path;
+}
+
+TEST(TestTiledMap, MappedOccupancyRaster) {
+  const auto data = make_raster();
+  const auto path = write_raster(data);
+  const auto raster = beluga_ros::MappedOccupancyRaster{path, kWidth, kHeight};
+  ASSERT_EQ(raster.width(), kWidth);
+  ASSERT_EQ(raster.height(), kHeight);
+  ASSERT_EQ(std::vector<std::int8_t>(raster.data(), raster.data() + kWidth * kHeight), data);
+  ASSERT_THROW(beluga_ros::MappedOccupancyRaster(path, kWidth, kHeight + 1), std::runtime_error);
+  ASSERT_THROW(beluga_ros::MappedOccupancyRaster(path + ".missing", kWidth, kHeight), std::runtime_error);
+}
+
+TEST(TestTiledMap, TilesMatchWholeMapLikelihoodField) {
+  const auto data = make_raster();
+  auto params = beluga::LikelihoodFieldModelParam{};
+  params.max_obstacle_distance = 0.5;
+  params.model_unknown_space = true;
+
+  auto field = beluga_ros::make_tiled_likelihood_field(
+      std::make_shared<const beluga_ros::MappedOccupancyRaster>(write_raster(data), kWidth, kHeight), kResolution,
+      params, 16, 8);
+  field.update_region(Eigen::AlignedBox2d{Eigen::Vector2d{0.0, 0.0}, Eigen::Vector2d{5.0, 3.0}});
+
+#if BELUGA_ROS_VERSION == 2
+  auto message = std::make_shared<beluga_ros::msg::OccupancyGrid>();
+#elif BELUGA_ROS_VERSION == 1
+  auto message = boost::make_shared<beluga_ros::msg::OccupancyGrid>();
+#else
+#error BELUGA_ROS_VERSION is not defined or invalid
+#endif
+  message->info.resolution = static_cast<float>(kResolution);
+  message->info.width = kWidth;
+  message->info.height = kHeight;
+  message->info.origin.orientation.w = 1.0;
+  message->data = data;
+  const auto expected = beluga::LikelihoodFieldModel<beluga_ros::OccupancyGrid>::make_likelihood_field(
+      params, beluga_ros::OccupancyGrid{message});
+
+  for (int yi = 0; yi < static_cast<int>(kHeight); ++yi) {
+    for (int xi = 0; xi < static_cast<int>(kWidth); ++xi) {
+      ASSERT_FLOAT_EQ(field.data_at(xi, yi).value(), expected.data_at(xi, yi).value()) << xi << ", " << yi;
+    }
+  }
+}
+
+}  // namespace